@@ -0,0 +1,490 @@
+//
+//  Benchmark.cpp
+//  Neon21ModelExporterBenchmark
+//
+//  Copyright (c) 2012 Neon Games LLC. All rights reserved.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <new>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <CoreFoundation/CoreFoundation.h>
+
+#define NO_LIBXML
+#include "FCollada.h"
+#include "FMath/FMAllocator.h"
+
+#include "ModelExporterDefines.h"
+#include "Logging.h"
+#include "main.h"
+
+#include "SceneGenerator.h"
+#include "MathBenchmark.h"
+
+#define BENCHMARK_PATH_LENGTH       (1024)
+#define BENCHMARK_RECORD_LENGTH     (4096)
+
+typedef enum
+{
+    BENCHMARK_PHASE_INIT,
+    BENCHMARK_PHASE_READ_SCENE,
+    BENCHMARK_PHASE_WRITE_SCENE,
+    BENCHMARK_PHASE_MAX
+} BenchmarkPhase;
+
+static const char* PHASE_NAMES[BENCHMARK_PHASE_MAX] = { "Init", "ReadScene", "WriteScene" };
+
+typedef struct
+{
+    double  mSeconds;
+    long    mNumAllocations;
+    long    mAllocatedBytes;
+    long    mProcessPeakRssBytes;   // Peak of the whole run process so far, not of the phase alone
+} PhaseRecord;
+
+static SceneParameters sDefaultScenes[] = { { "static_tris_10k",            10000,  SCENE_PRIMITIVES_TRIANGLES, 0, 0,   0.0f,   0.0f },
+                                            { "static_quads_10k",           10000,  SCENE_PRIMITIVES_POLYGONS,  0, 0,   0.0f,   0.0f },
+                                            { "static_tris_200k",           200000, SCENE_PRIMITIVES_TRIANGLES, 0, 0,   0.0f,   0.0f },
+                                            { "skinned_4inf_64j",           20000,  SCENE_PRIMITIVES_TRIANGLES, 4, 64,  0.0f,   0.0f },
+                                            { "animated_64j_10s_30fps",     2000,   SCENE_PRIMITIVES_TRIANGLES, 4, 64,  10.0f,  30.0f },
+                                            { "animated_128j_60s_60fps",    5000,   SCENE_PRIMITIVES_TRIANGLES, 4, 128, 60.0f,  60.0f } };
+
+static SceneParameters  sCustomScene = { "custom", 10000, SCENE_PRIMITIVES_TRIANGLES, 0, 0, 0.0f, 0.0f };
+static bool             sCustomSceneRequested = false;
+
+static const char*      sWorkDirectory = NULL;
+static const char*      sOutputFile = NULL;
+static int              sNumRuns = 1;
+static bool             sVerbose = false;
+static bool             sMathRequested = false;
+
+// Allocations made by the exporter and FCollada.  Both the FCollada containers, through its allocator, and the
+// objects created with new are counted.  Each run happens in its own process so these are never shared.
+static volatile long    sNumAllocations = 0;
+static volatile long    sAllocatedBytes = 0;
+
+static void CountAllocation(size_t inSize)
+{
+    __sync_fetch_and_add(&sNumAllocations, 1);
+    __sync_fetch_and_add(&sAllocatedBytes, (long)inSize);
+}
+
+static void* CountedAllocate(size_t inSize)
+{
+    CountAllocation(inSize);
+    return malloc(inSize);
+}
+
+static void CountedFree(void* inBuffer)
+{
+    free(inBuffer);
+}
+
+void* operator new(size_t inSize) throw(std::bad_alloc)
+{
+    CountAllocation(inSize);
+
+    void* buffer = malloc((inSize > 0) ? inSize : 1);
+
+    if (buffer == NULL)
+    {
+        throw std::bad_alloc();
+    }
+
+    return buffer;
+}
+
+void* operator new[](size_t inSize) throw(std::bad_alloc)
+{
+    return operator new(inSize);
+}
+
+void operator delete(void* inBuffer) throw()
+{
+    free(inBuffer);
+}
+
+void operator delete[](void* inBuffer) throw()
+{
+    free(inBuffer);
+}
+
+static double GetTime()
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+
+    return (double)now.tv_sec + ((double)now.tv_usec / 1000000.0);
+}
+
+// ru_maxrss never decreases: at the end of a phase it is the peak of the process up to then, so a phase
+// only shows its own peak when that exceeds the peaks of the phases before it.
+static long GetProcessPeakRssBytes()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+#ifdef __APPLE__
+    return (long)usage.ru_maxrss;
+#else
+    // Linux reports it in kilobytes.
+    return (long)usage.ru_maxrss * 1024;
+#endif
+}
+
+static void BeginPhase(PhaseRecord* outRecord)
+{
+    sNumAllocations = 0;
+    sAllocatedBytes = 0;
+
+    outRecord->mSeconds = GetTime();
+}
+
+static void EndPhase(PhaseRecord* outRecord)
+{
+    outRecord->mSeconds = GetTime() - outRecord->mSeconds;
+    outRecord->mNumAllocations = sNumAllocations;
+    outRecord->mAllocatedBytes = sAllocatedBytes;
+    outRecord->mProcessPeakRssBytes = GetProcessPeakRssBytes();
+}
+
+static void SilenceOutput()
+{
+    if (!sVerbose)
+    {
+        fflush(stdout);
+
+        int nullFile = open("/dev/null", O_WRONLY);
+
+        if (nullFile != -1)
+        {
+            dup2(nullFile, STDOUT_FILENO);
+            close(nullFile);
+        }
+    }
+}
+
+// Runs the exporter on a generated scene and writes the record of the phases to inRecordFile.
+// The exporter exits on bad input, in which case nothing is written.
+static void RunExporter(const SceneParameters* inScene, char* inSceneFile, char* inOutputDirectory, int inRun, int inRecordFile)
+{
+    PhaseRecord phases[BENCHMARK_PHASE_MAX];
+
+    SilenceOutput();
+    fm::SetAllocationFunctions(CountedAllocate, CountedFree);
+
+    gInputFile = inSceneFile;
+    gOutputDirectory = inOutputDirectory;
+
+    BeginPhase(&phases[BENCHMARK_PHASE_INIT]);
+    Init();
+    EndPhase(&phases[BENCHMARK_PHASE_INIT]);
+
+    BeginPhase(&phases[BENCHMARK_PHASE_READ_SCENE]);
+    ReadScene();
+    EndPhase(&phases[BENCHMARK_PHASE_READ_SCENE]);
+
+    BeginPhase(&phases[BENCHMARK_PHASE_WRITE_SCENE]);
+    WriteScene();
+    EndPhase(&phases[BENCHMARK_PHASE_WRITE_SCENE]);
+
+    char record[BENCHMARK_RECORD_LENGTH];
+    int length = snprintf(record, BENCHMARK_RECORD_LENGTH, "\"run\": %d, \"status\": \"ok\", \"phases\": {", inRun);
+
+    for (int curPhase = 0; curPhase < BENCHMARK_PHASE_MAX; curPhase++)
+    {
+        length += snprintf(&record[length], BENCHMARK_RECORD_LENGTH - length,
+                            "%s\"%s\": { \"seconds\": %.6f, \"allocations\": %ld, \"allocatedBytes\": %ld, \"processPeakRssBytes\": %ld }",
+                            (curPhase == 0) ? " " : ", ", PHASE_NAMES[curPhase], phases[curPhase].mSeconds,
+                            phases[curPhase].mNumAllocations, phases[curPhase].mAllocatedBytes, phases[curPhase].mProcessPeakRssBytes);
+    }
+
+    length += snprintf(&record[length], BENCHMARK_RECORD_LENGTH - length, " }");
+
+    write(inRecordFile, record, length);
+}
+
+// Each scene is generated and exported in a process of its own: the exporter keeps its state in globals,
+// exits on errors and its peak memory use would otherwise include the previous scenes.  A negative run
+// generates the scene instead of exporting it.
+static bool RunChild(const SceneParameters* inScene, char* inSceneFile, char* inOutputDirectory, int inRun, char* outRecord)
+{
+    int recordPipe[2];
+
+    // Anything left buffered would be written again by the child if the exporter exits.
+    fflush(NULL);
+
+    if (pipe(recordPipe) == -1)
+    {
+        return false;
+    }
+
+    pid_t child = fork();
+
+    if (child == 0)
+    {
+        close(recordPipe[0]);
+
+        if (inRun < 0)
+        {
+            SilenceOutput();
+
+            FCollada::Initialize();
+            bool success = GenerateScene(inScene, inSceneFile);
+            FCollada::Release();
+
+            write(recordPipe[1], success ? "ok" : "", success ? 2 : 0);
+        }
+        else
+        {
+            RunExporter(inScene, inSceneFile, inOutputDirectory, inRun, recordPipe[1]);
+        }
+
+        close(recordPipe[1]);
+
+        NeonLogFlush();
+        fflush(stdout);
+        _exit(0);
+    }
+
+    close(recordPipe[1]);
+
+    int length = 0;
+
+    if (child != -1)
+    {
+        ssize_t numRead = 0;
+
+        while ((length < BENCHMARK_RECORD_LENGTH - 1) && ((numRead = read(recordPipe[0], &outRecord[length], BENCHMARK_RECORD_LENGTH - 1 - length)) > 0))
+        {
+            length += (int)numRead;
+        }
+
+        waitpid(child, NULL, 0);
+    }
+
+    close(recordPipe[0]);
+    outRecord[length] = 0;
+
+    return (length > 0);
+}
+
+static long GetFileSize(const char* inFilename)
+{
+    struct stat fileInfo;
+
+    if (stat(inFilename, &fileInfo) == -1)
+    {
+        return 0;
+    }
+
+    return (long)fileInfo.st_size;
+}
+
+static void RunScene(const SceneParameters* inScene, FILE* inOutput, bool inFirstScene)
+{
+    char sceneFile[BENCHMARK_PATH_LENGTH];
+    char outputDirectory[BENCHMARK_PATH_LENGTH];
+    char record[BENCHMARK_RECORD_LENGTH];
+
+    snprintf(sceneFile, BENCHMARK_PATH_LENGTH, "%s/%s.dae", sWorkDirectory, inScene->mName);
+    snprintf(outputDirectory, BENCHMARK_PATH_LENGTH, "%s/%s", sWorkDirectory, inScene->mName);
+    mkdir(outputDirectory, 0755);
+
+    fprintf(stderr, "Benchmarking %s\n", inScene->mName);
+
+    bool generated = RunChild(inScene, sceneFile, outputDirectory, -1, record);
+    long fileBytes = GetFileSize(sceneFile);
+
+    for (int curRun = 0; curRun < sNumRuns; curRun++)
+    {
+        fprintf(inOutput, "%s\n        { \"name\": \"%s\", \"triangles\": %d, \"primitives\": \"%s\", \"influences\": %d, \"joints\": %d, "
+                            "\"clipLength\": %g, \"keysPerSecond\": %g, \"fileBytes\": %ld, ",
+                            (inFirstScene && (curRun == 0)) ? "" : ",", inScene->mName, inScene->mNumTriangles,
+                            (inScene->mPrimitives == SCENE_PRIMITIVES_TRIANGLES) ? "triangles" : "polygons",
+                            inScene->mNumInfluences, inScene->mNumJoints, inScene->mClipLength, inScene->mKeysPerSecond, fileBytes);
+
+        if (!generated)
+        {
+            fprintf(inOutput, "\"run\": %d, \"status\": \"generationFailed\" }", curRun);
+        }
+        else if (!RunChild(inScene, sceneFile, outputDirectory, curRun, record))
+        {
+            fprintf(inOutput, "\"run\": %d, \"status\": \"exportFailed\" }", curRun);
+        }
+        else
+        {
+            fprintf(inOutput, "%s }", record);
+        }
+    }
+}
+
+static void DisplayUsage()
+{
+    printf("Usage is Neon21ModelExporterBenchmark [options] <work directory>\n");
+    printf("The scenes are generated in the work directory and exported to subdirectories of it.  The results are written as JSON.\n");
+    printf("Optional arguments are:\n");
+    printf("-output <file>:\t\tWrite the results to this file instead of the standard output.\n");
+    printf("-runs <val>:\t\tNumber of times each scene is exported.\n");
+    printf("-verbose <val>:\t\tIf val is non-zero, the output of the exporter is shown.\n");
+    printf("-math <val>:\t\tIf val is non-zero, the NeonMath kernels are checked against their portable versions and timed instead.\n");
+    printf("Any of the following replaces the default scenes with a single scene:\n");
+    printf("-triangles <val>:\tNumber of triangles once exported.\n");
+    printf("-primitives <val>:\t\"triangles\" or \"polygons\" (quads).\n");
+    printf("-influences <val>:\tJoint influences per vertex.\n");
+    printf("-joints <val>:\t\tNumber of joints, the mesh is skinned if this and influences are non-zero.\n");
+    printf("-clipLength <val>:\tLength of the joint animations in seconds.\n");
+    printf("-keysPerSecond <val>:\tDensity of the animation keys.\n");
+}
+
+static bool ParseArgs(int inArgc, char* inArgv[])
+{
+    if ((inArgc < 2) || ((inArgc % 2) != 0))
+    {
+        DisplayUsage();
+        return false;
+    }
+
+    sWorkDirectory = inArgv[inArgc - 1];
+
+    int numExtraArgs = inArgc - 2;
+
+    for (int i = 0; i < numExtraArgs; i += 2)
+    {
+        int argIndex = i + 1;
+
+        if (strstr(inArgv[argIndex], "-output"))
+        {
+            sOutputFile = inArgv[argIndex + 1];
+        }
+        else if (strstr(inArgv[argIndex], "-runs"))
+        {
+            sscanf(inArgv[argIndex + 1], "%d", &sNumRuns);
+        }
+        else if (strstr(inArgv[argIndex], "-verbose"))
+        {
+            int verbose = 0;
+            sscanf(inArgv[argIndex + 1], "%d", &verbose);
+
+            sVerbose = (verbose != 0);
+        }
+        else if (strstr(inArgv[argIndex], "-math"))
+        {
+            int math = 0;
+            sscanf(inArgv[argIndex + 1], "%d", &math);
+
+            sMathRequested = (math != 0);
+        }
+        else if (strstr(inArgv[argIndex], "-triangles"))
+        {
+            sscanf(inArgv[argIndex + 1], "%d", &sCustomScene.mNumTriangles);
+            sCustomSceneRequested = true;
+        }
+        else if (strstr(inArgv[argIndex], "-primitives"))
+        {
+            sCustomScene.mPrimitives = (strcmp(inArgv[argIndex + 1], "polygons") == 0) ? SCENE_PRIMITIVES_POLYGONS : SCENE_PRIMITIVES_TRIANGLES;
+            sCustomSceneRequested = true;
+        }
+        else if (strstr(inArgv[argIndex], "-influences"))
+        {
+            sscanf(inArgv[argIndex + 1], "%d", &sCustomScene.mNumInfluences);
+            sCustomSceneRequested = true;
+        }
+        else if (strstr(inArgv[argIndex], "-joints"))
+        {
+            sscanf(inArgv[argIndex + 1], "%d", &sCustomScene.mNumJoints);
+            sCustomSceneRequested = true;
+        }
+        else if (strstr(inArgv[argIndex], "-clipLength"))
+        {
+            sscanf(inArgv[argIndex + 1], "%f", &sCustomScene.mClipLength);
+            sCustomSceneRequested = true;
+        }
+        else if (strstr(inArgv[argIndex], "-keysPerSecond"))
+        {
+            sscanf(inArgv[argIndex + 1], "%f", &sCustomScene.mKeysPerSecond);
+            sCustomSceneRequested = true;
+        }
+    }
+
+    if ((sNumRuns < 1) || (sCustomScene.mNumTriangles < 1))
+    {
+        DisplayUsage();
+        return false;
+    }
+
+    return true;
+}
+
+int main (int argc, char* argv[])
+{
+    if (!ParseArgs(argc, argv))
+    {
+        return 1;
+    }
+
+    mkdir(sWorkDirectory, 0755);
+
+    FILE* output = stdout;
+
+    if (sOutputFile != NULL)
+    {
+        output = fopen(sOutputFile, "w");
+
+        if (output == NULL)
+        {
+            printf("Couldn't open %s for writing.\n", sOutputFile);
+            return 1;
+        }
+    }
+
+    fprintf(output, "{\n    \"exporterVersion\": \"%d.%d\",\n", NEON21_MODELEXPORTER_MAJOR_VERSION, NEON21_MODELEXPORTER_MINOR_VERSION);
+
+    if (sMathRequested)
+    {
+        fprintf(output, "    \"math\": {\n        ");
+        bool success = RunMathBenchmark(output);
+        fprintf(output, "\n    }\n}\n");
+
+        if (output != stdout)
+        {
+            fclose(output);
+        }
+
+        return success ? 0 : 1;
+    }
+
+    fprintf(output, "    \"scenes\": [");
+    fflush(output);
+
+    if (sCustomSceneRequested)
+    {
+        RunScene(&sCustomScene, output, true);
+    }
+    else
+    {
+        int numScenes = sizeof(sDefaultScenes) / sizeof(SceneParameters);
+
+        for (int curScene = 0; curScene < numScenes; curScene++)
+        {
+            RunScene(&sDefaultScenes[curScene], output, (curScene == 0));
+            fflush(output);
+        }
+    }
+
+    fprintf(output, "\n    ]\n}\n");
+
+    if (output != stdout)
+    {
+        fclose(output);
+    }
+
+    return 0;
+}
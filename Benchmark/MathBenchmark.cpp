@@ -0,0 +1,385 @@
+//
+//  MathBenchmark.cpp
+//  Neon21ModelExporterBenchmark
+//
+//  Copyright (c) 2012 Neon Games LLC. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+
+#include "NeonMath.h"
+#include "FCollada.h"
+#include "MathBenchmark.h"
+
+#define MATH_BENCHMARK_MATRICES         (4096)
+#define MATH_BENCHMARK_POINTS           (65536)
+#define MATH_BENCHMARK_POINT_STRIDE     (8)         // Position, normal and texture coordinates, as in an interleaved stream
+#define MATH_BENCHMARK_ITERATIONS       (64)
+#define MATH_BENCHMARK_RESULT_FLOATS    (MATH_BENCHMARK_POINTS * MATH_BENCHMARK_POINT_STRIDE)
+#define MATH_BENCHMARK_FMMATRICES       (16384)     // A million calls over the iterations
+
+typedef struct
+{
+    Matrix44    mAffine[MATH_BENCHMARK_MATRICES];
+    Matrix44    mProjective[MATH_BENCHMARK_MATRICES];
+    Vector3     mVectors[MATH_BENCHMARK_MATRICES];
+    float       mPoints[MATH_BENCHMARK_RESULT_FLOATS];
+
+    // The same for the FCollada math, which the readers use on every transform and skin.
+    FMMatrix44  mFMMatrices[MATH_BENCHMARK_FMMATRICES];
+    FMVector3   mFMPoints[MATH_BENCHMARK_POINTS];
+} MathData;
+
+// Runs one kernel over the whole data set, either the version NeonMath uses or its portable one, and returns the
+// number of calls made.
+typedef int (*MathKernel)(MathData* inData, bool inScalar, float* outResults);
+
+typedef struct
+{
+    const char* mName;
+    MathKernel  mKernel;
+    float       mTolerance;     // Largest difference allowed with the portable version, relative to values above 1.  The
+                                // inverses are computed differently, so they only agree up to the rounding of each.
+    int         mComponents;    // Floats compared out of every four, FMVector3 results carry a padding float.
+} MathKernelEntry;
+
+static double GetTime()
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+
+    return (double)now.tv_sec + ((double)now.tv_usec / 1000000.0);
+}
+
+static float RandomFloat(float inLower, float inUpper)
+{
+    return inLower + ((inUpper - inLower) * ((float)rand() / (float)RAND_MAX));
+}
+
+// Rotations are kept within 45 degrees so that the Gauss-Jordan inverse, which doesn't pivot, stays accurate enough
+// to compare against.
+static void RandomAffineMatrix(Matrix44* outMatrix)
+{
+    Matrix44 rotation, scale, translation;
+
+    GenerateRotationMatrix(RandomFloat(-45.0f, 45.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(0.1f, 1.0f), &rotation);
+    GenerateScaleMatrix(RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f), &scale);
+    GenerateTranslationMatrix(RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f), &translation);
+
+    MatrixMultiplyScalar(&rotation, &scale, outMatrix);
+    MatrixMultiplyScalar(&translation, outMatrix, outMatrix);
+}
+
+static void GenerateData(MathData* outData)
+{
+    srand(1);
+
+    for (int curMatrix = 0; curMatrix < MATH_BENCHMARK_MATRICES; curMatrix++)
+    {
+        RandomAffineMatrix(&outData->mAffine[curMatrix]);
+        RandomAffineMatrix(&outData->mProjective[curMatrix]);
+
+        outData->mProjective[curMatrix].mMatrix[3] = RandomFloat(-0.1f, 0.1f);
+        outData->mProjective[curMatrix].mMatrix[7] = RandomFloat(-0.1f, 0.1f);
+        outData->mProjective[curMatrix].mMatrix[11] = RandomFloat(-0.1f, 0.1f);
+
+        Set(&outData->mVectors[curMatrix], RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f));
+    }
+
+    for (int curFloat = 0; curFloat < MATH_BENCHMARK_RESULT_FLOATS; curFloat++)
+    {
+        outData->mPoints[curFloat] = RandomFloat(-100.0f, 100.0f);
+    }
+
+    for (int curMatrix = 0; curMatrix < MATH_BENCHMARK_FMMATRICES; curMatrix++)
+    {
+        Matrix44 matrix;
+        RandomAffineMatrix(&matrix);
+
+        outData->mFMMatrices[curMatrix] = FMMatrix44(matrix.mMatrix);
+    }
+
+    for (int curPoint = 0; curPoint < MATH_BENCHMARK_POINTS; curPoint++)
+    {
+        outData->mFMPoints[curPoint] = FMVector3(RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f));
+    }
+}
+
+static int MatrixMultiplyKernel(MathData* inData, bool inScalar, float* outResults)
+{
+    Matrix44* results = (Matrix44*)outResults;
+
+    for (int curMatrix = 0; curMatrix < MATH_BENCHMARK_MATRICES; curMatrix++)
+    {
+        if (inScalar)
+        {
+            MatrixMultiplyScalar(&inData->mAffine[curMatrix], &inData->mProjective[curMatrix], &results[curMatrix]);
+        }
+        else
+        {
+            MatrixMultiply(&inData->mAffine[curMatrix], &inData->mProjective[curMatrix], &results[curMatrix]);
+        }
+    }
+
+    return MATH_BENCHMARK_MATRICES;
+}
+
+static int MatrixMultiplyNKernel(MathData* inData, bool inScalar, float* outResults)
+{
+    Matrix44* results = (Matrix44*)outResults;
+
+    if (inScalar)
+    {
+        for (int curMatrix = 0; curMatrix < MATH_BENCHMARK_MATRICES; curMatrix++)
+        {
+            MatrixMultiplyScalar(&inData->mAffine[curMatrix], &inData->mProjective[curMatrix], &results[curMatrix]);
+        }
+    }
+    else
+    {
+        MatrixMultiplyN(inData->mAffine, inData->mProjective, results, MATH_BENCHMARK_MATRICES);
+    }
+
+    return 1;
+}
+
+static int TransformVector4x3Kernel(MathData* inData, bool inScalar, float* outResults)
+{
+    Vector4* results = (Vector4*)outResults;
+
+    for (int curVector = 0; curVector < MATH_BENCHMARK_MATRICES; curVector++)
+    {
+        if (inScalar)
+        {
+            TransformVector4x3Scalar(&inData->mProjective[curVector], &inData->mVectors[curVector], &results[curVector]);
+        }
+        else
+        {
+            TransformVector4x3(&inData->mProjective[curVector], &inData->mVectors[curVector], &results[curVector]);
+        }
+    }
+
+    return MATH_BENCHMARK_MATRICES;
+}
+
+static int TransformPointsKernel(MathData* inData, bool inScalar, float* outResults)
+{
+    if (inScalar)
+    {
+        TransformPointsScalar(&inData->mAffine[0], inData->mPoints, outResults, MATH_BENCHMARK_POINTS, MATH_BENCHMARK_POINT_STRIDE);
+    }
+    else
+    {
+        TransformPoints(&inData->mAffine[0], inData->mPoints, outResults, MATH_BENCHMARK_POINTS, MATH_BENCHMARK_POINT_STRIDE);
+    }
+
+    return 1;
+}
+
+static int InverseKernel(MathData* inData, bool inScalar, float* outResults)
+{
+    Matrix44* results = (Matrix44*)outResults;
+
+    for (int curMatrix = 0; curMatrix < MATH_BENCHMARK_MATRICES; curMatrix++)
+    {
+        if (inScalar)
+        {
+            InverseGaussJordan(&inData->mProjective[curMatrix], &results[curMatrix]);
+        }
+        else
+        {
+            Inverse(&inData->mProjective[curMatrix], &results[curMatrix]);
+        }
+    }
+
+    return MATH_BENCHMARK_MATRICES;
+}
+
+static int InverseAffineKernel(MathData* inData, bool inScalar, float* outResults)
+{
+    Matrix44* results = (Matrix44*)outResults;
+
+    for (int curMatrix = 0; curMatrix < MATH_BENCHMARK_MATRICES; curMatrix++)
+    {
+        if (inScalar)
+        {
+            InverseGaussJordan(&inData->mAffine[curMatrix], &results[curMatrix]);
+        }
+        else
+        {
+            InverseAffine(&inData->mAffine[curMatrix], &results[curMatrix]);
+        }
+    }
+
+    return MATH_BENCHMARK_MATRICES;
+}
+
+// The FCollada kernels compare the SSE versions in FMMatrix44 with the FMath::Scalar ones they replaced.
+static int FMMatrixMultiplyKernel(MathData* inData, bool inScalar, float* outResults)
+{
+    FMMatrix44* results = (FMMatrix44*)outResults;
+    const FMMatrix44* matrices = inData->mFMMatrices;
+
+    for (int curMatrix = 0; curMatrix < MATH_BENCHMARK_FMMATRICES; curMatrix++)
+    {
+        const FMMatrix44& left = matrices[curMatrix];
+        const FMMatrix44& right = matrices[MATH_BENCHMARK_FMMATRICES - 1 - curMatrix];
+
+        results[curMatrix] = inScalar ? FMath::ScalarMultiply(left, right) : (left * right);
+    }
+
+    return MATH_BENCHMARK_FMMATRICES;
+}
+
+static int FMMatrixInvertedKernel(MathData* inData, bool inScalar, float* outResults)
+{
+    FMMatrix44* results = (FMMatrix44*)outResults;
+
+    for (int curMatrix = 0; curMatrix < MATH_BENCHMARK_FMMATRICES; curMatrix++)
+    {
+        const FMMatrix44& matrix = inData->mFMMatrices[curMatrix];
+
+        results[curMatrix] = inScalar ? FMath::ScalarInverse(matrix) : matrix.Inverted();
+    }
+
+    return MATH_BENCHMARK_FMMATRICES;
+}
+
+static int FMMatrixDeterminantKernel(MathData* inData, bool inScalar, float* outResults)
+{
+    for (int curMatrix = 0; curMatrix < MATH_BENCHMARK_FMMATRICES; curMatrix++)
+    {
+        const FMMatrix44& matrix = inData->mFMMatrices[curMatrix];
+
+        outResults[curMatrix] = inScalar ? FMath::ScalarDeterminant(matrix) : matrix.Determinant();
+    }
+
+    return MATH_BENCHMARK_FMMATRICES;
+}
+
+static int FMTransformCoordinatesKernel(MathData* inData, bool inScalar, float* outResults)
+{
+    FMVector3* results = (FMVector3*)outResults;
+    const FMMatrix44& matrix = inData->mFMMatrices[0];
+
+    if (inScalar)
+    {
+        for (int curPoint = 0; curPoint < MATH_BENCHMARK_POINTS; curPoint++)
+        {
+            FMVector4 result = FMath::ScalarTransform(matrix, FMVector4(inData->mFMPoints[curPoint], 1.0f));
+
+            results[curPoint].x = result.x;
+            results[curPoint].y = result.y;
+            results[curPoint].z = result.z;
+        }
+    }
+    else
+    {
+        matrix.TransformCoordinates(inData->mFMPoints, results, MATH_BENCHMARK_POINTS);
+    }
+
+    return 1;
+}
+
+static MathKernelEntry sKernels[] = {   { "MatrixMultiply",                   MatrixMultiplyKernel,           1e-5f, 4 },
+                                        { "MatrixMultiplyN",                  MatrixMultiplyNKernel,          1e-5f, 4 },
+                                        { "TransformVector4x3",               TransformVector4x3Kernel,       1e-5f, 4 },
+                                        { "TransformPoints",                  TransformPointsKernel,          1e-5f, 4 },
+                                        { "Inverse",                          InverseKernel,                  1e-3f, 4 },
+                                        { "InverseAffine",                    InverseAffineKernel,            1e-3f, 4 },
+                                        { "FMMatrix44::operator*",            FMMatrixMultiplyKernel,         1e-5f, 4 },
+                                        { "FMMatrix44::Inverted",             FMMatrixInvertedKernel,         1e-3f, 4 },
+                                        { "FMMatrix44::Determinant",          FMMatrixDeterminantKernel,      1e-3f, 4 },
+                                        { "FMMatrix44::TransformCoordinates", FMTransformCoordinatesKernel,   1e-5f, 3 } };
+
+static float CompareResults(float* inResults, float* inReference, int inComponents)
+{
+    float maxError = 0.0f;
+
+    for (int curFloat = 0; curFloat < MATH_BENCHMARK_RESULT_FLOATS; curFloat++)
+    {
+        if ((curFloat % 4) >= inComponents)
+        {
+            continue;
+        }
+
+        float error = fabsf(inResults[curFloat] - inReference[curFloat]) / NeonMax(1.0f, fabsf(inReference[curFloat]));
+
+        // Also catches NaNs, which compare false to everything.
+        if (!(error <= maxError))
+        {
+            maxError = isnan(error) ? INFINITY : error;
+        }
+    }
+
+    return maxError;
+}
+
+static double TimeKernel(MathKernel inKernel, MathData* inData, bool inScalar, float* outResults)
+{
+    double startTime = GetTime();
+
+    for (int curIteration = 0; curIteration < MATH_BENCHMARK_ITERATIONS; curIteration++)
+    {
+        inKernel(inData, inScalar, outResults);
+    }
+
+    return GetTime() - startTime;
+}
+
+bool RunMathBenchmark(FILE* inOutput)
+{
+    MathData* data = new MathData;
+    float* results = (float*)malloc(sizeof(float) * MATH_BENCHMARK_RESULT_FLOATS);
+    float* reference = (float*)malloc(sizeof(float) * MATH_BENCHMARK_RESULT_FLOATS);
+
+    GenerateData(data);
+
+#if defined(NEON_MATH_SIMD_SSE)
+    const char* simd = "sse";
+#elif defined(NEON_MATH_SIMD_NEON)
+    const char* simd = "neon";
+#else
+    const char* simd = "none";
+#endif
+
+    fprintf(inOutput, "\"simd\": \"%s\",\n        \"kernels\": [", simd);
+
+    bool success = true;
+    int numKernels = sizeof(sKernels) / sizeof(MathKernelEntry);
+
+    for (int curKernel = 0; curKernel < numKernels; curKernel++)
+    {
+        MathKernelEntry* entry = &sKernels[curKernel];
+
+        // The strided kernels leave the floats between the points alone.
+        memset(results, 0, sizeof(float) * MATH_BENCHMARK_RESULT_FLOATS);
+        memset(reference, 0, sizeof(float) * MATH_BENCHMARK_RESULT_FLOATS);
+
+        int numCalls = entry->mKernel(data, true, reference);
+        entry->mKernel(data, false, results);
+
+        float maxError = CompareResults(results, reference, entry->mComponents);
+        bool kernelSuccess = (maxError <= entry->mTolerance);
+
+        double scalarSeconds = TimeKernel(entry->mKernel, data, true, reference);
+        double seconds = TimeKernel(entry->mKernel, data, false, results);
+
+        fprintf(inOutput, "%s\n            { \"name\": \"%s\", \"calls\": %d, \"seconds\": %.6f, \"scalarSeconds\": %.6f, \"maxError\": %g, \"status\": \"%s\" }",
+                            (curKernel == 0) ? "" : ",", entry->mName, numCalls * MATH_BENCHMARK_ITERATIONS, seconds, scalarSeconds,
+                            maxError, kernelSuccess ? "ok" : "mismatch");
+
+        success = success && kernelSuccess;
+    }
+
+    fprintf(inOutput, "\n        ]");
+
+    delete data;
+    free(results);
+    free(reference);
+
+    return success;
+}
@@ -0,0 +1,14 @@
+//
+//  MathBenchmark.h
+//  Neon21ModelExporterBenchmark
+//
+//  Copyright (c) 2012 Neon Games LLC. All rights reserved.
+//
+
+#pragma once
+
+#include <stdio.h>
+
+// Checks the NeonMath and FCollada matrix kernels against their portable versions on random input and times both.  The results are
+// written to inOutput as the members of a JSON object.  Returns false if any kernel disagreed with its portable version.
+bool RunMathBenchmark(FILE* inOutput);
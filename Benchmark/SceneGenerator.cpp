@@ -0,0 +1,296 @@
+//
+//  SceneGenerator.cpp
+//  Neon21ModelExporterBenchmark
+//
+//  Copyright (c) 2012 Neon Games LLC. All rights reserved.
+//
+
+#include <stdio.h>
+#include <math.h>
+
+#define NO_LIBXML
+#include "FCollada.h"
+#include "FCDocument/FCDocument.h"
+#include "FCDocument/FCDAsset.h"
+#include "FCDocument/FCDLibrary.h"
+#include "FCDocument/FCDSceneNode.h"
+#include "FCDocument/FCDTransform.h"
+
+#include "FCDocument/FCDGeometry.h"
+#include "FCDocument/FCDGeometryMesh.h"
+#include "FCDocument/FCDGeometrySource.h"
+#include "FCDocument/FCDGeometryPolygons.h"
+#include "FCDocument/FCDGeometryPolygonsInput.h"
+
+#include "FCDocument/FCDController.h"
+#include "FCDocument/FCDControllerInstance.h"
+#include "FCDocument/FCDSkinController.h"
+
+#include "FCDocument/FCDAnimated.h"
+#include "FCDocument/FCDAnimation.h"
+#include "FCDocument/FCDAnimationChannel.h"
+#include "FCDocument/FCDAnimationCurve.h"
+#include "FCDocument/FCDAnimationKey.h"
+#include "FCDocument/FCDExtra.h"
+
+#include "SceneGenerator.h"
+
+#define JOINT_NAME_LENGTH   (32)
+
+// In the order of the axes.  The joints hold them in the Z, Y, X order that the exporter expects.
+static const char* ROTATION_NAMES[3] = { "rotateX", "rotateY", "rotateZ" };
+
+// Builds a grid of quads in the XZ plane, one unit per cell, with as few columns as possible past a square.
+static FCDGeometry* GenerateMesh(FCDocument* inDocument, const SceneParameters* inParameters, int* outNumRows)
+{
+    int numQuads = (inParameters->mNumTriangles + 1) / 2;
+    int numColumns = (int)ceil(sqrt((double)numQuads));
+    int numRows = (numQuads + numColumns - 1) / numColumns;
+    int numVertices = (numColumns + 1) * (numRows + 1);
+
+    FCDGeometry* geometry = inDocument->GetGeometryLibrary()->AddEntity();
+    geometry->SetDaeId("SyntheticMesh");
+    geometry->SetName(FC("SyntheticMesh"));
+
+    FCDGeometryMesh* mesh = geometry->CreateMesh();
+
+    FloatList positions(numVertices * 3, 0.0f);
+    FloatList normals(numVertices * 3, 0.0f);
+    FloatList texcoords(numVertices * 2, 0.0f);
+
+    for (int row = 0; row <= numRows; row++)
+    {
+        for (int column = 0; column <= numColumns; column++)
+        {
+            int vertex = (row * (numColumns + 1)) + column;
+
+            positions[(vertex * 3) + 0] = (float)column;
+            positions[(vertex * 3) + 2] = (float)row;
+            normals[(vertex * 3) + 1] = -1.0f;
+            texcoords[(vertex * 2) + 0] = (float)column / (float)numColumns;
+            texcoords[(vertex * 2) + 1] = (float)row / (float)numRows;
+        }
+    }
+
+    mesh->AddVertexSource(FUDaeGeometryInput::POSITION)->SetData(positions, 3);
+    mesh->AddVertexSource(FUDaeGeometryInput::NORMAL)->SetData(normals, 3);
+    mesh->AddVertexSource(FUDaeGeometryInput::TEXCOORD)->SetData(texcoords, 2);
+
+    // All the sources are per-vertex, so they share the indices of the position input.
+    FCDGeometryPolygons* polygons = mesh->AddPolygons();
+    polygons->SetMaterialSemantic(FC("SyntheticMaterial"));
+
+    bool isTriangles = (inParameters->mPrimitives == SCENE_PRIMITIVES_TRIANGLES);
+    UInt32List indices;
+    indices.reserve(isTriangles ? (inParameters->mNumTriangles * 3) : (numQuads * 4));
+
+    int numTriangles = 0;
+
+    for (int quad = 0; quad < numQuads; quad++)
+    {
+        uint32 corner = ((quad / numColumns) * (numColumns + 1)) + (quad % numColumns);
+        uint32 quadIndices[4] = { corner, corner + 1, corner + numColumns + 2, corner + numColumns + 1 };
+
+        if (isTriangles)
+        {
+            indices.push_back(quadIndices[0]); indices.push_back(quadIndices[1]); indices.push_back(quadIndices[2]);
+            polygons->AddFaceVertexCount(3);
+
+            if (++numTriangles < inParameters->mNumTriangles)
+            {
+                indices.push_back(quadIndices[0]); indices.push_back(quadIndices[2]); indices.push_back(quadIndices[3]);
+                polygons->AddFaceVertexCount(3);
+                numTriangles++;
+            }
+        }
+        else
+        {
+            indices.insert(indices.end(), quadIndices, quadIndices + 4);
+            polygons->AddFaceVertexCount(4);
+        }
+    }
+
+    polygons->FindInput(FUDaeGeometryInput::POSITION)->SetIndices(indices.begin(), indices.size());
+    mesh->Recalculate();
+
+    *outNumRows = numRows;
+
+    return geometry;
+}
+
+// Builds a chain of joints going up the grid, each with a translation and three rotations like the DCC exports.
+static void GenerateSkeleton(FCDSceneNode* inRoot, const SceneParameters* inParameters, int inNumRows, FCDSceneNode** outJoints)
+{
+    float jointLength = (float)inNumRows / (float)inParameters->mNumJoints;
+    FCDSceneNode* parent = inRoot;
+
+    for (int curJoint = 0; curJoint < inParameters->mNumJoints; curJoint++)
+    {
+        char jointName[JOINT_NAME_LENGTH];
+        snprintf(jointName, JOINT_NAME_LENGTH, "Joint%d", curJoint);
+
+        FCDSceneNode* joint = parent->AddChildNode();
+        joint->SetDaeId(jointName);
+        joint->SetSubId(jointName);
+        joint->SetName(TO_FSTRING(jointName));
+        joint->SetJointFlag(true);
+
+        FCDTTranslation* translation = (FCDTTranslation*)joint->AddTransform(FCDTransform::TRANSLATION);
+        translation->SetSubId("translate");
+        translation->SetTranslation(0.0f, 0.0f, (curJoint == 0) ? 0.0f : jointLength);
+
+        for (int axis = 2; axis >= 0; axis--)
+        {
+            FCDTRotation* rotation = (FCDTRotation*)joint->AddTransform(FCDTransform::ROTATION);
+            rotation->SetSubId(ROTATION_NAMES[axis]);
+            rotation->SetAxis((axis == 0) ? 1.0f : 0.0f, (axis == 1) ? 1.0f : 0.0f, (axis == 2) ? 1.0f : 0.0f);
+        }
+
+        outJoints[curJoint] = joint;
+        parent = joint;
+    }
+}
+
+// Skins each row of the grid to the joints nearest to it, with weights falling off along the chain.
+static FCDController* GenerateSkin(FCDocument* inDocument, FCDGeometry* inGeometry, const SceneParameters* inParameters, int inNumRows, FCDSceneNode** inJoints)
+{
+    FCDController* controller = inDocument->GetControllerLibrary()->AddEntity();
+    controller->SetDaeId("SyntheticSkin");
+    controller->SetName(FC("SyntheticSkin"));
+
+    FCDSkinController* skin = controller->CreateSkinController();
+    float jointLength = (float)inNumRows / (float)inParameters->mNumJoints;
+
+    for (int curJoint = 0; curJoint < inParameters->mNumJoints; curJoint++)
+    {
+        FMMatrix44 bindPose = FMMatrix44::TranslationMatrix(FMVector3(0.0f, 0.0f, jointLength * (float)curJoint));
+        skin->AddJoint(inJoints[curJoint]->GetSubId(), bindPose.Inverted());
+    }
+
+    skin->SetTarget(inGeometry);
+
+    int numInfluences = (inParameters->mNumInfluences < inParameters->mNumJoints) ? inParameters->mNumInfluences : inParameters->mNumJoints;
+    int numVertices = (int)skin->GetInfluenceCount();
+    int numColumns = (numVertices / (inNumRows + 1)) - 1;
+
+    for (int vertex = 0; vertex < numVertices; vertex++)
+    {
+        int row = vertex / (numColumns + 1);
+        int firstJoint = (int)((float)row / jointLength);
+
+        if (firstJoint > (inParameters->mNumJoints - numInfluences))
+        {
+            firstJoint = inParameters->mNumJoints - numInfluences;
+        }
+
+        FCDSkinControllerVertex* influence = skin->GetVertexInfluence(vertex);
+        influence->SetPairCount(0);
+
+        float totalWeight = (float)(numInfluences * (numInfluences + 1)) / 2.0f;
+
+        for (int curInfluence = 0; curInfluence < numInfluences; curInfluence++)
+        {
+            influence->AddPair(firstJoint + curInfluence, (float)(numInfluences - curInfluence) / totalWeight);
+        }
+    }
+
+    return controller;
+}
+
+// Animates the rotations of each joint with bezier keys.  Each animation gets the animation target extra that
+// the exporter reads, which the COLLADA import no longer generates.
+static void GenerateAnimations(FCDocument* inDocument, const SceneParameters* inParameters, FCDSceneNode** inJoints)
+{
+    int numKeys = (int)(inParameters->mClipLength * inParameters->mKeysPerSecond) + 1;
+
+    if (numKeys < 2)
+    {
+        numKeys = 2;
+    }
+
+    float keySpacing = inParameters->mClipLength / (float)(numKeys - 1);
+
+    for (int curJoint = 0; curJoint < inParameters->mNumJoints; curJoint++)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            // The translation comes first, followed by the rotations from Z to X.
+            FCDTRotation* rotation = (FCDTRotation*)inJoints[curJoint]->GetTransform(3 - axis);
+
+            FCDAnimation* animation = inDocument->GetAnimationLibrary()->AddEntity();
+            fm::string animationName = inJoints[curJoint]->GetDaeId() + "-" + ROTATION_NAMES[axis];
+            animation->SetDaeId(animationName);
+            animation->SetName(TO_FSTRING(animationName));
+
+            FCDETechnique* targetTechnique = animation->GetExtra()->AddType("AnimTargets")->AddTechnique("TEMP");
+            targetTechnique->AddChildNode("pointer")->SetContent(TO_FSTRING(inJoints[curJoint]->GetDaeId() + "/" + ROTATION_NAMES[axis]));
+            targetTechnique->AddChildNode("pointer")->SetContent(FC(".ANGLE"));
+
+            FCDAnimationCurve* curve = animation->AddChannel()->AddCurve();
+            curve->ReserveKeys(numKeys, FUDaeInterpolation::BEZIER);
+
+            for (int curKey = 0; curKey < numKeys; curKey++)
+            {
+                FCDAnimationKeyBezier* key = (FCDAnimationKeyBezier*)curve->AddKey(FUDaeInterpolation::BEZIER);
+
+                key->input = keySpacing * (float)curKey;
+                key->output = 30.0f * sinf((key->input * 2.0f) + (float)(curJoint + axis));
+                key->inTangent = FMVector2(key->input - (keySpacing / 3.0f), key->output);
+                key->outTangent = FMVector2(key->input + (keySpacing / 3.0f), key->output);
+            }
+
+            rotation->GetAngleAxis().GetAnimated()->AddCurve(3, curve);
+        }
+    }
+}
+
+bool GenerateScene(const SceneParameters* inParameters, const char* inFilename)
+{
+    FUObjectRef<FCDocument> document = FCollada::NewTopDocument();
+
+    // The exporter checks the DCC export settings in the contributor comments.  Only the triangle scenes are
+    // exported as triangles, the polygon scenes are split by the exporter.
+    if (inParameters->mPrimitives == SCENE_PRIMITIVES_TRIANGLES)
+    {
+        FCDAssetContributor* contributor = document->GetAsset()->AddContributor();
+        contributor->SetComments(FC("exportTriangles=1"));
+    }
+
+    int numRows = 0;
+    FCDGeometry* geometry = GenerateMesh(document, inParameters, &numRows);
+
+    FCDSceneNode* visualScene = document->AddVisualScene();
+    visualScene->SetDaeId("SyntheticScene");
+
+    bool isSkinned = (inParameters->mNumJoints > 0) && (inParameters->mNumInfluences > 0);
+
+    if (!isSkinned)
+    {
+        visualScene->AddChildNode()->AddInstance(geometry);
+    }
+    else
+    {
+        FCDSceneNode** joints = new FCDSceneNode*[inParameters->mNumJoints];
+
+        GenerateSkeleton(visualScene, inParameters, numRows, joints);
+        FCDController* controller = GenerateSkin(document, geometry, inParameters, numRows, joints);
+
+        FCDControllerInstance* controllerInstance = (FCDControllerInstance*)visualScene->AddChildNode()->AddInstance(controller);
+
+        for (int curJoint = 0; curJoint < inParameters->mNumJoints; curJoint++)
+        {
+            controllerInstance->AddJoint(joints[curJoint]);
+        }
+
+        controllerInstance->CalculateRootIds();
+
+        if (inParameters->mClipLength > 0.0f)
+        {
+            GenerateAnimations(document, inParameters, joints);
+        }
+
+        delete[] joints;
+    }
+
+    return FCollada::SaveDocument(document, inFilename);
+}
@@ -0,0 +1,33 @@
+//
+//  SceneGenerator.h
+//  Neon21ModelExporterBenchmark
+//
+//  Copyright (c) 2012 Neon Games LLC. All rights reserved.
+//
+
+#pragma once
+
+typedef enum
+{
+    SCENE_PRIMITIVES_TRIANGLES,
+    SCENE_PRIMITIVES_POLYGONS,
+    SCENE_PRIMITIVES_MAX
+} ScenePrimitives;
+
+typedef struct
+{
+    const char*     mName;
+
+    int             mNumTriangles;          // Triangle count once exported.  Polygon scenes hold half as many quads.
+    ScenePrimitives mPrimitives;
+
+    int             mNumInfluences;         // Joint influences per vertex.  The mesh is only skinned if this and mNumJoints are non-zero.
+    int             mNumJoints;
+
+    float           mClipLength;            // Length of the joint animations, in seconds.  0 for no animations.
+    float           mKeysPerSecond;
+} SceneParameters;
+
+// Writes a COLLADA document with a grid mesh, optionally skinned to a chain of joints whose rotations are animated,
+// through the FCollada writer.  FCollada must be initialized.  Returns false if the document couldn't be saved.
+bool GenerateScene(const SceneParameters* inParameters, const char* inFilename);
@@ -93,6 +93,117 @@ static void ComputeTCBTangent(const FCDAnimationKey* previousKey, const FCDAnima
 	rightTangent.y = k3 * pCurrentMinusPrevious.y + k4 * pNextMinusCurrent.y;
 }
 
+//
+// FCDAnimationKeyStorage
+//
+
+// A list of blocks of consecutive keys of one type.
+// The keys never move once allocated, since the curve hands out pointers to them.
+// Deleted keys are recycled for the next allocations.
+template <class KeyType>
+class FCDAnimationKeyBlockList
+{
+private:
+	fm::pvector<KeyType> blocks;
+	UInt32List blockSizes;
+	KeyType* next; // The next unused key of the last block.
+	KeyType* end;
+	fm::pvector<KeyType> freeKeys;
+
+public:
+	FCDAnimationKeyBlockList() : next(NULL), end(NULL) {}
+
+	~FCDAnimationKeyBlockList()
+	{
+		for (typename fm::pvector<KeyType>::iterator it = blocks.begin(); it != blocks.end(); ++it) delete[] (*it);
+	}
+
+	// Makes room for a number of keys, within one block if they do not fit in the current one.
+	void Reserve(size_t count)
+	{
+		size_t available = (size_t) (end - next) + freeKeys.size();
+		if (available < count) AddBlock(count - freeKeys.size());
+	}
+
+	KeyType* Allocate()
+	{
+		if (!freeKeys.empty())
+		{
+			KeyType* key = freeKeys.back();
+			freeKeys.pop_back();
+			return key;
+		}
+		if (next == end) AddBlock(blocks.empty() ? 16 : max((size_t) blockSizes.back() * 2, (size_t) 16));
+		return next++;
+	}
+
+	bool Release(FCDAnimationKey* key)
+	{
+		size_t blockCount = blocks.size();
+		for (size_t i = 0; i < blockCount; ++i)
+		{
+			if (key >= blocks[i] && key < blocks[i] + blockSizes[i])
+			{
+				freeKeys.push_back((KeyType*) key);
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	void AddBlock(size_t count)
+	{
+		// The rest of the current block is kept for later allocations.
+		while (next != end) freeKeys.push_back(next++);
+
+		KeyType* block = new KeyType[count];
+		blocks.push_back(block);
+		blockSizes.push_back((uint32) count);
+		next = block;
+		end = block + count;
+	}
+};
+
+// The key storage of a curve: the keys of each type are kept apart,
+// so that the linear and step keys do not take the room of the larger bezier or TCB keys.
+class FCDAnimationKeyStorage
+{
+public:
+	FCDAnimationKeyBlockList<FCDAnimationKey> simpleKeys;
+	FCDAnimationKeyBlockList<FCDAnimationKeyBezier> bezierKeys;
+	FCDAnimationKeyBlockList<FCDAnimationKeyTCB> tcbKeys;
+
+	void Reserve(FUDaeInterpolation::Interpolation interpolation, size_t count)
+	{
+		switch (interpolation)
+		{
+		case FUDaeInterpolation::BEZIER: bezierKeys.Reserve(count); break;
+		case FUDaeInterpolation::TCB: tcbKeys.Reserve(count); break;
+		default: simpleKeys.Reserve(count); break;
+		}
+	}
+
+	FCDAnimationKey* Allocate(FUDaeInterpolation::Interpolation interpolation)
+	{
+		FCDAnimationKey* key;
+		switch (interpolation)
+		{
+		case FUDaeInterpolation::BEZIER: key = bezierKeys.Allocate(); break;
+		case FUDaeInterpolation::TCB: key = tcbKeys.Allocate(); break;
+		default: key = simpleKeys.Allocate(); break;
+		}
+		key->interpolation = (uint32) interpolation;
+		return key;
+	}
+
+	void Release(FCDAnimationKey* key)
+	{
+		// The interpolation of a key may have been modified: look for its block instead.
+		if (!simpleKeys.Release(key) && !bezierKeys.Release(key)) tcbKeys.Release(key);
+	}
+};
+
 //
 // FCDAnimationCurve
 //
@@ -105,13 +216,15 @@ FCDAnimationCurve::FCDAnimationCurve(FCDocument* document, FCDAnimationChannel*
 	preInfinity(FUDaeInfinity::CONSTANT), postInfinity(FUDaeInfinity::CONSTANT),
 	inputDriver(NULL), inputDriverIndex(0)
 {
+	keyStorage = new FCDAnimationKeyStorage();
 	currentClip = NULL;
 	currentOffset = 0;
 }
 
 FCDAnimationCurve::~FCDAnimationCurve()
 {
-	CLEAR_POINTER_VECTOR(keys);
+	keys.clear();
+	SAFE_DELETE(keyStorage);
 
 	inputDriver = NULL;
 	parent = NULL;
@@ -124,29 +237,34 @@ void FCDAnimationCurve::SetKeyCount(size_t count, FUDaeInterpolation::Interpolat
 	size_t oldCount = GetKeyCount();
 	if (oldCount < count)
 	{
-		keys.reserve(count);
+		ReserveKeys(count - oldCount, interpolation);
 		for (; oldCount < count; ++oldCount) AddKey(interpolation);
 	}
 	else if (count < oldCount)
 	{
-		for (FCDAnimationKeyList::iterator it = keys.begin() + count; it != keys.end(); ++it) delete (*it);
+		for (FCDAnimationKeyList::iterator it = keys.begin() + count; it != keys.end(); ++it) keyStorage->Release(*it);
 		keys.resize(count);
 	}
 	SetDirtyFlag();
 }
 
+void FCDAnimationCurve::ReserveKeys(size_t count, FUDaeInterpolation::Interpolation interpolation)
+{
+	keys.reserve(keys.size() + count);
+	keyStorage->Reserve(interpolation, count);
+}
+
 FCDAnimationKey* FCDAnimationCurve::AddKey(FUDaeInterpolation::Interpolation interpolation)
 {
-	FCDAnimationKey* key;
 	switch (interpolation)
 	{
-	case FUDaeInterpolation::STEP: key = new FCDAnimationKey; break;
-	case FUDaeInterpolation::LINEAR: key = new FCDAnimationKey; break;
-	case FUDaeInterpolation::BEZIER: key = new FCDAnimationKeyBezier; break;
-	case FUDaeInterpolation::TCB: key = new FCDAnimationKeyTCB; break;
-	default: FUFail(key = new FCDAnimationKey; break;);
+	case FUDaeInterpolation::STEP:
+	case FUDaeInterpolation::LINEAR:
+	case FUDaeInterpolation::BEZIER:
+	case FUDaeInterpolation::TCB: break;
+	default: FUFail(break;);
 	}
-	key->interpolation = (uint32) interpolation;
+	FCDAnimationKey* key = keyStorage->Allocate(interpolation);
 	keys.push_back(key);
 	SetDirtyFlag();
 	return key;
@@ -156,16 +274,15 @@ FCDAnimationKey* FCDAnimationCurve::AddKey(FUDaeInterpolation::Interpolation int
 // Insert a new key into the ordered array at a certain time
 FCDAnimationKey* FCDAnimationCurve::AddKey(FUDaeInterpolation::Interpolation interpolation, float input, size_t& index)
 {
-	FCDAnimationKey* key;
 	switch (interpolation)
 	{
-	case FUDaeInterpolation::STEP: key = new FCDAnimationKey; break;
-	case FUDaeInterpolation::LINEAR: key = new FCDAnimationKey; break;
-	case FUDaeInterpolation::BEZIER: key = new FCDAnimationKeyBezier; break;
-	case FUDaeInterpolation::TCB: key = new FCDAnimationKeyTCB; break;
+	case FUDaeInterpolation::STEP:
+	case FUDaeInterpolation::LINEAR:
+	case FUDaeInterpolation::BEZIER:
+	case FUDaeInterpolation::TCB: break;
 	default: FUFail(return NULL);
 	}
-	key->interpolation = (uint32) interpolation;
+	FCDAnimationKey* key = keyStorage->Allocate(interpolation);
 	key->input = input;
 	FCDAnimationKeyList::iterator insertIdx = keys.begin();
 	FCDAnimationKeyList::iterator finalIdx = keys.end();
@@ -187,7 +304,7 @@ bool FCDAnimationCurve::DeleteKey(FCDAnimationKey* key)
 	if (kitr == keys.end()) return false;
 
 	keys.erase(kitr);
-	delete key;
+	keyStorage->Release(key);
 	return true;
 }
 
@@ -224,7 +341,7 @@ FCDAnimationCurve* FCDAnimationCurve::Clone(FCDAnimationCurve* clone, bool inclu
 	clone->SetTargetQualifier(targetQualifier);
 
 	// Pre-buffer the list of keys and clone them.
-	clone->keys.clear();
+	clone->SetKeyCount(0, FUDaeInterpolation::DEFAULT);
 	clone->keys.reserve(keys.size());
 	for (FCDAnimationKeyList::const_iterator it = keys.begin(); it != keys.end(); ++it)
 	{
@@ -311,26 +428,129 @@ float FCDAnimationCurve::Evaluate(float input) const
 	if (keys.size() == 0) return 0.0f;
 	if (keys.size() == 1) return keys.front()->output;
 
-	float inputStart = keys.front()->input;
-	float inputEnd = keys.back()->input;
+	float output, outputOffset;
+	if (ApplyCurveInfinity(input, outputOffset, output)) return output;
+
+	// Find the current interval
+	FCDAnimationKeyList::const_iterator it, start = keys.begin(), terminate = keys.end();
+	while (terminate - start > 3)
+	{ 
+		// Binary search.
+		it = (const FCDAnimationKey**) ((((size_t) terminate) / 2 + ((size_t) start) / 2) & ~((sizeof(size_t)-1)));
+		if ((*it)->input > input) terminate = it;
+		else start = it;
+	}
+	// Linear search is more efficient on the last interval
+	for (it = start; it != terminate; ++it)
+	{
+		if ((*it)->input >= input) break;
+	}
+	if (it == keys.end()) --it;
+	return outputOffset + EvaluateSegment(it - keys.begin(), input);
+}
+
+float FCDAnimationCurve::Evaluate(float input, size_t& segmentHint) const
+{
+	if (keys.size() == 0) return 0.0f;
+	if (keys.size() == 1) return keys.front()->output;
+
+	float output, outputOffset;
+	if (ApplyCurveInfinity(input, outputOffset, output)) return output;
+
+	// Walk from the previous segment: consecutive inputs usually fall within
+	// the same segment or within one of the next few segments.
+	size_t keyCount = keys.size();
+	size_t index = min(segmentHint, keyCount - 1);
+	if (index > 0 && keys[index - 1]->input >= input)
+	{
+		// Going backwards: restart the search from the first key.
+		index = 0;
+	}
+	for (size_t steps = 0; index < keyCount - 1 && keys[index]->input < input; ++index, ++steps)
+	{
+		if (steps == 4)
+		{
+			// Too far away: binary search within the remaining keys.
+			size_t low = index, high = keyCount - 1;
+			while (low < high)
+			{
+				size_t middle = (low + high) / 2;
+				if (keys[middle]->input < input) low = middle + 1;
+				else high = middle;
+			}
+			index = low;
+			break;
+		}
+	}
+
+	segmentHint = index;
+	return outputOffset + EvaluateSegment(index, input);
+}
+
+void FCDAnimationCurve::Evaluate(const float* inputs, float* outputs, size_t count) const
+{
+	size_t segmentHint = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		outputs[i] = Evaluate(inputs[i], segmentHint);
+	}
+}
+
+bool FCDAnimationCurve::ApplyCurveInfinity(float& input, float& outputOffset, float& output) const
+{
+	const FCDAnimationKey* first = keys.front();
+	const FCDAnimationKey* second = keys[1];
+	const FCDAnimationKey* penultimate = keys[keys.size() - 2];
+	const FCDAnimationKey* last = keys.back();
+	return ApplyInfinity(preInfinity, postInfinity,
+		first->input, first->output, second->input, second->output,
+		penultimate->input, penultimate->output, last->input, last->output,
+		input, outputOffset, output);
+}
+
+// Evaluates the segment that ends with the key at the given index.
+float FCDAnimationCurve::EvaluateSegment(size_t index, float input) const
+{
+	if (index == 0) return keys.front()->output;
+
+	// Get the keys for this interval and resolve its control points.
+	const FCDAnimationKey* previousKey = (index > 1) ? keys[index - 2] : NULL;
+	const FCDAnimationKey* startKey = keys[index - 1];
+	const FCDAnimationKey* endKey = keys[index];
+	const FCDAnimationKey* nextKey = (index + 1 < keys.size()) ? keys[index + 1] : NULL;
+
+	FMVector2 startControl, endControl;
+	uint32 mode = ResolveSegment(previousKey, startKey, endKey, nextKey, startControl, endControl);
+	return InterpolateSegment(mode, startKey->input, startKey->output, startControl, endControl, endKey->input, endKey->output, input, keys.front()->input);
+}
+
+// Applies the pre-infinity and post-infinity behaviors to an input value.
+// Returns true when the behavior fully determines the output value.
+bool FCDAnimationCurve::ApplyInfinity(FUDaeInfinity::Infinity preInfinity, FUDaeInfinity::Infinity postInfinity,
+		float firstInput, float firstOutput, float secondInput, float secondOutput,
+		float penultimateInput, float penultimateOutput, float lastInput, float lastOutput,
+		float& input, float& outputOffset, float& output)
+{
+	float inputStart = firstInput;
+	float inputEnd = lastInput;
 	float inputSpan = inputEnd - inputStart;
-	float outputStart = keys.front()->output;
-	float outputEnd = keys.back()->output;
+	float outputStart = firstOutput;
+	float outputEnd = lastOutput;
 	float outputSpan = outputEnd - outputStart;
 
 	// Account for pre-infinity mode
-	float outputOffset = 0.0f;
+	outputOffset = 0.0f;
 	if (input < inputStart)
 	{
 		float inputDifference = inputStart - input;
 		switch (preInfinity)
 		{
-		case FUDaeInfinity::CONSTANT: return outputStart;
-		case FUDaeInfinity::LINEAR: return outputStart + inputDifference * (keys[1]->output - outputStart) / (keys[1]->input - inputStart);
+		case FUDaeInfinity::CONSTANT: output = outputStart; return true;
+		case FUDaeInfinity::LINEAR: output = outputStart + inputDifference * (secondOutput - outputStart) / (secondInput - inputStart); return true;
 		case FUDaeInfinity::CYCLE: { float cycleCount = ceilf(inputDifference / inputSpan); input += cycleCount * inputSpan; break; }
 		case FUDaeInfinity::CYCLE_RELATIVE: { float cycleCount = ceilf(inputDifference / inputSpan); input += cycleCount * inputSpan; outputOffset -= cycleCount * outputSpan; break; }
 		case FUDaeInfinity::OSCILLATE: { float cycleCount = ceilf(inputDifference / (2.0f * inputSpan)); input += cycleCount * 2.0f * inputSpan; input = inputEnd - fabsf(input - inputEnd); break; }
-		case FUDaeInfinity::UNKNOWN: default: return outputStart;
+		case FUDaeInfinity::UNKNOWN: default: output = outputStart; return true;
 		}
 	}
 
@@ -340,144 +560,127 @@ float FCDAnimationCurve::Evaluate(float input) const
 		float inputDifference = input - inputEnd;
 		switch (postInfinity)
 		{
-		case FUDaeInfinity::CONSTANT: return outputEnd;
-		case FUDaeInfinity::LINEAR: return outputEnd + inputDifference * (keys[keys.size() - 2]->output - outputEnd) / (keys[keys.size() - 2]->input - inputEnd);
+		case FUDaeInfinity::CONSTANT: output = outputEnd; return true;
+		case FUDaeInfinity::LINEAR: output = outputEnd + inputDifference * (penultimateOutput - outputEnd) / (penultimateInput - inputEnd); return true;
 		case FUDaeInfinity::CYCLE: { float cycleCount = ceilf(inputDifference / inputSpan); input -= cycleCount * inputSpan; break; }
 		case FUDaeInfinity::CYCLE_RELATIVE: { float cycleCount = ceilf(inputDifference / inputSpan); input -= cycleCount * inputSpan; outputOffset += cycleCount * outputSpan; break; }
 		case FUDaeInfinity::OSCILLATE: { float cycleCount = ceilf(inputDifference / (2.0f * inputSpan)); input -= cycleCount * 2.0f * inputSpan; input = inputStart + fabsf(input - inputStart); break; }
-		case FUDaeInfinity::UNKNOWN: default: return outputEnd;
+		case FUDaeInfinity::UNKNOWN: default: output = outputEnd; return true;
 		}
 	}
+	return false;
+}
 
-	// Find the current interval
-	FCDAnimationKeyList::const_iterator it, start = keys.begin(), terminate = keys.end();
-	while (terminate - start > 3)
-	{ 
-		// Binary search.
-		it = (const FCDAnimationKey**) ((((size_t) terminate) / 2 + ((size_t) start) / 2) & ~((sizeof(size_t)-1)));
-		if ((*it)->input > input) terminate = it;
-		else start = it;
-	}
-	// Linear search is more efficient on the last interval
-	for (it = start; it != terminate; ++it)
-	{
-		if ((*it)->input >= input) break;
-	}
-	if (it == keys.begin()) return outputOffset + outputStart;
-
-	// Get the keys and values for this interval
-	const FCDAnimationKey* startKey = *(it - 1);
-	const FCDAnimationKey* endKey = *it;
-	float inputInterval = endKey->input - startKey->input;
-	float outputInterval = endKey->output - startKey->output;
-
-	// Interpolate the output.
-	// Similar code is found in FCDAnimationMultiCurve.cpp. If you update this, update the other one too.
-	float output;
+// Resolves the interpolation of a segment from the interpolation types of its two keys
+// and calculates the two inner control points used by the BEZIER and TCB segments.
+uint32 FCDAnimationCurve::ResolveSegment(const FCDAnimationKey* previousKey, const FCDAnimationKey* startKey, const FCDAnimationKey* endKey, const FCDAnimationKey* nextKey, FMVector2& startControl, FMVector2& endControl)
+{
+	startControl.x = startControl.y = endControl.x = endControl.y = 0.0f;
 	switch (startKey->interpolation)
 	{
-	case FUDaeInterpolation::LINEAR: {
-		output = startKey->output + (input - startKey->input) / inputInterval * outputInterval;
-		break; }
+	case FUDaeInterpolation::LINEAR:
+		return FUDaeInterpolation::LINEAR;
 
 	case FUDaeInterpolation::BEZIER: {
-		if (endKey->interpolation == FUDaeInterpolation::LINEAR) {
-			output = startKey->output + (input - startKey->input) / inputInterval * outputInterval;
-			break;
-		}
+		if (endKey->interpolation == FUDaeInterpolation::LINEAR) return FUDaeInterpolation::LINEAR;
 		if (endKey->interpolation == FUDaeInterpolation::DEFAULT || 
 			endKey->interpolation == FUDaeInterpolation::STEP ||
-			endKey->interpolation == FUDaeInterpolation::UNKNOWN) {
-			output = startKey->output;
-			break;
-		}
+			endKey->interpolation == FUDaeInterpolation::UNKNOWN) return FUDaeInterpolation::STEP;
+
 		//Code that applies to both whether the endKey is Bezier or TCB.
-		FCDAnimationKeyBezier* bkey1 = (FCDAnimationKeyBezier*) startKey;
-		FMVector2 inTangent;
+		startControl = ((const FCDAnimationKeyBezier*) startKey)->outTangent;
 		if (endKey->interpolation == FUDaeInterpolation::BEZIER) {
-			inTangent = ((FCDAnimationKeyBezier*) endKey)->inTangent;
+			endControl = ((const FCDAnimationKeyBezier*) endKey)->inTangent;
 		}
 		else if (endKey->interpolation == FUDaeInterpolation::TCB) {
-			FCDAnimationKeyTCB* tkey2 = (FCDAnimationKeyTCB*) endKey;
+			const FCDAnimationKeyTCB* tkey2 = (const FCDAnimationKeyTCB*) endKey;
 			FMVector2 tempTangent;
 			tempTangent.x = tempTangent.y = 0.0f;
-			const FCDAnimationKey* nextKey = (it + 1) < keys.end() ? (*(it + 1)) : NULL;
-			ComputeTCBTangent(startKey, endKey, nextKey, tkey2->tension, tkey2->continuity, tkey2->bias, inTangent, tempTangent);
+			ComputeTCBTangent(startKey, endKey, nextKey, tkey2->tension, tkey2->continuity, tkey2->bias, endControl, tempTangent);
 			//Change this when we've figured out the values of the vectors from TCB...
-			inTangent.x = endKey->input + inTangent.x; 
-			inTangent.y = endKey->output + inTangent.y;
+			endControl.x = endKey->input + endControl.x; 
+			endControl.y = endKey->output + endControl.y;
 		}
-		float t = (input - startKey->input) / inputInterval;
-		if (is2DEvaluation) t = FindT(bkey1->input, bkey1->outTangent.x, inTangent.x, endKey->input, input, t);
- 		float b = bkey1->outTangent.y;
-		float c = inTangent.y;
-		float ti = 1.0f - t;
-		float br = 3.0f;
-		float cr = 3.0f;
-		if (!is2DEvaluation) { 
-			br = inputInterval / (bkey1->outTangent.x - startKey->input);
-			cr = inputInterval / (endKey->input - inTangent.x);
-			br = FMath::Clamp(br, 0.01f, 100.0f);
-			cr = FMath::Clamp(cr, 0.01f, 100.0f);
-		}
-		output = startKey->output * ti * ti * ti + br * b * ti * ti * t + cr * c * ti * t * t + endKey->output * t * t * t;
-		break; }
+		return FUDaeInterpolation::BEZIER; }
+
 	case FUDaeInterpolation::TCB: {
-		if (endKey->interpolation == FUDaeInterpolation::LINEAR) {
-			output = startKey->output + (input - startKey->input) / inputInterval * outputInterval;
-			break;
-		}
+		if (endKey->interpolation == FUDaeInterpolation::LINEAR) return FUDaeInterpolation::LINEAR;
 		if (endKey->interpolation == FUDaeInterpolation::DEFAULT || 
 			endKey->interpolation == FUDaeInterpolation::STEP ||
-			endKey->interpolation == FUDaeInterpolation::UNKNOWN) {
-			output = startKey->output;
-			break;
-		}
+			endKey->interpolation == FUDaeInterpolation::UNKNOWN) return FUDaeInterpolation::STEP;
+
 		// Calculate the start key's out-tangent.
-		FCDAnimationKeyTCB* tkey1 = (FCDAnimationKeyTCB*) startKey;
+		const FCDAnimationKeyTCB* tkey1 = (const FCDAnimationKeyTCB*) startKey;
 		FMVector2 startTangent, tempTangent, endTangent;
 		startTangent.x = startTangent.y = tempTangent.x = tempTangent.y = endTangent.x = endTangent.y = 0.0f;
-		const FCDAnimationKey* previousKey = (it - 1) > keys.begin() ? (*(it - 2)) : NULL;
 		ComputeTCBTangent(previousKey, startKey, endKey, tkey1->tension, tkey1->continuity, tkey1->bias, tempTangent, startTangent);
 
 		// Calculate the end key's in-tangent.
-		float by = 0.0f, cy= 0.0f; //will be used in the Bezier equation.
-		float bx = 0.0f, cx = 0.0f; //will be used in FindT.. x equivalent of the point at b and c
 		if (endKey->interpolation == FUDaeInterpolation::TCB) {
-			FCDAnimationKeyTCB* tkey2 = (FCDAnimationKeyTCB*) endKey;
-			const FCDAnimationKey* nextKey = (it + 1) < keys.end() ? (*(it + 1)) : NULL;
+			const FCDAnimationKeyTCB* tkey2 = (const FCDAnimationKeyTCB*) endKey;
 			ComputeTCBTangent(startKey, endKey, nextKey, tkey2->tension, tkey2->continuity, tkey2->bias, endTangent, tempTangent);
-			cy = endKey->output + endTangent.y; //Assuming the tangent is GOING from the point.
-			cx = endKey->output + endTangent.x;
+			endControl.y = endKey->output + endTangent.y; //Assuming the tangent is GOING from the point.
+			endControl.x = endKey->output + endTangent.x;
 		}
 		else if (endKey->interpolation == FUDaeInterpolation::BEZIER) {
-			FCDAnimationKeyBezier* tkey2 = (FCDAnimationKeyBezier*) endKey;
-			endTangent = tkey2->inTangent;
-			cy = endTangent.y;
-			cx = endTangent.x;
+			endControl = ((const FCDAnimationKeyBezier*) endKey)->inTangent;
 		}
-		float t = (input - inputStart) / inputInterval;
-		by = startKey->output - startTangent.y; //Assuming the tangent is GOING from the point.
-		bx = startKey->input - startTangent.x;
+		startControl.y = startKey->output - startTangent.y; //Assuming the tangent is GOING from the point.
+		startControl.x = startKey->input - startTangent.x;
+		return FUDaeInterpolation::TCB; }
+
+	case FUDaeInterpolation::STEP:
+	case FUDaeInterpolation::UNKNOWN:
+	default:
+		return FUDaeInterpolation::STEP;
+	}
+}
+
+// Interpolates the output of a resolved segment.
+// Similar code is found in FCDAnimationMultiCurve.cpp. If you update this, update the other one too.
+float FCDAnimationCurve::InterpolateSegment(uint32 mode, float startInput, float startOutput, const FMVector2& startControl, const FMVector2& endControl, float endInput, float endOutput, float input, float inputStart)
+{
+	float inputInterval = endInput - startInput;
+	float outputInterval = endOutput - startOutput;
+
+	switch (mode)
+	{
+	case FUDaeInterpolation::LINEAR:
+		return startOutput + (input - startInput) / inputInterval * outputInterval;
+
+	case FUDaeInterpolation::BEZIER: {
+		float t = (input - startInput) / inputInterval;
+		if (is2DEvaluation) t = FindT(startInput, startControl.x, endControl.x, endInput, input, t);
+ 		float b = startControl.y;
+		float c = endControl.y;
+		float ti = 1.0f - t;
+		float br = 3.0f;
+		float cr = 3.0f;
+		if (!is2DEvaluation) { 
+			br = inputInterval / (startControl.x - startInput);
+			cr = inputInterval / (endInput - endControl.x);
+			br = FMath::Clamp(br, 0.01f, 100.0f);
+			cr = FMath::Clamp(cr, 0.01f, 100.0f);
+		}
+		return startOutput * ti * ti * ti + br * b * ti * ti * t + cr * c * ti * t * t + endOutput * t * t * t; }
 
-		if (is2DEvaluation) t = FindT(tkey1->input, bx, cx, endKey->input, input, t);
+	case FUDaeInterpolation::TCB: {
+		float t = (input - inputStart) / inputInterval;
+		if (is2DEvaluation) t = FindT(startInput, startControl.x, endControl.x, endInput, input, t);
 //		else { //Need to figure out algorithm for easing in and out.
 //			t = Ease(t, tkey1->easeIn, tkey1->easeOut);
 //		}
 
 		float ti = 1.0f - t;
-		output = startKey->output*ti*ti*ti +
-			3*by*t*ti*ti +
-			3*cy*t*t*ti +
-			endKey->output*t*t*t;
-		break; }
+		return startOutput*ti*ti*ti +
+			3*startControl.y*t*ti*ti +
+			3*endControl.y*t*t*ti +
+			endOutput*t*t*t; }
+
 	case FUDaeInterpolation::STEP:
-	case FUDaeInterpolation::UNKNOWN:
 	default:
-		output = startKey->output;
-		break;
+		return startOutput;
 	}
-	return outputOffset + output;
 }
 
 // Apply a conversion function on the key values and tangents
@@ -595,3 +798,123 @@ void FCDAnimationCurve::RegisterAnimationClip(FCDAnimationClip* clip)
 	clipOffsets.push_back(-clip->GetStart());
 	SetDirtyFlag();
 }
+
+//
+// FCDAnimationCurveSampler
+//
+
+FCDAnimationCurveSampler::FCDAnimationCurveSampler(const FCDAnimationCurve* curve)
+:	preInfinity(FUDaeInfinity::CONSTANT), postInfinity(FUDaeInfinity::CONSTANT)
+{
+	Update(curve);
+}
+
+void FCDAnimationCurveSampler::Update(const FCDAnimationCurve* curve)
+{
+	inputs.clear();
+	outputs.clear();
+	modes.clear();
+	startControlsX.clear(); startControlsY.clear();
+	endControlsX.clear(); endControlsY.clear();
+	if (curve == NULL) return;
+
+	preInfinity = curve->GetPreInfinity();
+	postInfinity = curve->GetPostInfinity();
+
+	const FCDAnimationKeyList& keys = curve->keys;
+	size_t keyCount = keys.size();
+	inputs.resize(keyCount);
+	outputs.resize(keyCount);
+	for (size_t i = 0; i < keyCount; ++i)
+	{
+		inputs[i] = keys[i]->input;
+		outputs[i] = keys[i]->output;
+	}
+
+	// Resolve the interpolation and the control points of every segment once.
+	// Segment i ends with the key i: the first entry is never used.
+	modes.resize(keyCount);
+	startControlsX.resize(keyCount); startControlsY.resize(keyCount);
+	endControlsX.resize(keyCount); endControlsY.resize(keyCount);
+	if (keyCount > 0)
+	{
+		modes.front() = FUDaeInterpolation::STEP;
+		startControlsX.front() = startControlsY.front() = endControlsX.front() = endControlsY.front() = 0.0f;
+	}
+	for (size_t i = 1; i < keyCount; ++i)
+	{
+		const FCDAnimationKey* previousKey = (i > 1) ? keys[i - 2] : NULL;
+		const FCDAnimationKey* nextKey = (i + 1 < keyCount) ? keys[i + 1] : NULL;
+		FMVector2 startControl, endControl;
+		modes[i] = FCDAnimationCurve::ResolveSegment(previousKey, keys[i - 1], keys[i], nextKey, startControl, endControl);
+		startControlsX[i] = startControl.x; startControlsY[i] = startControl.y;
+		endControlsX[i] = endControl.x; endControlsY[i] = endControl.y;
+	}
+}
+
+float FCDAnimationCurveSampler::Evaluate(float input) const
+{
+	size_t segmentHint = 0;
+	return Evaluate(input, segmentHint);
+}
+
+float FCDAnimationCurveSampler::Evaluate(float input, size_t& segmentHint) const
+{
+	size_t keyCount = inputs.size();
+	if (keyCount == 0) return 0.0f;
+	if (keyCount == 1) return outputs.front();
+
+	float output, outputOffset;
+	if (ApplyInfinity(input, outputOffset, output)) return output;
+
+	// Walk from the previous segment and fall back to a binary search
+	// when the input value is too far away.
+	const float* keyInputs = inputs.begin();
+	size_t index = min(segmentHint, keyCount - 1);
+	if (index > 0 && keyInputs[index - 1] >= input) index = 0;
+	for (size_t steps = 0; index < keyCount - 1 && keyInputs[index] < input; ++index, ++steps)
+	{
+		if (steps == 4)
+		{
+			size_t low = index, high = keyCount - 1;
+			while (low < high)
+			{
+				size_t middle = (low + high) / 2;
+				if (keyInputs[middle] < input) low = middle + 1;
+				else high = middle;
+			}
+			index = low;
+			break;
+		}
+	}
+
+	segmentHint = index;
+	return outputOffset + EvaluateSegment(index, input);
+}
+
+void FCDAnimationCurveSampler::Evaluate(const float* _inputs, float* _outputs, size_t count) const
+{
+	size_t segmentHint = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		_outputs[i] = Evaluate(_inputs[i], segmentHint);
+	}
+}
+
+bool FCDAnimationCurveSampler::ApplyInfinity(float& input, float& outputOffset, float& output) const
+{
+	size_t last = inputs.size() - 1;
+	return FCDAnimationCurve::ApplyInfinity(preInfinity, postInfinity,
+		inputs[0], outputs[0], inputs[1], outputs[1],
+		inputs[last - 1], outputs[last - 1], inputs[last], outputs[last],
+		input, outputOffset, output);
+}
+
+float FCDAnimationCurveSampler::EvaluateSegment(size_t index, float input) const
+{
+	if (index == 0) return outputs.front();
+	FMVector2 startControl(startControlsX[index], startControlsY[index]);
+	FMVector2 endControl(endControlsX[index], endControlsY[index]);
+	return FCDAnimationCurve::InterpolateSegment(modes[index], inputs[index - 1], outputs[index - 1],
+		startControl, endControl, inputs[index], outputs[index], input, inputs.front());
+}
@@ -25,7 +25,9 @@ class FCDAnimated;
 class FCDAnimationClip;
 class FCDAnimationChannel;
 class FCDAnimationKey;
+class FCDAnimationKeyStorage;
 class FCDConversionFunctor;
+class FCDAnimationCurveSampler;
 
 typedef float (*FCDConversionFunction)(float v); /**< A simple conversion function. */
 
@@ -57,6 +59,7 @@ private:
 
 	// Curve information
 	FCDAnimationKeyList keys;
+	FCDAnimationKeyStorage* keyStorage; // Holds the keys in contiguous blocks, per key type.
 	FUDaeInfinity::Infinity preInfinity, postInfinity;
 	
 	// Driver information
@@ -70,6 +73,8 @@ private:
 	float currentOffset;
 	static bool is2DEvaluation;
 
+	friend class FCDAnimationCurveSampler;
+
 public:
 	DeclareFlag(AnimChanged, 0);	// On Member Value Changed
 	DeclareFlagCount(1);
@@ -106,6 +111,14 @@ public:
 			for the new keys. */
 	void SetKeyCount(size_t count, FUDaeInterpolation::Interpolation interpolation);
 
+	/** Pre-allocates the storage for a number of keys.
+		The keys of a curve are not allocated one by one, but in contiguous
+		blocks of keys with the same interpolation type. When the number of keys
+		is known in advance, reserving them places them all in one block.
+		@param count The number of keys to pre-allocate.
+		@param interpolation The interpolation type of these keys. */
+	void ReserveKeys(size_t count, FUDaeInterpolation::Interpolation interpolation);
+
 	/** Retrieves one key in the animation curve.
 		@param index The index of the key to retrieve.
 		@return The key. */
@@ -240,6 +253,24 @@ public:
 		@return The sampled value of the curve at the given input value. */
 	float Evaluate(float input) const;
 
+	/** Evaluates the animation curve, starting the search for the
+		interval at the segment used by the previous evaluation.
+		This is much faster than the plain evaluation when sampling
+		the curve at increasing input values, as during playback.
+		@param input An input value.
+		@param segmentHint The index of the key that ends the segment used
+			by the previous evaluation. Set it to zero before the first evaluation.
+			It is updated with the index of the segment used by this evaluation.
+		@return The sampled value of the curve at the given input value. */
+	float Evaluate(float input, size_t& segmentHint) const;
+
+	/** Evaluates the animation curve for a list of input values.
+		The input values should preferably be sorted in increasing order.
+		@param inputs A list of input values.
+		@param outputs A pre-allocated list to fill in with the sampled values.
+		@param count The number of input values to evaluate. */
+	void Evaluate(const float* inputs, float* outputs, size_t count) const;
+
 	/** [INTERNAL] Adds an animation clip to the list of animation clips that use this curve.
 		@param clip An animation clip. */
 	void RegisterAnimationClip(FCDAnimationClip* clip);
@@ -282,6 +313,77 @@ public:
 	/** Returns whether 2D Curve Evaluation is on or off.
 		@return A boolean that indicates if the 2D Curve Evaluation is on or off. */
 	static bool Is2DCurveEvaluation() {return is2DEvaluation; }
+
+private:
+	// Evaluation helpers, shared with the FCDAnimationCurveSampler class.
+	bool ApplyCurveInfinity(float& input, float& outputOffset, float& output) const;
+	float EvaluateSegment(size_t index, float input) const;
+	static bool ApplyInfinity(FUDaeInfinity::Infinity preInfinity, FUDaeInfinity::Infinity postInfinity,
+		float firstInput, float firstOutput, float secondInput, float secondOutput,
+		float penultimateInput, float penultimateOutput, float lastInput, float lastOutput,
+		float& input, float& outputOffset, float& output);
+	static uint32 ResolveSegment(const FCDAnimationKey* previousKey, const FCDAnimationKey* startKey, const FCDAnimationKey* endKey, const FCDAnimationKey* nextKey, FMVector2& startControl, FMVector2& endControl);
+	static float InterpolateSegment(uint32 mode, float startInput, float startOutput, const FMVector2& startControl, const FMVector2& endControl, float endInput, float endOutput, float input, float inputStart);
+};
+
+/**
+	A read-only snapshot of an animation curve, laid out for fast sampling.
+	The key inputs and outputs are stored in contiguous lists and the control
+	points of every segment, including the TCB tangents, are calculated once
+	when the snapshot is taken. Use this class when a curve is sampled many
+	times, for example when exporting or playing back an animation.
+
+	The snapshot does not track the curve: call Update after modifying
+	the keys, the infinity types or the 2D curve evaluation flag.
+
+	@ingroup FCDocument
+*/
+class FCOLLADA_EXPORT FCDAnimationCurveSampler
+{
+private:
+	FloatList inputs;
+	FloatList outputs;
+	UInt32List modes; // One resolved interpolation per segment.
+	FloatList startControlsX, startControlsY; // One control point per segment.
+	FloatList endControlsX, endControlsY; // One control point per segment.
+	FUDaeInfinity::Infinity preInfinity, postInfinity;
+
+public:
+	/** Constructor.
+		@param curve The animation curve to sample. This pointer may be NULL. */
+	FCDAnimationCurveSampler(const FCDAnimationCurve* curve = NULL);
+
+	/** Takes a new snapshot of an animation curve.
+		@param curve The animation curve to sample. This pointer may be NULL. */
+	void Update(const FCDAnimationCurve* curve);
+
+	/** Retrieves the number of keys in the snapshot.
+		@return The number of keys. */
+	inline size_t GetKeyCount() const { return inputs.size(); }
+
+	/** Evaluates the animation curve snapshot.
+		@see FCDAnimationCurve::Evaluate
+		@param input An input value.
+		@return The sampled value of the curve at the given input value. */
+	float Evaluate(float input) const;
+
+	/** Evaluates the animation curve snapshot, starting the search for the
+		interval at the segment used by the previous evaluation.
+		@param input An input value.
+		@param segmentHint The index of the key that ends the segment used
+			by the previous evaluation. Set it to zero before the first evaluation.
+		@return The sampled value of the curve at the given input value. */
+	float Evaluate(float input, size_t& segmentHint) const;
+
+	/** Evaluates the animation curve snapshot for a list of input values.
+		@param inputs A list of input values.
+		@param outputs A pre-allocated list to fill in with the sampled values.
+		@param count The number of input values to evaluate. */
+	void Evaluate(const float* inputs, float* outputs, size_t count) const;
+
+private:
+	bool ApplyInfinity(float& input, float& outputOffset, float& output) const;
+	float EvaluateSegment(size_t index, float input) const;
 };
 
 /** A simple conversion functor. */
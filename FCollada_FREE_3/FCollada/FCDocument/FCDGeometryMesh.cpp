@@ -81,6 +81,15 @@ const FCDGeometrySource* FCDGeometryMesh::FindSourceById(const fm::string& id) c
 {
 	const char* localId = id.c_str();
 	if (localId[0] == '#') ++localId;
+
+	// Indexed ids are unique within the document, so a hit settles the search.
+	const FCDObjectWithId* indexed = GetDocument()->FindObjectWithId(localId);
+	if (indexed != NULL)
+	{
+		if (indexed->GetObjectOwner() != &sources) return NULL;
+		return (const FCDGeometrySource*) indexed;
+	}
+
 	for (const FCDGeometrySource** it = sources.begin(); it != sources.end(); ++it)
 	{
 		if ((*it)->GetDaeId() == localId) return (*it);
@@ -33,6 +33,18 @@
 // FCDLibrary
 //
 
+const FCDEntity* FCDLibraryRootEntity(const FCDSceneNode* node)
+{
+	while (node->GetParentCount() > 0) node = node->GetParent();
+	return node;
+}
+
+const FCDEntity* FCDLibraryRootEntity(const FCDAnimation* animation)
+{
+	while (animation->GetParent() != NULL) animation = animation->GetParent();
+	return animation;
+}
+
 typedef FCDLibrary<FCDAnimation> FCDAnimationLibrary; 
 typedef FCDLibrary<FCDAnimationClip> FCDAnimationClipLibrary; 
 typedef FCDLibrary<FCDCamera> FCDCameraLibrary; 
@@ -124,6 +136,8 @@ inline void LibraryExport()
 	ptr = l1->GetEntity(23); 
 	const T* cptr = ((const FCDLibrary<T>*)l1)->GetEntity(0);
 	cptr = ptr;
+	l1->SetDeferredLoad(NULL);
+	l1->LoadDeferred();
 	FCDAsset* asset = l1->GetAsset();
 	asset->SetFlag(11);
 }
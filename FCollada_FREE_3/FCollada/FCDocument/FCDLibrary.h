@@ -28,11 +28,42 @@
 #include "FUtils/FUParameter.h"
 #endif // _FU_PARAMETER_H_
 
+class FCDAnimation;
+class FCDEntity;
+class FCDSceneNode;
+
+/** [INTERNAL] Retrieves the library-level ancestor of an entity.
+	The visual scene node and the animation libraries are tree-based:
+	only their root entities are directly contained by the library.
+	@param entity An entity.
+	@return The root entity that contains the given entity. */
+inline const FCDEntity* FCDLibraryRootEntity(const FCDEntity* entity) { return entity; }
+FCOLLADA_EXPORT const FCDEntity* FCDLibraryRootEntity(const FCDSceneNode* node); /**< See above. */
+FCOLLADA_EXPORT const FCDEntity* FCDLibraryRootEntity(const FCDAnimation* animation); /**< See above. */
+
 class FCDocument;
 class FCDAsset;
 class FCDEntity;
 class FCDExtra;
 
+/**
+	[INTERNAL] The content of a lazy library, not yet turned into entities.
+	Archive plug-ins implement this interface for the libraries that
+	the document's load options mark as lazy.
+	@see FCDLoadOptions
+	@ingroup FCDocument
+*/
+class FCDLibraryDeferredLoad
+{
+public:
+	/** Destructor. */
+	virtual ~FCDLibraryDeferredLoad() {}
+
+	/** Creates the library entities.
+		Called once, the first time the library is accessed. */
+	virtual void Load() = 0;
+};
+
 /**
 	A COLLADA library.
 
@@ -63,6 +94,9 @@ private:
 	// Asset information for the entity.
 	DeclareParameterRef(FCDAsset, asset, FC("Asset Tag"));
 
+	// The content of a lazy library, until first accessed.
+	mutable FCDLibraryDeferredLoad* deferredLoad;
+
 public:
 	/** Constructor: do not use directly.
 		All the necessary libraries are created by the FCDocument object during its creation.
@@ -92,11 +126,11 @@ public:
 
 	/** Returns whether the library contains no entities.
 		@return Whether the library is empty. */
-	inline bool IsEmpty() const { return entities.empty(); }
+	inline bool IsEmpty() const { if (deferredLoad != NULL) LoadDeferred(); return entities.empty(); }
 
 	/** Retrieves the number of entities within the library.
 		@return the number of entities contained within the library. */
-	inline size_t GetEntityCount() const { return entities.size(); }
+	inline size_t GetEntityCount() const { if (deferredLoad != NULL) LoadDeferred(); return entities.size(); }
 
 	/** Retrieves an indexed entity from the library.
 		@param index The index of the entity to retrieve.
@@ -105,6 +139,18 @@ public:
 	inline T* GetEntity(size_t index) { FUAssert(index < GetEntityCount(), return NULL); return entities.at(index); }
 	inline const T* GetEntity(size_t index) const { FUAssert(index < GetEntityCount(), return NULL); return entities.at(index); } /**< See above. */
 
+	/** [INTERNAL] Defers the loading of this library until it is first accessed.
+		@param load The content of the library. The library takes ownership of it. */
+	void SetDeferredLoad(FCDLibraryDeferredLoad* load);
+
+	/** Retrieves whether the entities of this lazy library are still to be loaded.
+		@return Whether the library loading is deferred. */
+	inline bool IsLoadDeferred() const { return deferredLoad != NULL; }
+
+	/** Loads the entities of this lazy library, if they are still to be loaded.
+		The accessors of the library call this function as needed. */
+	void LoadDeferred() const;
+
 	/** Retrieves the asset information for the library.
 		The non-const version of this function can create
 		an empty asset structure for this library.
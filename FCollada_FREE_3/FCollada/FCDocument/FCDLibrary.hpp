@@ -21,6 +21,9 @@
 #ifndef _FCD_ENTITY_H_
 #include "FCDocument/FCDEntity.h"
 #endif // _FCD_ENITTY_H_
+#ifndef _FC_DOCUMENT_H_
+#include "FCDocument/FCDocument.h"
+#endif // _FC_DOCUMENT_H_
 
 template <class T>
 FCDLibrary<T>::FCDLibrary(FCDocument* document)
@@ -28,6 +31,7 @@ FCDLibrary<T>::FCDLibrary(FCDocument* document)
 ,	InitializeParameterNoArg(entities)
 ,	InitializeParameterNoArg(extra)
 ,	InitializeParameterNoArg(asset)
+,	deferredLoad(NULL)
 {
 	extra = new FCDExtra(document, this);
 }
@@ -35,10 +39,31 @@ FCDLibrary<T>::FCDLibrary(FCDocument* document)
 template <class T>
 FCDLibrary<T>::~FCDLibrary()
 {
+	SAFE_DELETE(deferredLoad);
 	SAFE_RELEASE(extra);
 	SAFE_RELEASE(asset);
 }
 
+template <class T>
+void FCDLibrary<T>::SetDeferredLoad(FCDLibraryDeferredLoad* load)
+{
+	SAFE_DELETE(deferredLoad);
+	deferredLoad = load;
+}
+
+template <class T>
+void FCDLibrary<T>::LoadDeferred() const
+{
+	// Detach the content first: loading accesses this library again.
+	FCDLibraryDeferredLoad* load = deferredLoad;
+	deferredLoad = NULL;
+	if (load != NULL)
+	{
+		load->Load();
+		SAFE_DELETE(load);
+	}
+}
+
 // Create the asset if it isn't already there.
 template <class T>
 FCDAsset* FCDLibrary<T>::GetAsset(bool create)
@@ -59,6 +84,24 @@ const T* FCDLibrary<T>::FindDaeId(const fm::string& daeId) const
 	FUAssert (daeId.empty() || daeId[0] != '#',);
 #endif
 
+	// An indexed id is unique within the document: when it is found,
+	// no other entity can hold it and the library search can be skipped.
+	// This also avoids loading a lazy library for ids that belong elsewhere.
+	const FCDocument* document = GetDocument();
+	const FCDObjectWithId* indexed = (document != NULL) ? document->FindObjectWithId(daeId) : NULL;
+	if (indexed != NULL)
+	{
+		if (indexed->GetObjectType() != T::GetClassType()) return NULL;
+		const T* found = (const T*) indexed;
+		return (FCDLibraryRootEntity(found)->GetObjectOwner() == &entities) ? found : NULL;
+	}
+	if (deferredLoad != NULL)
+	{
+		LoadDeferred();
+		return FindDaeId(daeId);
+	}
+
+	// Ids generated on demand are only indexed once first requested.
 	size_t entityCount = entities.size();
 	for (size_t i = 0; i < entityCount; ++i)
 	{
@@ -75,6 +118,7 @@ const T* FCDLibrary<T>::FindDaeId(const fm::string& daeId) const
 template <class T>
 T* FCDLibrary<T>::AddEntity()
 {
+	if (deferredLoad != NULL) LoadDeferred();
 	T* entity = new T(GetDocument());
 	entities.push_back(entity);
 	SetNewChildFlag();
@@ -85,5 +129,6 @@ T* FCDLibrary<T>::AddEntity()
 template <class T>
 void FCDLibrary<T>::AddEntity(T* entity) 
 { 
+	if (deferredLoad != NULL) LoadDeferred();
 	entities.push_back(entity); SetNewChildFlag(); 
 }
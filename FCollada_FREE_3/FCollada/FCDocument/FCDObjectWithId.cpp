@@ -43,16 +43,25 @@ const fm::string& FCDObjectWithId::GetDaeId() const
 	{
 		// Generate a new id
 		FCDObjectWithId* e = const_cast<FCDObjectWithId*>(this);
-		FUSUniqueStringMap* names = e->GetDocument()->GetUniqueNameMap();
-		FUAssert(!e->daeId->empty(), e->daeId = "unknown_object");
-		names->insert(e->daeId);
-		e->SetUniqueIdFlag();
+		FUCriticalSection& registry = e->GetDocument()->GetRegistryCriticalSection();
+		registry.Enter();
+		if (!GetUniqueIdFlag())
+		{
+			FUSUniqueStringMap* names = e->GetDocument()->GetUniqueNameMap();
+			FUAssert(!e->daeId->empty(), e->daeId = "unknown_object");
+			names->insert(e->daeId);
+			e->SetUniqueIdFlag();
+			e->GetDocument()->RegisterDaeId(e);
+		}
+		registry.Leave();
 	}
 	return daeId;
 }
 
 void FCDObjectWithId::SetDaeId(const fm::string& id)
 {
+	FUCriticalSection& registry = GetDocument()->GetRegistryCriticalSection();
+	registry.Enter();
 	RemoveDaeId();
 
 	// Use this id to enforce a unique id.
@@ -60,6 +69,8 @@ void FCDObjectWithId::SetDaeId(const fm::string& id)
 	daeId = CleanId(id);
 	names->insert(daeId);
 	SetUniqueIdFlag();
+	GetDocument()->RegisterDaeId(this);
+	registry.Leave();
 	SetDirtyFlag();
 }
 
@@ -73,9 +84,13 @@ void FCDObjectWithId::RemoveDaeId()
 {
 	if (GetUniqueIdFlag())
 	{
+		FUCriticalSection& registry = GetDocument()->GetRegistryCriticalSection();
+		registry.Enter();
+		GetDocument()->UnregisterDaeId(this);
 		FUSUniqueStringMap* names = GetDocument()->GetUniqueNameMap();
 		names->erase(daeId);
 		ResetUniqueIdFlag();
+		registry.Leave();
 		SetDirtyFlag();
 	}
 }
@@ -31,6 +31,8 @@
 
 	A unique COLLADA id is built, if none are provided, using the 'baseId' field of the constructor.
 	A unique COLLADA id is generated only on demand.
+	Once reserved, the unique COLLADA id is listed in the id index of the document,
+	which allows for fast lookups using FCDocument::FindObjectWithId.
 
 	@ingroup FCDocument
 */
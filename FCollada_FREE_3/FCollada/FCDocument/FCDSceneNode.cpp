@@ -162,8 +162,30 @@ FCDTransform* FCDSceneNode::AddTransform(FCDTransform::Type type, size_t index)
 }
 
 // Traverse the scene graph, searching for a node with the given COLLADA id
+// Check whether a scene node is this node or one of its descendants, through any of its parents
+static bool IsInSubTree(const FCDSceneNode* root, const FCDSceneNode* node)
+{
+	if (node == root) return true;
+	for (size_t i = 0; i < node->GetParentCount(); ++i)
+	{
+		if (IsInSubTree(root, node->GetParent(i))) return true;
+	}
+	return false;
+}
+
 const FCDEntity* FCDSceneNode::FindDaeId(const fm::string& daeId) const
 {
+	// An indexed id is unique within the document: walk up from the node
+	// holding it rather than down through the whole sub-tree.
+	const FCDObjectWithId* indexed = GetDocument()->FindObjectWithId(daeId);
+	if (indexed != NULL)
+	{
+		if (!indexed->HasType(FCDSceneNode::GetClassType())) return NULL;
+		const FCDSceneNode* node = (const FCDSceneNode*) indexed;
+		return IsInSubTree(this, node) ? node : NULL;
+	}
+
+	// Ids generated on demand are only indexed once first requested.
 	if (GetDaeId() == daeId) return this;
 	
 	for (const FCDSceneNode** it = children.begin(); it != children.end(); ++it)
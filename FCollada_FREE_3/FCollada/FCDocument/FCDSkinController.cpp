@@ -187,6 +187,35 @@ void FCDSkinController::ReduceInfluences(uint32 maxInfluenceCount, float minimum
 	SetDirtyFlag();
 }
 
+size_t FCDSkinController::GetTotalPairCount() const
+{
+	size_t pairCount = 0;
+	for (const FCDSkinControllerVertex* it = influences.begin(); it != influences.end(); ++it)
+	{
+		pairCount += (*it).GetPairCount();
+	}
+	return pairCount;
+}
+
+void FCDSkinController::GetPackedInfluences(uint32* offsets, int32* jointIndices, float* weights) const
+{
+	FUAssert(offsets != NULL, return);
+
+	uint32 offset = 0;
+	for (const FCDSkinControllerVertex* it = influences.begin(); it != influences.end(); ++it)
+	{
+		*(offsets++) = offset;
+		size_t pairCount = (*it).GetPairCount();
+		for (size_t i = 0; i < pairCount; ++i, ++offset)
+		{
+			const FCDJointWeightPair* pair = (*it).GetPair(i);
+			jointIndices[offset] = pair->jointIndex;
+			weights[offset] = pair->weight;
+		}
+	}
+	*offsets = offset;
+}
+
 //
 // FCDSkinControllerVertex
 //
@@ -236,6 +236,23 @@ public:
 	inline FCDSkinControllerVertex* GetVertexInfluence(size_t index) { FUAssert(index < influences.size(), return NULL); return &influences.at(index); }
 	inline const FCDSkinControllerVertex* GetVertexInfluence(size_t index) const { FUAssert(index < influences.size(), return NULL); return &influences.at(index); } /**< See above. */
 
+	/** Retrieves the total number of joint-weight pairs, summed over all the influenced vertices.
+		Use this value to size the joint index and weight buffers given to GetPackedInfluences.
+		@return The total number of joint-weight pairs. */
+	size_t GetTotalPairCount() const;
+
+	/** Copies all the per-vertex influences into pre-allocated contiguous buffers, in one pass.
+		The influences are packed in compressed-row form: the joint-weight pairs
+		for the vertex i are found at the indices [offsets[i], offsets[i + 1]).
+		@param offsets A buffer of GetInfluenceCount() + 1 elements
+			to fill in with the offset of the first pair of each vertex.
+			The last offset is the total number of joint-weight pairs.
+		@param jointIndices A buffer of GetTotalPairCount() elements
+			to fill in with the joint indices.
+		@param weights A buffer of GetTotalPairCount() elements
+			to fill in with the influence weights. */
+	void GetPackedInfluences(uint32* offsets, int32* jointIndices, float* weights) const;
+
 	/** Reduces the number of joints influencing each vertex.
 		1) All the influences with a weight less than the minimum will be removed.
 		2) If a vertex has more influences than the given maximum, they will be sorted and the
@@ -40,10 +40,52 @@
 #include "FCDocument/FCDSceneNode.h"
 #include "FCDocument/FCDTexture.h"
 #include "FCDocument/FCDVersion.h"
+#include "FUtils/FUCrc32.h"
 #include "FUtils/FUFileManager.h"
 #include "FUtils/FUUniqueStringMap.h"
 #include "FUtils/FUDaeSyntax.h"
 
+//
+// FCDLoadOptions
+//
+
+void FCDLoadOptions::AddRequestedEntity(const fm::string& name)
+{
+	if (IsEntityRequested(name)) return;
+	requestedEntities.push_back(name);
+
+	// Keep the hash table at most half full.
+	size_t requestedCount = requestedEntities.size();
+	if (requestedEntityTable.size() < requestedCount * 2)
+	{
+		size_t tableSize = 16;
+		while (tableSize < requestedCount * 2) tableSize *= 2;
+		requestedEntityTable.clear();
+		requestedEntityTable.resize(tableSize, 0);
+		for (size_t i = 0; i < requestedCount; ++i) InsertRequestedEntity(i);
+	}
+	else InsertRequestedEntity(requestedCount - 1);
+}
+
+void FCDLoadOptions::InsertRequestedEntity(size_t index)
+{
+	size_t mask = requestedEntityTable.size() - 1;
+	size_t slot = FUCrc32::CRC32(requestedEntities[index].c_str()) & mask;
+	while (requestedEntityTable[slot] != 0) slot = (slot + 1) & mask;
+	requestedEntityTable[slot] = (uint32) index + 1;
+}
+
+bool FCDLoadOptions::IsEntityRequested(const char* name) const
+{
+	if (requestedEntityTable.empty()) return false;
+	size_t mask = requestedEntityTable.size() - 1;
+	for (size_t slot = FUCrc32::CRC32(name) & mask; requestedEntityTable[slot] != 0; slot = (slot + 1) & mask)
+	{
+		if (IsEquivalent(requestedEntities[requestedEntityTable[slot] - 1], name)) return true;
+	}
+	return false;
+}
+
 //
 // FCDocument
 //
@@ -72,7 +114,7 @@ ImplementParameterObject(FCDocument, FCDEmitterLibrary, emitterLibrary, new FCDE
 
 FCDocument::FCDocument()
 :	FCDObject(this)
-,	fileManager(NULL), version(NULL), uniqueNameMap(NULL)
+,	fileManager(NULL), version(NULL), uniqueNameMap(NULL), idIndexCount(0)
 ,	InitializeParameterNoArg(visualSceneRoot)
 ,	InitializeParameterNoArg(physicsSceneRoots)
 ,	InitializeParameterNoArg(asset)
@@ -221,6 +263,10 @@ FCDPhysicsModel* FCDocument::FindPhysicsModel(const fm::string& daeId) { return
 const FCDSceneNode* FCDocument::FindSceneNode(const char* daeId) const { return visualSceneLibrary->FindDaeId(daeId); }
 FCDEntity* FCDocument::FindEntity(const fm::string& daeId)
 {
+	// Skip the library searches for ids held by objects that are not entities.
+	const FCDObjectWithId* indexed = FindObjectWithId(daeId);
+	if (indexed != NULL && !indexed->HasType(FCDEntity::GetClassType())) return NULL;
+
 #define CHECK_LIB(libraryName) { \
 	FCDEntity* e = libraryName->FindDaeId(daeId); \
 	if (e != NULL) return e; }
@@ -245,6 +291,85 @@ FCDEntity* FCDocument::FindEntity(const fm::string& daeId)
 	return NULL;
 }
 
+// Insert an object into the id index, which must hold at least one empty slot
+static void InsertIntoIdIndex(FCDObjectWithIdIndex& idIndex, FCDObjectWithId* object)
+{
+	size_t mask = idIndex.size() - 1;
+	size_t slot = FUCrc32::CRC32(object->GetDaeId().c_str()) & mask;
+	while (idIndex[slot] != NULL) slot = (slot + 1) & mask;
+	idIndex[slot] = object;
+}
+
+// Add an object with a reserved unique id to the id index
+void FCDocument::RegisterDaeId(FCDObjectWithId* object)
+{
+	registryCriticalSection.Enter();
+	if (idIndex.size() < (idIndexCount + 1) * 2)
+	{
+		// Keep the table at most half full, for short probe sequences.
+		FCDObjectWithIdIndex indexed(idIndex);
+		size_t tableSize = max((size_t) 64, idIndex.size() * 2);
+		idIndex.clear();
+		idIndex.resize(tableSize, NULL);
+		for (FCDObjectWithIdIndex::iterator it = indexed.begin(); it != indexed.end(); ++it)
+		{
+			if ((*it) != NULL) InsertIntoIdIndex(idIndex, *it);
+		}
+	}
+	InsertIntoIdIndex(idIndex, object);
+	++idIndexCount;
+	registryCriticalSection.Leave();
+}
+
+// Remove an object from the id index, before its unique id is released
+void FCDocument::UnregisterDaeId(FCDObjectWithId* object)
+{
+	registryCriticalSection.Enter();
+	if (!idIndex.empty())
+	{
+		size_t mask = idIndex.size() - 1;
+		size_t slot = FUCrc32::CRC32(object->GetDaeId().c_str()) & mask;
+		while (idIndex[slot] != NULL && idIndex[slot] != object) slot = (slot + 1) & mask;
+		if (idIndex[slot] == object)
+		{
+			idIndex[slot] = NULL;
+			--idIndexCount;
+
+			// Move back the following objects of the probe sequence that the freed slot would hide.
+			for (size_t next = (slot + 1) & mask; idIndex[next] != NULL; next = (next + 1) & mask)
+			{
+				size_t home = FUCrc32::CRC32(idIndex[next]->GetDaeId().c_str()) & mask;
+				bool reachable = (slot < next) ? (home > slot && home <= next) : (home > slot || home <= next);
+				if (!reachable)
+				{
+					idIndex[slot] = idIndex[next];
+					idIndex[next] = NULL;
+					slot = next;
+				}
+			}
+		}
+	}
+	registryCriticalSection.Leave();
+}
+
+// Search the id index for the object holding a given unique id
+const FCDObjectWithId* FCDocument::FindObjectWithId(const fm::string& daeId) const
+{
+	if (daeId.empty()) return NULL;
+	const FCDObjectWithId* object = NULL;
+	registryCriticalSection.Enter();
+	if (!idIndex.empty())
+	{
+		size_t mask = idIndex.size() - 1;
+		for (size_t slot = FUCrc32::CRC32(daeId.c_str()) & mask; idIndex[slot] != NULL; slot = (slot + 1) & mask)
+		{
+			if (idIndex[slot]->GetDaeId() == daeId) { object = idIndex[slot]; break; }
+		}
+	}
+	registryCriticalSection.Leave();
+	return object;
+}
+
 // Add an animated value to the list
 void FCDocument::RegisterAnimatedValue(FCDAnimated* animated)
 {
@@ -257,7 +382,9 @@ void FCDocument::RegisterAnimatedValue(FCDAnimated* animated)
 	}
 
 	// List the new animated value
+	registryCriticalSection.Enter();
 	animatedValues.insert(animated, animated);
+	registryCriticalSection.Leave();
 
 	//// Also add to the map the individual values for easy retrieval
 	//size_t count = animated->GetValueCount();
@@ -276,6 +403,7 @@ void FCDocument::UnregisterAnimatedValue(FCDAnimated* animated)
 		// Intentionally search from the end:
 		// - In the destructor of the document, we delete from the end.
 		// - In animation exporters, we add to the end and are likely to delete right away.
+		registryCriticalSection.Enter();
 		FCDAnimatedSet::iterator it = animatedValues.find(animated);
 		if (it != animatedValues.end())
 		{
@@ -293,6 +421,7 @@ void FCDocument::UnregisterAnimatedValue(FCDAnimated* animated)
 			//	}
 			//}
 		}
+		registryCriticalSection.Leave();
 	}
 }
 //
@@ -54,6 +54,7 @@ class FCDImage;
 class FCDLight;
 class FCDMaterial;
 class FCDObject;
+class FCDObjectWithId;
 class FCDPhysicsMaterial;
 class FCDPhysicsModel;
 class FCDPhysicsScene;
@@ -92,9 +93,132 @@ typedef FCDLibrary<FCDPhysicsMaterial> FCDPhysicsMaterialLibrary; /**< A COLLADA
 typedef	FCDLibrary<FCDPhysicsScene> FCDPhysicsSceneLibrary; /**< A COLLADA library of physics scene nodes. */
 typedef FUUniqueStringMapT<char> FUSUniqueStringMap; /**< A set of unique strings. */
 typedef fm::map<FCDExtra*, FCDExtra*> FCDExtraSet; /**< A set of extra trees. */
+typedef fm::vector<FCDObjectWithId*, true> FCDObjectWithIdIndex; /**< An open-addressed table of the objects that hold COLLADA ids. */
 
 /** @defgroup FCDocument COLLADA Document Object Model. */
 
+/**
+	The options used when importing a COLLADA document.
+
+	Each library may be loaded eagerly, which is the default, lazily or not at all.
+	The entities of a lazy library are only created the first time the library
+	is searched or enumerated, through FCDLibrary::FindDaeId, GetEntity or GetEntityCount.
+	The animation library is always loaded eagerly, since the other libraries
+	are linked to its channels while they are being read.
+	The scene node instances of the entities in a skipped library are dropped.
+
+	The import may also be restricted to a set of requested entities, by name.
+	Then, only the requested geometries and controllers, and the geometries and
+	controllers they depend on, are read in.
+
+	@ingroup FCDocument
+*/
+class FCOLLADA_EXPORT FCDLoadOptions
+{
+public:
+	/** The COLLADA libraries. */
+	enum Library
+	{
+		ANIMATION = 0,
+		ANIMATION_CLIP,
+		CAMERA,
+		CONTROLLER,
+		EFFECT,
+		EMITTER,
+		FORCE_FIELD,
+		GEOMETRY,
+		IMAGE,
+		LIGHT,
+		MATERIAL,
+		PHYSICS_MATERIAL,
+		PHYSICS_MODEL,
+		PHYSICS_SCENE,
+		VISUAL_SCENE,
+		LIBRARY_COUNT
+	};
+
+	/** How a library is loaded. */
+	enum Mode
+	{
+		EAGER = 0, /**< The library is loaded with the document. */
+		LAZY, /**< The library is loaded on first access. */
+		SKIP /**< The library is never loaded. */
+	};
+
+private:
+	Mode modes[LIBRARY_COUNT];
+
+	// The names of the requested entities, hashed with FUCrc32 in an open-addressed table.
+	// The table holds the 1-based indices of the names; zero marks an empty slot.
+	StringList requestedEntities;
+	UInt32List requestedEntityTable;
+
+	void InsertRequestedEntity(size_t index);
+
+	bool snapshotCache;
+	size_t parallelConversionThreshold;
+
+public:
+	/** Constructor: all the libraries are loaded eagerly. */
+	FCDLoadOptions() : snapshotCache(false), parallelConversionThreshold(256 * 1024) { SetAllModes(EAGER); }
+
+	/** Retrieves how a library is loaded.
+		@param library A COLLADA library.
+		@return The load mode of this library. */
+	inline Mode GetMode(Library library) const { return modes[library]; }
+
+	/** Sets how a library is loaded.
+		@param library A COLLADA library.
+		@param mode The load mode of this library. */
+	inline void SetMode(Library library, Mode mode) { modes[library] = mode; }
+
+	/** Sets how all the libraries are loaded.
+		@param mode The load mode of all the libraries. */
+	inline void SetAllModes(Mode mode) { for (size_t i = 0; i < LIBRARY_COUNT; ++i) modes[i] = mode; }
+
+	/** Retrieves whether the import is restricted to a set of requested entities.
+		@return Whether entities were requested. */
+	inline bool HasRequestedEntities() const { return !requestedEntities.empty(); }
+
+	/** Retrieves the names of the requested entities.
+		@return The list of requested entity names. */
+	inline const StringList& GetRequestedEntities() const { return requestedEntities; }
+
+	/** Restricts the import to the geometries and controllers requested by name.
+		@param name The name of an entity to import. */
+	void AddRequestedEntity(const fm::string& name);
+
+	/** Retrieves whether an entity was requested.
+		@param name The name of an entity.
+		@return Whether this entity name is in the set of requested entities. */
+	bool IsEntityRequested(const char* name) const;
+	inline bool IsEntityRequested(const fm::string& name) const { return IsEntityRequested(name.c_str()); } /**< See above. */
+
+	/** Retrieves whether the parsed document is cached in a binary snapshot.
+		When enabled, loading a file first looks for a snapshot next to it,
+		named after the file with the ".fcsnap" extension appended.
+		A snapshot that is missing or out-of-date is re-written after the file is parsed.
+		@return Whether the snapshot cache is enabled. */
+	inline bool IsSnapshotCacheEnabled() const { return snapshotCache; }
+
+	/** Enables or disables the binary snapshot cache.
+		@param enabled Whether the snapshot cache is enabled. */
+	inline void SetSnapshotCacheEnabled(bool enabled) { snapshotCache = enabled; }
+
+	/** Retrieves the amount of numeric array text above which the arrays
+		of the loaded libraries are converted in parallel, before their
+		entities are read in. Below it, starting the threads costs more
+		than it saves. Defaults to 256KB.
+		@return The amount of array text, in bytes. */
+	inline size_t GetParallelConversionThreshold() const { return parallelConversionThreshold; }
+
+	/** Sets the amount of numeric array text above which the arrays are
+		converted in parallel. A zero threshold always converts the arrays
+		ahead of time, on at least two threads, even on a single processor.
+		@param threshold The amount of array text, in bytes. */
+	inline void SetParallelConversionThreshold(size_t threshold) { parallelConversionThreshold = threshold; }
+};
+
 /** The top class for the COLLADA object model.
 
 	This class holds all the COLLADA libraries, the scene graphs and the
@@ -111,6 +235,9 @@ class FCOLLADA_EXPORT FCDocument : public FCDObject
 private:
 	DeclareObjectType(FCDObject);
 
+	// Protects the unique ids and the animated values. Declared first, to be released last.
+	mutable FUCriticalSection registryCriticalSection;
+
 	FUFileManager* fileManager;
 	FUObjectRef<FCDExternalReferenceManager> externalReferenceManager;
 	fstring fileUrl;
@@ -118,6 +245,10 @@ private:
 	FCDExtraSet extraTrees;
 
 	FUSUniqueStringMap* uniqueNameMap;
+	// The objects with reserved unique ids, hashed with FUCrc32 on these ids in an open-addressed table.
+	// The table holds no copy of the ids: NULL marks an empty slot.
+	FCDObjectWithIdIndex idIndex;
+	size_t idIndexCount;
 	DeclareParameterRef(FCDEntityReference, visualSceneRoot, FC("Root Visual Scene"));
 	DeclareParameterContainer(FCDEntityReference, physicsSceneRoots, FC("Root Physics Scenes"));
 
@@ -150,6 +281,8 @@ private:
 	typedef fm::map<FCDAnimated*, FCDAnimated*> FCDAnimatedSet;
 	FCDAnimatedSet animatedValues;
 
+	FCDLoadOptions loadOptions;
+
 public:
 	/** Construct a new COLLADA document. */
 	FCDocument();
@@ -173,6 +306,15 @@ public:
 	inline FCDVersion& GetVersion() { return *version; }
 	inline const FCDVersion& GetVersion() const { return *version; } /**< See above. */
 
+	/** Retrieves the options used when importing this COLLADA document.
+		@return The load options. */
+	inline FCDLoadOptions& GetLoadOptions() { return loadOptions; }
+	inline const FCDLoadOptions& GetLoadOptions() const { return loadOptions; } /**< See above. */
+
+	/** Sets the options used when importing this COLLADA document.
+		@param options The load options. */
+	inline void SetLoadOptions(const FCDLoadOptions& options) { loadOptions = options; }
+
 	/** [INTERNAL] Retrieves the local file manager for the COLLADA document. Used to resolve URIs and transform file
 		paths into their relative or absolute equivalent. May be deprecated in future versions.
 		@return The file manager for this COLLADA document. This pointer should never be NULL. */
@@ -225,6 +367,34 @@ public:
 	inline FUSUniqueStringMap* GetUniqueNameMap() { return uniqueNameMap; }
 	inline const FUSUniqueStringMap* GetUniqueNameMap() const { return uniqueNameMap; } /**< See above. */
 
+	/** [INTERNAL] Adds an object to the id index of this document.
+		Called by FCDObjectWithId whenever its unique COLLADA id is reserved.
+		@param object An object whose unique COLLADA id was just reserved. */
+	void RegisterDaeId(FCDObjectWithId* object);
+
+	/** [INTERNAL] Removes an object from the id index of this document.
+		Called by FCDObjectWithId before its unique COLLADA id is released.
+		@param object An object whose unique COLLADA id is about to be released. */
+	void UnregisterDaeId(FCDObjectWithId* object);
+
+	/** Retrieves the object that holds the given unique COLLADA id.
+		Only objects whose unique COLLADA id has been reserved are indexed:
+		ids that are generated on demand are indexed once first requested.
+		@param daeId A COLLADA id.
+		@return The object with the given COLLADA id. This pointer will be NULL
+			if no indexed object holds this COLLADA id. */
+	FCDObjectWithId* FindObjectWithId(const fm::string& daeId) { return const_cast<FCDObjectWithId*>(const_cast<const FCDocument*>(this)->FindObjectWithId(daeId)); }
+	const FCDObjectWithId* FindObjectWithId(const fm::string& daeId) const; /**< See above. */
+
+	/** Retrieves the critical section that protects the document-wide registries:
+		the map of unique ids, the id index and the animated values.
+		FCollada enters it whenever a unique id is reserved, released or looked up
+		and whenever an animated value is registered or unregistered.
+		This allows distinct entities of one document, such as its meshes,
+		to be modified on different threads.
+		@return The registry critical section. */
+	inline FUCriticalSection& GetRegistryCriticalSection() const { return registryCriticalSection; }
+
 	/** Retrieves the external reference manager.
 		@return The external reference manager. */
 	inline FCDExternalReferenceManager* GetExternalReferenceManager() { return externalReferenceManager; }
@@ -33,6 +33,7 @@ namespace FCollada
 	static size_t libraryInitializationCount = 0;
 	static FUTrackedList<FCDocument> topDocuments;
 	static bool dereferenceFlag = true;
+	static bool streamingSaveFlag = true;
 	FColladaPluginManager* pluginManager = NULL; // Externed in FCDExtra.cpp.
 	CancelLoadingCallback cancelLoadingCallback = NULL;
 
@@ -120,6 +121,13 @@ namespace FCollada
 		return pluginManager->LoadDocumentFromFile(document, filename);
 	}
 
+	FCOLLADA_EXPORT bool LoadDocumentFromFile(FCDocument* document, const fchar* filename, const FCDLoadOptions& options)
+	{
+		FUAssert(document != NULL, return false);
+		document->SetLoadOptions(options);
+		return LoadDocumentFromFile(document, filename);
+	}
+
 	FCOLLADA_EXPORT FCDocument* LoadDocument(const fchar* filename)
 	{
 		// This function is deprecated.
@@ -134,6 +142,12 @@ namespace FCollada
 		return pluginManager->LoadDocumentFromMemory(filename, document, data, length);
 	}
 
+	FCOLLADA_EXPORT bool ValidateDocumentFromFile(const fchar* filename, FUError::RecordList& errors)
+	{
+		FUAssert(pluginManager != NULL, return false);
+		return pluginManager->ValidateDocumentFromFile(filename, errors);
+	}
+
 	FCOLLADA_EXPORT bool SaveDocument(FCDocument* document, const fchar* filename)
 	{
 		FUAssert(pluginManager != NULL, return false);
@@ -150,6 +164,16 @@ namespace FCollada
 		dereferenceFlag = flag;
 	}
 
+	FCOLLADA_EXPORT bool GetStreamingSaveFlag()
+	{
+		return streamingSaveFlag;
+	}
+
+	FCOLLADA_EXPORT void SetStreamingSaveFlag(bool flag)
+	{
+		streamingSaveFlag = flag;
+	}
+
 	FCOLLADA_EXPORT bool RegisterPlugin(FUPlugin* plugin)
 	{
 		// This function is deprecated.
@@ -170,10 +194,10 @@ namespace FCollada
 };
 
 #ifndef RETAIL
-extern FUTestSuite* _testFMArray,* _testFMTree, * _testFMQuaternion;
+extern FUTestSuite* _testFMArray,* _testFMTree, * _testFMQuaternion, * _testFMMatrix44;
 extern FUTestSuite* _testFUObject, * _testFUCrc32, * _testFUFunctor;
 extern FUTestSuite* _testFUEvent, * _testFUString, * _testFUFileManager;
-extern FUTestSuite* _testFUBoundingTest;
+extern FUTestSuite* _testFUBoundingTest, * _testFUSemaphore;
 
 namespace FCollada
 {
@@ -183,6 +207,7 @@ namespace FCollada
 		testBed.RunTestSuite(::_testFMArray);
 		testBed.RunTestSuite(::_testFMTree);
 		testBed.RunTestSuite(::_testFMQuaternion);
+		testBed.RunTestSuite(::_testFMMatrix44);
 
 		// FUtils tests
 		testBed.RunTestSuite(::_testFUObject);
@@ -192,6 +217,7 @@ namespace FCollada
 		testBed.RunTestSuite(::_testFUString);
 		testBed.RunTestSuite(::_testFUFileManager);
 		testBed.RunTestSuite(::_testFUBoundingTest);
+		testBed.RunTestSuite(::_testFUSemaphore);
 	}
 };
 #endif // RETAIL
@@ -69,6 +69,7 @@
 
 // The main FCollada class: the document object.
 class FCDocument;
+class FCDLoadOptions;
 class FUTestBed;
 class FColladaPluginManager;
 typedef fm::pvector<FCDocument> FCDocumentList;
@@ -143,6 +144,14 @@ namespace FCollada
 		@param filename the string of the file to load from
 		@return the loaded FCDocument. NULL is returned if any error occurs. */
 	FCOLLADA_EXPORT bool LoadDocumentFromFile(FCDocument* document, const fchar* filename);
+
+	/** Load document, with control over which libraries are loaded.
+		@param document An empty document to load imported content into.
+		@param filename the string of the file to load from
+		@param options The libraries to load eagerly, lazily or to skip.
+			These options are kept by the document: see FCDocument::GetLoadOptions.
+		@return true if the file is imported successfully. */
+	FCOLLADA_EXPORT bool LoadDocumentFromFile(FCDocument* document, const fchar* filename, const FCDLoadOptions& options);
 	DEPRECATED(3.05A, LoadDocumentFromFile) inline bool LoadDocument(FCDocument* document, const fchar* filename) { return LoadDocumentFromFile(document, filename); }
 	DEPRECATED(3.05A, NewTopDocument and LoadDocumentFromFile) FCOLLADA_EXPORT FCDocument* LoadDocument(const fchar* filename);
 
@@ -154,6 +163,18 @@ namespace FCollada
 		@return true if the file is imported successfully. */
 	FCOLLADA_EXPORT bool LoadDocumentFromMemory(const fchar* filename, FCDocument* document, void* data, size_t length);
 
+	/** Validate document, without loading it.
+		The structure of the file is checked in one pass over it: the well-formedness,
+		the instance and scene URIs, the geometry source ids, the accessor counts and
+		the polygon index ranges. No FCDocument objects are built.
+		The errors are recorded instead of logged, with the codes that loading the
+		document would log, so that several files may be validated at once on different threads.
+		Replay them through FUError::Error to log them.
+		@param filename the string of the file to validate.
+		@param errors The list to fill in with the errors found.
+		@return Whether the document could be loaded without errors. */
+	FCOLLADA_EXPORT bool ValidateDocumentFromFile(const fchar* filename, FUError::RecordList& errors);
+
 	/** Save document.
 		@param document The FCollada document to be written on to the disk.
 		@param filename the string of the file name to which the content is saved.
@@ -174,6 +195,22 @@ namespace FCollada
 		@param flag Whether to automatically dereference the entity instances. */
 	FCOLLADA_EXPORT void SetDereferenceFlag(bool flag);
 
+	/** Retrieves the global streaming save flag.
+		When this flag is set, the COLLADA documents are written out with the
+		streaming XML writer, which formats the large numerical arrays directly
+		into the file. The output is the same either way.
+		The default behavior is to stream the documents.
+		@return Whether to stream the COLLADA documents when saving. */
+	FCOLLADA_EXPORT bool GetStreamingSaveFlag();
+
+	/** Sets the global streaming save flag.
+		When this flag is set, the COLLADA documents are written out with the
+		streaming XML writer, which formats the large numerical arrays directly
+		into the file. The output is the same either way.
+		The default behavior is to stream the documents.
+		@param flag Whether to stream the COLLADA documents when saving. */
+	FCOLLADA_EXPORT void SetStreamingSaveFlag(bool flag);
+
 	/**	Registers a new FUPlugin plug-in to the FColladaPluginManager.
 		@deprecated Use GetPluginManager()->AddPlugin() instead.
 		@param plugin The new plugin to register. */
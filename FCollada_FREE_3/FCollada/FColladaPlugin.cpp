@@ -129,6 +129,21 @@ bool FColladaPluginManager::LoadDocumentFromMemory(const fchar* filename, FCDocu
 	}
 }
 
+bool FColladaPluginManager::ValidateDocumentFromFile(const fchar* filename, FUError::RecordList& errors)
+{
+	FCPArchive* archiver = FindArchivePlugin(filename);
+	if (archiver != NULL && archiver->IsValidationSupported())
+	{
+		return archiver->ValidateFile(filename, errors);
+	}
+	else
+	{
+		FUError::Record record = { FUError::ERROR_LEVEL, FUError::NO_MATCHING_PLUGIN, 0 };
+		errors.push_back(record);
+		return false;
+	}
+}
+
 bool FColladaPluginManager::SaveDocumentToFile(FCDocument* document, const fchar* filename)
 {
 	FCPArchive* archiver = FindArchivePlugin(filename);
@@ -138,6 +138,18 @@ public:
 		@return Whether the file is imported successfully. */
 	virtual bool ImportFileFromMemory(const fchar* filePath, FCDocument* document, const void* contents, size_t length) = 0;
 
+	/**	Determine if this plug-in supports the validation of files.
+		@return Whether ValidateFile is implemented. */
+	virtual bool IsValidationSupported() { return false; }
+
+	/** Validate a file without importing it.
+		The errors that importing the file would log are recorded instead,
+		so that several files may be validated at once, on different threads.
+		@param filePath full file path to the file to be validated.
+		@param errors The list to fill in with the errors found.
+		@return Whether the file could be imported without errors. */
+	virtual bool ValidateFile(const fchar* /*filePath*/, FUError::RecordList& /*errors*/) { return false; }
+
 	/** Export a file from FCollada.
 		@param document a document to be be exported.
 		@param filePath full file path to the file to be exported.
@@ -237,6 +249,12 @@ public:
 		@param length The length of the memory buffer. */
 	bool LoadDocumentFromMemory(const fchar* filename, FCDocument* document, void* data, size_t length);
 
+	/** Validate the given file without loading it.
+		@param filename The file name of the file to validate.
+		@param errors The list to fill in with the errors found.
+		@return 'true' if the file could be loaded without errors. */
+	bool ValidateDocumentFromFile(const fchar* filename, FUError::RecordList& errors);
+
 	/**	Save document to the given file.
 		@param document the FCDocument whose contents are to be writtern in the file.
 		@param filename the full path of the file to write.
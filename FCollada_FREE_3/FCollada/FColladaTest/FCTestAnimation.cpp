@@ -17,6 +17,8 @@
 #include "FCDocument/FCDLibrary.h"
 #include "FCDocument/FCDSceneNode.h"
 #include "FCDocument/FCDSceneNodeTools.h"
+#include "FCDocument/FCDTransform.h"
+#include <time.h>
 
 TESTSUITE_START(FCDAnimation)
 
@@ -107,4 +109,197 @@ TESTSUITE_TEST(1, CurveMerging)
 	SAFE_RELEASE(c2);
 	SAFE_RELEASE(multiCurve);
 
+TESTSUITE_TEST(2, CurveSampling)
+	// Test that the hinted, batched and snapshot evaluations match the plain evaluation.
+	FUObjectRef<FCDocument> document = FCollada::NewTopDocument();
+	FCDAnimation* animation = document->GetAnimationLibrary()->AddEntity();
+	FCDAnimationChannel* channel = animation->AddChannel();
+
+	// Create a curve with all the interpolation types.
+	static const size_t keyCount = 8;
+	static const float keyInputs[keyCount] = { 0.0f, 0.5f, 1.0f, 2.0f, 2.5f, 3.0f, 4.0f, 5.0f };
+	static const float keyOutputs[keyCount] = { 1.0f, 3.0f, -2.0f, 0.5f, 4.0f, 2.0f, 2.0f, -1.0f };
+	static const FUDaeInterpolation::Interpolation keyInterpolations[keyCount] = { FUDaeInterpolation::BEZIER, FUDaeInterpolation::BEZIER, FUDaeInterpolation::TCB,
+		FUDaeInterpolation::TCB, FUDaeInterpolation::BEZIER, FUDaeInterpolation::LINEAR, FUDaeInterpolation::STEP, FUDaeInterpolation::BEZIER };
+	FCDAnimationCurve* curve = channel->AddCurve();
+	for (size_t i = 0; i < keyCount; ++i)
+	{
+		FCDAnimationKey* k = curve->AddKey(keyInterpolations[i]);
+		k->input = keyInputs[i]; k->output = keyOutputs[i];
+		if (k->interpolation == FUDaeInterpolation::BEZIER)
+		{
+			FCDAnimationKeyBezier* bk = (FCDAnimationKeyBezier*) k;
+			bk->inTangent = FMVector2(keyInputs[i] - 0.15f, keyOutputs[i] - 0.5f);
+			bk->outTangent = FMVector2(keyInputs[i] + 0.15f, keyOutputs[i] + 0.5f);
+		}
+		else if (k->interpolation == FUDaeInterpolation::TCB)
+		{
+			FCDAnimationKeyTCB* tk = (FCDAnimationKeyTCB*) k;
+			tk->tension = 0.2f; tk->continuity = -0.1f; tk->bias = 0.3f;
+		}
+	}
+
+	// Sample forward, backward and across the infinities.
+	static const FUDaeInfinity::Infinity infinities[3] = { FUDaeInfinity::CONSTANT, FUDaeInfinity::CYCLE_RELATIVE, FUDaeInfinity::OSCILLATE };
+	FloatList inputs;
+	for (float t = -6.0f; t <= 11.0f; t += 0.0625f) inputs.push_back(t);
+	for (float t = 11.0f; t >= -6.0f; t -= 0.375f) inputs.push_back(t);
+	FloatList outputs(inputs.size(), 0.0f), sampledOutputs(inputs.size(), 0.0f);
+	for (size_t evaluation = 0; evaluation < 2; ++evaluation)
+	{
+		bool is2DEvaluation = FCDAnimationCurve::Is2DCurveEvaluation();
+		FCDAnimationCurve::Set2DCurveEvaluation(evaluation == 0);
+		for (size_t i = 0; i < 3; ++i)
+		{
+			curve->SetPreInfinity(infinities[i]);
+			curve->SetPostInfinity(infinities[2 - i]);
+			FCDAnimationCurveSampler sampler(curve);
+			PassIf(sampler.GetKeyCount() == keyCount);
+
+			curve->Evaluate(inputs.begin(), outputs.begin(), inputs.size());
+			sampler.Evaluate(inputs.begin(), sampledOutputs.begin(), inputs.size());
+			size_t curveHint = 0, samplerHint = 0;
+			for (size_t j = 0; j < inputs.size(); ++j)
+			{
+				float expected = curve->Evaluate(inputs[j]);
+				PassIf(IsEquivalent(outputs[j], expected));
+				PassIf(IsEquivalent(sampledOutputs[j], expected));
+				PassIf(IsEquivalent(curve->Evaluate(inputs[j], curveHint), expected));
+				PassIf(IsEquivalent(sampler.Evaluate(inputs[j], samplerHint), expected));
+				PassIf(IsEquivalent(sampler.Evaluate(inputs[j]), expected));
+			}
+		}
+		FCDAnimationCurve::Set2DCurveEvaluation(is2DEvaluation);
+	}
+
+	// Verify that an empty snapshot and a single-key snapshot behave like the curves.
+	FCDAnimationCurveSampler emptySampler(NULL);
+	PassIf(IsEquivalent(emptySampler.Evaluate(1.0f), 0.0f));
+	curve->SetKeyCount(1, FUDaeInterpolation::LINEAR);
+	FCDAnimationCurveSampler poseSampler(curve);
+	PassIf(IsEquivalent(poseSampler.Evaluate(3.0f), curve->Evaluate(3.0f)));
+
+	SAFE_RELEASE(curve);
+
+TESTSUITE_TEST(3, DriverLinking)
+	// Benchmark the linking of a synthetic, heavily-animated scene: every driven node
+	// holds a translation animated by a curve that is driven by another node's translation.
+	static const uint32 nodeCount = 2000;
+	FUSStringBuilder builder;
+	builder.append("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n");
+	builder.append("<COLLADA xmlns=\"http://www.collada.org/2005/11/COLLADASchema\" version=\"1.4.1\">\n<library_animations>\n");
+	for (uint32 i = 0; i < nodeCount; ++i)
+	{
+		fm::string id = fm::string("anim") + TO_STRING(i);
+		builder.append("<animation id=\""); builder.append(id); builder.append("\">\n");
+		builder.append("<source id=\""); builder.append(id); builder.append("-in\"><float_array id=\""); builder.append(id);
+		builder.append("-in-array\" count=\"2\">0 1</float_array><technique_common><accessor source=\"#"); builder.append(id);
+		builder.append("-in-array\" count=\"2\"><param name=\"TIME\" type=\"float\"/></accessor></technique_common></source>\n");
+		builder.append("<source id=\""); builder.append(id); builder.append("-out\"><float_array id=\""); builder.append(id);
+		builder.append("-out-array\" count=\"2\">0 "); builder.append(i); builder.append("</float_array><technique_common><accessor source=\"#"); builder.append(id);
+		builder.append("-out-array\" count=\"2\"><param name=\"X\" type=\"float\"/></accessor></technique_common></source>\n");
+		builder.append("<source id=\""); builder.append(id); builder.append("-interp\"><Name_array id=\""); builder.append(id);
+		builder.append("-interp-array\" count=\"2\">LINEAR LINEAR</Name_array><technique_common><accessor source=\"#"); builder.append(id);
+		builder.append("-interp-array\" count=\"2\"><param name=\"INTERPOLATION\" type=\"Name\"/></accessor></technique_common></source>\n");
+		builder.append("<sampler id=\""); builder.append(id); builder.append("-sampler\"><input semantic=\"INPUT\" source=\"#"); builder.append(id);
+		builder.append("-in\"/><input semantic=\"OUTPUT\" source=\"#"); builder.append(id);
+		builder.append("-out\"/><input semantic=\"INTERPOLATION\" source=\"#"); builder.append(id);
+		builder.append("-interp\"/><input semantic=\"DRIVER\" source=\"#driver"); builder.append(i); builder.append("/translate(0)\"/></sampler>\n");
+		builder.append("<channel source=\"#"); builder.append(id); builder.append("-sampler\" target=\"driven"); builder.append(i); builder.append("/translate.X\"/>\n");
+		builder.append("</animation>\n");
+	}
+	builder.append("</library_animations>\n<library_visual_scenes><visual_scene id=\"scene\">\n");
+	for (uint32 i = 0; i < nodeCount; ++i)
+	{
+		builder.append("<node id=\"driven"); builder.append(i); builder.append("\"><translate sid=\"translate\">0 0 0</translate></node>\n");
+		builder.append("<node id=\"driver"); builder.append(i); builder.append("\"><translate sid=\"translate\">0 0 0</translate></node>\n");
+	}
+	builder.append("</visual_scene></library_visual_scenes>\n<scene><instance_visual_scene url=\"#scene\"/></scene>\n</COLLADA>\n");
+
+	FUErrorSimpleHandler errorHandler;
+	FUObjectRef<FCDocument> document = FCollada::NewTopDocument();
+	clock_t start = clock();
+	PassIf(FCollada::LoadDocumentFromMemory(FC("DriverLinking.dae"), document, (void*) builder.ToCharPtr(), builder.length()));
+	double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+	PassIf(errorHandler.IsSuccessful());
+	if (testBed.IsVerbose())
+	{
+		fileOut.WriteLine("DriverLinking: loaded %u driven nodes in %f seconds.", nodeCount, seconds);
+	}
+
+	// Every curve must be driven by the translation of its driver node.
+	for (uint32 i = 0; i < nodeCount; i += 97)
+	{
+		FCDSceneNode* driven = document->FindSceneNode((fm::string("driven") + TO_STRING(i)).c_str());
+		FCDSceneNode* driver = document->FindSceneNode((fm::string("driver") + TO_STRING(i)).c_str());
+		PassIf(driven != NULL && driver != NULL);
+		PassIf(driven->GetTransformCount() == 1 && driver->GetTransformCount() == 1);
+		FCDAnimated* animated = driven->GetTransform(0)->GetAnimated();
+		PassIf(animated != NULL && animated->GetCurve(0) != NULL);
+		FCDAnimationCurve* drivenCurve = animated->GetCurve(0);
+		PassIf(drivenCurve->HasDriver());
+		PassIf(drivenCurve->GetDriverPtr() == driver->GetTransform(0)->GetAnimated());
+		PassIf(drivenCurve->GetDriverIndex() == 0);
+	}
+
+TESTSUITE_TEST(4, KeyStorage)
+	// The keys are allocated in blocks per key type: verify that they keep their values
+	// as the blocks fill up, and that deleted keys are recycled.
+	FUObjectRef<FCDocument> document = FCollada::NewTopDocument();
+	FCDAnimation* animation = document->GetAnimationLibrary()->AddEntity();
+	FCDAnimationChannel* channel = animation->AddChannel();
+	FCDAnimationCurve* curve = channel->AddCurve();
+
+	static const size_t keyCount = 1000;
+	curve->ReserveKeys(keyCount / 2, FUDaeInterpolation::BEZIER);
+	for (size_t i = 0; i < keyCount; ++i)
+	{
+		FCDAnimationKey* key = curve->AddKey((i % 2) == 0 ? FUDaeInterpolation::BEZIER : FUDaeInterpolation::LINEAR);
+		key->input = (float) i;
+		key->output = (float) (2 * i);
+		if (key->interpolation == FUDaeInterpolation::BEZIER)
+		{
+			((FCDAnimationKeyBezier*) key)->inTangent = FMVector2((float) i, -1.0f);
+			((FCDAnimationKeyBezier*) key)->outTangent = FMVector2((float) i, 1.0f);
+		}
+	}
+	PassIf(curve->GetKeyCount() == keyCount);
+
+	// The reserved bezier keys are consecutive.
+	FCDAnimationKey** keys = curve->GetKeys();
+	for (size_t i = 2; i < keyCount; i += 2)
+	{
+		PassIf((FCDAnimationKeyBezier*) keys[i] == ((FCDAnimationKeyBezier*) keys[i - 2]) + 1);
+	}
+
+	// Clone the curve and compare all the key values.
+	FCDAnimationCurve* clone = curve->Clone(NULL, false);
+	PassIf(clone->GetKeyCount() == keyCount);
+	for (size_t i = 0; i < keyCount; ++i)
+	{
+		FCDAnimationKey* key = clone->GetKey(i);
+		PassIf(key->input == (float) i && key->output == (float) (2 * i));
+		PassIf(key->interpolation == (uint32) ((i % 2) == 0 ? FUDaeInterpolation::BEZIER : FUDaeInterpolation::LINEAR));
+		if (key->interpolation == FUDaeInterpolation::BEZIER)
+		{
+			PassIf(IsEquivalent(((FCDAnimationKeyBezier*) key)->inTangent, FMVector2((float) i, -1.0f)));
+			PassIf(IsEquivalent(((FCDAnimationKeyBezier*) key)->outTangent, FMVector2((float) i, 1.0f)));
+		}
+	}
+	SAFE_RELEASE(clone);
+
+	// A deleted key is given back to the next key of the same type.
+	FCDAnimationKey* deletedKey = curve->GetKey(11);
+	PassIf(curve->DeleteKey(deletedKey));
+	PassIf(curve->GetKeyCount() == keyCount - 1);
+	PassIf(curve->AddKey(FUDaeInterpolation::LINEAR, 10.5f) == deletedKey);
+	PassIf(curve->GetKey(11) == deletedKey);
+
+	curve->SetKeyCount(10, FUDaeInterpolation::BEZIER);
+	PassIf(curve->GetKeyCount() == 10);
+	PassIf(curve->GetKey(9)->input == 9.0f);
+	curve->SetKeyCount(20, FUDaeInterpolation::TCB);
+	PassIf(curve->GetKeyCount() == 20);
+	PassIf(curve->GetKey(19)->interpolation == FUDaeInterpolation::TCB);
+
 TESTSUITE_END
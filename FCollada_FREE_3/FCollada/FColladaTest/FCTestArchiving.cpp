@@ -10,7 +10,217 @@
 #include "FCDocument/FCDocument.h"
 #include "FCDocument/FCDLibrary.h"
 #include "FCDocument/FCDLight.h"
+#include "FCDocument/FCDAnimation.h"
+#include "FCDocument/FCDAnimationChannel.h"
+#include "FCDocument/FCDAnimationCurve.h"
+#include "FCDocument/FCDAnimationKey.h"
+#include "FCDocument/FCDAnimated.h"
+#include "FCDocument/FCDEntityInstance.h"
+#include "FCDocument/FCDExtra.h"
+#include "FCDocument/FCDSceneNode.h"
+#include "FCDocument/FCDCamera.h"
+#include "FCDocument/FCDController.h"
+#include "FCDocument/FCDEffect.h"
+#include "FCDocument/FCDGeometry.h"
+#include "FCDocument/FCDGeometryMesh.h"
+#include "FCDocument/FCDGeometryPolygons.h"
+#include "FCDocument/FCDGeometryPolygonsInput.h"
+#include "FCDocument/FCDGeometrySource.h"
+#include "FCDocument/FCDImage.h"
+#include "FCDocument/FCDMaterial.h"
+#include "FCDocument/FCDSkinController.h"
+#include "FCDocument/FCDTransform.h"
 #include "FUtils/FUFile.h"
+#include "FUtils/FUThread.h"
+#include <time.h>
+
+// Loads one document from memory on a worker thread.
+struct ConcurrentLoad
+{
+	FCDocument* document;
+	const uint8* data;
+	size_t dataLength;
+	bool result;
+};
+
+#ifdef WIN32
+static DWORD WINAPI LoadDocumentThread(void* parameter)
+#else
+static void* LoadDocumentThread(void* parameter)
+#endif // WIN32
+{
+	ConcurrentLoad* load = (ConcurrentLoad*) parameter;
+	load->result = FCollada::LoadDocumentFromMemory(FC("./TestConcurrent.dae"), load->document, (void*) load->data, load->dataLength);
+	return 0;
+}
+
+static const char* szTestName = "FColladaArchiving";
+
+// Records the errors logged by a full load, to compare them with the validation.
+static FUError::RecordList loadedErrors;
+static void RecordLoadError(FUError::Level errorLevel, uint32 errorCode, uint32 lineNumber)
+{
+	FUError::Record record = { errorLevel, errorCode, lineNumber };
+	loadedErrors.push_back(record);
+}
+
+// Retrieves whether a validation recorded the given error.
+static bool HasRecord(const FUError::RecordList& errors, FUError::Level errorLevel, uint32 errorCode)
+{
+	for (FUError::RecordList::const_iterator it = errors.begin(); it != errors.end(); ++it)
+	{
+		if ((*it).level == errorLevel && (*it).code == errorCode) return true;
+	}
+	return false;
+}
+
+// Verifies that a document loaded concurrently matches the sequentially-loaded one.
+static bool IsSameDocument(FULogFile& fileOut, FCDocument* expected, FCDocument* loaded)
+{
+	PassIf(loaded->GetLightLibrary()->GetEntityCount() == expected->GetLightLibrary()->GetEntityCount());
+	for (size_t i = 0; i < expected->GetLightLibrary()->GetEntityCount(); ++i)
+	{
+		FCDLight* light1 = expected->GetLightLibrary()->GetEntity(i);
+		FCDLight* light2 = loaded->GetLightLibrary()->GetEntity(i);
+		PassIf(light1->GetDaeId() == light2->GetDaeId());
+		PassIf(light2->GetIntensity().IsAnimated() == light1->GetIntensity().IsAnimated());
+		if (!light1->GetIntensity().IsAnimated())
+		{
+			PassIf(IsEquivalent(light1->GetIntensity(), light2->GetIntensity()));
+		}
+		else
+		{
+			const FCDAnimationCurve* curve1 = light1->GetIntensity().GetAnimated()->GetCurve(0);
+			const FCDAnimationCurve* curve2 = light2->GetIntensity().GetAnimated()->GetCurve(0);
+			FailIf(curve1 == NULL || curve2 == NULL);
+			PassIf(curve2->GetDocument() == loaded);
+			PassIf(curve1->GetKeyCount() == curve2->GetKeyCount());
+			for (size_t k = 0; k < curve1->GetKeyCount(); ++k)
+			{
+				PassIf(IsEquivalent(curve1->GetKey(k)->input, curve2->GetKey(k)->input));
+				PassIf(IsEquivalent(curve1->GetKey(k)->output, curve2->GetKey(k)->output));
+			}
+		}
+	}
+
+	FCDSceneNode* root1 = expected->GetVisualSceneInstance();
+	FCDSceneNode* root2 = loaded->GetVisualSceneInstance();
+	FailIf(root1 == NULL || root2 == NULL);
+	PassIf(root1->GetChildrenCount() == root2->GetChildrenCount());
+	for (size_t i = 0; i < root1->GetChildrenCount(); ++i)
+	{
+		FCDSceneNode* node1 = root1->GetChild(i);
+		FCDSceneNode* node2 = root2->GetChild(i);
+		PassIf(node1->GetDaeId() == node2->GetDaeId());
+		PassIf(node1->GetInstanceCount() == node2->GetInstanceCount());
+		for (size_t j = 0; j < node1->GetInstanceCount(); ++j)
+		{
+			FCDEntity* entity2 = node2->GetInstance(j)->GetEntity();
+			FailIf(entity2 == NULL);
+			PassIf(entity2->GetDocument() == loaded);
+			PassIf(entity2->GetDaeId() == node1->GetInstance(j)->GetEntity()->GetDaeId());
+		}
+	}
+	return true;
+}
+
+// Compares the numeric arrays read in for the meshes, the skins and the animation curves.
+static bool IsSameAnimation(FULogFile& fileOut, const FCDAnimation* expected, const FCDAnimation* loaded)
+{
+	PassIf(expected->GetChannelCount() == loaded->GetChannelCount());
+	for (size_t i = 0; i < expected->GetChannelCount(); ++i)
+	{
+		const FCDAnimationChannel* channel1 = expected->GetChannel(i);
+		const FCDAnimationChannel* channel2 = loaded->GetChannel(i);
+		PassIf(channel1->GetCurveCount() == channel2->GetCurveCount());
+		for (size_t j = 0; j < channel1->GetCurveCount(); ++j)
+		{
+			const FCDAnimationCurve* curve1 = channel1->GetCurve(j);
+			const FCDAnimationCurve* curve2 = channel2->GetCurve(j);
+			PassIf(curve1->GetKeyCount() == curve2->GetKeyCount());
+			for (size_t k = 0; k < curve1->GetKeyCount(); ++k)
+			{
+				PassIf(IsEquivalent(curve1->GetKey(k)->input, curve2->GetKey(k)->input));
+				PassIf(IsEquivalent(curve1->GetKey(k)->output, curve2->GetKey(k)->output));
+			}
+		}
+	}
+	PassIf(expected->GetChildrenCount() == loaded->GetChildrenCount());
+	for (size_t i = 0; i < expected->GetChildrenCount(); ++i)
+	{
+		PassIf(IsSameAnimation(fileOut, expected->GetChild(i), loaded->GetChild(i)));
+	}
+	return true;
+}
+
+static bool IsSameNumericData(FULogFile& fileOut, FCDocument* expected, FCDocument* loaded)
+{
+	PassIf(expected->GetGeometryLibrary()->GetEntityCount() == loaded->GetGeometryLibrary()->GetEntityCount());
+	for (size_t i = 0; i < expected->GetGeometryLibrary()->GetEntityCount(); ++i)
+	{
+		const FCDGeometryMesh* mesh1 = expected->GetGeometryLibrary()->GetEntity(i)->GetMesh();
+		const FCDGeometryMesh* mesh2 = loaded->GetGeometryLibrary()->GetEntity(i)->GetMesh();
+		PassIf((mesh1 == NULL) == (mesh2 == NULL));
+		if (mesh1 == NULL) continue;
+
+		PassIf(mesh1->GetSourceCount() == mesh2->GetSourceCount());
+		for (size_t j = 0; j < mesh1->GetSourceCount(); ++j)
+		{
+			const FCDGeometrySource* source1 = mesh1->GetSource(j);
+			const FCDGeometrySource* source2 = mesh2->GetSource(j);
+			PassIf(source1->GetStride() == source2->GetStride());
+			PassIf(source1->GetDataCount() == source2->GetDataCount());
+			PassIf(memcmp(source1->GetData(), source2->GetData(), source1->GetDataCount() * sizeof(float)) == 0);
+		}
+
+		PassIf(mesh1->GetPolygonsCount() == mesh2->GetPolygonsCount());
+		for (size_t j = 0; j < mesh1->GetPolygonsCount(); ++j)
+		{
+			const FCDGeometryPolygons* polygons1 = mesh1->GetPolygons(j);
+			const FCDGeometryPolygons* polygons2 = mesh2->GetPolygons(j);
+			PassIf(polygons1->GetFaceVertexCountCount() == polygons2->GetFaceVertexCountCount());
+			PassIf(memcmp(polygons1->GetFaceVertexCounts(), polygons2->GetFaceVertexCounts(), polygons1->GetFaceVertexCountCount() * sizeof(uint32)) == 0);
+			PassIf(polygons1->GetInputCount() == polygons2->GetInputCount());
+			for (size_t k = 0; k < polygons1->GetInputCount(); ++k)
+			{
+				const FCDGeometryPolygonsInput* input1 = polygons1->GetInput(k);
+				const FCDGeometryPolygonsInput* input2 = polygons2->GetInput(k);
+				PassIf(input1->GetIndexCount() == input2->GetIndexCount());
+				if (input1->GetIndexCount() == 0) continue;
+				PassIf(memcmp(input1->GetIndices(), input2->GetIndices(), input1->GetIndexCount() * sizeof(uint32)) == 0);
+			}
+		}
+	}
+
+	PassIf(expected->GetControllerLibrary()->GetEntityCount() == loaded->GetControllerLibrary()->GetEntityCount());
+	for (size_t i = 0; i < expected->GetControllerLibrary()->GetEntityCount(); ++i)
+	{
+		const FCDSkinController* skin1 = expected->GetControllerLibrary()->GetEntity(i)->GetSkinController();
+		const FCDSkinController* skin2 = loaded->GetControllerLibrary()->GetEntity(i)->GetSkinController();
+		PassIf((skin1 == NULL) == (skin2 == NULL));
+		if (skin1 == NULL) continue;
+
+		PassIf(skin1->GetInfluenceCount() == skin2->GetInfluenceCount());
+		for (size_t j = 0; j < skin1->GetInfluenceCount(); ++j)
+		{
+			const FCDSkinControllerVertex* vertex1 = skin1->GetVertexInfluence(j);
+			const FCDSkinControllerVertex* vertex2 = skin2->GetVertexInfluence(j);
+			PassIf(vertex1->GetPairCount() == vertex2->GetPairCount());
+			for (size_t k = 0; k < vertex1->GetPairCount(); ++k)
+			{
+				PassIf(vertex1->GetPair(k)->jointIndex == vertex2->GetPair(k)->jointIndex);
+				PassIf(IsEquivalent(vertex1->GetPair(k)->weight, vertex2->GetPair(k)->weight));
+			}
+		}
+	}
+
+	PassIf(expected->GetAnimationLibrary()->GetEntityCount() == loaded->GetAnimationLibrary()->GetEntityCount());
+	for (size_t i = 0; i < expected->GetAnimationLibrary()->GetEntityCount(); ++i)
+	{
+		PassIf(IsSameAnimation(fileOut, expected->GetAnimationLibrary()->GetEntity(i), loaded->GetAnimationLibrary()->GetEntity(i)));
+	}
+	return true;
+}
 
 TESTSUITE_START(FColladaArchiving)
 
@@ -50,4 +260,473 @@ TESTSUITE_TEST(0, FileArchiving)
 	PassIf(light3->GetLightType() == light->GetLightType());
 	PassIf(IsEquivalent(light->GetIntensity(), light->GetIntensity()));
 
+TESTSUITE_TEST(1, ConcurrentLoading)
+	FUErrorSimpleHandler errorHandler;
+	static const size_t lightCount = 64;
+	static const size_t threadCount = 8;
+	static const size_t roundCount = 4;
+
+	// Create a document with animated lights instantiated in the visual scene.
+	FUObjectRef<FCDocument> document = FCollada::NewTopDocument();
+	FCDSceneNode* root = document->AddVisualScene();
+	for (size_t i = 0; i < lightCount; ++i)
+	{
+		FCDLight* light = document->GetLightLibrary()->AddEntity();
+		light->SetLightType(FCDLight::POINT);
+		light->SetIntensity(0.1f * (float) (i + 1));
+		if (i % 2 == 0)
+		{
+			FCDAnimationChannel* channel = document->GetAnimationLibrary()->AddEntity()->AddChannel();
+			FCDAnimationCurve* curve = channel->AddCurve();
+			for (size_t k = 0; k < 4; ++k)
+			{
+				FCDAnimationKey* key = curve->AddKey(FUDaeInterpolation::LINEAR);
+				key->input = (float) k; key->output = (float) (i + k);
+			}
+			light->GetIntensity().GetAnimated()->AddCurve(0, curve);
+		}
+		root->AddChildNode()->AddInstance(light);
+	}
+	FCollada::SaveDocument(document, FC("./TestConcurrent.dae"));
+
+	FUFile file(FC("./TestConcurrent.dae"), FUFile::READ);
+	size_t dataLength = file.GetLength();
+	uint8* data = new uint8[dataLength];
+	PassIf(file.Read(data, dataLength));
+	file.Close();
+
+	// Sequential reference load.
+	FUObjectRef<FCDocument> reference = FCollada::NewTopDocument();
+	PassIf(FCollada::LoadDocumentFromMemory(FC("./TestConcurrent.dae"), reference, data, dataLength));
+	PassIf(errorHandler.IsSuccessful());
+	PassIf(reference->GetLightLibrary()->GetEntityCount() == lightCount);
+	PassIf(reference->GetAnimationLibrary()->GetEntityCount() == lightCount / 2);
+	FailIf(reference->GetVisualSceneInstance() == NULL);
+	PassIf(reference->GetVisualSceneInstance()->GetChildrenCount() == lightCount);
+
+	// Load the same data on several threads at once, a few times over.
+	for (size_t round = 0; round < roundCount; ++round)
+	{
+		ConcurrentLoad loads[threadCount];
+		FUThread* threads[threadCount];
+		for (size_t i = 0; i < threadCount; ++i)
+		{
+			// Documents are created on this thread: the list of top documents isn't thread-safe.
+			loads[i].document = FCollada::NewTopDocument();
+			loads[i].data = data;
+			loads[i].dataLength = dataLength;
+			loads[i].result = false;
+		}
+		bool isEveryThreadCreated = true;
+		for (size_t i = 0; i < threadCount; ++i)
+		{
+			threads[i] = FUThread::CreateFUThread(LoadDocumentThread, &loads[i]);
+			isEveryThreadCreated &= threads[i] != NULL;
+		}
+
+		// Wait for the loads that did start before failing the test: they use the data and the documents.
+		for (size_t i = 0; i < threadCount; ++i)
+		{
+			FUThread::ExitFUThread(threads[i]);
+		}
+		if (!isEveryThreadCreated)
+		{
+			for (size_t i = 0; i < threadCount; ++i) loads[i].document->Release();
+			SAFE_DELETE_ARRAY(data);
+		}
+		PassIf(isEveryThreadCreated);
+		for (size_t i = 0; i < threadCount; ++i)
+		{
+			PassIf(loads[i].result);
+			PassIf(IsSameDocument(fileOut, reference, loads[i].document));
+			loads[i].document->Release();
+		}
+	}
+	PassIf(errorHandler.IsSuccessful());
+	SAFE_DELETE_ARRAY(data);
+
+TESTSUITE_TEST(2, DispatchCost)
+	// The archive plug-in dispatches every loaded and written object on its type.
+	// Compare a pointer-keyed tree lookup against a flat table indexed by type identifier.
+	const FUObjectType* types[] = { &FCDObject::GetClassType(), &FCDEntity::GetClassType(), &FCDSceneNode::GetClassType(),
+		&FCDLight::GetClassType(), &FCDCamera::GetClassType(), &FCDGeometry::GetClassType(), &FCDGeometryMesh::GetClassType(),
+		&FCDGeometrySource::GetClassType(), &FCDGeometryPolygons::GetClassType(), &FCDController::GetClassType(),
+		&FCDMaterial::GetClassType(), &FCDEffect::GetClassType(), &FCDImage::GetClassType(), &FCDAnimation::GetClassType(),
+		&FCDAnimationChannel::GetClassType(), &FCDAnimationCurve::GetClassType(), &FCDEntityInstance::GetClassType(),
+		&FCDTTranslation::GetClassType(), &FCDTRotation::GetClassType(), &FCDTScale::GetClassType(), &FCDTMatrix::GetClassType() };
+	static const size_t typeCount = sizeof(types) / sizeof(*types);
+	static const uint32 dispatchCount = 4000000;
+
+	fm::map<const FUObjectType*, size_t> typeMap;
+	fm::vector<size_t> typeTable(FUObjectType::GetTypeCount(), (size_t) ~0);
+	for (size_t i = 0; i < typeCount; ++i)
+	{
+		typeMap.insert(types[i], i);
+		typeTable[types[i]->GetTypeId()] = i;
+	}
+
+	size_t mapHits = 0, tableHits = 0;
+	clock_t start = clock();
+	for (uint32 i = 0; i < dispatchCount; ++i)
+	{
+		fm::map<const FUObjectType*, size_t>::iterator it = typeMap.find(types[i % typeCount]);
+		if (it != typeMap.end()) mapHits += it->second;
+	}
+	clock_t mapTicks = clock() - start;
+
+	start = clock();
+	for (uint32 i = 0; i < dispatchCount; ++i)
+	{
+		uint32 typeId = types[i % typeCount]->GetTypeId();
+		if (typeId < typeTable.size()) tableHits += typeTable[typeId];
+	}
+	clock_t tableTicks = clock() - start;
+	PassIf(mapHits == tableHits);
+
+	if (testBed.IsVerbose())
+	{
+		fileOut.WriteLine("DispatchCost: %u dispatches, tree lookup %f ns each, flat table %f ns each.", dispatchCount,
+			1.0e9 * mapTicks / CLOCKS_PER_SEC / dispatchCount, 1.0e9 * tableTicks / CLOCKS_PER_SEC / dispatchCount);
+	}
+
+TESTSUITE_TEST(3, LoadOptions)
+	FUErrorSimpleHandler errorHandler;
+
+	// Create a document with an animated light, a camera and a scene that instantiates them.
+	FUObjectRef<FCDocument> document = FCollada::NewTopDocument();
+	FCDSceneNode* root = document->AddVisualScene();
+	FCDLight* light = document->GetLightLibrary()->AddEntity();
+	light->SetLightType(FCDLight::SPOT);
+	light->SetDaeId("LazyLight");
+	FCDAnimationCurve* curve = document->GetAnimationLibrary()->AddEntity()->AddChannel()->AddCurve();
+	for (size_t k = 0; k < 4; ++k)
+	{
+		FCDAnimationKey* key = curve->AddKey(FUDaeInterpolation::LINEAR);
+		key->input = (float) k; key->output = (float) k * 0.5f;
+	}
+	light->GetIntensity().GetAnimated()->AddCurve(0, curve);
+	FCDCamera* camera = document->GetCameraLibrary()->AddEntity();
+	camera->SetDaeId("SkippedCamera");
+	root->AddChildNode()->AddInstance(light);
+	root->AddChildNode()->AddInstance(camera);
+	FCollada::SaveDocument(document, FC("./TestLoadOptions.dae"));
+
+	// Load the lights on demand and skip the cameras.
+	FCDLoadOptions options;
+	options.SetMode(FCDLoadOptions::LIGHT, FCDLoadOptions::LAZY);
+	options.SetMode(FCDLoadOptions::CAMERA, FCDLoadOptions::SKIP);
+	PassIf(options.GetMode(FCDLoadOptions::GEOMETRY) == FCDLoadOptions::EAGER);
+	FUObjectRef<FCDocument> document2 = FCollada::NewTopDocument();
+	PassIf(FCollada::LoadDocumentFromFile(document2, FC("./TestLoadOptions.dae"), options));
+	PassIf(errorHandler.IsSuccessful());
+	PassIf(document2->GetLoadOptions().GetMode(FCDLoadOptions::LIGHT) == FCDLoadOptions::LAZY);
+	PassIf(document2->GetAnimationLibrary()->GetEntityCount() == 1);
+	PassIf(document2->GetLightLibrary()->IsLoadDeferred());
+	FailIf(document2->GetCameraLibrary()->IsLoadDeferred());
+	PassIf(document2->GetCameraLibrary()->GetEntityCount() == 0);
+	PassIf(document2->FindCamera("SkippedCamera") == NULL);
+
+	// The scene node instances are resolved by identifier: this loads the light library.
+	FCDSceneNode* root2 = document2->GetVisualSceneInstance();
+	FailIf(root2 == NULL);
+	PassIf(root2->GetChildrenCount() == 2);
+	FCDLight* light2 = document2->FindLight("LazyLight");
+	FailIf(light2 == NULL);
+	FailIf(document2->GetLightLibrary()->IsLoadDeferred());
+	PassIf(document2->GetLightLibrary()->GetEntityCount() == 1);
+	PassIf(light2->GetLightType() == FCDLight::SPOT);
+	PassIf(light2->GetIntensity().IsAnimated());
+	PassIf(light2->GetIntensity().GetAnimated()->HasCurve());
+	PassIf(errorHandler.IsSuccessful());
+
+	// A lazy library is loaded by its first access, and released with its document if it never was.
+	FUObjectRef<FCDocument> document3 = FCollada::NewTopDocument();
+	options.SetAllModes(FCDLoadOptions::LAZY);
+	options.SetMode(FCDLoadOptions::VISUAL_SCENE, FCDLoadOptions::SKIP);
+	PassIf(FCollada::LoadDocumentFromFile(document3, FC("./TestLoadOptions.dae"), options));
+	PassIf(document3->GetVisualSceneInstance() == NULL);
+	PassIf(document3->GetCameraLibrary()->IsLoadDeferred());
+	PassIf(document3->GetLightLibrary()->IsLoadDeferred());
+	PassIf(document3->GetCameraLibrary()->GetEntityCount() == 1);
+	FailIf(document3->GetCameraLibrary()->IsLoadDeferred());
+	PassIf(document3->GetLightLibrary()->IsLoadDeferred());
+	document3 = NULL;
+	PassIf(errorHandler.IsSuccessful());
+
+TESTSUITE_TEST(4, RequestedEntities)
+	FUErrorSimpleHandler errorHandler;
+
+	// The requested entity names are kept in a hash set.
+	FCDLoadOptions options;
+	FailIf(options.HasRequestedEntities());
+	FailIf(options.IsEntityRequested("Anything"));
+	for (size_t i = 0; i < 100; ++i)
+	{
+		options.AddRequestedEntity(fm::string("Object") + FUStringConversion::ToString((uint32) i));
+	}
+	options.AddRequestedEntity("Object7");
+	PassIf(options.GetRequestedEntities().size() == 100);
+	PassIf(options.IsEntityRequested("Object0"));
+	PassIf(options.IsEntityRequested("Object99"));
+	FailIf(options.IsEntityRequested("Object100"));
+	FailIf(options.IsEntityRequested("Object"));
+	FCDLoadOptions optionsCopy = options;
+	PassIf(optionsCopy.IsEntityRequested("Object42"));
+
+	// Create a document with three meshes, one of them deformed by a skin controller.
+	FUObjectRef<FCDocument> document = FCollada::NewTopDocument();
+	FCDSceneNode* root = document->AddVisualScene();
+	const char* geometryNames[] = { "Wanted", "Unwanted", "SkinnedMesh" };
+	FCDGeometry* geometries[3];
+	for (size_t i = 0; i < 3; ++i)
+	{
+		geometries[i] = document->GetGeometryLibrary()->AddEntity();
+		geometries[i]->SetName(TO_FSTRING(geometryNames[i]));
+		FCDGeometrySource* source = geometries[i]->CreateMesh()->AddVertexSource(FUDaeGeometryInput::POSITION);
+		float positions[9] = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f };
+		source->SetData(FloatList(positions, 9), 3);
+		root->AddChildNode()->AddInstance(geometries[i]);
+	}
+	FCDController* controller = document->GetControllerLibrary()->AddEntity();
+	controller->SetName(FC("Skinned"));
+	controller->CreateSkinController()->SetTarget(geometries[2]);
+	root->AddChildNode()->AddInstance(controller);
+	FCollada::SaveDocument(document, FC("./TestRequestedEntities.dae"));
+
+	// Request one mesh and the controller: the skinned mesh is read in for the controller.
+	FCDLoadOptions requested;
+	requested.AddRequestedEntity("Wanted");
+	requested.AddRequestedEntity("Skinned");
+	FUObjectRef<FCDocument> document2 = FCollada::NewTopDocument();
+	PassIf(FCollada::LoadDocumentFromFile(document2, FC("./TestRequestedEntities.dae"), requested));
+	PassIf(errorHandler.IsSuccessful());
+	PassIf(document2->GetGeometryLibrary()->GetEntityCount() == 2);
+	PassIf(document2->GetControllerLibrary()->GetEntityCount() == 1);
+	FCDController* controller2 = document2->GetControllerLibrary()->GetEntity(0);
+	FailIf(controller2->GetBaseGeometry() == NULL);
+	PassIf(IsEquivalent(controller2->GetBaseGeometry()->GetName(), FC("SkinnedMesh")));
+	for (size_t i = 0; i < document2->GetGeometryLibrary()->GetEntityCount(); ++i)
+	{
+		FailIf(IsEquivalent(document2->GetGeometryLibrary()->GetEntity(i)->GetName(), FC("Unwanted")));
+	}
+
+	// The instance of the unwanted mesh is dropped with it.
+	FCDSceneNode* root2 = document2->GetVisualSceneInstance();
+	FailIf(root2 == NULL);
+	size_t instanceCount = 0;
+	for (size_t i = 0; i < root2->GetChildrenCount(); ++i)
+	{
+		FCDSceneNode* child = root2->GetChild(i);
+		for (size_t j = 0; j < child->GetInstanceCount(); ++j)
+		{
+			FailIf(child->GetInstance(j)->GetEntity() == NULL);
+			++instanceCount;
+		}
+	}
+	PassIf(instanceCount == 3);
+
+TESTSUITE_TEST(5, SnapshotCache)
+	FUErrorSimpleHandler errorHandler;
+
+	// Create a document with a mesh, holding values that do not round-trip through short decimal strings.
+	FUObjectRef<FCDocument> document = FCollada::NewTopDocument();
+	FCDGeometry* geometry = document->GetGeometryLibrary()->AddEntity();
+	geometry->SetName(FC("Cached"));
+	FCDGeometrySource* source = geometry->CreateMesh()->AddVertexSource(FUDaeGeometryInput::POSITION);
+	FloatList positions;
+	for (size_t i = 0; i < 300; ++i) positions.push_back((float) i / 7.0f - 1.0e-5f * (float) (i * i));
+	source->SetData(positions, 3);
+	document->AddVisualScene()->AddChildNode()->AddInstance(geometry);
+	FCollada::SaveDocument(document, FC("./TestSnapshot.dae"));
+	remove("./TestSnapshot.dae.fcsnap");
+
+	FCDLoadOptions options;
+	options.SetSnapshotCacheEnabled(true);
+
+	// The first load parses the document and writes out the snapshot.
+	FUError::AddErrorCallback(FUError::DEBUG_LEVEL, RecordLoadError);
+	loadedErrors.clear();
+	FUObjectRef<FCDocument> parsed = FCollada::NewTopDocument();
+	PassIf(FCollada::LoadDocumentFromFile(parsed, FC("./TestSnapshot.dae"), options));
+	PassIf(errorHandler.IsSuccessful());
+	PassIf(!HasRecord(loadedErrors, FUError::DEBUG_LEVEL, FUError::DEBUG_LOAD_FROM_SNAPSHOT));
+	FUFile snapshotFile(FC("./TestSnapshot.dae.fcsnap"), FUFile::READ);
+	PassIf(snapshotFile.IsOpen());
+	snapshotFile.Close();
+	FCDGeometrySource* parsedSource = parsed->GetGeometryLibrary()->GetEntity(0)->GetMesh()->GetSource(0);
+	PassIf(parsedSource->GetDataCount() == 300);
+
+	// The second load restores the document from the snapshot, with the same values.
+	// Also restore the geometries lazily, from copies of the snapshot nodes.
+	for (size_t pass = 0; pass < 2; ++pass)
+	{
+		FCDLoadOptions restoreOptions = options;
+		if (pass == 1) restoreOptions.SetMode(FCDLoadOptions::GEOMETRY, FCDLoadOptions::LAZY);
+		loadedErrors.clear();
+		FUObjectRef<FCDocument> restored = FCollada::NewTopDocument();
+		PassIf(FCollada::LoadDocumentFromFile(restored, FC("./TestSnapshot.dae"), restoreOptions));
+		PassIf(errorHandler.IsSuccessful());
+		PassIf(HasRecord(loadedErrors, FUError::DEBUG_LEVEL, FUError::DEBUG_LOAD_FROM_SNAPSHOT));
+		PassIf(restored->GetGeometryLibrary()->GetEntityCount() == 1);
+		FCDGeometry* restoredGeometry = restored->GetGeometryLibrary()->GetEntity(0);
+		PassIf(IsEquivalent(restoredGeometry->GetName(), FC("Cached")));
+		FCDGeometrySource* restoredSource = restoredGeometry->GetMesh()->GetSource(0);
+		PassIf(restoredSource->GetStride() == 3);
+		PassIf(restoredSource->GetDataCount() == parsedSource->GetDataCount());
+		PassIf(memcmp(restoredSource->GetData(), parsedSource->GetData(), 300 * sizeof(float)) == 0);
+		PassIf(restored->GetVisualSceneInstance()->GetChild(0)->GetInstanceCount() == 1);
+	}
+
+	// Modifying the document invalidates its snapshot.
+	positions[0] = 42.0f;
+	source->SetData(positions, 3);
+	FCollada::SaveDocument(document, FC("./TestSnapshot.dae"));
+	loadedErrors.clear();
+	FUObjectRef<FCDocument> modified = FCollada::NewTopDocument();
+	PassIf(FCollada::LoadDocumentFromFile(modified, FC("./TestSnapshot.dae"), options));
+	PassIf(!HasRecord(loadedErrors, FUError::DEBUG_LEVEL, FUError::DEBUG_LOAD_FROM_SNAPSHOT));
+	PassIf(IsEquivalent(modified->GetGeometryLibrary()->GetEntity(0)->GetMesh()->GetSource(0)->GetData()[0], 42.0f));
+
+	// The snapshot of the modified document replaced the previous one.
+	loadedErrors.clear();
+	FUObjectRef<FCDocument> restoredModified = FCollada::NewTopDocument();
+	PassIf(FCollada::LoadDocumentFromFile(restoredModified, FC("./TestSnapshot.dae"), options));
+	FUError::RemoveErrorCallback(FUError::DEBUG_LEVEL, RecordLoadError);
+	PassIf(HasRecord(loadedErrors, FUError::DEBUG_LEVEL, FUError::DEBUG_LOAD_FROM_SNAPSHOT));
+	PassIf(IsEquivalent(restoredModified->GetGeometryLibrary()->GetEntity(0)->GetMesh()->GetSource(0)->GetData()[0], 42.0f));
+
+TESTSUITE_TEST(6, StreamingSave)
+	FUErrorSimpleHandler errorHandler;
+
+	// Add a document with a content and an attribute that need escaping, on top of the samples.
+	FUObjectRef<FCDocument> escaped = FCollada::NewTopDocument();
+	FCDETechnique* technique = escaped->GetExtra()->AddType("ESCAPED")->AddTechnique("ESCAPED_TECHNIQUE");
+	FCDENode* parameter = technique->AddParameter("Escaped", FC("<A & \"B\">\r\n"));
+	parameter->AddAttribute("quotes", FC("'\"<&>\"'\t"));
+	escaped->AddVisualScene()->AddChildNode();
+	FCollada::SaveDocument(escaped, FC("./TestEscaped.dae"));
+
+	// The streaming writer and libxml must write out the exact same files.
+	static const fchar* filenames[] = { FC("./TestEscaped.dae"), FC("./TestOut.dae"), FC("./TestSphere.dae"), FC("./Eagle.DAE") };
+	bool wasStreaming = FCollada::GetStreamingSaveFlag();
+	for (size_t i = 0; i < sizeof(filenames) / sizeof(*filenames); ++i)
+	{
+		FUObjectRef<FCDocument> document = FCollada::NewTopDocument();
+		PassIf(FCollada::LoadDocumentFromFile(document, filenames[i]));
+
+		FCollada::SetStreamingSaveFlag(true);
+		PassIf(FCollada::SaveDocument(document, FC("./TestStreamed.dae")));
+		FCollada::SetStreamingSaveFlag(false);
+		PassIf(FCollada::SaveDocument(document, FC("./TestNotStreamed.dae")));
+
+		FUFile streamedFile(FC("./TestStreamed.dae"), FUFile::READ);
+		FUFile referenceFile(FC("./TestNotStreamed.dae"), FUFile::READ);
+		size_t length = streamedFile.GetLength();
+		PassIf(length > 0 && length == referenceFile.GetLength());
+		uint8* streamed = new uint8[length];
+		uint8* reference = new uint8[length];
+		PassIf(streamedFile.Read(streamed, length) && referenceFile.Read(reference, length));
+		bool isSame = memcmp(streamed, reference, length) == 0;
+		SAFE_DELETE_ARRAY(streamed);
+		SAFE_DELETE_ARRAY(reference);
+		PassIf(isSame);
+	}
+	FCollada::SetStreamingSaveFlag(wasStreaming);
+
+TESTSUITE_TEST(7, FastValidation)
+	// The validation of valid documents records the same errors as their full load.
+	static const fchar* filenames[] = { FC("./TestSphere.dae"), FC("./Eagle.DAE") };
+	for (size_t i = 0; i < sizeof(filenames) / sizeof(*filenames); ++i)
+	{
+		loadedErrors.clear();
+		FUError::AddErrorCallback(FUError::DEBUG_LEVEL, RecordLoadError);
+		FUError::AddErrorCallback(FUError::WARNING_LEVEL, RecordLoadError);
+		FUError::AddErrorCallback(FUError::ERROR_LEVEL, RecordLoadError);
+		FUObjectRef<FCDocument> document = FCollada::NewTopDocument();
+		bool isLoaded = FCollada::LoadDocumentFromFile(document, filenames[i]);
+		FUError::RemoveErrorCallback(FUError::DEBUG_LEVEL, RecordLoadError);
+		FUError::RemoveErrorCallback(FUError::WARNING_LEVEL, RecordLoadError);
+		FUError::RemoveErrorCallback(FUError::ERROR_LEVEL, RecordLoadError);
+		PassIf(isLoaded);
+
+		FUError::RecordList errors;
+		PassIf(FCollada::ValidateDocumentFromFile(filenames[i], errors));
+		PassIf(errors.size() == loadedErrors.size());
+		for (size_t j = 0; j < errors.size(); ++j)
+		{
+			PassIf(errors[j].level == loadedErrors[j].level);
+			PassIf(errors[j].code == loadedErrors[j].code);
+			PassIf(errors[j].line == loadedErrors[j].line);
+		}
+	}
+
+	// The validation also checks the accessor counts and the polygon indices.
+	static const char* invalidDocument =
+		"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+		"<COLLADA xmlns=\"http://www.collada.org/2005/11/COLLADASchema\" version=\"1.4.1\">\n"
+		"<library_geometries><geometry id=\"Invalid\"><mesh>\n"
+		"<source id=\"Positions\"><float_array id=\"Positions-array\" count=\"6\">0 0 0 1 0 0</float_array>\n"
+		"<technique_common><accessor source=\"#Positions-array\" count=\"3\" stride=\"3\"/></technique_common></source>\n"
+		"<vertices id=\"Vertices\"><input semantic=\"POSITION\" source=\"#Positions\"/></vertices>\n"
+		"<triangles material=\"Material\" count=\"1\"><input semantic=\"VERTEX\" source=\"#Vertices\" offset=\"0\"/><p>0 1 5</p></triangles>\n"
+		"</mesh></geometry></library_geometries>\n"
+		"<library_visual_scenes><visual_scene id=\"Scene\"><node id=\"Node\"><instance_geometry url=\"#Missing\"/></node></visual_scene></library_visual_scenes>\n"
+		"<scene><instance_visual_scene url=\"#Scene\"/></scene>\n"
+		"</COLLADA>\n";
+	FUFile invalidFile(FC("./TestValidation.dae"), FUFile::WRITE);
+	PassIf(invalidFile.Write(invalidDocument, strlen(invalidDocument)));
+	invalidFile.Close();
+	FUError::RecordList errors;
+	PassIf(!FCollada::ValidateDocumentFromFile(FC("./TestValidation.dae"), errors));
+	PassIf(HasRecord(errors, FUError::WARNING_LEVEL, FUError::WARNING_INVALID_ACCESSOR_COUNT));
+	PassIf(HasRecord(errors, FUError::ERROR_LEVEL, FUError::ERROR_INVALID_POLYGON_INDEX));
+	PassIf(HasRecord(errors, FUError::WARNING_LEVEL, FUError::WARNING_INST_ENTITY_MISSING));
+	PassIf(!HasRecord(errors, FUError::DEBUG_LEVEL, FUError::DEBUG_LOAD_SUCCESSFUL));
+
+	// Input offsets far beyond the number of inputs are rejected, without allocating their index bounds.
+	static const char* invalidOffsetDocument =
+		"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+		"<COLLADA xmlns=\"http://www.collada.org/2005/11/COLLADASchema\" version=\"1.4.1\">\n"
+		"<library_geometries><geometry id=\"Invalid\"><mesh>\n"
+		"<source id=\"Positions\"><float_array id=\"Positions-array\" count=\"9\">0 0 0 1 0 0 0 1 0</float_array>\n"
+		"<technique_common><accessor source=\"#Positions-array\" count=\"3\" stride=\"3\"/></technique_common></source>\n"
+		"<vertices id=\"Vertices\"><input semantic=\"POSITION\" source=\"#Positions\"/></vertices>\n"
+		"<triangles material=\"Material\" count=\"1\"><input semantic=\"VERTEX\" source=\"#Vertices\" offset=\"0\"/>"
+		"<input semantic=\"NORMAL\" source=\"#Positions\" offset=\"4294967295\"/><p>0 0 1 1 2 2</p></triangles>\n"
+		"</mesh></geometry></library_geometries>\n"
+		"</COLLADA>\n";
+	FUFile invalidOffsetFile(FC("./TestValidation.dae"), FUFile::WRITE);
+	PassIf(invalidOffsetFile.Write(invalidOffsetDocument, strlen(invalidOffsetDocument)));
+	invalidOffsetFile.Close();
+	errors.clear();
+	PassIf(!FCollada::ValidateDocumentFromFile(FC("./TestValidation.dae"), errors));
+	PassIf(HasRecord(errors, FUError::ERROR_LEVEL, FUError::ERROR_INVALID_INPUT_OFFSET));
+	PassIf(!HasRecord(errors, FUError::ERROR_LEVEL, FUError::ERROR_NO_VERTEX_INPUT));
+
+	// Malformed documents are only reported as such.
+	static const char* malformedDocument = "<COLLADA><library_geometries></COLLADA>";
+	FUFile malformedFile(FC("./TestValidation.dae"), FUFile::WRITE);
+	PassIf(malformedFile.Write(malformedDocument, strlen(malformedDocument)));
+	malformedFile.Close();
+	errors.clear();
+	PassIf(!FCollada::ValidateDocumentFromFile(FC("./TestValidation.dae"), errors));
+	PassIf(errors.size() == 1 && errors[0].code == FUError::ERROR_MALFORMED_XML);
+
+TESTSUITE_TEST(8, ParallelConversion)
+	// The arrays converted ahead of time, on the worker threads, must read in as when converted by their entities.
+	FCDLoadOptions serialOptions;
+	serialOptions.SetParallelConversionThreshold(~(size_t) 0);
+	FCDLoadOptions parallelOptions;
+	parallelOptions.SetParallelConversionThreshold(0);
+
+	static const fchar* filenames[] = { FC("./TestOut.dae"), FC("./TestSphere.dae"), FC("./Eagle.DAE") };
+	for (size_t i = 0; i < sizeof(filenames) / sizeof(*filenames); ++i)
+	{
+		FUObjectRef<FCDocument> serial = FCollada::NewTopDocument();
+		PassIf(FCollada::LoadDocumentFromFile(serial, filenames[i], serialOptions));
+		FUObjectRef<FCDocument> parallel = FCollada::NewTopDocument();
+		PassIf(FCollada::LoadDocumentFromFile(parallel, filenames[i], parallelOptions));
+		PassIf(IsSameNumericData(fileOut, serial, parallel));
+	}
+
 TESTSUITE_END
@@ -203,5 +203,39 @@ TESTSUITE_TEST(2, ReduceInfluence_Bulvan)
 		default: FUFail("");
 		}
 	}
-	
+
+TESTSUITE_TEST(3, PackedInfluences)
+
+	// Create the COLLADA skin controller.
+	FUObjectRef<FCDocument> document = FCollada::NewTopDocument();
+	FCDController* testController = document->GetControllerLibrary()->AddEntity();
+	FCDSkinController* skinController = testController->CreateSkinController();
+	skinController->AddJoint("Test1");
+	skinController->AddJoint("Test2");
+	skinController->AddJoint("Test3");
+
+	// Create three vertices: the second one has no influences.
+	skinController->SetInfluenceCount(3);
+	skinController->GetVertexInfluence(0)->AddPair(0, 0.25f);
+	skinController->GetVertexInfluence(0)->AddPair(2, 0.75f);
+	skinController->GetVertexInfluence(2)->AddPair(1, 0.5f);
+	skinController->GetVertexInfluence(2)->AddPair(-1, 0.25f);
+	skinController->GetVertexInfluence(2)->AddPair(0, 0.25f);
+	PassIf(skinController->GetTotalPairCount() == 5);
+
+	// Pack the influences and verify the compressed rows.
+	static const uint32 expectedOffsets[4] = { 0, 2, 2, 5 };
+	static const int32 expectedJointIndices[5] = { 0, 2, 1, -1, 0 };
+	static const float expectedWeights[5] = { 0.25f, 0.75f, 0.5f, 0.25f, 0.25f };
+	UInt32List offsets(skinController->GetInfluenceCount() + 1, 0);
+	Int32List jointIndices(skinController->GetTotalPairCount(), 0);
+	FloatList weights(skinController->GetTotalPairCount(), 0.0f);
+	skinController->GetPackedInfluences(offsets.begin(), jointIndices.begin(), weights.begin());
+	for (size_t i = 0; i < 4; ++i) PassIf(offsets[i] == expectedOffsets[i]);
+	for (size_t i = 0; i < 5; ++i)
+	{
+		PassIf(jointIndices[i] == expectedJointIndices[i]);
+		PassIf(weights[i] == expectedWeights[i]);
+	}
+
 TESTSUITE_END
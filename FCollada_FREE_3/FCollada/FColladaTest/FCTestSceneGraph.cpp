@@ -8,6 +8,8 @@
 
 #include "StdAfx.h"
 #include "FCDocument/FCDocument.h"
+#include "FCDocument/FCDGeometry.h"
+#include "FCDocument/FCDLibrary.h"
 #include "FCDocument/FCDSceneNode.h"
 #include "FCDocument/FCDSceneNodeIterator.h"
 
@@ -76,5 +78,84 @@ TESTSUITE_TEST(0, Iterator)
 	++it4;
 	PassIf(it4.IsDone());
 
+TESTSUITE_TEST(1, IdIndex)
+	FUObjectRef<FCDocument> doc = FCollada::NewTopDocument();
+	FCDSceneNode* top = doc->AddVisualScene();
+	top->SetDaeId("scene");
+	FCDSceneNode* child = top->AddChildNode();
+	child->SetDaeId("child");
+	FCDGeometry* geometry = doc->GetGeometryLibrary()->AddEntity();
+	geometry->SetDaeId("mesh");
+
+	// Check the lookups of explicitly set ids.
+	PassIf(doc->FindObjectWithId("child") == child);
+	PassIf(doc->FindSceneNode("child") == child);
+	PassIf(doc->FindVisualScene("scene") == top);
+	PassIf(doc->FindEntity("child") == child);
+	PassIf(doc->FindGeometry("mesh") == geometry);
+	PassIf(doc->FindEntity("mesh") == geometry);
+	PassIf(doc->FindGeometry("child") == NULL);
+	PassIf(doc->FindSceneNode("mesh") == NULL);
+	PassIf(doc->FindEntity("unknown") == NULL);
+
+	// Ids generated on demand must also be found.
+	FCDGeometry* generated = doc->GetGeometryLibrary()->AddEntity();
+	PassIf(doc->FindGeometry(generated->GetDaeId()) == generated);
+	PassIf(doc->FindObjectWithId(generated->GetDaeId()) == generated);
+
+	// Renaming an object must move it within the index.
+	child->SetDaeId("renamed");
+	PassIf(doc->FindSceneNode("child") == NULL);
+	PassIf(doc->FindSceneNode("renamed") == child);
+	fm::string duplicate = "mesh";
+	child->SetDaeId(duplicate);
+	PassIf(duplicate != "mesh");
+	PassIf(doc->FindSceneNode(duplicate.c_str()) == child);
+	PassIf(doc->FindGeometry("mesh") == geometry);
+
+	// Many ids, to exercise the index beyond a handful of entries.
+	fm::pvector<FCDSceneNode> nodes;
+	for (size_t i = 0; i < 256; ++i)
+	{
+		FCDSceneNode* node = child->AddChildNode();
+		node->SetDaeId(fm::string("node") + TO_STRING((uint32) i));
+		nodes.push_back(node);
+	}
+	for (size_t i = 0; i < 256; ++i)
+	{
+		PassIf(doc->FindSceneNode((fm::string("node") + TO_STRING((uint32) i)).c_str()) == nodes[i]);
+	}
+
+	// Sub-tree lookups only find the nodes below the searched node.
+	PassIf(top->FindDaeId("node42") == nodes[42]);
+	PassIf(child->FindDaeId("node42") == nodes[42]);
+	PassIf(nodes[42]->FindDaeId("node42") == nodes[42]);
+	PassIf(nodes[41]->FindDaeId("node42") == NULL);
+	PassIf(child->FindDaeId("scene") == NULL);
+	PassIf(top->FindDaeId("unknown") == NULL);
+	nodes[41]->AddChildNode(nodes[42]);
+	PassIf(nodes[41]->FindDaeId("node42") == nodes[42]);
+	FCDSceneNode* unnamed = nodes[43]->AddChildNode();
+	PassIf(nodes[43]->FindDaeId(unnamed->GetDaeId()) == unnamed);
+	PassIf(nodes[44]->FindDaeId(unnamed->GetDaeId()) == NULL);
+
+	// Released objects must leave the index.
+	fm::string releasedId = nodes[17]->GetDaeId();
+	nodes[17]->Release();
+	PassIf(doc->FindObjectWithId(releasedId) == NULL);
+	PassIf(doc->FindSceneNode(releasedId.c_str()) == NULL);
+	geometry->Release();
+	PassIf(doc->FindGeometry("mesh") == NULL);
+	PassIf(doc->FindSceneNode("node18") == nodes[18]);
+
+	// Releasing many objects must leave the other ones reachable.
+	for (size_t i = 0; i < 256; i += 3) nodes[i]->Release();
+	for (size_t i = 0; i < 256; ++i)
+	{
+		if (i == 17) continue;
+		FCDSceneNode* found = doc->FindSceneNode((fm::string("node") + TO_STRING((uint32) i)).c_str());
+		PassIf(found == ((i % 3 == 0) ? NULL : nodes[i]));
+	}
+
 TESTSUITE_END
 
@@ -10,6 +10,90 @@
 #include "FMMatrix44.h"
 #include <limits>
 
+#if (defined(__SSE__) || defined(_M_X64)) && !defined(FM_NO_SSE)
+#define FM_MATRIX44_SSE
+#include <xmmintrin.h>
+
+// The rows are loaded whole. Unaligned loads are as fast as aligned ones
+// on aligned data, and also handle the platforms without ALIGN_STRUCT.
+#define LOAD_ROW(mx, row) _mm_loadu_ps((mx).m[row])
+#define STORE_ROW(mx, row, v) _mm_storeu_ps((mx).m[row], v)
+
+// [a[i], a[j], b[k], b[l]]
+#define SHUFFLE(a, b, i, j, k, l) _mm_shuffle_ps(a, b, _MM_SHUFFLE(l, k, j, i))
+#define SWIZZLE(a, i, j, k, l) SHUFFLE(a, a, i, j, k, l)
+
+// Weights the four rows and sums them up in the same order as the scalar
+// code, so that both give the same results.
+static inline __m128 CombineRows(const __m128* rows, __m128 v)
+{
+	__m128 result = _mm_mul_ps(rows[0], SWIZZLE(v, 0, 0, 0, 0));
+	result = _mm_add_ps(result, _mm_mul_ps(rows[1], SWIZZLE(v, 1, 1, 1, 1)));
+	result = _mm_add_ps(result, _mm_mul_ps(rows[2], SWIZZLE(v, 2, 2, 2, 2)));
+	return _mm_add_ps(result, _mm_mul_ps(rows[3], SWIZZLE(v, 3, 3, 3, 3)));
+}
+
+static inline __m128 CombineRows3(const __m128* rows, __m128 v)
+{
+	__m128 result = _mm_mul_ps(rows[0], SWIZZLE(v, 0, 0, 0, 0));
+	result = _mm_add_ps(result, _mm_mul_ps(rows[1], SWIZZLE(v, 1, 1, 1, 1)));
+	return _mm_add_ps(result, _mm_mul_ps(rows[2], SWIZZLE(v, 2, 2, 2, 2)));
+}
+
+// Products of 2x2 matrices, each held in a register as [m00, m01, m10, m11].
+static inline __m128 Mat2Mul(__m128 a, __m128 b) // a * b
+{
+	return _mm_add_ps(_mm_mul_ps(a, SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(SWIZZLE(a, 1, 0, 3, 2), SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+static inline __m128 Mat2AdjMul(__m128 a, __m128 b) // adjugate(a) * b
+{
+	return _mm_sub_ps(_mm_mul_ps(SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(SWIZZLE(a, 1, 1, 2, 2), SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+static inline __m128 Mat2MulAdj(__m128 a, __m128 b) // a * adjugate(b)
+{
+	return _mm_sub_ps(_mm_mul_ps(a, SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(SWIZZLE(a, 1, 0, 3, 2), SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// Splits the matrix in the 2x2 blocks [A B, C D] and computes the
+// determinant from them: |A||D| + |B||C| - tr(adj(A) B adj(D) C).
+struct Matrix44Blocks
+{
+	__m128 A, B, C, D;
+	__m128 detA, detB, detC, detD;
+	__m128 AB, DC; // adj(A) * B, adj(D) * C
+	__m128 det;
+};
+
+static inline void ComputeBlocks(const FMMatrix44& mx, Matrix44Blocks& blocks)
+{
+	__m128 row0 = LOAD_ROW(mx, 0), row1 = LOAD_ROW(mx, 1), row2 = LOAD_ROW(mx, 2), row3 = LOAD_ROW(mx, 3);
+
+	blocks.A = SHUFFLE(row0, row1, 0, 1, 0, 1);
+	blocks.B = SHUFFLE(row0, row1, 2, 3, 2, 3);
+	blocks.C = SHUFFLE(row2, row3, 0, 1, 0, 1);
+	blocks.D = SHUFFLE(row2, row3, 2, 3, 2, 3);
+
+	// The four block determinants at once.
+	__m128 detSub = _mm_sub_ps(_mm_mul_ps(SHUFFLE(row0, row2, 0, 2, 0, 2), SHUFFLE(row1, row3, 1, 3, 1, 3)),
+		_mm_mul_ps(SHUFFLE(row0, row2, 1, 3, 1, 3), SHUFFLE(row1, row3, 0, 2, 0, 2)));
+	blocks.detA = SWIZZLE(detSub, 0, 0, 0, 0);
+	blocks.detB = SWIZZLE(detSub, 1, 1, 1, 1);
+	blocks.detC = SWIZZLE(detSub, 2, 2, 2, 2);
+	blocks.detD = SWIZZLE(detSub, 3, 3, 3, 3);
+
+	blocks.AB = Mat2AdjMul(blocks.A, blocks.B);
+	blocks.DC = Mat2AdjMul(blocks.D, blocks.C);
+
+	__m128 trace = _mm_mul_ps(blocks.AB, SWIZZLE(blocks.DC, 0, 2, 1, 3));
+	trace = _mm_add_ps(trace, SWIZZLE(trace, 2, 3, 0, 1));
+	trace = _mm_add_ps(trace, SWIZZLE(trace, 1, 0, 3, 2));
+
+	blocks.det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(blocks.detA, blocks.detD), _mm_mul_ps(blocks.detB, blocks.detC)), trace);
+}
+#endif // FM_MATRIX44_SSE
+
 static float __identity[] = { 1, 0, 0, 0, 0, 1, 0 ,0 ,0, 0, 1, 0, 0, 0, 0, 1 };
 FMMatrix44 FMMatrix44::Identity(__identity);
 
@@ -61,30 +145,80 @@ FMMatrix44 FMMatrix44::Transposed() const
 
 FMVector3 FMMatrix44::TransformCoordinate(const FMVector3& coordinate) const
 {
+#ifdef FM_MATRIX44_SSE
+	__m128 rows[4] = { LOAD_ROW(*this, 0), LOAD_ROW(*this, 1), LOAD_ROW(*this, 2), LOAD_ROW(*this, 3) };
+	__m128 result = _mm_add_ps(CombineRows3(rows, _mm_setr_ps(coordinate.x, coordinate.y, coordinate.z, 0.0f)), rows[3]);
+
+	FMVector4 v; _mm_storeu_ps(&v.x, result);
+	return FMVector3(v.x, v.y, v.z);
+#else // FM_MATRIX44_SSE
 	return FMVector3(
 		m[0][0] * coordinate.x + m[1][0] * coordinate.y + m[2][0] * coordinate.z + m[3][0],
 		m[0][1] * coordinate.x + m[1][1] * coordinate.y + m[2][1] * coordinate.z + m[3][1],
 		m[0][2] * coordinate.x + m[1][2] * coordinate.y + m[2][2] * coordinate.z + m[3][2]
 	);
+#endif // FM_MATRIX44_SSE
 }
 
 FMVector4 FMMatrix44::TransformCoordinate(const FMVector4& coordinate) const
 {
-	return FMVector4(
-		m[0][0] * coordinate.x + m[1][0] * coordinate.y + m[2][0] * coordinate.z + m[3][0] * coordinate.w,
-		m[0][1] * coordinate.x + m[1][1] * coordinate.y + m[2][1] * coordinate.z + m[3][1] * coordinate.w,
-		m[0][2] * coordinate.x + m[1][2] * coordinate.y + m[2][2] * coordinate.z + m[3][2] * coordinate.w,
-		m[0][3] * coordinate.x + m[1][3] * coordinate.y + m[2][3] * coordinate.z + m[3][3] * coordinate.w
-	);
+	return (*this) * coordinate;
 }
 
 FMVector3 FMMatrix44::TransformVector(const FMVector3& v) const
 {
+#ifdef FM_MATRIX44_SSE
+	__m128 rows[3] = { LOAD_ROW(*this, 0), LOAD_ROW(*this, 1), LOAD_ROW(*this, 2) };
+	__m128 result = CombineRows3(rows, _mm_setr_ps(v.x, v.y, v.z, 0.0f));
+
+	FMVector4 out; _mm_storeu_ps(&out.x, result);
+	return FMVector3(out.x, out.y, out.z);
+#else // FM_MATRIX44_SSE
 	return FMVector3(
 		m[0][0] * v.x + m[1][0] * v.y + m[2][0] * v.z,
 		m[0][1] * v.x + m[1][1] * v.y + m[2][1] * v.z,
 		m[0][2] * v.x + m[1][2] * v.y + m[2][2] * v.z
 	);
+#endif // FM_MATRIX44_SSE
+}
+
+void FMMatrix44::TransformCoordinates(const FMVector3* coordinates, FMVector3* out, size_t count) const
+{
+#ifdef FM_MATRIX44_SSE
+	__m128 rows[4] = { LOAD_ROW(*this, 0), LOAD_ROW(*this, 1), LOAD_ROW(*this, 2), LOAD_ROW(*this, 3) };
+
+	// FMVector3 is padded to four floats: the padding is read and
+	// overwritten along with the coordinates.
+	for (size_t i = 0; i < count; ++i)
+	{
+		__m128 result = _mm_add_ps(CombineRows3(rows, _mm_loadu_ps(&coordinates[i].x)), rows[3]);
+		_mm_storeu_ps(&out[i].x, result);
+	}
+#else // FM_MATRIX44_SSE
+	for (size_t i = 0; i < count; ++i)
+	{
+		FMVector3 v = TransformCoordinate(coordinates[i]);
+		out[i].x = v.x; out[i].y = v.y; out[i].z = v.z;
+	}
+#endif // FM_MATRIX44_SSE
+}
+
+void FMMatrix44::TransformVectors(const FMVector3* vectors, FMVector3* out, size_t count) const
+{
+#ifdef FM_MATRIX44_SSE
+	__m128 rows[3] = { LOAD_ROW(*this, 0), LOAD_ROW(*this, 1), LOAD_ROW(*this, 2) };
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		_mm_storeu_ps(&out[i].x, CombineRows3(rows, _mm_loadu_ps(&vectors[i].x)));
+	}
+#else // FM_MATRIX44_SSE
+	for (size_t i = 0; i < count; ++i)
+	{
+		FMVector3 v = TransformVector(vectors[i]);
+		out[i].x = v.x; out[i].y = v.y; out[i].z = v.z;
+	}
+#endif // FM_MATRIX44_SSE
 }
 /*
 void FMMatrix44::SetTranslation(const FMVector3& translation)
@@ -184,6 +318,45 @@ static float det3x3(float a1, float a2, float a3, float b1, float b2, float b3,
 // Returns the inverse of this matrix
 FMMatrix44 FMMatrix44::Inverted() const
 {
+#ifdef FM_MATRIX44_SSE
+	// Inverse of the 2x2 blocks: [A B, C D]^-1 = 1/|M| [X Y, Z W], with
+	// X = |D|A - B(adj(D)C), W = |A|D - C(adj(A)B),
+	// Y = |B|C - D adj(adj(A)B), Z = |C|B - A adj(adj(D)C).
+	Matrix44Blocks blocks;
+	ComputeBlocks(*this, blocks);
+
+	__m128 X = _mm_sub_ps(_mm_mul_ps(blocks.detD, blocks.A), Mat2Mul(blocks.B, blocks.DC));
+	__m128 W = _mm_sub_ps(_mm_mul_ps(blocks.detA, blocks.D), Mat2Mul(blocks.C, blocks.AB));
+	__m128 Y = _mm_sub_ps(_mm_mul_ps(blocks.detB, blocks.C), Mat2MulAdj(blocks.D, blocks.AB));
+	__m128 Z = _mm_sub_ps(_mm_mul_ps(blocks.detC, blocks.B), Mat2MulAdj(blocks.A, blocks.DC));
+
+	// Same handling of the singular matrices as the scalar version.
+	double det = _mm_cvtss_f32(blocks.det);
+	double epsilon = std::numeric_limits<double>::epsilon();
+	if (det + epsilon >= 0.0f && det - epsilon <= 0.0f) det = FMath::Sign(det) * 0.0001f;
+	float oodet = (float) (1.0 / det);
+
+	// The adjugates of the blocks come out with these signs.
+	__m128 scale = _mm_mul_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), _mm_set1_ps(oodet));
+	X = _mm_mul_ps(X, scale);
+	Y = _mm_mul_ps(Y, scale);
+	Z = _mm_mul_ps(Z, scale);
+	W = _mm_mul_ps(W, scale);
+
+	FMMatrix44 b;
+	STORE_ROW(b, 0, SHUFFLE(X, Y, 3, 1, 3, 1));
+	STORE_ROW(b, 1, SHUFFLE(X, Y, 2, 0, 2, 0));
+	STORE_ROW(b, 2, SHUFFLE(Z, W, 3, 1, 3, 1));
+	STORE_ROW(b, 3, SHUFFLE(Z, W, 2, 0, 2, 0));
+	return b;
+#else // FM_MATRIX44_SSE
+	return FMath::ScalarInverse(*this);
+#endif // FM_MATRIX44_SSE
+}
+
+FMMatrix44 FMath::ScalarInverse(const FMMatrix44& matrix)
+{
+	const float (*m)[4] = matrix.m;
 	FMMatrix44 b;
 
 	b.m[0][0] =  det3x3(m[1][1], m[1][2], m[1][3], m[2][1], m[2][2], m[2][3], m[3][1], m[3][2], m[3][3]);
@@ -237,6 +410,18 @@ FMMatrix44 FMMatrix44::Inverted() const
 
 float FMMatrix44::Determinant() const
 {
+#ifdef FM_MATRIX44_SSE
+	Matrix44Blocks blocks;
+	ComputeBlocks(*this, blocks);
+	return _mm_cvtss_f32(blocks.det);
+#else // FM_MATRIX44_SSE
+	return FMath::ScalarDeterminant(*this);
+#endif // FM_MATRIX44_SSE
+}
+
+float FMath::ScalarDeterminant(const FMMatrix44& matrix)
+{
+	const float (*m)[4] = matrix.m;
 	float cofactor0 = det3x3(m[1][1], m[1][2], m[1][3], m[2][1], m[2][2], 
 							 m[2][3], m[3][1], m[3][2], m[3][3]);
 	float cofactor1 = -det3x3(m[0][1], m[0][2], m[0][3], m[2][1], m[2][2], 
@@ -250,6 +435,22 @@ float FMMatrix44::Determinant() const
 }
 
 FMMatrix44 operator*(const FMMatrix44& m1, const FMMatrix44& m2)
+{
+#ifdef FM_MATRIX44_SSE
+	__m128 rows[4] = { LOAD_ROW(m1, 0), LOAD_ROW(m1, 1), LOAD_ROW(m1, 2), LOAD_ROW(m1, 3) };
+
+	FMMatrix44 mx;
+	STORE_ROW(mx, 0, CombineRows(rows, LOAD_ROW(m2, 0)));
+	STORE_ROW(mx, 1, CombineRows(rows, LOAD_ROW(m2, 1)));
+	STORE_ROW(mx, 2, CombineRows(rows, LOAD_ROW(m2, 2)));
+	STORE_ROW(mx, 3, CombineRows(rows, LOAD_ROW(m2, 3)));
+	return mx;
+#else // FM_MATRIX44_SSE
+	return FMath::ScalarMultiply(m1, m2);
+#endif // FM_MATRIX44_SSE
+}
+
+FMMatrix44 FMath::ScalarMultiply(const FMMatrix44& m1, const FMMatrix44& m2)
 {
     FMMatrix44 mx;
     mx.m[0][0] = m1.m[0][0] * m2.m[0][0] + m1.m[1][0] * m2.m[0][1] + m1.m[2][0] * m2.m[0][2] + m1.m[3][0] * m2.m[0][3];
@@ -272,6 +473,19 @@ FMMatrix44 operator*(const FMMatrix44& m1, const FMMatrix44& m2)
 }
 
 FMVector4 operator*(const FMMatrix44& m, const FMVector4& v)
+{
+#ifdef FM_MATRIX44_SSE
+	__m128 rows[4] = { LOAD_ROW(m, 0), LOAD_ROW(m, 1), LOAD_ROW(m, 2), LOAD_ROW(m, 3) };
+
+	FMVector4 out;
+	_mm_storeu_ps(&out.x, CombineRows(rows, _mm_loadu_ps(&v.x)));
+	return out;
+#else // FM_MATRIX44_SSE
+	return FMath::ScalarTransform(m, v);
+#endif // FM_MATRIX44_SSE
+}
+
+FMVector4 FMath::ScalarTransform(const FMMatrix44& m, const FMVector4& v)
 {
 	float x = m[0][0] * v.x + m[1][0] * v.y + m[2][0] * v.z + m[3][0] * v.w;
 	float y = m[0][1] * v.x + m[1][1] * v.y + m[2][1] * v.z + m[3][1] * v.w;
@@ -17,6 +17,10 @@
 /**
 	A 4x4 Row Major matrix: use to represent 3D transformations.
 
+	The matrix is aligned on 16 bytes where ALIGN_STRUCT is supported, so
+	that each row fits a SSE register. The multiplications, the inverse
+	and the transforms use SSE when it is available.
+
 	@ingroup FMath
 */
 class FCOLLADA_EXPORT
@@ -121,6 +125,29 @@ public:
 		@return The FMVector3 representation of the transformed vector. */
 	FMVector3 TransformVector(const FMVector3& v) const;
 
+	/** Transforms a list of points by this matrix.
+		@param coordinates The points to transform.
+		@param out The transformed points. It may be the same list as
+			\a coordinates, to transform the points in-place.
+		@param count The number of points to transform. */
+	void TransformCoordinates(const FMVector3* coordinates, FMVector3* out, size_t count) const;
+
+	/** Transforms, in-place, a list of points by this matrix.
+		@param coordinates The points to transform. */
+	inline void TransformCoordinates(FMVector3List& coordinates) const { TransformCoordinates(coordinates.begin(), coordinates.begin(), coordinates.size()); }
+
+	/** Transforms a list of vectors by this matrix.
+		The translation of the matrix is not applied.
+		@param vectors The vectors to transform.
+		@param out The transformed vectors. It may be the same list as
+			\a vectors, to transform the vectors in-place.
+		@param count The number of vectors to transform. */
+	void TransformVectors(const FMVector3* vectors, FMVector3* out, size_t count) const;
+
+	/** Transforms, in-place, a list of vectors by this matrix.
+		@param vectors The vectors to transform. */
+	inline void TransformVectors(FMVector3List& vectors) const { TransformVectors(vectors.begin(), vectors.begin(), vectors.size()); }
+
 	/** Gets the translation component of this matrix.
 		@return A Reference to the FMVector3 representation of the translation. */
 	inline const FMVector3& GetTranslation() const { return GetAxis(FMath::TRANS); }
@@ -231,4 +258,15 @@ inline FMMatrix44& operator*=(FMMatrix44& m1, const FMMatrix44& m2) { return m1
 /** A dynamically-sized array of 4x4 matrices. */
 typedef fm::vector<FMMatrix44> FMMatrix44List;
 
+namespace FMath
+{
+	/** The portable implementations of the matrix operations.
+		The FMMatrix44 operations use SSE when it is available: these are
+		kept to check and to time them against. */
+	FMMatrix44 FCOLLADA_EXPORT ScalarMultiply(const FMMatrix44& m1, const FMMatrix44& m2); /**< See operator*. */
+	FMVector4 FCOLLADA_EXPORT ScalarTransform(const FMMatrix44& m, const FMVector4& v); /**< See operator*. */
+	FMMatrix44 FCOLLADA_EXPORT ScalarInverse(const FMMatrix44& m); /**< See FMMatrix44::Inverted. */
+	float FCOLLADA_EXPORT ScalarDeterminant(const FMMatrix44& m); /**< See FMMatrix44::Determinant. */
+};
+
 #endif // _FM_MATRIX44_H_
@@ -0,0 +1,111 @@
+/*
+	Copyright (C) 2005-2007 Feeling Software Inc.
+	Portions of the code are:
+	Copyright (C) 2005-2007 Sony Computer Entertainment America
+	
+	MIT License: http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "StdAfx.h"
+#include "FMMatrix44.h"
+#include "FMRandom.h"
+#include "FUtils/FUTestBed.h"
+
+//
+// The SSE matrix operations are checked against the portable ones.
+//
+
+static FMMatrix44 RandomTransform()
+{
+	FMVector3 scale(FMRandom::GetFloat(0.5f, 2.0f), FMRandom::GetFloat(0.5f, 2.0f), FMRandom::GetFloat(0.5f, 2.0f));
+	FMVector3 rotation(FMRandom::GetFloat(-3.0f, 3.0f), FMRandom::GetFloat(-3.0f, 3.0f), FMRandom::GetFloat(-3.0f, 3.0f));
+	FMVector3 translation(FMRandom::GetFloat(-5.0f, 5.0f), FMRandom::GetFloat(-5.0f, 5.0f), FMRandom::GetFloat(-5.0f, 5.0f));
+
+	FMMatrix44 mx;
+	mx.Recompose(scale, rotation, translation);
+	return mx;
+}
+
+TESTSUITE_START(FMMatrix44)
+
+TESTSUITE_TEST(0, Multiplication)
+	for (size_t i = 0; i < 64; ++i)
+	{
+		FMMatrix44 m1 = RandomTransform(), m2 = RandomTransform();
+		m2[0][3] = FMRandom::GetFloat(-0.1f, 0.1f);
+		PassIf(IsEquivalent(m1 * m2, FMath::ScalarMultiply(m1, m2)));
+
+		FMVector4 v(FMRandom::GetFloat(-10.0f, 10.0f), FMRandom::GetFloat(-10.0f, 10.0f), FMRandom::GetFloat(-10.0f, 10.0f), 1.0f);
+		FMVector4 expected = FMath::ScalarTransform(m2, v);
+		FMVector4 result = m2 * v;
+		PassIf(IsEquivalent(result.x, expected.x) && IsEquivalent(result.y, expected.y) && IsEquivalent(result.z, expected.z) && IsEquivalent(result.w, expected.w));
+		PassIf(IsEquivalent(m2.TransformCoordinate(FMVector3(v.x, v.y, v.z)), FMVector3(expected.x, expected.y, expected.z)));
+
+		// In-place.
+		FMMatrix44 m3 = m1;
+		m3 *= m2;
+		PassIf(IsEquivalent(m3, FMath::ScalarMultiply(m1, m2)));
+	}
+
+TESTSUITE_TEST(1, Inverse)
+	for (size_t i = 0; i < 64; ++i)
+	{
+		FMMatrix44 mx = RandomTransform();
+		if ((i % 2) == 1)
+		{
+			// Not affine.
+			mx[0][3] = FMRandom::GetFloat(-0.1f, 0.1f);
+			mx[1][3] = FMRandom::GetFloat(-0.1f, 0.1f);
+			mx[2][3] = FMRandom::GetFloat(-0.1f, 0.1f);
+		}
+
+		FMMatrix44 inverse = mx.Inverted();
+		PassIf(IsEquivalent(inverse, FMath::ScalarInverse(mx)));
+		PassIf(IsEquivalent(mx * inverse, FMMatrix44::Identity));
+		PassIf(IsEquivalent(inverse * mx, FMMatrix44::Identity));
+		PassIf(IsEquivalent(mx.Determinant(), FMath::ScalarDeterminant(mx)));
+	}
+
+	// Singular matrices don't give NaNs, as before.
+	FMMatrix44 singular(FMMatrix44::Identity);
+	singular[2][2] = 0.0f;
+	PassIf(IsEquivalent(singular.Determinant(), 0.0f));
+	PassIf(IsEquivalent(singular.Inverted(), FMath::ScalarInverse(singular)));
+
+TESTSUITE_TEST(2, BatchTransforms)
+	FMMatrix44 mx = RandomTransform();
+	FMVector3List points, vectors;
+	for (size_t i = 0; i < 37; ++i)
+	{
+		points.push_back(FMVector3(FMRandom::GetFloat(-10.0f, 10.0f), FMRandom::GetFloat(-10.0f, 10.0f), FMRandom::GetFloat(-10.0f, 10.0f)));
+	}
+	vectors = points;
+
+	FMVector3List transformedPoints(points.size(), FMVector3::Zero);
+	mx.TransformCoordinates(points.begin(), transformedPoints.begin(), points.size());
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		PassIf(IsEquivalent(transformedPoints[i], mx.TransformCoordinate(points[i])));
+	}
+
+	// In-place.
+	mx.TransformCoordinates(points);
+	mx.TransformVectors(vectors);
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		PassIf(IsEquivalent(points[i], transformedPoints[i]));
+		PassIf(IsEquivalent(vectors[i] + mx.GetTranslation(), transformedPoints[i]));
+	}
+
+TESTSUITE_TEST(3, Alignment)
+	FMMatrix44List matrices(3, FMMatrix44::Identity);
+	FMMatrix44 mx(FMMatrix44::Identity);
+#if defined(__GNUC__) && !defined(WIN32)
+	PassIf((((size_t) &mx) % 16) == 0);
+	for (size_t i = 0; i < matrices.size(); ++i)
+	{
+		PassIf((((size_t) &matrices[i]) % 16) == 0);
+	}
+#endif // __GNUC__ && !WIN32
+
+TESTSUITE_END
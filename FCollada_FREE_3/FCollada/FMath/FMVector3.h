@@ -20,11 +20,13 @@ class FMVector4;
 
 	Simple, non-optimized vector class: * is the dot-product, ^ is the 
 	cross-product.
+
+	Not aligned with ALIGN_STRUCT: vectors are read in-place from the
+	packed float arrays of the geometry sources.
 	
 	@ingroup FMath
 */
 class FCOLLADA_EXPORT
-ALIGN_STRUCT(16)
 FMVector3
 {
 public:
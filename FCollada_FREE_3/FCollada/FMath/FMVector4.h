@@ -19,11 +19,11 @@ class FMColor;
 /**
 	A 4 dimensional vector.
 	Not used within FCollada.
+	Not aligned with ALIGN_STRUCT, since 3D vectors are cast to it.
 	
 	@ingroup FMath
 */
 class FCOLLADA_EXPORT
-ALIGN_STRUCT(16)
 FMVector4
 {
 public:
@@ -119,20 +119,19 @@ FUBoundingBox FUBoundingBox::Transform(const FMMatrix44& transform) const
 
 	FUBoundingBox transformedBoundingBox;
 
-	FMVector3 testPoints[6] =
+	FMVector3 testPoints[8] =
 	{
 		FMVector3(minimum.x, maximum.y, minimum.z), FMVector3(minimum.x, maximum.y, maximum.z),
 		FMVector3(maximum.x, maximum.y, minimum.z), FMVector3(minimum.x, minimum.y, maximum.z),
-		FMVector3(maximum.x, minimum.y, minimum.z), FMVector3(maximum.x, minimum.y, maximum.z)
+		FMVector3(maximum.x, minimum.y, minimum.z), FMVector3(maximum.x, minimum.y, maximum.z),
+		minimum, maximum
 	};
 
-	for (size_t i = 0; i < 6; ++i)
+	transform.TransformCoordinates(testPoints, testPoints, 8);
+	for (size_t i = 0; i < 8; ++i)
 	{
-		testPoints[i] = transform.TransformCoordinate(testPoints[i]);
 		transformedBoundingBox.Include(testPoints[i]);
 	}
-	transformedBoundingBox.Include(transform.TransformCoordinate(minimum));
-	transformedBoundingBox.Include(transform.TransformCoordinate(maximum));
 
 	return transformedBoundingBox;
 }
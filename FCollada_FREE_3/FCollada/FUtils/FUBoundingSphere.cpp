@@ -178,9 +178,9 @@ FUBoundingSphere FUBoundingSphere::Transform(const FMMatrix44& transform) const
 		FMVector3(0.0f, 0.0f, radius)
 	};
 
-	for (size_t i = 0; i < 6; ++i)
+	transform.TransformVectors(testPoints, testPoints, 3);
+	for (size_t i = 0; i < 3; ++i)
 	{
-		testPoints[i] = transform.TransformVector(testPoints[i]);
 		float lengthSquared = testPoints[i].LengthSquared();
 		if (lengthSquared > transformedSphere.radius * transformedSphere.radius)
 		{
@@ -78,6 +78,20 @@ namespace FUCrc32
 		return (crc32) (crc ^ 0xffffffff); 
 	}
 
+	crc32 CRC32(const void* data, size_t length, crc32 previous)
+	{
+		uint32 crc = previous ^ 0xffffffff;
+
+		const uint8* b = (const uint8*) data;
+		const uint8* end = b + length;
+		while (b != end)
+		{
+			crc = (crc >> 8) ^ kCRCTable[(crc & 0xFF) ^ *b++];
+		}
+
+		return (crc32) (crc ^ 0xffffffff);
+	}
+
 // #define GENERATE_CRC32_TABLE
 #ifdef GENERATE_CRC32_TABLE
 	// ** The above table was created using the code below.
@@ -38,6 +38,17 @@ namespace FUCrc32
 #ifdef UNICODE
 	FCOLLADA_EXPORT crc32 CRC32(const fchar* text); /**< See above. */
 #endif // UNICODE
+
+	/** Hashes a block of memory.
+		Large buffers may be hashed in pieces, by passing in the hash
+		value of the previous pieces.
+		@param data The memory block to hash.
+		@param length The length, in bytes, of the memory block.
+		@param previous The hash value of the previous pieces.
+			Use zero when hashing the first piece.
+		@return The 32-bit hash value. For a string, it is equal to
+			the hash value of this string without the NULL terminator. */
+	FCOLLADA_EXPORT crc32 CRC32(const void* data, size_t length, crc32 previous = 0);
 };
 
 #endif // _FU_CRC32_H_
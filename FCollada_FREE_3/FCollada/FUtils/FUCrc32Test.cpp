@@ -57,4 +57,20 @@ TESTSUITE_TEST(1, BackwardCompatibility)
 		FailIf(answer != answers[i]);
 	}
 
+TESTSUITE_TEST(2, MemoryBlocks)
+	for (size_t i = 0; i < 10; ++i)
+	{
+		// A block holding a string hashes like the string.
+		size_t length = strlen(input[i]);
+		FailIf(CRC32(input[i], length) != answers[i]);
+
+		// Hashing a block in pieces gives the same result.
+		for (size_t split = 0; split <= length; ++split)
+		{
+			crc32 answer = CRC32(input[i], split);
+			answer = CRC32(input[i] + split, length - split, answer);
+			FailIf(answer != answers[i]);
+		}
+	}
+
 TESTSUITE_END
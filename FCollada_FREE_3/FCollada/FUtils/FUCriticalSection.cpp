@@ -13,6 +13,12 @@ FUCriticalSection::FUCriticalSection()
 {
 #ifdef WIN32
 	InitializeCriticalSection(&criticalSection);
+#else
+	pthread_mutexattr_t attributes;
+	pthread_mutexattr_init(&attributes);
+	pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&criticalSection, &attributes);
+	pthread_mutexattr_destroy(&attributes);
 #endif
 }
 
@@ -20,6 +26,8 @@ FUCriticalSection::~FUCriticalSection()
 {
 #ifdef WIN32
 	DeleteCriticalSection(&criticalSection);
+#else
+	pthread_mutex_destroy(&criticalSection);
 #endif
 }
 
@@ -27,6 +35,8 @@ void FUCriticalSection::Enter()
 {
 #ifdef WIN32
 	EnterCriticalSection(&criticalSection);
+#else
+	pthread_mutex_lock(&criticalSection);
 #endif
 }
 
@@ -34,6 +44,8 @@ void FUCriticalSection::Leave()
 {
 #ifdef WIN32
 	LeaveCriticalSection(&criticalSection);
+#else
+	pthread_mutex_unlock(&criticalSection);
 #endif
 }
 
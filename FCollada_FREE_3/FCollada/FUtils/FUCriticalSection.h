@@ -14,14 +14,15 @@
 #ifndef _FU_CRITICAL_SECTION_H_
 #define _FU_CRITICAL_SECTION_H_
 
-#ifdef __APPLE__
-#include <CoreServices/CoreServices.h>
+#ifndef WIN32
+#include <pthread.h>
 #endif
 
 /**
 	An OS dependent critical section.
 	
-	Currently only supported for WIN32.
+	Implemented with a CRITICAL_SECTION on WIN32 and a recursive
+	pthread mutex everywhere else.
 
 	@ingroup FUtils
 */
@@ -30,12 +31,8 @@ class FCOLLADA_EXPORT FUCriticalSection
 private:
 #ifdef WIN32
 	CRITICAL_SECTION criticalSection; // WIN32
-#elif defined (__APPLE__)
-	//Do something here.
-	MPCriticalRegionID criticalSection;
-#elif defined (LINUX)
 #else
-#warning "FUCriticalSection: Critical section not implemented for other platforms."
+	pthread_mutex_t criticalSection; // Recursive POSIX mutex
 #endif
 
 public:
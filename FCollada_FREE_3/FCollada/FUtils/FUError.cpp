@@ -258,9 +258,13 @@ const char* FUError::GetErrorString(FUError::Code errorCode)
 
 	case WARNING_SHAPE_NODE_MISSING: return "Shape node missing."; 
 	case WARNING_MASS_AND_DENSITY_MISSING: return "Mass and density missing."; 
+	case WARNING_INVALID_ACCESSOR_COUNT: return "Geometry source accessor expects more values than its array holds."; 
+	case ERROR_INVALID_POLYGON_INDEX: return "Polygon index out of the bounds of its geometry source."; 
+	case ERROR_INVALID_INPUT_OFFSET: return "Polygons input offset out of the range of the polygons inputs."; 
 	
 	case DEBUG_LOAD_SUCCESSFUL: return "COLLADA document loaded successfully."; 
 	case DEBUG_WRITE_SUCCESSFUL: return "COLLADA document written successfully."; 
+	case DEBUG_LOAD_FROM_SNAPSHOT: return "COLLADA document restored from its snapshot."; 
 
 	case ERROR_CUSTOM_STRING: return customErrorString.c_str(); 
 	default: return "Unknown error code.";
@@ -218,11 +218,19 @@ public:
 		WARNING_XREF_UNASSIGNED,
 		WARNING_MASS_AND_DENSITY_MISSING,
 
+		// Warnings only raised by the validation, see FCollada::ValidateDocumentFromFile
+		WARNING_INVALID_ACCESSOR_COUNT,
+
+		// Errors only raised by the validation, see FCollada::ValidateDocumentFromFile
+		ERROR_INVALID_POLYGON_INDEX,
+		ERROR_INVALID_INPUT_OFFSET,
+
 		//
 		//Debug
 		//
 		DEBUG_LOAD_SUCCESSFUL,
 		DEBUG_WRITE_SUCCESSFUL,
+		DEBUG_LOAD_FROM_SNAPSHOT,
 
 		ERROR_CUSTOM_STRING = 5000
 	};
@@ -239,6 +247,16 @@ public:
 		LEVEL_COUNT
 	};
 
+	/** An error that was recorded instead of logged.
+		See FCollada::ValidateDocumentFromFile. */
+	struct Record
+	{
+		FUError::Level level; /**< The error level. */
+		uint32 code; /**< The error code. */
+		uint32 line; /**< The line number of the error in the COLLADA document. */
+	};
+	typedef fm::vector<Record, true> RecordList; /**< A dynamically-sized array of recorded errors. */
+
 	/** Callback functor definition. */
 	typedef IFunctor3<FUError::Level, uint32, uint32, void> FUErrorFunctor;
 
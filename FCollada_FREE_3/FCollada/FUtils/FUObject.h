@@ -72,6 +72,11 @@ public:
 		@return Whether this object is exactly or inherits the given type. */
 	inline bool HasType(const FUObjectType& _type) const { return GetObjectType().Includes(_type); }
 
+	/** Retrieves the owner of this object.
+		@return The owner of this object. This pointer will be NULL
+			if no container or reference owns this object. */
+	inline const FUObjectOwner* GetObjectOwner() const { return objectOwner; }
+
 protected:
 	/** Detaches this object from its owner.
 		Mainly notifies the owner before the destructor is called. */
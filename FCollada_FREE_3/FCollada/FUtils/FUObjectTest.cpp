@@ -229,4 +229,19 @@ TESTSUITE_TEST(7, Shortcuts)
 	PassIf(DynamicCast<FUTSimple2>(&t3) == &t3);
 	PassIf(DynamicCast<FUTSimple3>(&t4) == NULL);
 
+TESTSUITE_TEST(8, TypeIds)
+	// Every object type gets its own dense identifier.
+	const FUObjectType* types[] = { &FUObject::GetClassType(), &FUTrackable::GetClassType(),
+		&FUTObject1::GetClassType(), &FUTObject2::GetClassType(), &FUTObject1Up::GetClassType(),
+		&FUTSimple1::GetClassType(), &FUTSimple2::GetClassType(), &FUTSimple3::GetClassType(), &FUTSimple4::GetClassType() };
+	static const size_t typeCount = sizeof(types) / sizeof(*types);
+	for (size_t i = 0; i < typeCount; ++i)
+	{
+		PassIf(types[i]->GetTypeId() < FUObjectType::GetTypeCount());
+		for (size_t j = i + 1; j < typeCount; ++j)
+		{
+			FailIf(types[i]->GetTypeId() == types[j]->GetTypeId());
+		}
+	}
+
 TESTSUITE_END
@@ -9,16 +9,27 @@
 #include "StdAfx.h"
 #include "FUObjectType.h"
 
+// Object types are all constructed during static initialization:
+// this POD counter is zero-initialized before any of them.
+static uint32 objectTypeCount = 0;
+
 FUObjectType::FUObjectType(const char* _typeName)
 : parent(NULL)
 {
 	typeName = _typeName;
+	typeId = objectTypeCount++;
 }
 
 FUObjectType::FUObjectType(const FUObjectType& _parent, const char* _typeName)
 : parent(&_parent)
 {
 	typeName = _typeName;
+	typeId = objectTypeCount++;
+}
+
+uint32 FUObjectType::GetTypeCount()
+{
+	return objectTypeCount;
 }
 
 bool FUObjectType::Includes(const FUObjectType& otherType) const
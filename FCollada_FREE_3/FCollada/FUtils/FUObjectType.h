@@ -32,6 +32,7 @@ class FCOLLADA_EXPORT FUObjectType
 private:
 	const FUObjectType* parent;
 	const char* typeName;
+	uint32 typeId;
 
 public:
 	/** [INTERNAL] Constructor: do not use directly.
@@ -75,6 +76,17 @@ public:
 	/** Retrieves the object type name.
 		@return The object type name. */
 	inline const char* GetTypeName() const { return typeName; }
+
+	/** Retrieves the dense identifier assigned to this object type when it was registered.
+		Identifiers are contiguous, starting at zero, and are meant to index
+		flat per-type tables, such as dispatch tables.
+		@return The object type identifier. */
+	inline uint32 GetTypeId() const { return typeId; }
+
+	/** Retrieves the number of object types registered so far.
+		All the object type identifiers are smaller than this count.
+		@return The number of registered object types. */
+	static uint32 GetTypeCount();
 };
 
 /**
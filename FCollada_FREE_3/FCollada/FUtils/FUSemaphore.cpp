@@ -9,14 +9,19 @@
 #include "StdAfx.h"
 #include "FUSemaphore.h"
 
-FUSemaphore::FUSemaphore(uint32 initialValue, uint32 maximumValue)
+FUSemaphore::FUSemaphore(uint32 initialValue, uint32 _maximumValue)
 #ifdef WIN32
 :	semaphoreHandle(NULL)
+#else
+:	value(initialValue), maximumValue(_maximumValue)
 #endif // WIN32
 {	
+	FUAssert(initialValue <= _maximumValue, ;);
 #ifdef WIN32
-	FUAssert(initialValue <= maximumValue, ;);
-	semaphoreHandle = CreateSemaphore(NULL, initialValue, maximumValue, NULL);
+	semaphoreHandle = CreateSemaphore(NULL, initialValue, _maximumValue, NULL);
+#else
+	pthread_mutex_init(&mutex, NULL);
+	pthread_cond_init(&condition, NULL);
 #endif
 }
 
@@ -24,6 +29,9 @@ FUSemaphore::~FUSemaphore()
 {
 #ifdef WIN32
 	CloseHandle(semaphoreHandle);
+#else
+	pthread_cond_destroy(&condition);
+	pthread_mutex_destroy(&mutex);
 #endif
 }
 
@@ -31,6 +39,15 @@ void FUSemaphore::Up()
 {
 #ifdef WIN32
 	ReleaseSemaphore(semaphoreHandle, 1, NULL);
+#else
+	// Like ReleaseSemaphore, leave the value unchanged at its maximum.
+	pthread_mutex_lock(&mutex);
+	if (value < maximumValue)
+	{
+		++value;
+		pthread_cond_signal(&condition);
+	}
+	pthread_mutex_unlock(&mutex);
 #endif
 }
 
@@ -38,6 +55,11 @@ void FUSemaphore::Down()
 {
 #ifdef WIN32
 	WaitForSingleObject(semaphoreHandle, INFINITE);
+#else
+	pthread_mutex_lock(&mutex);
+	while (value == 0) pthread_cond_wait(&condition, &mutex);
+	--value;
+	pthread_mutex_unlock(&mutex);
 #endif
 }
 
@@ -14,14 +14,15 @@
 #ifndef _FU_SEMAPHORE_H_
 #define _FU_SEMAPHORE_H_
 
-#ifdef __APPLE__
-#include <CoreServices/CoreServices.h>
+#ifndef WIN32
+#include <pthread.h>
 #endif
 
 /**
 	An OS independent semaphore. 
 	
-	Currently only supported for WIN32.
+	Implemented with a semaphore object on WIN32 and with a pthread
+	mutex and condition variable everywhere else.
 
 	@ingroup FUtils
 */
@@ -30,10 +31,11 @@ class FCOLLADA_EXPORT FUSemaphore
 private:
 #ifdef WIN32
 	HANDLE semaphoreHandle; // WIN32
-#elif defined (__APPLE__)
-	MPTaskID semaphoreHandle;
 #else
-#warning "FUSemaphore: Semaphore not implemented for non Windows"
+	pthread_mutex_t mutex;
+	pthread_cond_t condition;
+	uint32 value;
+	uint32 maximumValue;
 #endif
 
 public:
@@ -46,7 +48,8 @@ public:
 	~FUSemaphore();
 
 	/** Increments the value of the semaphore. 
-		Do not increment it above the maximum value set in the constructor. No check is made. */
+		The value is never incremented above the maximum value set in the constructor:
+		at the maximum value, this method has no effect. */
 	void Up();
 
 	/** Decrements the value of the semaphore.
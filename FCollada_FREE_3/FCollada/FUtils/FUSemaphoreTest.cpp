@@ -0,0 +1,75 @@
+/*
+	Copyright (C) 2005-2007 Feeling Software Inc.
+	Portions of the code are:
+	Copyright (C) 2005-2007 Sony Computer Entertainment America
+	
+	MIT License: http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "StdAfx.h"
+#include "FUTestBed.h"
+#include "FUSemaphore.h"
+#include "FUThread.h"
+
+///////////////////////////////////////////////////////////////////////////////
+struct FUTSemaphoreWaiter
+{
+	FUSemaphore* semaphore;
+	volatile bool isDecremented;
+};
+
+#ifdef WIN32
+static DWORD WINAPI FUTSemaphoreWaiterThread(void* parameter)
+#else
+static void* FUTSemaphoreWaiterThread(void* parameter)
+#endif // WIN32
+{
+	FUTSemaphoreWaiter* waiter = (FUTSemaphoreWaiter*) parameter;
+	waiter->semaphore->Down();
+	waiter->isDecremented = true;
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+TESTSUITE_START(FUSemaphore)
+
+TESTSUITE_TEST(0, MaximumValue)
+	// The increments above the maximum value are ignored.
+	FUSemaphore semaphore(1, 2);
+	semaphore.Up();
+	semaphore.Up();
+	semaphore.Down();
+	semaphore.Down();
+
+	// The value is now zero: another decrement must wait for the next increment.
+	FUTSemaphoreWaiter waiter;
+	waiter.semaphore = &semaphore;
+	waiter.isDecremented = false;
+	FUThread* thread = FUThread::CreateFUThread(FUTSemaphoreWaiterThread, &waiter);
+	PassIf(thread != NULL);
+	FUThread::SleepCurrentThread(50);
+	bool isBlocked = !waiter.isDecremented;
+	semaphore.Up();
+	FUThread::ExitFUThread(thread);
+	PassIf(isBlocked);
+	PassIf(waiter.isDecremented);
+
+TESTSUITE_TEST(1, BinarySemaphore)
+	FUBinarySemaphore semaphore;
+	semaphore.Up();
+	semaphore.Up();
+	semaphore.Down();
+
+	FUTSemaphoreWaiter waiter;
+	waiter.semaphore = &semaphore;
+	waiter.isDecremented = false;
+	FUThread* thread = FUThread::CreateFUThread(FUTSemaphoreWaiterThread, &waiter);
+	PassIf(thread != NULL);
+	FUThread::SleepCurrentThread(50);
+	bool isBlocked = !waiter.isDecremented;
+	semaphore.Up();
+	FUThread::ExitFUThread(thread);
+	PassIf(isBlocked);
+	PassIf(waiter.isDecremented);
+
+TESTSUITE_END
@@ -80,6 +80,206 @@ template<> void FUSStringBuilder::append(int32 i)
 }
 #endif // UNICODE
 
+//
+// Shortest round-trip float to decimal conversion
+//
+
+// This is the Ryu algorithm from Ulf Adams, "Ryu: Fast Float-to-String Conversion", PLDI 2018.
+// The decimal interval that rounds to the floating-point value is computed with fixed-point
+// multiplications by powers of five, and decimal digits are dropped while the interval allows it.
+// The powers of five are split in 32-bit halves: { high, low }.
+#define FLOAT_POW5_INV_BITCOUNT 59
+#define FLOAT_POW5_BITCOUNT 61
+
+static const uint32 floatPow5InvSplit[31][2] =
+{
+	{ 0x08000000, 0x00000001 }, { 0x06666666, 0x66666667 }, { 0x051EB851, 0xEB851EB9 },
+	{ 0x04189374, 0xBC6A7EFA }, { 0x068DB8BA, 0xC710CB2A }, { 0x053E2D62, 0x38DA3C22 },
+	{ 0x0431BDE8, 0x2D7B634E }, { 0x06B5FCA6, 0xAF2BD216 }, { 0x055E63B8, 0x8C230E78 },
+	{ 0x044B82FA, 0x09B5A52D }, { 0x06DF37F6, 0x75EF6EAE }, { 0x057F5FF8, 0x5E592558 },
+	{ 0x0465E660, 0x4B7A8447 }, { 0x0709709A, 0x125DA071 }, { 0x05A126E1, 0xA84AE6C1 },
+	{ 0x0480EBE7, 0xB9D58567 }, { 0x0734ACA5, 0xF6226F0B }, { 0x05C3BD51, 0x91B525A3 },
+	{ 0x049C9774, 0x7490EAE9 }, { 0x0760F253, 0xEDB4AB0E }, { 0x05E72843, 0x249088D8 },
+	{ 0x04B8ED02, 0x83A6D3E0 }, { 0x078E4804, 0x05D7B966 }, { 0x060B6CD0, 0x04AC9452 },
+	{ 0x04D5F0A6, 0x6A23A9DB }, { 0x07BCB43D, 0x769F762B }, { 0x06309031, 0x2BB2C4EF },
+	{ 0x04F3A68D, 0xBC8F03F3 }, { 0x07EC3DAF, 0x94180651 }, { 0x065697BF, 0xA9ACD1DA },
+	{ 0x051212FF, 0xBAF0A7E2 }
+};
+
+static const uint32 floatPow5Split[47][2] =
+{
+	{ 0x10000000, 0x00000000 }, { 0x14000000, 0x00000000 }, { 0x19000000, 0x00000000 },
+	{ 0x1F400000, 0x00000000 }, { 0x13880000, 0x00000000 }, { 0x186A0000, 0x00000000 },
+	{ 0x1E848000, 0x00000000 }, { 0x1312D000, 0x00000000 }, { 0x17D78400, 0x00000000 },
+	{ 0x1DCD6500, 0x00000000 }, { 0x12A05F20, 0x00000000 }, { 0x174876E8, 0x00000000 },
+	{ 0x1D1A94A2, 0x00000000 }, { 0x12309CE5, 0x40000000 }, { 0x16BCC41E, 0x90000000 },
+	{ 0x1C6BF526, 0x34000000 }, { 0x11C37937, 0xE0800000 }, { 0x16345785, 0xD8A00000 },
+	{ 0x1BC16D67, 0x4EC80000 }, { 0x1158E460, 0x913D0000 }, { 0x15AF1D78, 0xB58C4000 },
+	{ 0x1B1AE4D6, 0xE2EF5000 }, { 0x10F0CF06, 0x4DD59200 }, { 0x152D02C7, 0xE14AF680 },
+	{ 0x1A784379, 0xD99DB420 }, { 0x108B2A2C, 0x28029094 }, { 0x14ADF4B7, 0x320334B9 },
+	{ 0x19D971E4, 0xFE8401E7 }, { 0x1027E72F, 0x1F128130 }, { 0x1431E0FA, 0xE6D7217C },
+	{ 0x193E5939, 0xA08CE9DB }, { 0x1F8DEF88, 0x08B02452 }, { 0x13B8B5B5, 0x056E16B3 },
+	{ 0x18A6E322, 0x46C99C60 }, { 0x1ED09BEA, 0xD87C0378 }, { 0x13426172, 0xC74D822B },
+	{ 0x1812F9CF, 0x7920E2B6 }, { 0x1E17B843, 0x57691B64 }, { 0x12CED32A, 0x16A1B11E },
+	{ 0x178287F4, 0x9C4A1D66 }, { 0x1D6329F1, 0xC35CA4BF }, { 0x125DFA37, 0x1A19E6F7 },
+	{ 0x16F578C4, 0xE0A060B5 }, { 0x1CB2D6F6, 0x18C878E3 }, { 0x11EFC659, 0xCF7D4B8D },
+	{ 0x166BB7F0, 0x435C9E71 }, { 0x1C06A5EC, 0x5433C60D }
+};
+
+// ceil(log2(5^e)), for 0 < e <= 3528; pow5bits(0) is 1.
+static inline int32 Pow5Bits(int32 e) { return (int32) (((uint32) e * 1217359) >> 19) + 1; }
+// floor(log10(2^e)), for 0 <= e <= 1650.
+static inline uint32 Log10Pow2(int32 e) { return ((uint32) e * 78913) >> 18; }
+// floor(log10(5^e)), for 0 <= e <= 2620.
+static inline uint32 Log10Pow5(int32 e) { return ((uint32) e * 732923) >> 20; }
+
+static inline bool IsMultipleOfPowerOf5(uint32 value, uint32 p)
+{
+	uint32 count = 0;
+	for (; value != 0 && value % 5 == 0; value /= 5) ++count;
+	return count >= p;
+}
+
+static inline bool IsMultipleOfPowerOf2(uint32 value, uint32 p)
+{
+	return (value & ((1u << p) - 1)) == 0;
+}
+
+// Returns (m * factor) >> shift, with shift > 32.
+static inline uint32 MulShift(uint32 m, const uint32* factor, int32 shift)
+{
+	uint64 bits0 = (uint64) m * factor[1];
+	uint64 bits1 = (uint64) m * factor[0];
+	uint64 sum = (bits0 >> 32) + bits1;
+	return (uint32) (sum >> (shift - 32));
+}
+
+uint32 FloatToShortestDecimal(float f, int32& exponent)
+{
+	union { float f; uint32 i; } bits;
+	bits.f = f;
+	uint32 ieeeMantissa = bits.i & 0x007FFFFF;
+	uint32 ieeeExponent = (bits.i >> 23) & 0xFF;
+
+	// Step 1: decode the floating-point value: f = m2 * 2^e2.
+	// Two extra bits of precision are kept for the interval boundaries.
+	int32 e2;
+	uint32 m2;
+	if (ieeeExponent == 0) { e2 = 1 - 127 - 23 - 2; m2 = ieeeMantissa; }
+	else { e2 = (int32) ieeeExponent - 127 - 23 - 2; m2 = (1u << 23) | ieeeMantissa; }
+	bool acceptBounds = (m2 & 1) == 0;
+
+	// Step 2: the interval of valid decimal representations: [mm, mp] around mv.
+	uint32 mv = 4 * m2;
+	uint32 mp = 4 * m2 + 2;
+	uint32 mmShift = (ieeeMantissa != 0 || ieeeExponent <= 1) ? 1 : 0;
+	uint32 mm = 4 * m2 - 1 - mmShift;
+
+	// Step 3: convert the interval to a decimal power base.
+	uint32 vr, vp, vm;
+	int32 e10;
+	bool vmIsTrailingZeros = false, vrIsTrailingZeros = false;
+	uint32 lastRemovedDigit = 0;
+	if (e2 >= 0)
+	{
+		uint32 q = Log10Pow2(e2);
+		e10 = (int32) q;
+		int32 k = FLOAT_POW5_INV_BITCOUNT + Pow5Bits((int32) q) - 1;
+		int32 i = -e2 + (int32) q + k;
+		vr = MulShift(mv, floatPow5InvSplit[q], i);
+		vp = MulShift(mp, floatPow5InvSplit[q], i);
+		vm = MulShift(mm, floatPow5InvSplit[q], i);
+		if (q != 0 && (vp - 1) / 10 <= vm / 10)
+		{
+			// One removed digit is needed for the rounding, even if the loop below doesn't run.
+			int32 l = FLOAT_POW5_INV_BITCOUNT + Pow5Bits((int32) (q - 1)) - 1;
+			lastRemovedDigit = MulShift(mv, floatPow5InvSplit[q - 1], -e2 + (int32) q - 1 + l) % 10;
+		}
+		if (q <= 9)
+		{
+			// Only one of mp, mv and mm can be a multiple of 5, if any.
+			if (mv % 5 == 0) vrIsTrailingZeros = IsMultipleOfPowerOf5(mv, q);
+			else if (acceptBounds) vmIsTrailingZeros = IsMultipleOfPowerOf5(mm, q);
+			else vp -= IsMultipleOfPowerOf5(mp, q) ? 1 : 0;
+		}
+	}
+	else
+	{
+		uint32 q = Log10Pow5(-e2);
+		e10 = (int32) q + e2;
+		int32 i = -e2 - (int32) q;
+		int32 k = Pow5Bits(i) - FLOAT_POW5_BITCOUNT;
+		int32 j = (int32) q - k;
+		vr = MulShift(mv, floatPow5Split[i], j);
+		vp = MulShift(mp, floatPow5Split[i], j);
+		vm = MulShift(mm, floatPow5Split[i], j);
+		if (q != 0 && (vp - 1) / 10 <= vm / 10)
+		{
+			j = (int32) q - 1 - (Pow5Bits(i + 1) - FLOAT_POW5_BITCOUNT);
+			lastRemovedDigit = MulShift(mv, floatPow5Split[i + 1], j) % 10;
+		}
+		if (q <= 1)
+		{
+			// mv = 4 * m2 always has at least two trailing zero bits.
+			vrIsTrailingZeros = true;
+			if (acceptBounds) vmIsTrailingZeros = mmShift == 1;
+			else --vp;
+		}
+		else if (q < 31)
+		{
+			vrIsTrailingZeros = IsMultipleOfPowerOf2(mv, q - 1);
+		}
+	}
+
+	// Step 4: find the shortest decimal representation within the interval.
+	int32 removed = 0;
+	uint32 output;
+	if (vmIsTrailingZeros || vrIsTrailingZeros)
+	{
+		// General case, which happens rarely.
+		while (vp / 10 > vm / 10)
+		{
+			vmIsTrailingZeros &= vm % 10 == 0;
+			vrIsTrailingZeros &= lastRemovedDigit == 0;
+			lastRemovedDigit = vr % 10;
+			vr /= 10; vp /= 10; vm /= 10;
+			++removed;
+		}
+		if (vmIsTrailingZeros)
+		{
+			while (vm % 10 == 0)
+			{
+				vrIsTrailingZeros &= lastRemovedDigit == 0;
+				lastRemovedDigit = vr % 10;
+				vr /= 10; vp /= 10; vm /= 10;
+				++removed;
+			}
+		}
+		// Round to even if the exact number is .....50..0.
+		if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0) lastRemovedDigit = 4;
+		output = vr + (((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5) ? 1 : 0);
+	}
+	else
+	{
+		// Common case.
+		while (vp / 10 > vm / 10)
+		{
+			lastRemovedDigit = vr % 10;
+			vr /= 10; vp /= 10; vm /= 10;
+			++removed;
+		}
+		output = vr + ((vr == vm || lastRemovedDigit >= 5) ? 1 : 0);
+	}
+
+	// Rounding up may leave trailing zeroes.
+	exponent = e10 + removed;
+	while (output != 0 && output % 10 == 0) { output /= 10; ++exponent; }
+	return output;
+}
+
+#undef FLOAT_POW5_INV_BITCOUNT
+#undef FLOAT_POW5_BITCOUNT
+
 FCOLLADA_EXPORT void TrickLinker2()
 {
 	{
@@ -100,6 +300,9 @@ FCOLLADA_EXPORT void TrickLinker2()
 		b4.append((int32) -2); d4.append((int32) -2);
 		b5.append(1.0f); d5.append(-1.0f);
 		b5.append(1.0); d5.append(-1.0);
+		float f = 1.0f; uint32 u = 1;
+		b5.appendValues(&f, 1); d5.appendValues(&f, 1);
+		b5.appendValues(&u, 1); d5.appendValues(&u, 1);
 		b5.append(FMVector2::Zero); d5.append(FMVector2::Zero);
 		b5.append(FMVector3::Zero); d5.append(FMVector3::Zero);
 		b5.append(FMVector4::Zero); d5.append(FMVector4::Zero);
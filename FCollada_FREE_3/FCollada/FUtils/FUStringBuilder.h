@@ -21,6 +21,15 @@
 #ifndef _FCU_STRING_BUILDER_
 #define _FCU_STRING_BUILDER_
 
+/** Converts a floating-point value into the shortest decimal number
+	that reads back as the same floating-point value.
+	@param f A finite, non-zero floating-point value. Its sign is ignored.
+	@param exponent The decimal exponent of the number:
+		the number is the returned mantissa times ten to this power.
+	@return The decimal mantissa. It has at most nine digits and
+		no trailing zeroes. */
+FCOLLADA_EXPORT uint32 FloatToShortestDecimal(float f, int32& exponent);
+
 /**
 	A dynamically-sized string object.
 	The template has two arguments: the character definition and
@@ -145,10 +154,27 @@ public:
 		that represents infinity, the string "INF" is appended. If it represents
 		the negative infinity, the string "-INF" is appended. If it represents the
 		impossibility, the string "NaN" is appended.
+		Single-precision values are written out with the shortest number of
+		digits that reads back as the same value.
 		@param f A floating-point value. */
 	void append(float f);
 	void append(double f); /**< See above. */
 
+	/** Appends a list of floating-point values, separated by spaces,
+		to the content of the builder.
+		Each value is written out with the shortest number of digits that
+		reads back as the same value. The buffer is enlarged only once,
+		so this is much faster than appending the values one at a time.
+		@param values A contiguous array of floating-point values.
+		@param count The number of values in the array. */
+	void appendValues(const float* values, size_t count);
+
+	/** Appends a list of unsigned integers, separated by spaces,
+		to the content of the builder.
+		@param values A contiguous array of unsigned integers.
+		@param count The number of values in the array. */
+	void appendValues(const uint32* values, size_t count);
+
 	/** Appends a vector to the content of the builder.
 		@param v A vector. */
 	void append(const FMVector2& v);
@@ -83,6 +83,87 @@ void FloatToString(FloatType f, Char* sz)
 	(*buffer) = 0;
 }
 
+// The longest string written out by FloatToShortestString: "-1.17549435e-38".
+#define FLOAT_SHORTEST_STRING_MAX 16
+
+template <class Char>
+Char* FloatToShortestString(float f, Char* buffer)
+{
+	union { float f; uint32 i; } bits;
+	bits.f = f;
+	bool isNegative = (bits.i & 0x80000000) != 0;
+	if ((bits.i & 0x7F800000) == 0x7F800000)
+	{
+		if ((bits.i & 0x007FFFFF) != 0) { (*buffer++) = 'N'; (*buffer++) = 'a'; (*buffer++) = 'N'; }
+		else
+		{
+			if (isNegative) (*buffer++) = '-';
+			(*buffer++) = 'I'; (*buffer++) = 'N'; (*buffer++) = 'F';
+		}
+		return buffer;
+	}
+	else if ((bits.i & 0x7FFFFFFF) == 0)
+	{
+		(*buffer++) = '0';
+		return buffer;
+	}
+
+	int32 exponent;
+	uint32 mantissa = FloatToShortestDecimal(f, exponent);
+	Char digits[9];
+	int32 digitCount = 0;
+	for (; mantissa != 0; mantissa /= 10) digits[8 - (digitCount++)] = (Char) ('0' + (mantissa % 10));
+	const Char* digit = digits + 9 - digitCount;
+
+	// As with ecvt, 'decimal' is the position of the decimal point within the digits.
+	// Pick the shorter of the simple notation and the scientific notation, favoring the simple one.
+	int32 decimal = digitCount + exponent;
+	int32 scientificExponent = decimal - 1;
+	int32 simpleLength = (decimal <= 0) ? 2 - decimal + digitCount : ((decimal >= digitCount) ? decimal : digitCount + 1);
+	int32 scientificLength = digitCount + ((digitCount > 1) ? 3 : 2) + ((scientificExponent < 0) ? 1 : 0)
+		+ ((scientificExponent >= 10 || scientificExponent <= -10) ? 1 : 0);
+
+	if (isNegative) (*buffer++) = '-';
+	if (simpleLength <= scientificLength)
+	{
+		if (decimal <= 0)
+		{
+			// Tiny number: 0.0M
+			(*buffer++) = '0'; (*buffer++) = '.';
+			for (int32 i = 0; i < -decimal; ++i) (*buffer++) = '0';
+			for (int32 i = 0; i < digitCount; ++i) (*buffer++) = (*digit++);
+		}
+		else if (decimal >= digitCount)
+		{
+			// Integer: M00
+			for (int32 i = 0; i < digitCount; ++i) (*buffer++) = (*digit++);
+			for (int32 i = digitCount; i < decimal; ++i) (*buffer++) = '0';
+		}
+		else
+		{
+			// Simple number: A.B
+			for (int32 i = 0; i < decimal; ++i) (*buffer++) = (*digit++);
+			(*buffer++) = '.';
+			for (int32 i = decimal; i < digitCount; ++i) (*buffer++) = (*digit++);
+		}
+	}
+	else
+	{
+		// Scientific notation: P.MeX
+		(*buffer++) = (*digit++);
+		if (digitCount > 1)
+		{
+			(*buffer++) = '.';
+			for (int32 i = 1; i < digitCount; ++i) (*buffer++) = (*digit++);
+		}
+		(*buffer++) = 'e';
+		if (scientificExponent < 0) { (*buffer++) = '-'; scientificExponent = -scientificExponent; }
+		if (scientificExponent >= 10) (*buffer++) = (Char) ('0' + (scientificExponent / 10));
+		(*buffer++) = (Char) ('0' + (scientificExponent % 10));
+	}
+	return buffer;
+}
+
 template <class Char>
 FUStringBuilderT<Char>::FUStringBuilderT(const String& sz)
 {
@@ -234,27 +315,8 @@ void FUStringBuilderT<Char>::append(const FUStringBuilderT& b)
 template <class Char>
 void FUStringBuilderT<Char>::append(float f)
 {
-#ifdef WIN32
-	// use <float.h> _isnan method to detect the 1.#IND00 NaN.
-	if (f != std::numeric_limits<float>::infinity() && f != -std::numeric_limits<float>::infinity() && f != std::numeric_limits<float>::quiet_NaN() && f != std::numeric_limits<float>::signaling_NaN() && !_isnan((double)f))
-#else
-	if (f != std::numeric_limits<float>::infinity() && f != -std::numeric_limits<float>::infinity() && f != std::numeric_limits<float>::quiet_NaN() && f != std::numeric_limits<float>::signaling_NaN())
-#endif
-	{
-		if (IsEquivalent(f, 0.0f, std::numeric_limits<float>::epsilon())) append((Char)'0');
-		else
-		{
-			Char sz[128];
-			FloatToString(f, sz);
-			append(sz + 1);
-		}
-	}
-	else if (f == std::numeric_limits<float>::infinity())
-	{ append((Char)'I'); append((Char)'N'); append((Char)'F'); }
-	else if (f == -std::numeric_limits<float>::infinity())
-	{ append((Char)'-'); append((Char)'I'); append((Char)'N'); append((Char)'F'); }
-	else
-	{ append((Char)'N'); append((Char)'a'); append((Char)'N'); }
+	if (size + FLOAT_SHORTEST_STRING_MAX >= reserved) enlarge(FLOAT_SHORTEST_STRING_MAX);
+	size = FloatToShortestString(f, buffer + size) - buffer;
 }
 
 template <class Char>
@@ -283,6 +345,46 @@ void FUStringBuilderT<Char>::append(double f)
 	{ append((Char)'N'); append((Char)'a'); append((Char)'N'); }
 }
 
+template <class Char>
+void FUStringBuilderT<Char>::appendValues(const float* values, size_t count)
+{
+	if (count == 0) return;
+
+	// One separator and one value per float.
+	size_t maximum = count * (FLOAT_SHORTEST_STRING_MAX + 1);
+	if (size + maximum >= reserved) enlarge(maximum);
+
+	Char* p = FloatToShortestString(*(values++), buffer + size);
+	for (const float* end = values + count - 1; values != end; ++values)
+	{
+		(*p++) = ' ';
+		p = FloatToShortestString(*values, p);
+	}
+	size = p - buffer;
+}
+
+template <class Char>
+void FUStringBuilderT<Char>::appendValues(const uint32* values, size_t count)
+{
+	if (count == 0) return;
+
+	// One separator and at most ten digits per integer.
+	size_t maximum = count * 11;
+	if (size + maximum >= reserved) enlarge(maximum);
+
+	Char* p = buffer + size;
+	Char digits[10];
+	for (const uint32* end = values + count; values != end; ++values)
+	{
+		if (p != buffer + size) (*p++) = ' ';
+		Char* digit = digits + 10;
+		uint32 value = *values;
+		do { (*--digit) = (Char) ('0' + (value % 10)); value /= 10; } while (value != 0);
+		for (; digit != digits + 10; ++digit) (*p++) = *digit;
+	}
+	size = p - buffer;
+}
+
 template <class Char>
 void FUStringBuilderT<Char>::append(const FMVector2& v)
 {
@@ -9,6 +9,7 @@
 #include "StdAfx.h"
 #include "FUTestBed.h"
 #include "FUString.h"
+#include <limits>
 
 TESTSUITE_START(FUStringBuilder)
 
@@ -49,13 +50,11 @@ TESTSUITE_TEST(2, ExtremeNumbers)
 	FUSStringBuilder builder;
 
 	builder.set(-10231.52f);
-	// Last time I checked: we had 6 digits of precision.
-	// If this one fails: the number of digits of precisions have changed
-	// and the strings below are now useless.
-	PassIf(IsEquivalent(builder.ToCharPtr(), "-10231.5"));
+	// Floats are written out with the shortest number of digits that reads back as the same value.
+	PassIf(IsEquivalent(builder.ToCharPtr(), "-10231.52"));
 
 	builder.set(123456789.0f);
-	PassIf(IsEquivalent(builder.ToCharPtr(), "1.23457e8"));
+	PassIf(IsEquivalent(builder.ToCharPtr(), "123456790"));
 
 	builder.set(1e16f);
 	PassIf(IsEquivalent(builder.ToCharPtr(), "1e16"));
@@ -69,8 +68,72 @@ TESTSUITE_TEST(2, ExtremeNumbers)
 	builder.set(9.55e9f);
 	PassIf(IsEquivalent(builder.ToCharPtr(), "9.55e9"));
 
-	// Right now, the expected behavior for very small numbers is to output a zero.
+	// Very small numbers are written out in the scientific notation, rather than as zero.
 	builder.set(-1e-16f);
+	PassIf(IsEquivalent(builder.ToCharPtr(), "-1e-16"));
+
+	builder.set(1.17549435e-38f);
+	PassIf(IsEquivalent(builder.ToCharPtr(), "1.1754944e-38"));
+
+	builder.set(1.4e-45f);
+	PassIf(IsEquivalent(builder.ToCharPtr(), "1e-45"));
+
+	builder.set(0.1f);
+	PassIf(IsEquivalent(builder.ToCharPtr(), "0.1"));
+
+	builder.set(100.0f);
+	PassIf(IsEquivalent(builder.ToCharPtr(), "100"));
+
+	builder.set(-0.0f);
 	PassIf(IsEquivalent(builder.ToCharPtr(), "0"));
 
+	builder.set(std::numeric_limits<float>::infinity());
+	PassIf(IsEquivalent(builder.ToCharPtr(), "INF"));
+
+	builder.set(-std::numeric_limits<float>::infinity());
+	PassIf(IsEquivalent(builder.ToCharPtr(), "-INF"));
+
+	builder.set(std::numeric_limits<float>::quiet_NaN());
+	PassIf(IsEquivalent(builder.ToCharPtr(), "NaN"));
+
+TESTSUITE_TEST(3, RoundTrip)
+	// Every written-out float must read back as the same value.
+	FUSStringBuilder builder;
+	uint32 seed = 12345;
+	for (size_t i = 0; i < 100000; ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		union { uint32 i; float f; } value;
+		value.i = seed;
+		if ((value.i & 0x7F800000) == 0x7F800000) continue;
+
+		builder.set(value.f);
+		const char* sz = builder.ToCharPtr();
+		float readBack = (float) strtod(sz, NULL);
+		FailIf(memcmp(&readBack, &value.f, sizeof(float)) != 0 && value.f != 0.0f);
+		PassIf(FUStringConversion::ToFloat(sz) == value.f);
+	}
+
+TESTSUITE_TEST(4, ValueLists)
+	FloatList floats;
+	floats.push_back(0.5f); floats.push_back(-2.0f); floats.push_back(1e10f); floats.push_back(0.0f);
+	FUSStringBuilder builder;
+	FUStringConversion::ToString(builder, floats);
+	PassIf(IsEquivalent(builder.ToCharPtr(), "0.5 -2 1e10 0"));
+
+	// A space separates the list from the existing content.
+	FUStringConversion::ToString(builder, floats);
+	PassIf(IsEquivalent(builder.ToCharPtr(), "0.5 -2 1e10 0 0.5 -2 1e10 0"));
+
+	FloatList readBack;
+	FUStringConversion::ToFloatList(builder.ToCharPtr(), readBack);
+	PassIf(readBack.size() == 8);
+	for (size_t i = 0; i < readBack.size(); ++i) PassIf(readBack[i] == floats[i % 4]);
+
+	UInt32List integers;
+	integers.push_back(0); integers.push_back(7); integers.push_back(4294967295u);
+	builder.clear();
+	FUStringConversion::ToString(builder, integers);
+	PassIf(IsEquivalent(builder.ToCharPtr(), "0 7 4294967295"));
+
 TESTSUITE_END
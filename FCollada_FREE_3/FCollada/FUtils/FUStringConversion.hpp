@@ -67,7 +67,7 @@ FCOLLADA_EXPORT float FUStringConversion::ToFloat(const CH** value)
 	double val = 0.0;
 	float sign = 1.0;
 	if (*s == '-') { ++s; sign = -1.0; }
-	float decimals = 0.0;
+	double decimals = 0.0;
 	int32 exponent = 0;
 	bool infinity = false;
 	bool nonValidFound = false;
@@ -116,8 +116,10 @@ FCOLLADA_EXPORT float FUStringConversion::ToFloat(const CH** value)
 	{
 		// Generate the value
 		if (decimals == 0.0) decimals = 1.0;
+		// Scale in double precision, so that the shortest strings written out
+		// by the string builder read back as the same values.
+		if (exponent != 0) val *= pow(10.0, (double) exponent);
 		out = (float) (val * sign / decimals);
-		if (exponent != 0) out *= powf(10.0f, (float) exponent);
 	}
 
 	// Find next whitespaces and Skip end whitespaces
@@ -560,9 +562,7 @@ FCOLLADA_EXPORT void FUStringConversion::ToString(FUStringBuilderT<CH>& builder,
 {
 	if (values.empty()) return;
 	if (!builder.empty()) SPACE;
-	FloatList::const_iterator itV = values.begin();
-	builder.append(*itV);
-	for (++itV; itV != values.end(); ++itV) { SPACE; VAL(*itV); }
+	builder.appendValues(values.begin(), values.size());
 }
 
 template <class CH>
@@ -580,8 +580,8 @@ FCOLLADA_EXPORT void FUStringConversion::ToString(FUStringBuilderT<CH>& builder,
 {
 	if (count > 0)
 	{
-		if (builder.empty()) { builder.append(*values++); --count; }
-		while (((intptr_t) count) > 0) { SPACE; VAL(*values++); --count; }
+		if (!builder.empty()) SPACE;
+		builder.appendValues(values, count);
 	}
 }
 
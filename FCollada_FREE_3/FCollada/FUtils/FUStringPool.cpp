@@ -0,0 +1,104 @@
+/*
+	Copyright (C) 2005-2007 Feeling Software Inc.
+	Portions of the code are:
+	Copyright (C) 2005-2007 Sony Computer Entertainment America
+	
+	MIT License: http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "StdAfx.h"
+#include "FUStringPool.h"
+
+//
+// FUStringPool
+//
+
+FUStringPool::FUStringPool()
+{
+}
+
+FUStringPool::~FUStringPool()
+{
+}
+
+// FNV-1a: quick on the short strings that are interned.
+uint32 FUStringPool::Hash(const char* str, size_t length)
+{
+	uint32 hash = 2166136261u;
+	for (size_t i = 0; i < length; ++i)
+	{
+		hash ^= (uint8) str[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// Returns the bucket holding the given string, or the empty bucket where it belongs.
+size_t FUStringPool::FindBucket(const char* str, size_t length, uint32 hash) const
+{
+	size_t mask = buckets.size() - 1;
+	for (size_t i = hash & mask;; i = (i + 1) & mask)
+	{
+		Handle handle = buckets[i];
+		if (handle == 0) return i;
+
+		const Entry& entry = entries[handle - 1];
+		if (entry.hash == hash && entry.length == length && memcmp(characters.begin() + entry.offset, str, length) == 0) return i;
+	}
+}
+
+void FUStringPool::Rehash(size_t bucketCount)
+{
+	buckets.clear();
+	buckets.resize(bucketCount, 0);
+	size_t mask = bucketCount - 1;
+	size_t entryCount = entries.size();
+	for (size_t i = 0; i < entryCount; ++i)
+	{
+		size_t b = entries[i].hash & mask;
+		while (buckets[b] != 0) b = (b + 1) & mask;
+		buckets[b] = (Handle) (i + 1);
+	}
+}
+
+FUStringPool::Handle FUStringPool::Intern(const char* str, size_t length)
+{
+	if (length == 0) return 0;
+
+	// Keep the buckets at most half-full.
+	if ((entries.size() + 1) * 2 > buckets.size()) Rehash(max(buckets.size() * 2, (size_t) 64));
+
+	uint32 hash = Hash(str, length);
+	size_t bucket = FindBucket(str, length, hash);
+	if (buckets[bucket] != 0) return buckets[bucket];
+
+	// Grow the buffers geometrically: the vectors only add fixed-size blocks.
+	size_t offset = characters.size();
+	if (offset + length + 1 > characters.capacity()) characters.reserve(max(characters.capacity() * 2, offset + length + 1 + 1024));
+	if (entries.size() == entries.capacity()) entries.reserve(max(entries.capacity() * 2, (size_t) 64));
+
+	characters.insert(characters.end(), str, length);
+	characters.push_back(0);
+	Entry entry = { (uint32) offset, (uint32) length, hash };
+	entries.push_back(entry);
+	return buckets[bucket] = (Handle) entries.size();
+}
+
+FUStringPool::Handle FUStringPool::Find(const char* str, size_t length) const
+{
+	if (length == 0 || buckets.empty()) return 0;
+	return buckets[FindBucket(str, length, Hash(str, length))];
+}
+
+const char* FUStringPool::GetString(Handle handle) const
+{
+	if (handle == 0 || handle > entries.size()) return emptyCharString;
+	return characters.begin() + entries[handle - 1].offset;
+}
+
+void FUStringPool::clear()
+{
+	characters.clear();
+	entries.clear();
+	buckets.clear();
+}
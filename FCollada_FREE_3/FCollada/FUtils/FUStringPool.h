@@ -0,0 +1,103 @@
+/*
+	Copyright (C) 2005-2007 Feeling Software Inc.
+	Portions of the code are:
+	Copyright (C) 2005-2007 Sony Computer Entertainment America
+	
+	MIT License: http://www.opensource.org/licenses/mit-license.php
+*/
+
+/**
+	@file FUStringPool.h
+	This file contains the FUStringPool class.
+*/
+
+#ifndef _FU_STRING_POOL_H_
+#define _FU_STRING_POOL_H_
+
+/**
+	A pool of interned UTF-8 strings.
+
+	Each distinct string is stored once, in one contiguous character buffer,
+	and is identified by a 32-bit handle. Two strings interned in the same pool
+	are equal if and only if their handles are equal. The empty string is
+	always interned, with the handle zero.
+
+	The strings are only removed all at once, with the clear function:
+	a pool is meant to be short-lived and scoped to the index that uses it,
+	such as the animation target pointers of one document import.
+
+	@ingroup FUtils
+*/
+class FCOLLADA_EXPORT FUStringPool
+{
+public:
+	/** A handle to an interned string. */
+	typedef uint32 Handle;
+
+private:
+	struct Entry
+	{
+		uint32 offset; // Within the character buffer.
+		uint32 length;
+		uint32 hash;
+	};
+	typedef fm::vector<Entry, true> EntryList;
+
+	fm::vector<char, true> characters; // All the strings, each followed by its null terminator.
+	EntryList entries; // Indexed by handle - 1.
+	fm::vector<Handle, true> buckets; // Open addressing, power-of-two size. Empty buckets are zero.
+
+public:
+	/** Constructor. */
+	FUStringPool();
+
+	/** Destructor. */
+	~FUStringPool();
+
+	/** Interns a string.
+		@param str The string to intern. It does not need to be null-terminated.
+		@param length The length of the string.
+		@return The handle of the interned string. */
+	Handle Intern(const char* str, size_t length);
+	inline Handle Intern(const char* str) { return Intern(str, (str != NULL) ? strlen(str) : 0); } /**< See above. */
+	inline Handle Intern(const fm::string& str) { return Intern(str.c_str(), str.length()); } /**< See above. */
+
+	/** Retrieves the handle of an already interned string, without interning it.
+		@param str The string to look for. It does not need to be null-terminated.
+		@param length The length of the string.
+		@return The handle of the interned string. This handle is zero
+			for the empty string and for the strings that are not interned. */
+	Handle Find(const char* str, size_t length) const;
+	inline Handle Find(const char* str) const { return Find(str, (str != NULL) ? strlen(str) : 0); } /**< See above. */
+	inline Handle Find(const fm::string& str) const { return Find(str.c_str(), str.length()); } /**< See above. */
+
+	/** Retrieves an interned string.
+		@param handle The handle of the interned string.
+		@return The null-terminated string. This pointer is only valid
+			until the next string is interned. */
+	const char* GetString(Handle handle) const;
+
+	/** Retrieves the length of an interned string.
+		@param handle The handle of the interned string.
+		@return The length of the string. */
+	inline size_t GetLength(Handle handle) const { return (handle != 0 && handle <= entries.size()) ? entries[handle - 1].length : 0; }
+
+	/** Retrieves the number of strings interned in the pool.
+		@return The number of strings, not counting the empty string. */
+	inline size_t GetCount() const { return entries.size(); }
+
+	/** Retrieves the size of the character buffer.
+		@return The number of bytes used by the strings and their null terminators. */
+	inline size_t GetCharacterCount() const { return characters.size(); }
+
+	/** Removes all the strings from the pool.
+		All the handles previously returned are invalidated. */
+	void clear();
+
+private:
+	static uint32 Hash(const char* str, size_t length);
+	size_t FindBucket(const char* str, size_t length, uint32 hash) const;
+	void Rehash(size_t bucketCount);
+};
+
+#endif // _FU_STRING_POOL_H_
@@ -0,0 +1,63 @@
+/*
+	Copyright (C) 2005-2007 Feeling Software Inc.
+	Portions of the code are:
+	Copyright (C) 2005-2007 Sony Computer Entertainment America
+	
+	MIT License: http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "StdAfx.h"
+#include "FUStringPool.h"
+#include "FUTestBed.h"
+
+TESTSUITE_START(FUStringPool)
+
+TESTSUITE_TEST(0, Interning)
+	FUStringPool pool;
+	PassIf(pool.Intern("") == 0);
+	PassIf(pool.Find("Test") == 0);
+	PassIf(IsEquivalent(pool.GetString(0), ""));
+
+	// The same string always gets the same handle.
+	FUStringPool::Handle test = pool.Intern("Test");
+	FUStringPool::Handle glad = pool.Intern(fm::string("Glad"));
+	FailIf(test == 0);
+	FailIf(glad == 0);
+	FailIf(test == glad);
+	PassIf(pool.Intern("Test") == test);
+	PassIf(pool.Find("Glad") == glad);
+	PassIf(pool.Intern("Testing", 4) == test);
+	PassIf(pool.Find("Tes") == 0);
+	PassIf(pool.GetCount() == 2);
+
+	PassIf(IsEquivalent(pool.GetString(test), "Test"));
+	PassIf(IsEquivalent(pool.GetString(glad), "Glad"));
+	PassIf(pool.GetLength(test) == 4);
+
+	pool.clear();
+	PassIf(pool.GetCount() == 0);
+	PassIf(pool.Find("Test") == 0);
+
+TESTSUITE_TEST(1, ManyStrings)
+	// Enough strings to grow the buckets and the character buffer many times over.
+	FUStringPool pool;
+	FUSStringBuilder builder;
+	fm::vector<FUStringPool::Handle, true> handles;
+	for (uint32 i = 0; i < 5000; ++i)
+	{
+		builder.set("Node");
+		builder.append(i);
+		handles.push_back(pool.Intern(builder.ToCharPtr()));
+	}
+	PassIf(pool.GetCount() == 5000);
+
+	for (uint32 i = 0; i < 5000; ++i)
+	{
+		builder.set("Node");
+		builder.append(i);
+		PassIf(pool.Find(builder.ToCharPtr()) == handles[i]);
+		PassIf(IsEquivalent(pool.GetString(handles[i]), builder.ToCharPtr()));
+	}
+	PassIf(pool.GetCount() == 5000);
+
+TESTSUITE_END
@@ -85,6 +85,7 @@ TESTSUITE_TEST(2, SubTestSuites)
 	RUN_TESTSUITE(FUStringBuilder);
 	RUN_TESTSUITE(FUStringConversion);
 	RUN_TESTSUITE(FUUniqueStringMap);
+	RUN_TESTSUITE(FUStringPool);
 #ifndef WIN32
 	PassIf(true);
 #endif // WIN32
@@ -9,9 +9,15 @@
 #include "StdAfx.h"
 #include "FUThread.h"
 
+#ifndef WIN32
+#include <sched.h>
+#endif // WIN32
+
 FUThread::FUThread()
 #ifdef WIN32
 :	thread(NULL)
+#else
+:	isRunning(false)
 #endif
 {
 }
@@ -24,6 +30,8 @@ void FUThread::YieldCurrentThread()
 {
 #ifdef WIN32
 	SwitchToThread();
+#else
+	sched_yield();
 #endif
 }
 
@@ -31,13 +39,27 @@ void FUThread::SleepCurrentThread(unsigned long milliseconds)
 {
 #ifdef WIN32
 	Sleep(milliseconds);
+#else
+	usleep((useconds_t) milliseconds * 1000);
+#endif
+}
+
+uint32 FUThread::GetProcessorCount()
+{
+#ifdef WIN32
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	return (systemInfo.dwNumberOfProcessors > 1) ? (uint32) systemInfo.dwNumberOfProcessors : 1;
+#else
+	long processorCount = sysconf(_SC_NPROCESSORS_ONLN);
+	return (processorCount > 1) ? (uint32) processorCount : 1;
 #endif
 }
 
 #ifdef WIN32
 FUThread* FUThread::CreateFUThread(LPTHREAD_START_ROUTINE lpStartAddress, void* lpParameter)
 #else
-FUThread* FUThread::CreateFUThread()
+FUThread* FUThread::CreateFUThread(void* (*lpStartAddress)(void*), void* lpParameter)
 #endif // WIN32
 {
 #ifdef WIN32
@@ -45,7 +67,10 @@ FUThread* FUThread::CreateFUThread()
 	newThread->thread = CreateThread(NULL, 0, lpStartAddress, lpParameter, 0, NULL);
 	return newThread;
 #else
-	return NULL;
+	FUThread* newThread = new FUThread();
+	newThread->isRunning = pthread_create(&newThread->thread, NULL, lpStartAddress, lpParameter) == 0;
+	if (!newThread->isRunning) SAFE_DELETE(newThread);
+	return newThread;
 #endif
 }
 
@@ -57,6 +82,11 @@ void FUThread::ExitFUThread(FUThread* thread)
 	WaitForSingleObject(thread->thread, INFINITE);
 	CloseHandle(thread->thread); // delete the thread once it's finished
 	SAFE_DELETE(thread);
+#else
+	if (thread == NULL) return;
+
+	if (thread->isRunning) pthread_join(thread->thread, NULL);
+	SAFE_DELETE(thread);
 #endif
 }
 
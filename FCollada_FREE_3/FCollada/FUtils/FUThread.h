@@ -14,10 +14,14 @@
 #ifndef _FU_THREAD_H_
 #define _FU_THREAD_H_
 
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
 /**
 	An OS independent thread. 
 	
-	Currently only supported for WIN32.
+	Implemented with WIN32 threads on Windows and POSIX threads everywhere else.
 
 	@ingroup FUtils
 */
@@ -27,7 +31,8 @@ private:
 #ifdef WIN32
 	HANDLE thread;
 #else
-#warning "Threads not yet implemented for non Windows."
+	pthread_t thread;
+	bool isRunning;
 #endif
 
 private:
@@ -46,7 +51,7 @@ public:
 #ifdef WIN32
 	static FUThread* CreateFUThread(LPTHREAD_START_ROUTINE lpStartAddress, void* lpParameter);
 #else
-	static FUThread* CreateFUThread(); // TODO: implement and merge with WIN32, removing the LPTHREAD_START_ROUTINE
+	static FUThread* CreateFUThread(void* (*lpStartAddress)(void*), void* lpParameter);
 #endif
 
 	/** Waits for the thread to exit and clean up after it.
@@ -59,6 +64,10 @@ public:
 	/** Sleeps the current thread for a minimum specified duration.
 		@param milliseconds The duration to sleep. */
 	static void SleepCurrentThread(unsigned long milliseconds);
+
+	/** Retrieves the number of processors available to run threads.
+		@return The number of online processors. This value is always at least 1. */
+	static uint32 GetProcessorCount();
 };
 
 #endif // _FU_THREAD_H_
@@ -9,6 +9,7 @@
 #include "StdAfx.h"
 #include "FUXmlDocument.h"
 #include "FUXmlWriter.h"
+#include "FUXmlStreamWriter.h"
 #include "FUFileManager.h"
 #include "FUFile.h"
 #include "FCDocument/FCDocument.h"
@@ -21,6 +22,7 @@
 FUXmlDocument::FUXmlDocument(FUFileManager* manager, const fchar* _filename, bool _isParsing)
 :	isParsing(_isParsing), filename(_filename)
 ,	xmlDocument(NULL)
+,	isStreaming(false)
 {
 	if (isParsing)
 	{
@@ -50,6 +52,7 @@ FUXmlDocument::FUXmlDocument(FUFileManager* manager, const fchar* _filename, boo
 FUXmlDocument::FUXmlDocument(const char* data, size_t length)
 :	isParsing(true)
 ,	xmlDocument(NULL)
+,	isStreaming(false)
 {
 	FUAssert(data != NULL, return);
 
@@ -69,9 +72,10 @@ FUXmlDocument::FUXmlDocument(const char* data, size_t length)
 
 FUXmlDocument::~FUXmlDocument()
 {
-	// Release the XML document
+	// Release the XML document.
+	// The parser's global state is cleaned up once, when the archive plug-in is released,
+	// since other documents may still be parsing on other threads.
 	ReleaseXmlData();
-	xmlCleanupParser();
 }
 
 xmlNode* FUXmlDocument::GetRootNode()
@@ -106,6 +110,48 @@ void FUXmlDocument::ReleaseXmlData()
 		xmlFreeDoc(xmlDocument);
 		xmlDocument = NULL;
 	}
+	CLEAR_POINTER_VECTOR(deferredContents);
+}
+
+void FUXmlDocument::SetStreaming(bool streaming)
+{
+	FUAssert(!isParsing && xmlDocument != NULL, return);
+	isStreaming = streaming;
+
+	// FUXmlWriter::AddContentValues finds the document through the libxml document.
+	xmlDocument->_private = isStreaming ? (void*) this : NULL;
+}
+
+void FUXmlDocument::ConvertDeferredContents(xmlNode* node)
+{
+	// Walk the tree, rather than the deferred content list, since nodes may have been released.
+	for (; node != NULL; node = node->next)
+	{
+		if (node->type != XML_ELEMENT_NODE) continue;
+		if (node->_private != NULL)
+		{
+			FUXmlDeferredContent* content = (FUXmlDeferredContent*) node->_private;
+			FUSStringBuilder builder;
+			if (!content->floatValues.empty()) builder.appendValues(content->floatValues.begin(), content->floatValues.size());
+			else builder.appendValues(content->uint32Values.begin(), content->uint32Values.size());
+			node->_private = NULL;
+
+			// The deferred content always comes first.
+			xmlNode* text = xmlNewDocText(xmlDocument, (const xmlChar*) builder.ToCharPtr());
+			if (node->children == NULL) xmlAddChild(node, text);
+			else xmlAddPrevSibling(node->children, text);
+		}
+		ConvertDeferredContents(node->children);
+	}
+}
+
+FUXmlDeferredContent* FUXmlDocument::AddDeferredContent(xmlNode* node)
+{
+	FUAssert(node->_private == NULL && node->children == NULL, return NULL);
+	FUXmlDeferredContent* content = new FUXmlDeferredContent();
+	deferredContents.push_back(content);
+	node->_private = (void*) content;
+	return content;
 }
 
 // Writes out the XML document.
@@ -114,5 +160,14 @@ bool FUXmlDocument::Write(const char* encoding)
 	FUFile file(filename, FUFile::WRITE);
 	if (!file.IsOpen()) return false;
 	xmlDocument->encoding = xmlStrdup((const xmlChar*) encoding);
-	return xmlDocFormatDump(file.GetHandle(), xmlDocument, 1) > 0;
+	// The streaming writer only outputs UTF-8: let libxml handle the other encodings.
+	if (!isStreaming || !IsEquivalentI(encoding, "utf-8"))
+	{
+		ConvertDeferredContents(xmlDocGetRootElement(xmlDocument));
+		return xmlDocFormatDump(file.GetHandle(), xmlDocument, 1) > 0;
+	}
+
+	FUXmlStreamWriter writer(&file);
+	writer.WriteDocument(xmlDocument);
+	return writer.Close();
 }
@@ -15,6 +15,15 @@ typedef struct _xmlDoc xmlDoc;
 
 #ifdef HAS_LIBXML
 
+/** The numerical content of a XML tree node, kept in binary form until the
+	document is written out. Only one of the two lists is filled in.
+	See FUXmlWriter::AddContentValues. */
+struct FUXmlDeferredContent
+{
+	FloatList floatValues; /**< The floating-point values. */
+	UInt32List uint32Values; /**< The unsigned integer values. */
+};
+
 /** Simple container for a XML document.
 	When this container is released, it will automatically release the XML document. */
 class FCOLLADA_EXPORT FUXmlDocument
@@ -24,6 +33,9 @@ private:
 	fstring filename;
 	xmlDoc* xmlDocument;
 
+	bool isStreaming;
+	fm::pvector<FUXmlDeferredContent> deferredContents;
+
 public:
 	/** Constructor.
 		Opens the XML document for the given filename.
@@ -55,10 +67,31 @@ public:
 			if the document did not load successfully. */
 	xmlNode* GetRootNode();
 
+	/** Sets whether the XML document is written out with the streaming writer.
+		When streaming, the numerical contents added with FUXmlWriter::AddContentValues
+		stay in binary form within the document and they are formatted, in chunks,
+		directly into the file. The output is identical to the libxml serialization.
+		This should be set before the XML tree is built.
+		@param streaming Whether to use the streaming writer. */
+	void SetStreaming(bool streaming);
+
+	/** Retrieves whether the XML document is written out with the streaming writer.
+		@return Whether the streaming writer is used. */
+	inline bool IsStreaming() const { return isStreaming; }
+
+	/** Attaches a new deferred content to a XML tree node of this document.
+		This function is used by FUXmlWriter::AddContentValues.
+		@param node The XML tree node. It must not have any content.
+		@return The new deferred content, owned by the document. */
+	FUXmlDeferredContent* AddDeferredContent(xmlNode* node);
+
 	/** Writes out the XML document.
 		@param encoding The format encoding string.
 		@return Whether the XML document was written out successfully. */
 	bool Write(const char* encoding = "utf-8");
+
+private:
+	void ConvertDeferredContents(xmlNode* node);
 };
 
 #endif // HAS_LIBXML
@@ -0,0 +1,382 @@
+/*
+	Copyright (C) 2005-2007 Feeling Software Inc.
+	Portions of the code are:
+	Copyright (C) 2005-2007 Sony Computer Entertainment America
+	
+	MIT License: http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "StdAfx.h"
+#include "FUXmlStreamWriter.h"
+#include "FUXmlDocument.h"
+#include "FUFile.h"
+#include "FUStringBuilder.h"
+#include <libxml/parserInternals.h> // For xmlStringTextNoenc.
+
+// The number of values formatted at once for a deferred content.
+#define DEFERRED_CHUNK_SIZE 4096
+
+// Same as the libxml serializer: two spaces per level, up to thirty levels.
+#define INDENT_MAX_LEVEL 30
+
+//
+// FUXmlStreamWriter
+//
+
+FUXmlStreamWriter::FUXmlStreamWriter(FUFile* _file)
+:	file(_file), buffer(NULL), bufferUsed(0), failed(false)
+{
+	buffer = new char[BUFFER_SIZE];
+}
+
+FUXmlStreamWriter::~FUXmlStreamWriter()
+{
+	Flush();
+	SAFE_DELETE_ARRAY(buffer);
+}
+
+bool FUXmlStreamWriter::Close()
+{
+	Flush();
+	if (file != NULL) file->Flush();
+	return !failed;
+}
+
+void FUXmlStreamWriter::Flush()
+{
+	if (bufferUsed > 0 && !failed)
+	{
+		failed = file == NULL || !file->Write(buffer, bufferUsed);
+	}
+	bufferUsed = 0;
+}
+
+void FUXmlStreamWriter::Write(const char* data, size_t length)
+{
+	while (length > 0)
+	{
+		if (bufferUsed == BUFFER_SIZE) Flush();
+		size_t count = min(length, BUFFER_SIZE - bufferUsed);
+		memcpy(buffer + bufferUsed, data, count);
+		bufferUsed += count;
+		data += count;
+		length -= count;
+	}
+}
+
+void FUXmlStreamWriter::WriteDocument(xmlDoc* document)
+{
+	FUAssert(document != NULL, return);
+
+	// The XML declaration.
+	WriteString("<?xml version=");
+	if (document->version != NULL) WriteQuotedString((const char*) document->version);
+	else WriteString("\"1.0\"");
+	if (document->encoding != NULL)
+	{
+		WriteString(" encoding=");
+		WriteQuotedString((const char*) document->encoding);
+	}
+	if (document->standalone == 0) WriteString(" standalone=\"no\"");
+	else if (document->standalone == 1) WriteString(" standalone=\"yes\"");
+	WriteString("?>\n");
+
+	// The document's top-level nodes are never indented.
+	for (xmlNode* child = document->children; child != NULL; child = child->next)
+	{
+		WriteNode(child, 0, true);
+		Write('\n');
+	}
+}
+
+void FUXmlStreamWriter::WriteChildren(xmlNode* child, int level, bool format)
+{
+	for (; child != NULL; child = child->next)
+	{
+		if (format && child->type == XML_ELEMENT_NODE) WriteIndent(level);
+		WriteNode(child, level, format);
+		if (format) Write('\n');
+	}
+}
+
+void FUXmlStreamWriter::WriteNode(xmlNode* node, int level, bool format)
+{
+	switch (node->type)
+	{
+	case XML_ELEMENT_NODE: break;
+	case XML_TEXT_NODE:
+		if (node->content != NULL)
+		{
+			if (node->name == xmlStringTextNoenc) WriteString((const char*) node->content);
+			else WriteEscapedContent((const char*) node->content);
+		}
+		return;
+	case XML_CDATA_SECTION_NODE:
+		if (node->content != NULL)
+		{
+			// Split the section around any ']]>' sequence.
+			const char* start = (const char*) node->content;
+			const char* end = start;
+			for (; *end != 0; ++end)
+			{
+				if (end[0] == ']' && end[1] == ']' && end[2] == '>')
+				{
+					end += 2;
+					WriteString("<![CDATA[");
+					Write(start, end - start);
+					WriteString("]]>");
+					start = end;
+				}
+			}
+			if (start != end)
+			{
+				WriteString("<![CDATA[");
+				Write(start, end - start);
+				WriteString("]]>");
+			}
+		}
+		return;
+	case XML_COMMENT_NODE:
+		if (node->content != NULL)
+		{
+			WriteString("<!--");
+			WriteString((const char*) node->content);
+			WriteString("-->");
+		}
+		return;
+	case XML_PI_NODE:
+		WriteString("<?");
+		WriteString((const char*) node->name);
+		if (node->content != NULL)
+		{
+			Write(' ');
+			WriteString((const char*) node->content);
+		}
+		WriteString("?>");
+		return;
+	case XML_ENTITY_REF_NODE:
+		Write('&');
+		WriteString((const char*) node->name);
+		Write(';');
+		return;
+	default:
+		// Declarations and the other node types are not found in the FCollada trees.
+		return;
+	}
+
+	// A deferred content behaves as a first text child.
+	bool hasDeferredContent = node->_private != NULL;
+	bool childFormat = format && !hasDeferredContent;
+	for (xmlNode* child = node->children; child != NULL && childFormat; child = child->next)
+	{
+		if (child->type == XML_TEXT_NODE || child->type == XML_CDATA_SECTION_NODE || child->type == XML_ENTITY_REF_NODE)
+		{
+			childFormat = false;
+		}
+	}
+
+	Write('<');
+	if (node->ns != NULL && node->ns->prefix != NULL)
+	{
+		WriteString((const char*) node->ns->prefix);
+		Write(':');
+	}
+	WriteString((const char*) node->name);
+	for (xmlNs* ns = node->nsDef; ns != NULL; ns = ns->next)
+	{
+		if (ns->type != XML_LOCAL_NAMESPACE || ns->href == NULL) continue;
+		if (ns->prefix != NULL && strcmp((const char*) ns->prefix, "xml") == 0) continue;
+		if (ns->prefix != NULL)
+		{
+			WriteString(" xmlns:");
+			WriteString((const char*) ns->prefix);
+		}
+		else WriteString(" xmlns");
+		Write('=');
+		WriteQuotedString((const char*) ns->href);
+	}
+	for (xmlAttr* attribute = node->properties; attribute != NULL; attribute = attribute->next)
+	{
+		WriteAttribute(attribute);
+	}
+
+	if (node->children == NULL && !hasDeferredContent)
+	{
+		WriteString("/>");
+		return;
+	}
+
+	Write('>');
+	if (hasDeferredContent) WriteDeferredContent(node);
+	if (node->children != NULL)
+	{
+		if (childFormat) Write('\n');
+		WriteChildren(node->children, level + 1, childFormat);
+		if (childFormat) WriteIndent(level);
+	}
+	WriteString("</");
+	if (node->ns != NULL && node->ns->prefix != NULL)
+	{
+		WriteString((const char*) node->ns->prefix);
+		Write(':');
+	}
+	WriteString((const char*) node->name);
+	Write('>');
+}
+
+void FUXmlStreamWriter::WriteDeferredContent(xmlNode* node)
+{
+	const FUXmlDeferredContent* content = (const FUXmlDeferredContent*) node->_private;
+
+	// Format the values in chunks, to keep the memory usage bounded.
+	FUSStringBuilder builder;
+	size_t floatCount = content->floatValues.size(), uint32Count = content->uint32Values.size();
+	for (size_t i = 0; i < floatCount; i += DEFERRED_CHUNK_SIZE)
+	{
+		builder.clear();
+		if (i > 0) builder.append(' ');
+		builder.appendValues(content->floatValues.begin() + i, min(floatCount - i, (size_t) DEFERRED_CHUNK_SIZE));
+		Write(builder.ToCharPtr(), builder.length());
+	}
+	for (size_t i = 0; i < uint32Count; i += DEFERRED_CHUNK_SIZE)
+	{
+		builder.clear();
+		if (i > 0) builder.append(' ');
+		builder.appendValues(content->uint32Values.begin() + i, min(uint32Count - i, (size_t) DEFERRED_CHUNK_SIZE));
+		Write(builder.ToCharPtr(), builder.length());
+	}
+}
+
+void FUXmlStreamWriter::WriteAttribute(xmlAttr* attribute)
+{
+	Write(' ');
+	if (attribute->ns != NULL && attribute->ns->prefix != NULL)
+	{
+		WriteString((const char*) attribute->ns->prefix);
+		Write(':');
+	}
+	WriteString((const char*) attribute->name);
+	WriteString("=\"");
+
+	// Without a document encoding, libxml writes out the non-ASCII characters as references.
+	bool escapeExtended = attribute->doc == NULL || attribute->doc->encoding == NULL;
+	for (xmlNode* child = attribute->children; child != NULL; child = child->next)
+	{
+		if (child->type == XML_TEXT_NODE)
+		{
+			if (child->content != NULL) WriteEscapedAttribute((const char*) child->content, escapeExtended);
+		}
+		else if (child->type == XML_ENTITY_REF_NODE)
+		{
+			Write('&');
+			WriteString((const char*) child->name);
+			Write(';');
+		}
+	}
+	Write('"');
+}
+
+void FUXmlStreamWriter::WriteIndent(int level)
+{
+	if (level > INDENT_MAX_LEVEL) level = INDENT_MAX_LEVEL;
+	for (int i = 0; i < level; ++i) Write("  ", 2);
+}
+
+void FUXmlStreamWriter::WriteEscapedContent(const char* text)
+{
+	const char* base = text;
+	for (; *text != 0; ++text)
+	{
+		const char* entity;
+		switch (*text)
+		{
+		case '<': entity = "&lt;"; break;
+		case '>': entity = "&gt;"; break;
+		case '&': entity = "&amp;"; break;
+		case '\r': entity = "&#13;"; break;
+		default: continue;
+		}
+		Write(base, text - base);
+		WriteString(entity);
+		base = text + 1;
+	}
+	Write(base, text - base);
+}
+
+void FUXmlStreamWriter::WriteEscapedAttribute(const char* text, bool escapeExtended)
+{
+	const uint8* base = (const uint8*) text;
+	const uint8* c = base;
+	while (*c != 0)
+	{
+		const char* entity;
+		switch (*c)
+		{
+		case '\n': entity = "&#10;"; break;
+		case '\r': entity = "&#13;"; break;
+		case '\t': entity = "&#9;"; break;
+		case '"': entity = "&quot;"; break;
+		case '<': entity = "&lt;"; break;
+		case '>': entity = "&gt;"; break;
+		case '&': entity = "&amp;"; break;
+		default: entity = NULL; break;
+		}
+
+		if (entity != NULL)
+		{
+			Write((const char*) base, c - base);
+			WriteString(entity);
+			base = ++c;
+		}
+		else if (*c >= 0x80 && escapeExtended)
+		{
+			// Decode the UTF-8 sequence: invalid bytes are written out on their own.
+			Write((const char*) base, c - base);
+			uint32 value = 0, length = 1;
+			if (*c >= 0xC0 && *c < 0xE0) { value = c[0] & 0x1F; length = 2; }
+			else if (*c >= 0xE0 && *c < 0xF0) { value = c[0] & 0x0F; length = 3; }
+			else if (*c >= 0xF0 && *c < 0xF8) { value = c[0] & 0x07; length = 4; }
+			for (uint32 i = 1; i < length; ++i) value = (value << 6) | (c[i] & 0x3F);
+			bool isCharacter = (value >= 0x20 && value <= 0xD7FF) || (value >= 0xE000 && value <= 0xFFFD) || (value >= 0x10000 && value <= 0x10FFFF);
+			if (length == 1 || !isCharacter) { value = *c; length = 1; }
+			WriteHexCharRef(value);
+			c += length;
+			base = c;
+		}
+		else ++c;
+	}
+	Write((const char*) base, c - base);
+}
+
+void FUXmlStreamWriter::WriteQuotedString(const char* text)
+{
+	if (strchr(text, '"') == NULL)
+	{
+		Write('"'); WriteString(text); Write('"');
+	}
+	else if (strchr(text, '\'') == NULL)
+	{
+		Write('\''); WriteString(text); Write('\'');
+	}
+	else
+	{
+		Write('"');
+		for (; *text != 0; ++text)
+		{
+			if (*text == '"') WriteString("&quot;");
+			else Write(*text);
+		}
+		Write('"');
+	}
+}
+
+void FUXmlStreamWriter::WriteHexCharRef(uint32 value)
+{
+	static const char* hexDigits = "0123456789ABCDEF";
+	char digits[8];
+	int count = 0;
+	do { digits[count++] = hexDigits[value & 0xF]; value >>= 4; } while (value > 0);
+	WriteString("&#x");
+	while (count > 0) Write(digits[--count]);
+	Write(';');
+}
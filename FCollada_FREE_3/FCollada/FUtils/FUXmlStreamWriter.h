@@ -0,0 +1,79 @@
+/*
+	Copyright (C) 2005-2007 Feeling Software Inc.
+	Portions of the code are:
+	Copyright (C) 2005-2007 Sony Computer Entertainment America
+	
+	MIT License: http://www.opensource.org/licenses/mit-license.php
+*/
+
+/**
+@file FUXmlStreamWriter.h
+This file defines the FUXmlStreamWriter class.
+*/
+
+#ifndef _FU_XML_STREAM_WRITER_H_
+#define _FU_XML_STREAM_WRITER_H_
+
+#ifdef HAS_LIBXML
+
+class FUFile;
+
+/**
+A streaming XML document serializer.
+
+The XML tree is written out through a fixed-size buffer, directly into the file.
+The numerical contents attached to the XML tree nodes with
+FUXmlWriter::AddContentValues are formatted in small chunks, so that
+their text is never held in memory in its entirety.
+
+The output is identical to the one of the libxml 'xmlDocFormatDump'
+function, for UTF-8 documents.
+This class is considered internal and should only be used by FUXmlDocument.
+
+@ingroup FUtils
+*/
+class FCOLLADA_EXPORT FUXmlStreamWriter
+{
+private:
+	FUFile* file;
+	char* buffer;
+	size_t bufferUsed;
+	bool failed;
+
+public:
+	/** Constructor.
+		@param file The file to write into. It must be opened for writing. */
+	FUXmlStreamWriter(FUFile* file);
+
+	/** Destructor. Flushes the buffered output. */
+	~FUXmlStreamWriter();
+
+	/** Writes out a XML document: its declaration and its tree.
+		@param document The XML document. */
+	void WriteDocument(xmlDoc* document);
+
+	/** Flushes the buffered output into the file.
+		@return Whether all the output was written out successfully. */
+	bool Close();
+
+private:
+	void WriteNode(xmlNode* node, int level, bool format);
+	void WriteChildren(xmlNode* child, int level, bool format);
+	void WriteDeferredContent(xmlNode* node);
+	void WriteAttribute(xmlAttr* attribute);
+	void WriteIndent(int level);
+	void WriteEscapedContent(const char* text);
+	void WriteEscapedAttribute(const char* text, bool escapeExtended);
+	void WriteQuotedString(const char* text);
+	void WriteHexCharRef(uint32 value);
+	void WriteString(const char* text) { Write(text, strlen(text)); }
+	void Write(const char* data, size_t length);
+	void Write(char c) { if (bufferUsed == BUFFER_SIZE) Flush(); buffer[bufferUsed++] = c; }
+	void Flush();
+
+	static const size_t BUFFER_SIZE = 65536;
+};
+
+#endif // HAS_LIBXML
+
+#endif // _FU_XML_STREAM_WRITER_H_
@@ -9,6 +9,7 @@
 #include "StdAfx.h"
 #include "FUXmlWriter.h"
 #include "FUXmlParser.h"
+#include "FUXmlDocument.h"
 #include "FUStringConversion.h"
 
 #define xcT(text) (const xmlChar*) (text)
@@ -191,6 +192,50 @@ namespace FUXmlWriter
 		if (node != NULL) xmlNodeAddContent(node, xcT(content));
 	}
 
+	// Retrieves the streaming document of a XML tree node, if its content may be deferred.
+	static FUXmlDocument* GetStreamingDocument(xmlNode* node)
+	{
+		// Deferred content always comes first: the node must not have any content yet.
+		if (node->doc == NULL || node->children != NULL || node->_private != NULL) return NULL;
+		return (FUXmlDocument*) node->doc->_private;
+	}
+
+	void AddContentValues(xmlNode* node, const float* values, size_t count)
+	{
+		if (node == NULL || count == 0) return;
+
+		FUXmlDocument* document = GetStreamingDocument(node);
+		if (document != NULL)
+		{
+			FUXmlDeferredContent* content = document->AddDeferredContent(node);
+			content->floatValues.insert(content->floatValues.end(), values, count);
+		}
+		else
+		{
+			FUSStringBuilder builder;
+			builder.appendValues(values, count);
+			xmlNodeAddContent(node, xcT(builder.ToCharPtr()));
+		}
+	}
+
+	void AddContentValues(xmlNode* node, const uint32* values, size_t count)
+	{
+		if (node == NULL || count == 0) return;
+
+		FUXmlDocument* document = GetStreamingDocument(node);
+		if (document != NULL)
+		{
+			FUXmlDeferredContent* content = document->AddDeferredContent(node);
+			content->uint32Values.insert(content->uint32Values.end(), values, count);
+		}
+		else
+		{
+			FUSStringBuilder builder;
+			builder.appendValues(values, count);
+			xmlNodeAddContent(node, xcT(builder.ToCharPtr()));
+		}
+	}
+
 	void AddAttribute(xmlNode* node, const char* attributeName, const char* value)
 	{
 		if (node != NULL)
@@ -71,6 +71,17 @@ namespace FUXmlWriter
 	inline void AddContentUnprocessed(xmlNode* node, const fm::string& content) { return AddContentUnprocessed(node, content.c_str()); } /**< See above. */
 	inline void AddContentUnprocessed(xmlNode* node, FUSStringBuilder& content) { return AddContentUnprocessed(node, content.ToCharPtr()); } /**< See above. */
 
+	/** Appends a list of numerical values, separated by spaces, as the content of a XML tree node.
+		If the XML tree node belongs to a streaming document, the values are copied
+		in binary form and they are only formatted when the document is written out.
+		Otherwise, they are converted into a content string right away.
+		See FUXmlDocument::SetStreaming.
+		@param node The XML tree node.
+		@param values A contiguous array of numerical values.
+		@param count The number of values in the array. */
+	FCOLLADA_EXPORT void AddContentValues(xmlNode* node, const float* values, size_t count);
+	FCOLLADA_EXPORT void AddContentValues(xmlNode* node, const uint32* values, size_t count); /**< See above. */
+
 	/** Creates a child XML tree node within a XML tree node.
 		The child XML tree node is added at the end of the parent XML tree node children list.
 		The given content value is added, in string-form, to the returned child XML tree node.
@@ -228,7 +228,9 @@ inline int wcsicmp(const wchar_t* s1, const wchar_t* s2) { wchar_t c1 = *s1, c2
 	@param byteCount The number of bytes to align to.*/
 //#define ALIGN_STRUCT(byteCount) __declspec(align(byteCount))
 #define ALIGN_STRUCT(byteCount)
-#else // !WIN32
+#elif defined(__GNUC__)
+#define ALIGN_STRUCT(byteCount) __attribute__((aligned(byteCount)))
+#else // !WIN32 && !__GNUC__
 #define ALIGN_STRUCT(byteCount)
 #endif // WIN32
 
@@ -17,6 +17,7 @@
 #include "FCDocument/FCDAnimationChannel.h"
 #include "FCDocument/FCDAnimationCurve.h"
 #include "FCDocument/FCDAnimationMultiCurve.h"
+#include "FUtils/FUCrc32.h"
 
 #define DONT_DEFINE_THIS
 
@@ -27,7 +28,7 @@
 bool FArchiveXML::LoadAnimationChannel(FCDObject* object, xmlNode* channelNode)
 { 
 	FCDAnimationChannel* animationChannel = (FCDAnimationChannel*)object;
-	FCDAnimationChannelData& data = FArchiveXML::documentLinkDataMap[animationChannel->GetDocument()].animationChannelData[animationChannel];
+	FCDAnimationChannelData& data = FArchiveXML::GetLinkData(animationChannel->GetDocument()).animationChannelData[animationChannel];
 
 	bool status = true;
 
@@ -109,6 +110,11 @@ bool FArchiveXML::LoadAnimationChannel(FCDObject* object, xmlNode* channelNode)
 		interpolations.insert(interpolations.end(), keyCount - interpolations.size(), FUDaeInterpolation::FromString(""));
 	}
 
+	// Count the keys of each interpolation type: the curves allocate them in one block per type.
+	size_t interpolationCounts[FUDaeInterpolation::UNKNOWN + 1];
+	memset(interpolationCounts, 0, sizeof(interpolationCounts));
+	for (size_t j = 0; j < keyCount; ++j) ++interpolationCounts[min(interpolations[j], (uint32) FUDaeInterpolation::UNKNOWN)];
+
 	// Read in the interleaved outputs as floats
 	fm::vector<FloatList> tempFloatArrays;
 	tempFloatArrays.resize(curveCount);
@@ -124,9 +130,14 @@ bool FArchiveXML::LoadAnimationChannel(FCDObject* object, xmlNode* channelNode)
 		}
 
 		// Create all the keys, on the curves, according to the interpolation types.
+		FCDAnimationCurve* curve = animationChannel->GetCurve(i);
+		for (uint32 k = 0; k <= FUDaeInterpolation::UNKNOWN; ++k)
+		{
+			if (interpolationCounts[k] > 0) curve->ReserveKeys(interpolationCounts[k], (FUDaeInterpolation::Interpolation) k);
+		}
 		for (size_t j = 0; j < keyCount; ++j)
 		{
-			FCDAnimationKey* key = animationChannel->GetCurve(i)->AddKey((FUDaeInterpolation::Interpolation) interpolations[j]);
+			FCDAnimationKey* key = curve->AddKey((FUDaeInterpolation::Interpolation) interpolations[j]);
 			key->input = inputs[j];
 			key->output = tempFloatArrays[i][j];
 
@@ -361,8 +372,8 @@ bool FArchiveXML::LoadAnimationChannel(FCDObject* object, xmlNode* channelNode)
 
 xmlNode* FArchiveXML::FindChildByIdFCDAnimation(FCDAnimation* animation, const fm::string& _id)
 {
-	FCDAnimationDataMap::iterator animationIt = FArchiveXML::documentLinkDataMap[animation->GetDocument()].animationData.find(animation);
-	FUAssert(animationIt != FArchiveXML::documentLinkDataMap[animation->GetDocument()].animationData.end(),);
+	FCDAnimationDataMap::iterator animationIt = FArchiveXML::GetLinkData(animation->GetDocument()).animationData.find(animation);
+	FUAssert(animationIt != FArchiveXML::GetLinkData(animation->GetDocument()).animationData.end(),);
 	FCDAnimationData& data = animationIt->second;
 
 	FUCrc32::crc32 id = FUCrc32::CRC32(_id.c_str() + ((_id[0] == '#') ? 1 : 0));
@@ -397,7 +408,7 @@ bool FArchiveXML::LoadAnimationMultiCurve(FCDObject* UNUSED(object), xmlNode* UN
 bool FArchiveXML::LoadAnimation(FCDObject* object, xmlNode* node)
 { 
 	FCDAnimation* animation = (FCDAnimation*)object;
-	FCDAnimationData& data = FArchiveXML::documentLinkDataMap[animation->GetDocument()].animationData[animation];
+	FCDAnimationData& data = FArchiveXML::GetLinkData(animation->GetDocument()).animationData[animation];
 
 	bool status = FArchiveXML::LoadEntity(animation, node);
 	if (!status) return status;
@@ -513,8 +524,8 @@ bool FArchiveXML::ProcessChannels(FCDAnimated* animated, FCDAnimationChannelList
 		if (curveCount == 0) continue;
 		
 		// Retrieve the channel's qualifier and check for a requested matrix element
-		FCDAnimationChannelDataMap::iterator itChannelData = FArchiveXML::documentLinkDataMap[channel->GetDocument()].animationChannelData.find(channel);
-		FUAssert(itChannelData != FArchiveXML::documentLinkDataMap[channel->GetDocument()].animationChannelData.end(),);
+		FCDAnimationChannelDataMap::iterator itChannelData = FArchiveXML::GetLinkData(channel->GetDocument()).animationChannelData.find(channel);
+		FUAssert(itChannelData != FArchiveXML::GetLinkData(channel->GetDocument()).animationChannelData.end(),);
 		FCDAnimationChannelData& channelData = itChannelData->second;
 
 		const fm::string& qualifier = channelData.targetQualifier;
@@ -595,7 +606,7 @@ bool FArchiveXML::ProcessChannels(FCDAnimated* animated, FCDAnimationChannelList
 		{
 			for (size_t j = 0; j < animated->GetCurves()[i].size(); ++j)
 			{
-				FCDAnimationCurveData& curveData = FArchiveXML::documentLinkDataMap[animated->GetCurves()[i][j]->GetDocument()].animationCurveData[animated->GetCurves()[i][j]];
+				FCDAnimationCurveData& curveData = FArchiveXML::GetLinkData(animated->GetCurves()[i][j]->GetDocument()).animationCurveData[animated->GetCurves()[i][j]];
 
 				curveData.targetElement = animated->GetArrayElement();
 				curveData.targetQualifier = qualifiers[i];
@@ -611,11 +622,15 @@ void FArchiveXML::FindAnimationChannels(FCDocument* fcdocument, const fm::string
 {
 	if (pointer.empty()) return;
 
-	size_t animationCount = (uint32) fcdocument->GetAnimationLibrary()->GetEntityCount();
-	for (size_t i = 0; i < animationCount; ++i)
+	// A pointer that was never interned is not targeted by any channel.
+	FCDocumentLinkData& linkData = FArchiveXML::IndexAnimationChannels(fcdocument);
+	uint32 handle = linkData.animationChannelPointers.Find(pointer);
+	if (handle == 0) return;
+	FCDAnimationChannelPointerMap::iterator it = linkData.animationChannelTargets.find(handle);
+	if (it == linkData.animationChannelTargets.end()) return;
+	for (FCDAnimationChannelList::iterator itC = it->second.begin(); itC != it->second.end(); ++itC)
 	{
-		FCDAnimation* animation = fcdocument->GetAnimationLibrary()->GetEntity(i);
-		FArchiveXML::FindAnimationChannels(animation, pointer, channels);
+		channels.push_back(*itC);
 	}
 }
 
@@ -624,8 +639,8 @@ void FArchiveXML::FindAnimationChannels(FCDAnimation* animation, const fm::strin
 	// Look for channels locally
 	for (size_t i = 0; i < animation->GetChannelCount(); ++i)
 	{
-		FCDAnimationChannelDataMap::iterator itChannelData = FArchiveXML::documentLinkDataMap[animation->GetChannel(i)->GetDocument()].animationChannelData.find(animation->GetChannel(i));
-		FUAssert(itChannelData != FArchiveXML::documentLinkDataMap[animation->GetChannel(i)->GetDocument()].animationChannelData.end(),);
+		FCDAnimationChannelDataMap::iterator itChannelData = FArchiveXML::GetLinkData(animation->GetChannel(i)->GetDocument()).animationChannelData.find(animation->GetChannel(i));
+		FUAssert(itChannelData != FArchiveXML::GetLinkData(animation->GetChannel(i)->GetDocument()).animationChannelData.end(),);
 		FCDAnimationChannelData& channelData = itChannelData->second;
 
 		if (channelData.targetPointer == pointer)
@@ -640,3 +655,49 @@ void FArchiveXML::FindAnimationChannels(FCDAnimation* animation, const fm::strin
 		FArchiveXML::FindAnimationChannels(animation->GetChild(i), pointer, targetChannels);
 	}
 }
+
+FCDocumentLinkData& FArchiveXML::IndexAnimationChannels(FCDocument* fcdocument)
+{
+	// The channels are all loaded with the animation library, before any animated value
+	// is linked: the index is therefore built once per document.
+	FCDocumentLinkData& linkData = FArchiveXML::GetLinkData(fcdocument);
+	if (linkData.animationChannelIndexSize != linkData.animationChannelData.size())
+	{
+		linkData.animationChannelPointers.clear();
+		linkData.animationChannelTargets.clear();
+		linkData.animationChannelDrivers.clear();
+		size_t animationCount = fcdocument->GetAnimationLibrary()->GetEntityCount();
+		for (size_t i = 0; i < animationCount; ++i)
+		{
+			FArchiveXML::IndexAnimationChannels(fcdocument->GetAnimationLibrary()->GetEntity(i), linkData);
+		}
+		linkData.animationChannelIndexSize = linkData.animationChannelData.size();
+	}
+	return linkData;
+}
+
+void FArchiveXML::IndexAnimationChannels(FCDAnimation* animation, FCDocumentLinkData& linkData)
+{
+	// Keep the channels in the order of the library traversal
+	for (size_t i = 0; i < animation->GetChannelCount(); ++i)
+	{
+		FCDAnimationChannel* channel = animation->GetChannel(i);
+		FCDAnimationChannelDataMap::iterator itChannelData = linkData.animationChannelData.find(channel);
+		FUAssert(itChannelData != linkData.animationChannelData.end(), continue);
+		FCDAnimationChannelData& channelData = itChannelData->second;
+
+		if (!channelData.targetPointer.empty())
+		{
+			linkData.animationChannelTargets[linkData.animationChannelPointers.Intern(channelData.targetPointer)].push_back(channel);
+		}
+		if (!channelData.driverPointer.empty())
+		{
+			linkData.animationChannelDrivers[linkData.animationChannelPointers.Intern(channelData.driverPointer)].push_back(channel);
+		}
+	}
+
+	for (size_t i = 0; i < animation->GetChildrenCount(); ++i)
+	{
+		FArchiveXML::IndexAnimationChannels(animation->GetChild(i), linkData);
+	}
+}
@@ -127,6 +127,133 @@ namespace FUDaeParser
 		}
 	}
 
+	// Reads in the values of a float array one by one, whether they are held
+	// in the text content of the node or in binary form, from a document snapshot.
+	// As when parsing the text content, zero is read in past the last value.
+	class FloatArrayReader
+	{
+	private:
+		xmlNode* node;
+		const float* values;
+		const float* end;
+		const char* text;
+
+	public:
+		FloatArrayReader(xmlNode* arrayNode)
+		:	node(arrayNode)
+		{
+			uint32 count;
+			values = ReadNodeBinaryFloats(arrayNode, count);
+			end = values + count;
+			text = (values == NULL) ? ReadNodeContentDirect(arrayNode) : NULL;
+		}
+
+		~FloatArrayReader() { ReleaseNodeBinaryValues(node); }
+
+		inline bool IsDone() const { return (values != NULL) ? values == end : *text == 0; }
+		inline float Read()
+		{
+			if (values == NULL) return FUStringConversion::ToFloat(&text);
+			return (values != end) ? *(values++) : 0.0f;
+		}
+	};
+
+	// Retrieves the values of a float array restored in binary form from a document snapshot.
+	// The _private pointer of such a node points to the value count, followed by the values.
+	const float* ReadNodeBinaryFloats(xmlNode* arrayNode, uint32& count)
+	{
+		if (arrayNode == NULL || arrayNode->_private == NULL) { count = 0; return NULL; }
+		const uint32* block = (const uint32*) arrayNode->_private;
+		count = block[0];
+		return (const float*) (block + 1);
+	}
+
+	// Retrieves the values of an unsigned integer list converted ahead of time, in the same layout as above.
+	const uint32* ReadNodeBinaryUInt32s(xmlNode* node, uint32& count)
+	{
+		if (node == NULL || node->_private == NULL) { count = 0; return NULL; }
+		const uint32* block = (const uint32*) node->_private;
+		count = block[0];
+		return block + 1;
+	}
+
+	// The arrays converted ahead of time keep their text content, unlike the float arrays
+	// restored from a snapshot, whose values belong to the mapped snapshot. Reading such a
+	// node again after its values are freed parses its text content.
+	void ReleaseNodeBinaryValues(xmlNode* node)
+	{
+		if (node == NULL || node->_private == NULL || *ReadNodeContentDirect(node) == 0) return;
+		uint32* block = (uint32*) node->_private;
+		node->_private = NULL;
+		SAFE_DELETE_ARRAY(block);
+	}
+
+	// Retrieves the unsigned integer list contained by a node
+	void ReadNodeUInt32List(xmlNode* node, UInt32List& array)
+	{
+		uint32 valueCount;
+		const uint32* values = ReadNodeBinaryUInt32s(node, valueCount);
+		if (values != NULL)
+		{
+			array.resize(valueCount);
+			if (valueCount > 0) memcpy(array.begin(), values, valueCount * sizeof(uint32));
+			ReleaseNodeBinaryValues(node);
+		}
+		else
+		{
+			array.clear();
+			const char* content = ReadNodeContentDirect(node);
+			if (content != NULL) FUStringConversion::ToUInt32List(content, array);
+		}
+	}
+
+	// Retrieves the interleaved unsigned integer lists contained by a node.
+	// Splits the values exactly as FUStringConversion::ToInterleavedUInt32List does.
+	void ReadNodeInterleavedUInt32List(xmlNode* node, fm::pvector<UInt32List>& arrays)
+	{
+		uint32 valueCount;
+		const uint32* values = ReadNodeBinaryUInt32s(node, valueCount);
+		if (values == NULL)
+		{
+			FUStringConversion::ToInterleavedUInt32List(ReadNodeContentDirect(node), arrays);
+			return;
+		}
+
+		size_t stride = arrays.size();
+		if (stride == 0) return;
+		const uint32* end = values + valueCount;
+
+		// Fill in the already-allocated values
+		size_t length = arrays.front()->size(), count = 0;
+		for (; count < length && values != end; ++count)
+		{
+			for (size_t i = 0; i < stride && values != end; ++i)
+			{
+				if (arrays[i] != NULL) arrays[i]->at(count) = *values;
+				++values;
+			}
+		}
+
+		// Append the remaining complete items
+		while (values != end)
+		{
+			if ((size_t) (end - values) < stride) break;
+			for (size_t i = 0; i < stride; ++i)
+			{
+				if (arrays[i] != NULL) arrays[i]->push_back(*values);
+				++values;
+			}
+			++count;
+		}
+
+		// Resize the lists to the number of items read
+		for (size_t i = 0; i < stride; ++i)
+		{
+			if (arrays[i] != NULL) arrays[i]->resize(count);
+		}
+		ReleaseNodeBinaryValues(node);
+	}
+
 	// Retrieves a list of floats from a source node
 	// Returns the data's stride.
 	uint32 ReadSource(xmlNode* sourceNode, FloatList& array)
@@ -140,8 +267,19 @@ namespace FUDaeParser
 			array.resize(ReadNodeCount(accessorNode) * stride);
 
 			xmlNode* arrayNode = FindChildByType(sourceNode, DAE_FLOAT_ARRAY_ELEMENT);
-			const char* arrayContent = ReadNodeContentDirect(arrayNode);
-			FUStringConversion::ToFloatList(arrayContent, array);
+			uint32 valueCount;
+			const float* values = ReadNodeBinaryFloats(arrayNode, valueCount);
+			if (values != NULL)
+			{
+				array.resize(valueCount);
+				if (valueCount > 0) memcpy(array.begin(), values, valueCount * sizeof(float));
+				ReleaseNodeBinaryValues(arrayNode);
+			}
+			else
+			{
+				const char* arrayContent = ReadNodeContentDirect(arrayNode);
+				FUStringConversion::ToFloatList(arrayContent, array);
+			}
 		}
 		return stride;
 	}
@@ -156,8 +294,19 @@ namespace FUDaeParser
 			array.resize(ReadNodeCount(accessorNode));
 
 			xmlNode* arrayNode = FindChildByType(sourceNode, DAE_FLOAT_ARRAY_ELEMENT);
-			const char* arrayContent = ReadNodeContentDirect(arrayNode);
-			FUStringConversion::ToInt32List(arrayContent, array);
+			uint32 valueCount;
+			const float* values = ReadNodeBinaryFloats(arrayNode, valueCount);
+			if (values != NULL)
+			{
+				array.resize(valueCount);
+				for (uint32 i = 0; i < valueCount; ++i) array[i] = (int32) values[i];
+				ReleaseNodeBinaryValues(arrayNode);
+			}
+			else
+			{
+				const char* arrayContent = ReadNodeContentDirect(arrayNode);
+				FUStringConversion::ToInt32List(arrayContent, array);
+			}
 		}
 	}
 
@@ -187,8 +336,23 @@ namespace FUDaeParser
 			array.resize(ReadNodeCount(accessorNode));
 
 			xmlNode* arrayNode = FindChildByType(sourceNode, DAE_FLOAT_ARRAY_ELEMENT);
-			const char* arrayContent = ReadNodeContentDirect(arrayNode);
-			FUStringConversion::ToPointList(arrayContent, array);
+			if (arrayNode != NULL && arrayNode->_private != NULL)
+			{
+				FloatArrayReader reader(arrayNode);
+				size_t count = 0;
+				for (; !reader.IsDone(); ++count)
+				{
+					if (count == array.size()) array.push_back(FMVector3::Zero);
+					FMVector3& point = array[count];
+					point.x = reader.Read(); point.y = reader.Read(); point.z = reader.Read();
+				}
+				array.resize(count);
+			}
+			else
+			{
+				const char* arrayContent = ReadNodeContentDirect(arrayNode);
+				FUStringConversion::ToPointList(arrayContent, array);
+			}
 		}
 	}
 
@@ -202,8 +366,28 @@ namespace FUDaeParser
 			array.resize(ReadNodeCount(accessorNode));
 
 			xmlNode* arrayNode = FindChildByType(sourceNode, DAE_FLOAT_ARRAY_ELEMENT);
-			const char* arrayContent = ReadNodeContentDirect(arrayNode);
-			FUStringConversion::ToMatrixList(arrayContent, array);
+			if (arrayNode != NULL && arrayNode->_private != NULL)
+			{
+				FloatArrayReader reader(arrayNode);
+				size_t count = 0;
+				for (; !reader.IsDone(); ++count)
+				{
+					if (count == array.size()) array.push_back(FMMatrix44::Identity);
+
+					// COLLADA is column major
+					FMMatrix44& mx = array[count];
+					for (size_t row = 0; row < 4; ++row)
+					{
+						for (size_t column = 0; column < 4; ++column) mx[column][row] = reader.Read();
+					}
+				}
+				array.resize(count);
+			}
+			else
+			{
+				const char* arrayContent = ReadNodeContentDirect(arrayNode);
+				FUStringConversion::ToMatrixList(arrayContent, array);
+			}
 		}
 	}
 
@@ -227,8 +411,32 @@ namespace FUDaeParser
 
 			// Read and parse the float array
    			xmlNode* arrayNode = FindChildByType(sourceNode, DAE_FLOAT_ARRAY_ELEMENT);
-			const char* arrayContent = ReadNodeContentDirect(arrayNode);
-			FUStringConversion::ToInterleavedFloatList(arrayContent, arrays);
+			if (arrayNode != NULL && arrayNode->_private != NULL)
+			{
+				FloatArrayReader reader(arrayNode);
+				size_t validCount = 0;
+				for (; stride > 0 && !reader.IsDone(); ++validCount)
+				{
+					size_t i = 0;
+					for (; i < stride && !reader.IsDone(); ++i)
+					{
+						FloatList* array = arrays[i];
+						if (array == NULL) reader.Read();
+						else if (validCount < array->size()) array->at(validCount) = reader.Read();
+						else array->push_back(reader.Read());
+					}
+					if (i < stride && validCount >= count) break;
+				}
+				for (size_t i = 0; i < stride; ++i)
+				{
+					if (arrays[i] != NULL) arrays[i]->resize(validCount);
+				}
+			}
+			else
+			{
+				const char* arrayContent = ReadNodeContentDirect(arrayNode);
+				FUStringConversion::ToInterleavedFloatList(arrayContent, arrays);
+			}
 		}
 	}
 
@@ -252,20 +460,20 @@ namespace FUDaeParser
 			{
 				// Read and parse the float array
 				xmlNode* arrayNode = FindChildByType(sourceNode, DAE_FLOAT_ARRAY_ELEMENT);
-				const char* value = ReadNodeContentDirect(arrayNode);
-				for (size_t i = 0; i < count && *value != 0; ++i)
+				FloatArrayReader reader(arrayNode);
+				for (size_t i = 0; i < count && !reader.IsDone(); ++i)
 				{
-					for (size_t j = 0; j < stride && *value != 0; ++j)
+					for (size_t j = 0; j < stride && !reader.IsDone(); ++j)
 					{
-						arrays[j]->at(i) = FMVector2(FUStringConversion::ToFloat(&value), 0.0f);
+						arrays[j]->at(i) = FMVector2(reader.Read(), 0.0f);
 					}
 				}
 
-				while (*value != 0)
+				while (!reader.IsDone())
 				{
-					for (size_t i = 0; i < stride && *value != 0; ++i)
+					for (size_t i = 0; i < stride && !reader.IsDone(); ++i)
 					{
-						arrays[i]->push_back(FMVector2(FUStringConversion::ToFloat(&value), 0.0f));
+						arrays[i]->push_back(FMVector2(reader.Read(), 0.0f));
 					}
 				}
 			}
@@ -277,39 +485,39 @@ namespace FUDaeParser
 
 				// Read and parse the float array
 				xmlNode* arrayNode = FindChildByType(sourceNode, DAE_FLOAT_ARRAY_ELEMENT);
-				const char* value = ReadNodeContentDirect(arrayNode);
-				for (size_t i = 0; i < count && *value != 0; ++i)
+				FloatArrayReader reader(arrayNode);
+				for (size_t i = 0; i < count && !reader.IsDone(); ++i)
 				{
-					for (size_t j = 0; 2 * j < stride && *value != 0; ++j)
+					for (size_t j = 0; 2 * j < stride && !reader.IsDone(); ++j)
 					{
 						if (arrays[j] != NULL)
 						{
-							arrays[j]->at(i).u = FUStringConversion::ToFloat(&value);
-							arrays[j]->at(i).v = FUStringConversion::ToFloat(&value);
+							arrays[j]->at(i).u = reader.Read();
+							arrays[j]->at(i).v = reader.Read();
 						}
 						else
 						{
-							FUStringConversion::ToFloat(&value);
-							FUStringConversion::ToFloat(&value);
+							reader.Read();
+							reader.Read();
 						}
 					}
 				}
 
-				while (*value != 0)
+				while (!reader.IsDone())
 				{
-					for (size_t i = 0; 2 * i < stride && *value != 0; ++i)
+					for (size_t i = 0; 2 * i < stride && !reader.IsDone(); ++i)
 					{
 						if (arrays[i] != NULL)
 						{
 							FMVector2 v;
-							v.u = FUStringConversion::ToFloat(&value);
-							v.v = FUStringConversion::ToFloat(&value);
+							v.u = reader.Read();
+							v.v = reader.Read();
 							arrays[i]->push_back(v);
 						}
 						else
 						{
-							FUStringConversion::ToFloat(&value);
-							FUStringConversion::ToFloat(&value);
+							reader.Read();
+							reader.Read();
 						}
 					}
 				}
@@ -338,20 +546,20 @@ namespace FUDaeParser
 			{
 				// Read and parse the float array
 				xmlNode* arrayNode = FindChildByType(sourceNode, DAE_FLOAT_ARRAY_ELEMENT);
-				const char* value = ReadNodeContentDirect(arrayNode);
-				for (size_t i = 0; i < count && *value != 0; ++i)
+				FloatArrayReader reader(arrayNode);
+				for (size_t i = 0; i < count && !reader.IsDone(); ++i)
 				{
-					for (size_t j = 0; j < stride && *value != 0; ++j)
+					for (size_t j = 0; j < stride && !reader.IsDone(); ++j)
 					{
-						arrays[j]->at(i) = FMVector3(FUStringConversion::ToFloat(&value), 0.0f, 0.0f);
+						arrays[j]->at(i) = FMVector3(reader.Read(), 0.0f, 0.0f);
 					}
 				}
 
-				while (*value != 0)
+				while (!reader.IsDone())
 				{
-					for (size_t i = 0; i < stride && *value != 0; ++i)
+					for (size_t i = 0; i < stride && !reader.IsDone(); ++i)
 					{
-						arrays[i]->push_back(FMVector3(FUStringConversion::ToFloat(&value), 0.0f, 0.0f));
+						arrays[i]->push_back(FMVector3(reader.Read(), 0.0f, 0.0f));
 					}
 				}
 			}
@@ -363,43 +571,43 @@ namespace FUDaeParser
 
 				// Read and parse the float array
 				xmlNode* arrayNode = FindChildByType(sourceNode, DAE_FLOAT_ARRAY_ELEMENT);
-				const char* value = ReadNodeContentDirect(arrayNode);
-				for (size_t i = 0; i < count && *value != 0; ++i)
+				FloatArrayReader reader(arrayNode);
+				for (size_t i = 0; i < count && !reader.IsDone(); ++i)
 				{
-					for (size_t j = 0; 3 * j < stride && *value != 0; ++j)
+					for (size_t j = 0; 3 * j < stride && !reader.IsDone(); ++j)
 					{
 						if (arrays[j] != NULL)
 						{
-							arrays[j]->at(i).x = FUStringConversion::ToFloat(&value);
-							arrays[j]->at(i).y = FUStringConversion::ToFloat(&value);
-							arrays[j]->at(i).z = FUStringConversion::ToFloat(&value);
+							arrays[j]->at(i).x = reader.Read();
+							arrays[j]->at(i).y = reader.Read();
+							arrays[j]->at(i).z = reader.Read();
 						}
 						else
 						{
-							FUStringConversion::ToFloat(&value);
-							FUStringConversion::ToFloat(&value);
-							FUStringConversion::ToFloat(&value);
+							reader.Read();
+							reader.Read();
+							reader.Read();
 						}
 					}
 				}
 
-				while (*value != 0)
+				while (!reader.IsDone())
 				{
-					for (size_t i = 0; 2 * i < stride && *value != 0; ++i)
+					for (size_t i = 0; 2 * i < stride && !reader.IsDone(); ++i)
 					{
 						if (arrays[i] != NULL)
 						{
 							FMVector3 v;
-							v.x = FUStringConversion::ToFloat(&value);
-							v.y = FUStringConversion::ToFloat(&value);
-							v.z = FUStringConversion::ToFloat(&value);
+							v.x = reader.Read();
+							v.y = reader.Read();
+							v.z = reader.Read();
 							arrays[i]->push_back(v);
 						}
 						else
 						{
-							FUStringConversion::ToFloat(&value);
-							FUStringConversion::ToFloat(&value);
-							FUStringConversion::ToFloat(&value);
+							reader.Read();
+							reader.Read();
+							reader.Read();
 						}
 					}
 				}
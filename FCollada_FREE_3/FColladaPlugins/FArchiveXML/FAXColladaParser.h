@@ -52,6 +52,11 @@ namespace FUDaeParser
 	uint32 ReadSourceInterleaved(xmlNode* sourceNode, fm::pvector<FMVector2List>& arrays);
 	uint32 ReadSourceInterleaved(xmlNode* sourceNode, fm::pvector<FMVector3List>& arrays);
 	void ReadSourceInterpolation(xmlNode* sourceNode, UInt32List& array);
+	const float* ReadNodeBinaryFloats(xmlNode* arrayNode, uint32& count); // For the float arrays restored from a document snapshot
+	const uint32* ReadNodeBinaryUInt32s(xmlNode* node, uint32& count); // For the index lists converted ahead of time by the importer
+	void ReleaseNodeBinaryValues(xmlNode* node); // Frees the values converted ahead of time by the importer, once read
+	void ReadNodeUInt32List(xmlNode* node, UInt32List& array);
+	void ReadNodeInterleavedUInt32List(xmlNode* node, fm::pvector<UInt32List>& arrays);
 
 	// Target support
 	void ReadNodeTargetProperty(xmlNode* targetingNode, fm::string& pointer, fm::string& qualifier);
@@ -76,56 +76,38 @@ namespace FUDaeWriter
 
 	xmlNode* AddArray(xmlNode* parent, const char* id, const FMVector2List& values)
 	{
-		// Reserve the necessary space within the string builder
-		FUSStringBuilder builder;
-		size_t valueCount = values.size();
-		builder.reserve(valueCount * 2 * FLOAT_STR_ESTIMATE);
-		if (valueCount > 0)
+		// Flatten the vectors: the values are formatted when the document is written out.
+		FloatList flatValues;
+		flatValues.reserve(values.size() * 2);
+		for (FMVector2List::const_iterator itP = values.begin(); itP != values.end(); ++itP)
 		{
-			// Write out the values
-			FMVector2List::const_iterator itP = values.begin();
-			FUStringConversion::ToString(builder, *itP);
-			for (++itP; itP != values.end(); ++itP) { builder.append(' '); FUStringConversion::ToString(builder, *itP); }
+			flatValues.push_back((*itP).u); flatValues.push_back((*itP).v);
 		}
-
-		// Create the typed array node.
-		return AddArray(parent, id, DAE_FLOAT_ARRAY_ELEMENT, builder.ToCharPtr(), valueCount * 2);
+		return AddArray(parent, id, flatValues);
 	}
 
 	xmlNode* AddArray(xmlNode* parent, const char* id, const FMVector3List& values)
 	{
-		// Reserve the necessary space within the string builder
-		FUSStringBuilder builder;
-		size_t valueCount = values.size();
-		builder.reserve(valueCount * 3 * FLOAT_STR_ESTIMATE);
-		if (valueCount > 0)
+		// Flatten the vectors: the values are formatted when the document is written out.
+		FloatList flatValues;
+		flatValues.reserve(values.size() * 3);
+		for (FMVector3List::const_iterator itP = values.begin(); itP != values.end(); ++itP)
 		{
-			// Write out the values
-			FMVector3List::const_iterator itP = values.begin();
-			FUStringConversion::ToString(builder, *itP);
-			for (++itP; itP != values.end(); ++itP) { builder.append(' '); FUStringConversion::ToString(builder, *itP); }
+			flatValues.push_back((*itP).x); flatValues.push_back((*itP).y); flatValues.push_back((*itP).z);
 		}
-
-		// Create the typed array node.
-		return AddArray(parent, id, DAE_FLOAT_ARRAY_ELEMENT, builder.ToCharPtr(), valueCount * 3);
+		return AddArray(parent, id, flatValues);
 	}
 
 	xmlNode* AddArray(xmlNode* parent, const char* id, const FMVector4List& values)
 	{
-		// Reserve the necessary space within the string builder
-		FUSStringBuilder builder;
-		size_t valueCount = values.size();
-		builder.reserve(valueCount * 4 * FLOAT_STR_ESTIMATE);
-		if (valueCount > 0)
+		// Flatten the vectors: the values are formatted when the document is written out.
+		FloatList flatValues;
+		flatValues.reserve(values.size() * 4);
+		for (FMVector4List::const_iterator itP = values.begin(); itP != values.end(); ++itP)
 		{
-			// Write out the values
-			FMVector4List::const_iterator itP = values.begin();
-			FUStringConversion::ToString(builder, *itP);
-			for (++itP; itP != values.end(); ++itP) { builder.append(' '); FUStringConversion::ToString(builder, *itP); }
+			flatValues.push_back((*itP).x); flatValues.push_back((*itP).y); flatValues.push_back((*itP).z); flatValues.push_back((*itP).w);
 		}
-
-		// Create the typed array node.
-		return AddArray(parent, id, DAE_FLOAT_ARRAY_ELEMENT, builder.ToCharPtr(), valueCount * 4);
+		return AddArray(parent, id, flatValues);
 	}
 
 	xmlNode* AddArray(xmlNode* parent, const char* id, const FMMatrix44List& values)
@@ -144,11 +126,11 @@ namespace FUDaeWriter
 
 	xmlNode* AddArray(xmlNode* parent, const char* id, const FloatList& values)
 	{
-		size_t valueCount = values.size();
-		FUSStringBuilder builder;
-		builder.reserve(valueCount * FLOAT_STR_ESTIMATE);
-		FUStringConversion::ToString(builder, values);
-		return AddArray(parent, id, DAE_FLOAT_ARRAY_ELEMENT, builder.ToCharPtr(), valueCount);
+		xmlNode* arrayNode = AddChild(parent, DAE_FLOAT_ARRAY_ELEMENT);
+		AddContentValues(arrayNode, values.begin(), values.size());
+		AddAttribute(arrayNode, DAE_ID_ATTRIBUTE, id);
+		AddAttribute(arrayNode, DAE_COUNT_ATTRIBUTE, values.size());
+		return arrayNode;
 	}
 
 	xmlNode* AddArray(xmlNode* parent, const char* id, const StringList& values, const char* arrayType)
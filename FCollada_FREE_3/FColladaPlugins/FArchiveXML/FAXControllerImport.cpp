@@ -57,7 +57,7 @@ bool FArchiveXML::LoadController(FCDObject* object, xmlNode* controllerNode)
 bool FArchiveXML::LoadSkinController(FCDObject* object, xmlNode* skinNode)
 {
 	FCDSkinController* skinController = (FCDSkinController*)object;
-	FCDSkinControllerDataMap& skinDataMap = FArchiveXML::documentLinkDataMap[skinController->GetDocument()].skinControllerDataMap;
+	FCDSkinControllerDataMap& skinDataMap = FArchiveXML::GetLinkData(skinController->GetDocument()).skinControllerDataMap;
 	if (skinDataMap.find(skinController) == skinDataMap.end())
 	{
 		FCDSkinControllerData data;
@@ -245,7 +245,7 @@ bool FArchiveXML::LoadSkinController(FCDObject* object, xmlNode* skinNode)
 bool FArchiveXML::LoadMorphController(FCDObject* object, xmlNode* morphNode)
 {
 	FCDMorphController* morphController = (FCDMorphController*)object;
-	FCDMorphControllerData& data = FArchiveXML::documentLinkDataMap[morphController->GetDocument()].morphControllerDataMap[morphController];
+	FCDMorphControllerData& data = FArchiveXML::GetLinkData(morphController->GetDocument()).morphControllerDataMap[morphController];
 
 	bool status = true;
 	if (!IsEquivalent(morphNode->name, DAE_CONTROLLER_MORPH_ELEMENT))
@@ -256,8 +256,8 @@ void FArchiveXML::FindAnimationChannelsArrayIndices(FCDocument* fcdocument, xmlN
 	FArchiveXML::FindAnimationChannels(fcdocument, pointer, channels);
 	for (FCDAnimationChannelList::iterator it = channels.begin(); it != channels.end(); ++it)
 	{
-		FCDAnimationChannelDataMap::iterator itData = FArchiveXML::documentLinkDataMap[(*it)->GetDocument()].animationChannelData.find(*it);
-		FUAssert(itData != FArchiveXML::documentLinkDataMap[(*it)->GetDocument()].animationChannelData.end(),);
+		FCDAnimationChannelDataMap::iterator itData = FArchiveXML::GetLinkData((*it)->GetDocument()).animationChannelData.find(*it);
+		FUAssert(itData != FArchiveXML::GetLinkData((*it)->GetDocument()).animationChannelData.end(),);
 		FCDAnimationChannelData& data = itData->second;
 
 		int32 animatedIndex = FUStringConversion::ParseQualifier(data.targetQualifier);
@@ -267,6 +267,9 @@ void FArchiveXML::FindAnimationChannelsArrayIndices(FCDocument* fcdocument, xmlN
 
 void FArchiveXML::RegisterLoadedDocument(FCDocument* document)
 {
+	// Placeholders are shared between documents: link them one document at a time.
+	registrationCriticalSection.Enter();
+
 	fm::pvector<FCDocument> allDocuments;
 	FCollada::GetAllDocuments(allDocuments);
 	for (FCDocument** it = allDocuments.begin(); it != allDocuments.end(); ++it)
@@ -296,4 +299,6 @@ void FArchiveXML::RegisterLoadedDocument(FCDocument* document)
 			if (pHolder->GetFileUrl() == (*itD)->GetFileUrl()) pHolder->LoadTarget(*itD);
 		}
 	}
+
+	registrationCriticalSection.Leave();
 }
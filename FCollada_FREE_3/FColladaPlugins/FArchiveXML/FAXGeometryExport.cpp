@@ -205,16 +205,15 @@ xmlNode* FArchiveXML::WriteGeometryPolygons(FCDObject* object, xmlNode* parentNo
 		}
 	}
 
-	FUSStringBuilder builder;
-	builder.reserve(1024);
+	// The indices are kept in binary form: they are formatted when the document is written out.
+	UInt32List indices;
+	indices.reserve(geometryPolygons->GetFaceVertexCount() * idxOwners.size());
 
 	// For the poly-list case, export the list of vertex counts
 	if (!hasHoles && hasNPolys)
 	{
-		FUStringConversion::ToString(builder, geometryPolygons->GetFaceVertexCounts(), geometryPolygons->GetFaceVertexCountCount());
 		xmlNode* vcountNode = AddChild(polygonsNode, DAE_VERTEXCOUNT_ELEMENT);
-		AddContentUnprocessed(vcountNode, builder.ToCharPtr());
-		builder.clear();
+		AddContentValues(vcountNode, geometryPolygons->GetFaceVertexCounts(), geometryPolygons->GetFaceVertexCountCount());
 	}
 
 	// For the non-holes cases, open only one <p> element for all the data indices
@@ -254,21 +253,15 @@ xmlNode* FArchiveXML::WriteGeometryPolygons(FCDObject* object, xmlNode* parentNo
 			{
 				for (fm::pvector<const FCDGeometryPolygonsInput>::iterator itI = idxOwners.begin(); itI != idxOwners.end(); ++itI)
 				{
-					if ((*itI) != NULL)
-					{
-						builder.append((*itI)->GetIndices()[faceVertexIndex]);
-						builder.append(' ');
-					}
-					else builder.append("0 ");
+					indices.push_back((*itI) != NULL ? (*itI)->GetIndices()[faceVertexIndex] : 0);
 				}
 			}
 
 			// For the holes cases: write out the indices for every polygon element
 			if (hasHoles)
 			{
-				if (!builder.empty()) builder.pop_back(); // take out the last space
-				AddContentUnprocessed(pNode, builder.ToCharPtr());
-				builder.clear();
+				AddContentValues(pNode, indices.begin(), indices.size());
+				indices.clear();
 
 				if (holeIndex < holeCount)
 				{
@@ -285,8 +278,7 @@ xmlNode* FArchiveXML::WriteGeometryPolygons(FCDObject* object, xmlNode* parentNo
 	// For the non-holes cases: write out the indices at the very end, for the single <p> element
 	if (!hasHoles)
 	{
-		if (!builder.empty()) builder.pop_back(); // take out the last space
-		AddContentUnprocessed(pNode, builder.ToCharPtr());
+		AddContentValues(pNode, indices.begin(), indices.size());
 	}
 
 	// Write out the material semantic and the number of polygons
@@ -24,7 +24,7 @@ bool FArchiveXML::LoadGeometrySource(FCDObject* object, xmlNode* sourceNode)
 	FCDGeometrySource* geometrySource = (FCDGeometrySource*) object;
 	FCDGeometrySourceData data;
 	data.sourceNode = sourceNode;
-	FArchiveXML::documentLinkDataMap[geometrySource->GetDocument()].geometrySourceDataMap.insert(geometrySource, data);
+	FArchiveXML::GetLinkData(geometrySource->GetDocument()).geometrySourceDataMap.insert(geometrySource, data);
 
 	bool status = true;
 
@@ -391,9 +391,8 @@ bool FArchiveXML::LoadGeometryPolygons(FCDObject* object, xmlNode* baseNode)
 		else if (isPolylist)
 		{
 			// Process the vertex counts.
-			const char* vCountDataString = ReadNodeContentDirect(vCountNode);
 			UInt32List vCountData;
-			if (vCountDataString != NULL) FUStringConversion::ToUInt32List(vCountDataString, vCountData);
+			ReadNodeUInt32List(vCountNode, vCountData);
 			size_t vCountCount = vCountData.size();
 			geometryPolygons->SetFaceVertexCountCount(vCountCount);
 			memcpy((void*) geometryPolygons->GetFaceVertexCounts(), vCountData.begin(), sizeof(uint32) * vCountCount);
@@ -448,10 +447,10 @@ bool FArchiveXML::LoadGeometryPolygons(FCDObject* object, xmlNode* baseNode)
 		{
 			// Retrieve the indices
 			xmlNode* holeNode = NULL;
-			const char* content = NULL;
+			xmlNode* contentNode = NULL;
 			if (!IsEquivalent(itNode->name, DAE_POLYGONHOLED_ELEMENT)) 
 			{
-				content = ReadNodeContentDirect(itNode);
+				contentNode = itNode;
 			} 
 			else 
 			{
@@ -461,7 +460,7 @@ bool FArchiveXML::LoadGeometryPolygons(FCDObject* object, xmlNode* baseNode)
 					if (child->type != XML_ELEMENT_NODE) continue;
 					if (IsEquivalent(child->name, DAE_POLYGON_ELEMENT)) 
 					{
-						content = ReadNodeContentDirect(child);
+						contentNode = child;
 					}
 					else if (IsEquivalent(child->name, DAE_HOLE_ELEMENT)) 
 					{ 
@@ -476,7 +475,7 @@ bool FArchiveXML::LoadGeometryPolygons(FCDObject* object, xmlNode* baseNode)
 			}
 
 			// Parse the indices
-			FUStringConversion::ToInterleavedUInt32List(content, allIndices);
+			ReadNodeInterleavedUInt32List(contentNode, allIndices);
 			uint32 localFaceVertexCount = (uint32) masterIndices->size();
 
 			if (isTriangles) for (uint32 i = 0; i < localFaceVertexCount / 3; ++i) geometryPolygons->AddFaceVertexCount(3);
@@ -495,8 +494,7 @@ bool FArchiveXML::LoadGeometryPolygons(FCDObject* object, xmlNode* baseNode)
 				if (holeNode->type != XML_ELEMENT_NODE) continue;
 
 				// Read in the hole indices and push them on top of the other indices
-				content = ReadNodeContentDirect(holeNode);
-				FUStringConversion::ToInterleavedUInt32List(content, allIndices);
+				ReadNodeInterleavedUInt32List(holeNode, allIndices);
 				for (size_t k = 0; k < indexStride; ++k)
 				{
 					FCDGeometryPolygonsInput* input = idxOwners[k];
@@ -705,8 +703,8 @@ bool FArchiveXML::LoadNURBSSpline(FCDObject* object, xmlNode* splineNode)
 
 void FArchiveXML::SetTypeFCDGeometrySource(FCDGeometrySource* geometrySource, FUDaeGeometryInput::Semantic type)
 {
-	FCDGeometrySourceDataMap::iterator it = FArchiveXML::documentLinkDataMap[geometrySource->GetDocument()].geometrySourceDataMap.find(geometrySource);
-	FUAssert(it != FArchiveXML::documentLinkDataMap[geometrySource->GetDocument()].geometrySourceDataMap.end(),);
+	FCDGeometrySourceDataMap::iterator it = FArchiveXML::GetLinkData(geometrySource->GetDocument()).geometrySourceDataMap.find(geometrySource);
+	FUAssert(it != FArchiveXML::GetLinkData(geometrySource->GetDocument()).geometrySourceDataMap.end(),);
 	FCDGeometrySourceData& data = it->second;
 
 	geometrySource->SetSourceType(type);
@@ -41,12 +41,19 @@
 
 bool FArchiveXML::LinkDriver(FCDocument* fcdoument, FCDAnimated* animated, const fm::string& animatedTargetPointer)
 {
+	if (animatedTargetPointer.empty()) return false;
+
+	// Only the channels indexed under this driver pointer need to be considered.
+	FCDocumentLinkData& linkData = FArchiveXML::IndexAnimationChannels(fcdoument);
+	uint32 handle = linkData.animationChannelPointers.Find(animatedTargetPointer);
+	if (handle == 0) return false;
+	FCDAnimationChannelPointerMap::iterator it = linkData.animationChannelDrivers.find(handle);
+	if (it == linkData.animationChannelDrivers.end()) return false;
+
 	bool driven = false;
-	size_t animationCount = fcdoument->GetAnimationLibrary()->GetEntityCount();
-	for (size_t i = 0; i < animationCount; ++i)
+	for (FCDAnimationChannelList::iterator itC = it->second.begin(); itC != it->second.end(); ++itC)
 	{
-		FCDAnimation* animation = fcdoument->GetAnimationLibrary()->GetEntity(i);
-		driven |= FArchiveXML::LinkDriver(animation, animated, animatedTargetPointer);
+		driven |= FArchiveXML::LinkDriver(*itC, animated, animatedTargetPointer);
 	}
 	return driven;
 }
@@ -67,8 +74,8 @@ bool FArchiveXML::LinkDriver(FCDAnimation* animation, FCDAnimated* animated, con
 
 bool FArchiveXML::LinkDriver(FCDAnimationChannel* animationChannel, FCDAnimated* animated, const fm::string& animatedTargetPointer)
 {
-	FCDAnimationChannelDataMap::iterator it = FArchiveXML::documentLinkDataMap[animationChannel->GetDocument()].animationChannelData.find(animationChannel);
-	FUAssert(it != FArchiveXML::documentLinkDataMap[animationChannel->GetDocument()].animationChannelData.end(),);
+	FCDAnimationChannelDataMap::iterator it = FArchiveXML::GetLinkData(animationChannel->GetDocument()).animationChannelData.find(animationChannel);
+	FUAssert(it != FArchiveXML::GetLinkData(animationChannel->GetDocument()).animationChannelData.end(),);
 	FCDAnimationChannelData& data = it->second;
 
 	bool driver = !data.driverPointer.empty();
@@ -94,11 +101,11 @@ bool FArchiveXML::LinkAnimation(FCDAnimation* animation)
 	for (size_t i = 0; i < animation->GetChannelCount(); ++i)
 	{
 		FCDAnimationChannel* channel = animation->GetChannel(i);
-		FCDAnimationChannelDataMap::iterator it = FArchiveXML::documentLinkDataMap[channel->GetDocument()].animationChannelData.find(channel);
-		FUAssert(it != FArchiveXML::documentLinkDataMap[channel->GetDocument()].animationChannelData.end(), continue);
+		FCDAnimationChannelDataMap::iterator it = FArchiveXML::GetLinkData(channel->GetDocument()).animationChannelData.find(channel);
+		FUAssert(it != FArchiveXML::GetLinkData(channel->GetDocument()).animationChannelData.end(), continue);
 		FCDAnimationChannelData& data = it->second;
 
-		if (!data.driverPointer.empty() && channel->GetCurveCount() > 0 && channel->GetCurve(0)->HasDriver())
+		if (!data.driverPointer.empty() && channel->GetCurveCount() > 0 && !channel->GetCurve(0)->HasDriver())
 		{
 			status &= FUError::Error(FUError::ERROR_LEVEL, FUError::ERROR_ANIM_CURVE_DRIVER_MISSING);
 		}
@@ -131,7 +138,7 @@ bool FArchiveXML::LinkAnimated(FCDAnimated* animated, xmlNode* node)
 		linked |= FArchiveXML::ProcessChannels(animated, channels);
 		if (linked)
 		{
-			FArchiveXML::documentLinkDataMap[animated->GetDocument()].animatedData.insert(animated, data);
+			FArchiveXML::GetLinkData(animated->GetDocument()).animatedData.insert(animated, data);
 		}
 	}
 	else linked = true;
@@ -169,7 +176,7 @@ bool FArchiveXML::LinkAnimatedCustom(FCDAnimatedCustom* animatedCustom, xmlNode*
 			if (chanelCurveCount == 0) continue;
 			
 			// Retrieve the channel's qualifier
-			FCDAnimationChannelData& channelData = FArchiveXML::documentLinkDataMap[channel->GetDocument()].animationChannelData[channel];
+			FCDAnimationChannelData& channelData = FArchiveXML::GetLinkData(channel->GetDocument()).animationChannelData[channel];
 			fm::string qualifier = channelData.targetQualifier;
 			if (qualifier.empty())
 			{
@@ -191,7 +198,7 @@ bool FArchiveXML::LinkAnimatedCustom(FCDAnimatedCustom* animatedCustom, xmlNode*
 		linked |= FArchiveXML::LinkDriver(animatedCustom->GetDocument(), animatedCustom, data.pointer);
 		if (linked)
 		{
-			FArchiveXML::documentLinkDataMap[animatedCustom->GetDocument()].animatedData.insert(animatedCustom, data);
+			FArchiveXML::GetLinkData(animatedCustom->GetDocument()).animatedData.insert(animatedCustom, data);
 		}
 	}
 	else linked = true;
@@ -209,8 +216,8 @@ bool FArchiveXML::LinkTargetedEntity(FCDTargetedEntity* targetedEntity)
 {
 	bool status = true;
 
-	FCDTargetedEntityDataMap::iterator it = FArchiveXML::documentLinkDataMap[targetedEntity->GetDocument()].targetedEntityDataMap.find(targetedEntity);
-	FUAssert(it != FArchiveXML::documentLinkDataMap[targetedEntity->GetDocument()].targetedEntityDataMap.end(),);
+	FCDTargetedEntityDataMap::iterator it = FArchiveXML::GetLinkData(targetedEntity->GetDocument()).targetedEntityDataMap.find(targetedEntity);
+	FUAssert(it != FArchiveXML::GetLinkData(targetedEntity->GetDocument()).targetedEntityDataMap.end(),);
 	FCDTargetedEntityData& data = it->second;
 
 	if (data.targetId.empty()) return status;
@@ -341,8 +348,8 @@ void FArchiveXML::LinkEffectParameterSurface(FCDEffectParameterSurface* effectPa
 
 void FArchiveXML::LinkEffectParameterSampler(FCDEffectParameterSampler* effectParameterSampler, FCDEffectParameterList& parameters)
 {
-	FCDEffectParameterSamplerDataMap::iterator it = FArchiveXML::documentLinkDataMap[effectParameterSampler->GetDocument()].effectParameterSamplerDataMap.find(effectParameterSampler);
-	FUAssert(it != FArchiveXML::documentLinkDataMap[effectParameterSampler->GetDocument()].effectParameterSamplerDataMap.end(),);
+	FCDEffectParameterSamplerDataMap::iterator it = FArchiveXML::GetLinkData(effectParameterSampler->GetDocument()).effectParameterSamplerDataMap.find(effectParameterSampler);
+	FUAssert(it != FArchiveXML::GetLinkData(effectParameterSampler->GetDocument()).effectParameterSamplerDataMap.end(),);
 	FCDEffectParameterSamplerData& data = it->second;
 
 	FCDEffectParameter* surface = NULL;
@@ -470,8 +477,8 @@ void FArchiveXML::LinkEffectTechnique(FCDEffectTechnique* effectTechnique)
 
 void FArchiveXML::LinkTexture(FCDTexture* texture, FCDEffectParameterList& parameters)
 {
-	FCDTextureDataMap::iterator it = FArchiveXML::documentLinkDataMap[texture->GetDocument()].textureDataMap.find(texture);
-	FUAssert(it != FArchiveXML::documentLinkDataMap[texture->GetDocument()].textureDataMap.end(),);
+	FCDTextureDataMap::iterator it = FArchiveXML::GetLinkData(texture->GetDocument()).textureDataMap.find(texture);
+	FUAssert(it != FArchiveXML::GetLinkData(texture->GetDocument()).textureDataMap.end(),);
 	FCDTextureData& data = it->second;
 
 	if (!data.samplerSid.empty())
@@ -540,8 +547,8 @@ bool FArchiveXML::LinkSkinController(FCDSkinController* UNUSED(skinController))
 
 bool FArchiveXML::LinkMorphController(FCDMorphController* morphController)
 {
-	FCDMorphControllerDataMap::iterator it = FArchiveXML::documentLinkDataMap[morphController->GetDocument()].morphControllerDataMap.find(morphController);
-	FUAssert(it != FArchiveXML::documentLinkDataMap[morphController->GetDocument()].morphControllerDataMap.end(),);
+	FCDMorphControllerDataMap::iterator it = FArchiveXML::GetLinkData(morphController->GetDocument()).morphControllerDataMap.find(morphController);
+	FUAssert(it != FArchiveXML::GetLinkData(morphController->GetDocument()).morphControllerDataMap.end(),);
 	FCDMorphControllerData& data = it->second;
 
 	if (morphController->GetBaseTarget() == NULL)
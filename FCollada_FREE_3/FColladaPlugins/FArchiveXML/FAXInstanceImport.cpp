@@ -10,6 +10,7 @@
 #include "FArchiveXML.h"
 #include "FCDocument/FCDocument.h"
 #include "FCDocument/FCDExtra.h"
+#include "FCDocument/FCDLibrary.h"
 #include "FCDocument/FCDEntityReference.h"
 #include "FCDocument/FCDEntityInstance.h"
 #include "FCDocument/FCDEmitterInstance.h"
@@ -28,6 +29,21 @@
 #include "FCDocument/FCDPhysicsModel.h"
 #include "FCDocument/FCDPhysicsRigidBody.h"
 
+// Whether the library of the instantiated entities is yet to be loaded on demand.
+static bool IsEntityLoadDeferred(FCDocument* document, FCDEntity::Type entityType)
+{
+	switch (entityType)
+	{
+	case FCDEntity::CAMERA: return document->GetCameraLibrary()->IsLoadDeferred();
+	case FCDEntity::CONTROLLER: return document->GetControllerLibrary()->IsLoadDeferred();
+	case FCDEntity::EMITTER: return document->GetEmitterLibrary()->IsLoadDeferred();
+	case FCDEntity::FORCE_FIELD: return document->GetForceFieldLibrary()->IsLoadDeferred();
+	case FCDEntity::GEOMETRY: return document->GetGeometryLibrary()->IsLoadDeferred();
+	case FCDEntity::LIGHT: return document->GetLightLibrary()->IsLoadDeferred();
+	default: return false;
+	}
+}
+
 bool FArchiveXML::LoadEntityInstance(FCDObject* object, xmlNode* instanceNode)
 { 
 	FCDEntityInstance* entityInstance = (FCDEntityInstance*)object;
@@ -36,7 +52,9 @@ bool FArchiveXML::LoadEntityInstance(FCDObject* object, xmlNode* instanceNode)
 
 	FUUri uri = ReadNodeUrl(instanceNode);
 	entityInstance->GetEntityReference()->SetUri(uri);
-	if (!entityInstance->IsExternalReference() && entityInstance->GetEntity() == NULL)
+	// Don't resolve the entities of the lazy libraries: that would load them right away.
+	if (!entityInstance->IsExternalReference() && !IsEntityLoadDeferred(entityInstance->GetDocument(), entityInstance->GetEntityType())
+		&& entityInstance->GetEntity() == NULL)
 	{
 		FUError::Error(FUError::WARNING_LEVEL, FUError::WARNING_INST_ENTITY_MISSING, instanceNode->line);
 	}
@@ -380,7 +398,7 @@ bool FArchiveXML::LinkControllerInstance(FCDControllerInstance* controllerInstan
 {
 	const FCDSkinController* skin =  FArchiveXML::FindSkinController(controllerInstance, controllerInstance->GetEntity());
 	if (skin == NULL) return true;
-	FCDSkinControllerData& data = FArchiveXML::documentLinkDataMap[skin->GetDocument()].skinControllerDataMap.find(const_cast<FCDSkinController*>(skin))->second;
+	FCDSkinControllerData& data = FArchiveXML::GetLinkData(skin->GetDocument()).skinControllerDataMap.find(const_cast<FCDSkinController*>(skin))->second;
 
 	// Look for each joint, by COLLADA id, within the scene graph
 	size_t jointCount = skin->GetJointCount();
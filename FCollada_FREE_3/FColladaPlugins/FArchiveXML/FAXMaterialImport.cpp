@@ -394,7 +394,7 @@ bool FArchiveXML::LoadEffectParameterSampler(FCDObject* object, xmlNode* paramet
 
 	bool status = true;
 	FCDEffectParameterSampler* effectParameterSampler = (FCDEffectParameterSampler*)object;
-	FCDEffectParameterSamplerData& data = FArchiveXML::documentLinkDataMap[effectParameterSampler->GetDocument()].effectParameterSamplerDataMap[effectParameterSampler];
+	FCDEffectParameterSamplerData& data = FArchiveXML::GetLinkData(effectParameterSampler->GetDocument()).effectParameterSamplerDataMap[effectParameterSampler];
 
 	// Find the sampler node
 	xmlNode* samplerNode = NULL;
@@ -1542,7 +1542,7 @@ bool FArchiveXML::LoadImage(FCDObject* object, xmlNode* imageNode)
 bool FArchiveXML::LoadTexture(FCDObject* object, xmlNode* textureNode)
 {
 	FCDTexture* texture = (FCDTexture*)object;
-	FCDTextureData& data = FArchiveXML::documentLinkDataMap[texture->GetDocument()].textureDataMap[texture];
+	FCDTextureData& data = FArchiveXML::GetLinkData(texture->GetDocument()).textureDataMap[texture];
 
 	bool status = true;
 
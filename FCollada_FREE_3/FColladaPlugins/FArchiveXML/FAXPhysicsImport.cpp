@@ -229,8 +229,8 @@ bool FArchiveXML::AttachModelInstancesFCDPhysicsModel(FCDPhysicsModel* physicsMo
 {
 	bool status = true;
 	
-	FCDPhysicsModelDataMap::iterator it = FArchiveXML::documentLinkDataMap[physicsModel->GetDocument()].physicsModelDataMap.find(physicsModel);
-	FUAssert(it != FArchiveXML::documentLinkDataMap[physicsModel->GetDocument()].physicsModelDataMap.end(),);
+	FCDPhysicsModelDataMap::iterator it = FArchiveXML::GetLinkData(physicsModel->GetDocument()).physicsModelDataMap.find(physicsModel);
+	FUAssert(it != FArchiveXML::GetLinkData(physicsModel->GetDocument()).physicsModelDataMap.end(),);
 	FCDPhysicsModelData& data = it->second;
 
 	for (ModelInstanceNameNodeMap::iterator it = data.modelInstancesMap.begin(); it != data.modelInstancesMap.end(); ++it)
@@ -645,7 +645,7 @@ bool FArchiveXML::LoadPhysicsModel(FCDObject* object, xmlNode* physicsModelNode)
 
 	bool status = true;
 	FCDPhysicsModel* physicsModel = (FCDPhysicsModel*)object;
-	FCDPhysicsModelData& data = FArchiveXML::documentLinkDataMap[physicsModel->GetDocument()].physicsModelDataMap[physicsModel];
+	FCDPhysicsModelData& data = FArchiveXML::GetLinkData(physicsModel->GetDocument()).physicsModelDataMap[physicsModel];
 	if (!IsEquivalent(physicsModelNode->name, DAE_PHYSICS_MODEL_ELEMENT))
 	{
 		FUError::Error(FUError::WARNING_LEVEL, FUError::WARNING_UNKNOWN_PHYS_LIB_ELEMENT, physicsModelNode->line);
@@ -21,6 +21,37 @@
 #include "FCDocument/FCDEmitterInstance.h"
 #include "FCDocument/FCDEntityInstance.h"
 
+// Instances of the entities in a skipped library are not loaded.
+static bool IsInstanceSkipped(const FCDocument* document, uint32 instanceType)
+{
+	FCDLoadOptions::Library library;
+	switch (instanceType)
+	{
+	case FCDEntity::CAMERA: library = FCDLoadOptions::CAMERA; break;
+	case FCDEntity::CONTROLLER: library = FCDLoadOptions::CONTROLLER; break;
+	case FCDEntity::EMITTER: library = FCDLoadOptions::EMITTER; break;
+	case FCDEntity::FORCE_FIELD: library = FCDLoadOptions::FORCE_FIELD; break;
+	case FCDEntity::GEOMETRY: library = FCDLoadOptions::GEOMETRY; break;
+	case FCDEntity::LIGHT: library = FCDLoadOptions::LIGHT; break;
+	default: return false;
+	}
+	return document->GetLoadOptions().GetMode(library) == FCDLoadOptions::SKIP;
+}
+
+// When the import is restricted to requested entities, the instances
+// of the geometries and controllers that were not read in are dropped.
+static bool IsInstanceUnrequested(FCDocument* document, uint32 instanceType, xmlNode* instanceNode)
+{
+	if (!document->GetLoadOptions().HasRequestedEntities()) return false;
+	if (instanceType != FCDEntity::GEOMETRY && instanceType != FCDEntity::CONTROLLER) return false;
+
+	FUUri uri = ReadNodeUrl(instanceNode);
+	if (uri.IsFile()) return false;
+	fm::string entityId = FCDObjectWithId::CleanId(TO_STRING(uri.GetFragment()));
+	if (instanceType == FCDEntity::GEOMETRY) return document->FindGeometry(entityId) == NULL;
+	else return document->FindController(entityId) == NULL;
+}
+
 bool FArchiveXML::LoadEntity(FCDObject* object, xmlNode* entityNode)
 { 
 	FCDEntity* entity = (FCDEntity*)object;
@@ -83,7 +114,7 @@ bool FArchiveXML::LoadTargetedEntity(FCDObject* object, xmlNode* entityNode)
 
 	bool status = true;
 	FCDTargetedEntity* targetedEntity = (FCDTargetedEntity*)object;
-	FCDTargetedEntityData& data = FArchiveXML::documentLinkDataMap[targetedEntity->GetDocument()].targetedEntityDataMap[targetedEntity];
+	FCDTargetedEntityData& data = FArchiveXML::GetLinkData(targetedEntity->GetDocument()).targetedEntityDataMap[targetedEntity];
 
 	// Look for and extract the target information from the extra tree nodes.
 	// For backward-compatibility: we want to process the <technique> straight into the extra tree..
@@ -180,7 +211,8 @@ bool FArchiveXML::LoadSceneNode(FCDObject* object, xmlNode* node)
 			else
 			{
 				uint32 instanceType = FArchiveXML::GetEntityInstanceType(child);
-				if (instanceType != (uint32) ~0)
+				if (IsInstanceSkipped(sceneNode->GetDocument(), instanceType) || IsInstanceUnrequested(sceneNode->GetDocument(), instanceType, child)) continue;
+				else if (instanceType != (uint32) ~0)
 				{
 					FCDEntityInstance* instance = sceneNode->AddInstance((FCDEntity::Type) instanceType);
 					status &= (FArchiveXML::LoadSwitch(instance, &instance->GetObjectType(), child));
@@ -278,6 +310,10 @@ bool FArchiveXML::LoadFromExtraSceneNode(FCDSceneNode* sceneNode)
 				{
 					status = false;
 				}
+				else if (IsInstanceSkipped(sceneNode->GetDocument(), instanceType) || IsInstanceUnrequested(sceneNode->GetDocument(), instanceType, instanceNode))
+				{
+					nodesToRelease.push_back(node);
+				}
 				else
 				{
 					FCDEntityInstance* instance = sceneNode->AddInstance((FCDEntity::Type) instanceType);
@@ -0,0 +1,519 @@
+/*
+	Copyright (C) 2005-2007 Feeling Software Inc.
+	Portions of the code are:
+	Copyright (C) 2005-2007 Sony Computer Entertainment America
+
+	MIT License: http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "StdAfx.h"
+#include "FAXSnapshot.h"
+#include "FUtils/FUCrc32.h"
+#include "FUtils/FUFile.h"
+#include "FUtils/FUStringConversion.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef WIN32
+#include <io.h>
+#include <process.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif // WIN32
+
+#define SNAPSHOT_MAGIC 0x4E534346 // "FCSN"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_EXTENSION FC(".fcsnap")
+#define SNAPSHOT_NONE 0xFFFFFFFF
+#define SNAPSHOT_HASH_BLOCK_SIZE 65536
+#define SNAPSHOT_INTERNED_LENGTH 64
+
+//
+// Snapshot layout
+//
+// All the values are little-endian. The header is followed by the node records,
+// the attribute records, the string offsets, the float array words and the string data.
+// All the references are indices, or offsets relative to the start of their section.
+//
+
+struct FAXSnapshotHeader
+{
+	uint32 magic;
+	uint32 version;
+	uint32 sourceHash;
+	uint32 nodeCount;
+	uint32 attributeCount;
+	uint32 stringCount;
+	uint32 floatWordCount;
+	uint32 stringDataLength;
+	uint64 sourceSize;
+	int64 sourceTime;
+};
+
+// The nodes are stored in pre-order: the children of a node directly follow it.
+struct FAXSnapshotNode
+{
+	uint32 type;
+	uint32 name;
+	uint32 content;
+	uint32 line;
+	uint32 firstAttribute;
+	uint32 attributeCount;
+	uint32 childCount;
+	uint32 floatArray; // Offset of the value count, followed by the values, within the float array words.
+};
+
+struct FAXSnapshotAttribute
+{
+	uint32 name;
+	uint32 value;
+};
+
+typedef fm::vector<FAXSnapshotNode, true> FAXSnapshotNodeList;
+typedef fm::vector<FAXSnapshotAttribute, true> FAXSnapshotAttributeList;
+typedef fm::vector<const char*, true> FAXSnapshotStringList;
+typedef fm::map<fm::string, uint32> FAXSnapshotStringMap;
+
+static bool IsLittleEndianHost()
+{
+	uint32 one = 1;
+	return *((const uint8*) &one) == 1;
+}
+
+static bool IsSnapshotNodeType(xmlElementType type)
+{
+	return type == XML_ELEMENT_NODE || type == XML_TEXT_NODE || type == XML_CDATA_SECTION_NODE
+		|| type == XML_COMMENT_NODE || type == XML_PI_NODE;
+}
+
+// The fm::vector grows linearly: double its capacity instead, for the large snapshot tables.
+template <class T, bool PRIMITIVE>
+static void ReserveAdditional(fm::vector<T, PRIMITIVE>& list, size_t additional)
+{
+	size_t required = list.size() + additional;
+	if (required > list.capacity())
+	{
+		size_t doubled = list.capacity() * 2;
+		list.reserve(doubled > required ? doubled : required);
+	}
+}
+
+static bool WriteBlock(FUFile& file, const void* data, size_t length)
+{
+	return length == 0 || file.Write(data, length);
+}
+
+// Replaces a file in a single step: the processes that have the old file
+// mapped keep their view of it, instead of seeing it truncated.
+static bool ReplaceSnapshotFile(const fstring& sourceFilename, const fstring& targetFilename)
+{
+#ifdef WIN32
+	return MoveFileEx(sourceFilename.c_str(), targetFilename.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+#else
+	return rename(TO_STRING(sourceFilename).c_str(), TO_STRING(targetFilename).c_str()) == 0;
+#endif // WIN32
+}
+
+static void RemoveSnapshotFile(const fstring& filename)
+{
+#if defined(WIN32) && defined(UNICODE)
+	_wremove(filename.c_str());
+#else
+	remove(TO_STRING(filename).c_str());
+#endif // WIN32 && UNICODE
+}
+
+//
+// FAXSnapshotWriter
+//
+
+class FAXSnapshotWriter
+{
+public:
+	FAXSnapshotNodeList nodes;
+	FAXSnapshotAttributeList attributes;
+	FAXSnapshotStringList strings;
+	UInt32List floatWords;
+	uint64 stringDataLength;
+
+private:
+	FAXSnapshotStringMap internedStrings;
+
+public:
+	FAXSnapshotWriter() : stringDataLength(0) {}
+
+	// Short strings, such as the element names and the whitespace, are interned.
+	// The long strings are referenced in place, within the XML tree.
+	uint32 AddString(const char* text, bool copy = false)
+	{
+		if (text == NULL) text = emptyCharString;
+		size_t length = strlen(text);
+		if (length < SNAPSHOT_INTERNED_LENGTH || copy)
+		{
+			FAXSnapshotStringMap::iterator it = internedStrings.find(fm::string(text, length));
+			if (it != internedStrings.end()) return it->second;
+			it = internedStrings.insert(fm::string(text, length), (uint32) strings.size());
+			text = it->first.c_str();
+		}
+
+		ReserveAdditional(strings, 1);
+		strings.push_back(text);
+		stringDataLength += length + 1;
+		return (uint32) strings.size() - 1;
+	}
+
+	void AddAttribute(xmlAttr* attribute)
+	{
+		FAXSnapshotAttribute record;
+		record.name = AddString((const char*) attribute->name);
+
+		xmlNode* valueNode = attribute->children;
+		if (valueNode == NULL) record.value = AddString(emptyCharString);
+		else if (valueNode->next == NULL && valueNode->type == XML_TEXT_NODE) record.value = AddString((const char*) valueNode->content);
+		else
+		{
+			// Rare: the attribute value is split across entity references.
+			xmlChar* value = xmlNodeListGetString(attribute->doc, valueNode, 1);
+			record.value = AddString((const char*) value, true);
+			xmlFree(value);
+		}
+
+		ReserveAdditional(attributes, 1);
+		attributes.push_back(record);
+	}
+
+	void AddFloatArray(xmlNode* arrayNode, FAXSnapshotNode& record)
+	{
+		FloatList values;
+		FUStringConversion::ToFloatList(ReadNodeContentDirect(arrayNode), values);
+
+		size_t count = values.size();
+		record.floatArray = (uint32) floatWords.size();
+		ReserveAdditional(floatWords, count + 1);
+		floatWords.push_back((uint32) count);
+		floatWords.resize(floatWords.size() + count);
+		if (count > 0) memcpy(floatWords.end() - count, values.begin(), count * sizeof(float));
+	}
+
+	void AddNode(xmlNode* node, bool isSourceChild, bool isInExtra)
+	{
+		size_t index = nodes.size();
+		ReserveAdditional(nodes, 1);
+		nodes.push_back(FAXSnapshotNode());
+
+		FAXSnapshotNode record;
+		record.type = (uint32) node->type;
+		record.name = (node->type == XML_ELEMENT_NODE || node->type == XML_PI_NODE) ? AddString((const char*) node->name) : SNAPSHOT_NONE;
+		record.content = (node->type != XML_ELEMENT_NODE) ? AddString((const char*) node->content) : SNAPSHOT_NONE;
+		record.line = (uint32) node->line;
+		record.firstAttribute = (uint32) attributes.size();
+		record.attributeCount = 0;
+		record.childCount = 0;
+		record.floatArray = SNAPSHOT_NONE;
+
+		if (node->type == XML_ELEMENT_NODE)
+		{
+			for (xmlAttr* attribute = node->properties; attribute != NULL; attribute = attribute->next)
+			{
+				AddAttribute(attribute);
+				++record.attributeCount;
+			}
+
+			if (isSourceChild && !isInExtra && IsEquivalent(node->name, DAE_FLOAT_ARRAY_ELEMENT))
+			{
+				// The text content of the float arrays is replaced by the parsed values.
+				AddFloatArray(node, record);
+			}
+			else
+			{
+				bool isSource = IsEquivalent(node->name, DAE_SOURCE_ELEMENT);
+				bool isExtra = isInExtra || IsEquivalent(node->name, DAE_EXTRA_ELEMENT);
+				for (xmlNode* child = node->children; child != NULL; child = child->next)
+				{
+					if (!IsSnapshotNodeType(child->type)) continue;
+					AddNode(child, isSource, isExtra);
+					++record.childCount;
+				}
+			}
+		}
+
+		nodes[index] = record;
+	}
+};
+
+//
+// FAXSnapshot
+//
+
+FAXSnapshot::FAXSnapshot(const fstring& _sourceFilename)
+:	sourceFilename(_sourceFilename), snapshotFilename(_sourceFilename + SNAPSHOT_EXTENSION)
+,	hasSourceSignature(false), sourceSize(0), sourceTime(0), sourceHash(0)
+,	data(NULL), dataLength(0), mapping(NULL)
+,	xmlDocument(NULL)
+{
+	FUFile file(sourceFilename, FUFile::READ);
+	if (!file.IsOpen()) return;
+
+#ifdef WIN32
+	struct _stat fileStatus;
+	if (_fstat(_fileno(file.GetHandle()), &fileStatus) != 0) return;
+#else
+	struct stat fileStatus;
+	if (fstat(fileno(file.GetHandle()), &fileStatus) != 0) return;
+#endif // WIN32
+	sourceSize = (uint64) fileStatus.st_size;
+	sourceTime = (int64) fileStatus.st_mtime;
+
+	// Hash the contents of the COLLADA file in pieces.
+	uint8* buffer = new uint8[SNAPSHOT_HASH_BLOCK_SIZE];
+	uint64 remaining = sourceSize;
+	FUCrc32::crc32 hash = 0;
+	while (remaining > 0)
+	{
+		size_t length = remaining < SNAPSHOT_HASH_BLOCK_SIZE ? (size_t) remaining : SNAPSHOT_HASH_BLOCK_SIZE;
+		if (!file.Read(buffer, length)) break;
+		hash = FUCrc32::CRC32(buffer, length, hash);
+		remaining -= length;
+	}
+	SAFE_DELETE_ARRAY(buffer);
+
+	sourceHash = hash;
+	hasSourceSignature = (remaining == 0);
+}
+
+FAXSnapshot::~FAXSnapshot()
+{
+	Close();
+}
+
+bool FAXSnapshot::Open()
+{
+	Close();
+	if (!hasSourceSignature || !IsLittleEndianHost()) return false;
+
+	FUFile file(snapshotFilename, FUFile::READ);
+	if (!file.IsOpen()) return false;
+	size_t length = file.GetLength();
+	if (length < sizeof(FAXSnapshotHeader)) return false;
+
+	// The mapping stays valid once the file is closed.
+#ifdef WIN32
+	HANDLE fileHandle = (HANDLE) _get_osfhandle(_fileno(file.GetHandle()));
+	HANDLE fileMapping = CreateFileMapping(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (fileMapping == NULL) return false;
+	void* view = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == NULL) { CloseHandle(fileMapping); return false; }
+	mapping = (void*) fileMapping;
+#else
+	void* view = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fileno(file.GetHandle()), 0);
+	if (view == MAP_FAILED) return false;
+#endif // WIN32
+	data = (const uint8*) view;
+	dataLength = length;
+
+	if (!BuildXmlDocument())
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void FAXSnapshot::Close()
+{
+	ReleaseXmlDocument();
+	if (data == NULL) return;
+
+#ifdef WIN32
+	UnmapViewOfFile((LPCVOID) data);
+	CloseHandle((HANDLE) mapping);
+#else
+	munmap((void*) data, dataLength);
+#endif // WIN32
+	data = NULL;
+	dataLength = 0;
+	mapping = NULL;
+}
+
+xmlNode* FAXSnapshot::GetRootNode()
+{
+	return (xmlDocument != NULL) ? xmlDocGetRootElement(xmlDocument) : NULL;
+}
+
+void FAXSnapshot::ReleaseXmlDocument()
+{
+	if (xmlDocument != NULL)
+	{
+		xmlFreeDoc(xmlDocument);
+		xmlDocument = NULL;
+	}
+}
+
+bool FAXSnapshot::BuildXmlDocument()
+{
+	// Check the signature and that the sections exactly fill the snapshot.
+	const FAXSnapshotHeader* header = (const FAXSnapshotHeader*) data;
+	if (header->magic != SNAPSHOT_MAGIC || header->version != SNAPSHOT_VERSION) return false;
+	if (header->sourceSize != sourceSize || header->sourceTime != sourceTime || header->sourceHash != sourceHash) return false;
+	if (header->nodeCount == 0 || header->stringDataLength == 0) return false;
+
+	uint64 expectedLength = sizeof(FAXSnapshotHeader)
+		+ (uint64) header->nodeCount * sizeof(FAXSnapshotNode)
+		+ (uint64) header->attributeCount * sizeof(FAXSnapshotAttribute)
+		+ (uint64) header->stringCount * sizeof(uint32)
+		+ (uint64) header->floatWordCount * sizeof(uint32)
+		+ (uint64) header->stringDataLength;
+	if (expectedLength != (uint64) dataLength) return false;
+
+	const FAXSnapshotNode* nodes = (const FAXSnapshotNode*) (header + 1);
+	const FAXSnapshotAttribute* attributes = (const FAXSnapshotAttribute*) (nodes + header->nodeCount);
+	const uint32* stringOffsets = (const uint32*) (attributes + header->attributeCount);
+	const uint32* floatWords = stringOffsets + header->stringCount;
+	const char* stringData = (const char*) (floatWords + header->floatWordCount);
+	if (stringData[header->stringDataLength - 1] != 0) return false;
+	for (uint32 i = 0; i < header->stringCount; ++i)
+	{
+		if (stringOffsets[i] >= header->stringDataLength) return false;
+	}
+#define SNAPSHOT_STRING(index) ((const xmlChar*) (stringData + stringOffsets[index]))
+
+	// The element names are interned in the dictionary of the document, as the parser does.
+	xmlDocument = xmlNewDoc(NULL);
+	xmlDocument->dict = xmlDictCreate();
+
+	// Rebuild the nodes in pre-order, counting the children left to attach to each open parent.
+	fm::pvector<xmlNode> parents;
+	UInt32List remainingChildren;
+	for (uint32 i = 0; i < header->nodeCount; ++i)
+	{
+		const FAXSnapshotNode& record = nodes[i];
+		if (i > 0 && parents.empty()) return false;
+		bool hasName = record.name < header->stringCount;
+		bool hasContent = record.content < header->stringCount;
+
+		xmlNode* node = NULL;
+		switch (record.type)
+		{
+		case XML_ELEMENT_NODE: if (hasName) node = xmlNewDocNode(xmlDocument, NULL, SNAPSHOT_STRING(record.name), NULL); break;
+		case XML_TEXT_NODE: if (hasContent) node = xmlNewDocText(xmlDocument, SNAPSHOT_STRING(record.content)); break;
+		case XML_CDATA_SECTION_NODE: if (hasContent) node = xmlNewCDataBlock(xmlDocument, SNAPSHOT_STRING(record.content), xmlStrlen(SNAPSHOT_STRING(record.content))); break;
+		case XML_COMMENT_NODE: if (hasContent) node = xmlNewDocComment(xmlDocument, SNAPSHOT_STRING(record.content)); break;
+		case XML_PI_NODE: if (hasName && hasContent) node = xmlNewDocPI(xmlDocument, SNAPSHOT_STRING(record.name), SNAPSHOT_STRING(record.content)); break;
+		default: break;
+		}
+		if (node == NULL) return false;
+
+		if (i == 0)
+		{
+			if (node->type != XML_ELEMENT_NODE) { xmlFreeNode(node); return false; }
+			xmlDocSetRootElement(xmlDocument, node);
+		}
+		else
+		{
+			// Link the node directly: xmlAddChild would merge adjacent text nodes.
+			xmlNode* parent = parents.back();
+			node->parent = parent;
+			node->prev = parent->last;
+			if (parent->last != NULL) parent->last->next = node;
+			else parent->children = node;
+			parent->last = node;
+			--remainingChildren.back();
+		}
+		node->line = (unsigned short) (record.line < 0xFFFF ? record.line : 0xFFFF);
+
+		if (record.attributeCount > 0)
+		{
+			if (node->type != XML_ELEMENT_NODE) return false;
+			if ((uint64) record.firstAttribute + record.attributeCount > header->attributeCount) return false;
+			for (uint32 j = 0; j < record.attributeCount; ++j)
+			{
+				const FAXSnapshotAttribute& attribute = attributes[record.firstAttribute + j];
+				if (attribute.name >= header->stringCount || attribute.value >= header->stringCount) return false;
+				xmlNewProp(node, SNAPSHOT_STRING(attribute.name), SNAPSHOT_STRING(attribute.value));
+			}
+		}
+
+		if (record.floatArray != SNAPSHOT_NONE)
+		{
+			if (node->type != XML_ELEMENT_NODE || record.floatArray >= header->floatWordCount) return false;
+			if ((uint64) record.floatArray + 1 + floatWords[record.floatArray] > header->floatWordCount) return false;
+			node->_private = (void*) (floatWords + record.floatArray);
+		}
+
+		while (!remainingChildren.empty() && remainingChildren.back() == 0)
+		{
+			parents.pop_back();
+			remainingChildren.pop_back();
+		}
+		if (record.childCount > 0)
+		{
+			if (node->type != XML_ELEMENT_NODE) return false;
+			parents.push_back(node);
+			remainingChildren.push_back(record.childCount);
+		}
+	}
+#undef SNAPSHOT_STRING
+
+	return parents.empty();
+}
+
+bool FAXSnapshot::Write(xmlNode* rootNode)
+{
+	if (!hasSourceSignature || !IsLittleEndianHost() || rootNode == NULL) return false;
+
+	FAXSnapshotWriter writer;
+	writer.AddNode(rootNode, false, false);
+	if (writer.stringDataLength >= SNAPSHOT_NONE || writer.floatWords.size() >= SNAPSHOT_NONE) return false;
+
+	UInt32List stringOffsets;
+	stringOffsets.reserve(writer.strings.size());
+	uint32 stringOffset = 0;
+	for (FAXSnapshotStringList::iterator it = writer.strings.begin(); it != writer.strings.end(); ++it)
+	{
+		stringOffsets.push_back(stringOffset);
+		stringOffset += (uint32) strlen(*it) + 1;
+	}
+
+	// Write to a file of this process only, which then replaces the snapshot:
+	// other processes may have the current snapshot mapped.
+#ifdef WIN32
+	uint32 processId = (uint32) _getpid();
+#else
+	uint32 processId = (uint32) getpid();
+#endif // WIN32
+	fstring temporaryFilename = snapshotFilename + FC(".") + TO_FSTRING(processId) + FC(".tmp");
+	FUFile file(temporaryFilename, FUFile::WRITE);
+	if (!file.IsOpen()) return false;
+
+	// The header is written last, so that a partially written snapshot is never valid.
+	FAXSnapshotHeader header;
+	memset(&header, 0, sizeof(header));
+	bool written = WriteBlock(file, &header, sizeof(header));
+	written &= WriteBlock(file, writer.nodes.begin(), writer.nodes.size() * sizeof(FAXSnapshotNode));
+	written &= WriteBlock(file, writer.attributes.begin(), writer.attributes.size() * sizeof(FAXSnapshotAttribute));
+	written &= WriteBlock(file, stringOffsets.begin(), stringOffsets.size() * sizeof(uint32));
+	written &= WriteBlock(file, writer.floatWords.begin(), writer.floatWords.size() * sizeof(uint32));
+	for (FAXSnapshotStringList::iterator it = writer.strings.begin(); it != writer.strings.end() && written; ++it)
+	{
+		written &= WriteBlock(file, *it, strlen(*it) + 1);
+	}
+
+	header.magic = SNAPSHOT_MAGIC;
+	header.version = SNAPSHOT_VERSION;
+	header.sourceHash = sourceHash;
+	header.nodeCount = (uint32) writer.nodes.size();
+	header.attributeCount = (uint32) writer.attributes.size();
+	header.stringCount = (uint32) writer.strings.size();
+	header.floatWordCount = (uint32) writer.floatWords.size();
+	header.stringDataLength = stringOffset;
+	header.sourceSize = sourceSize;
+	header.sourceTime = sourceTime;
+	written &= (fseek(file.GetHandle(), 0, SEEK_SET) == 0);
+	written &= WriteBlock(file, &header, sizeof(header));
+	file.Close();
+
+	written = written && ReplaceSnapshotFile(temporaryFilename, snapshotFilename);
+	if (!written) RemoveSnapshotFile(temporaryFilename);
+	return written;
+}
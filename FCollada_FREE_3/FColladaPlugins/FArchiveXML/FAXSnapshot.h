@@ -0,0 +1,100 @@
+/*
+	Copyright (C) 2005-2007 Feeling Software Inc.
+	Portions of the code are:
+	Copyright (C) 2005-2007 Sony Computer Entertainment America
+
+	MIT License: http://www.opensource.org/licenses/mit-license.php
+*/
+
+/**
+	@file FAXSnapshot.h
+	This file contains the FAXSnapshot class.
+*/
+
+#ifndef _FAX_SNAPSHOT_H_
+#define _FAX_SNAPSHOT_H_
+
+#ifdef HAS_LIBXML
+
+/**
+	A binary snapshot of a parsed COLLADA document.
+
+	The snapshot is a cache of the XML tree, written next to the COLLADA file
+	the first time it is parsed. When the COLLADA file is loaded again,
+	the snapshot is memory-mapped and the XML tree is rebuilt from it,
+	without tokenizing the text of the COLLADA file.
+
+	All the strings of the tree are interned in one string table.
+	The float arrays of the sources are stored as raw little-endian floats:
+	their nodes have no text content and their _private pointer refers to
+	the mapped values. See FUDaeParser::ReadNodeBinaryFloats.
+	The snapshot must therefore stay mapped for as long as these nodes,
+	or copies of them, are read in.
+
+	A snapshot is only used if the size, the modification time and the
+	CRC-32 of the COLLADA file all match the ones recorded in it.
+
+	@ingroup FColladaPlugins
+*/
+class FAXSnapshot
+{
+private:
+	fstring sourceFilename;
+	fstring snapshotFilename;
+
+	// The signature of the COLLADA file.
+	bool hasSourceSignature;
+	uint64 sourceSize;
+	int64 sourceTime;
+	uint32 sourceHash;
+
+	// The mapped snapshot.
+	const uint8* data;
+	size_t dataLength;
+	void* mapping;
+
+	// The XML tree rebuilt from the snapshot.
+	xmlDoc* xmlDocument;
+
+public:
+	/** Constructor.
+		Reads in the signature of the COLLADA file.
+		@param sourceFilename The absolute filename of the COLLADA file. */
+	FAXSnapshot(const fstring& sourceFilename);
+
+	/** Destructor. Unmaps the snapshot. */
+	~FAXSnapshot();
+
+	/** Retrieves the filename of the snapshot.
+		@return The filename of the COLLADA file with the ".fcsnap" extension appended. */
+	inline const fstring& GetSnapshotFilename() const { return snapshotFilename; }
+
+	/** Maps the snapshot and rebuilds the XML tree.
+		@return Whether an up-to-date and valid snapshot was found. */
+	bool Open();
+
+	/** Retrieves whether the snapshot is mapped.
+		@return Whether the document was restored from the snapshot. */
+	inline bool IsOpen() const { return data != NULL; }
+
+	/** Retrieves the root node of the XML tree rebuilt from the snapshot.
+		@return The root node. This pointer will be NULL if the snapshot is not open. */
+	xmlNode* GetRootNode();
+
+	/** Releases the XML tree rebuilt from the snapshot.
+		The snapshot itself stays mapped, for the copied float array nodes. */
+	void ReleaseXmlDocument();
+
+	/** Writes out the snapshot of a freshly parsed COLLADA file.
+		@param rootNode The root node of the parsed XML tree.
+		@return Whether the snapshot was written out. */
+	bool Write(xmlNode* rootNode);
+
+private:
+	bool BuildXmlDocument();
+	void Close();
+};
+
+#endif // HAS_LIBXML
+
+#endif // _FAX_SNAPSHOT_H_
@@ -64,12 +64,41 @@ class FCDForceDrag;
 class FCDForceDragDamping;
 class FCDEmitter;
 class FCDExternalReferenceManager;
+class FAXSnapshot;
+
+//
+// Flat function table indexed by the dense object type identifiers.
+// Filled once when the plug-in is initialized, read-only afterwards.
+//
+template <class FUNC>
+class FAXFunctionTable
+{
+private:
+	fm::vector<FUNC> functions;
+
+public:
+	void insert(const FUObjectType* type, FUNC function)
+	{
+		uint32 typeId = type->GetTypeId();
+		if (typeId >= functions.size()) functions.resize(typeId + 1, NULL);
+		functions[typeId] = function;
+	}
+
+	inline FUNC find(const FUObjectType* type) const
+	{
+		uint32 typeId = type->GetTypeId();
+		return (typeId < functions.size()) ? functions[typeId] : NULL;
+	}
+
+	inline bool empty() const { return functions.empty(); }
+	inline void clear() { functions.clear(); }
+};
 
 typedef bool(* XMLLoadFunc)(FCDObject*, xmlNode* node);
-typedef fm::map<const FUObjectType*, XMLLoadFunc> XMLLoadFuncMap;
+typedef FAXFunctionTable<XMLLoadFunc> XMLLoadFuncTable;
 
 typedef xmlNode* (* XMLWriteFunc)(FCDObject*, xmlNode* node);
-typedef fm::map<const FUObjectType*, XMLWriteFunc> XMLWriteFuncMap;
+typedef FAXFunctionTable<XMLWriteFunc> XMLWriteFuncTable;
 
 //
 // Define data structures to store intermediate data.
@@ -225,6 +254,8 @@ typedef fm::map<FCDGeometrySource*, FCDGeometrySourceData> FCDGeometrySourceData
 
 
 typedef fm::pvector<FCDAnimationChannel> FCDAnimationChannelList;
+typedef fm::map<uint32, FCDAnimationChannelList> FCDAnimationChannelPointerMap; // Target or driver pointer, interned in the link data's pool -> channels
+typedef fm::map<const xmlNode*, bool> FAXNodeSet;
 
 #endif //_FAXSTRUCTURES_H_
 
@@ -245,6 +276,33 @@ struct FCDocumentLinkData
 	FCDSkinControllerDataMap skinControllerDataMap;
 	FCDMorphControllerDataMap morphControllerDataMap;
 	FCDGeometrySourceDataMap geometrySourceDataMap;
+
+	// Animation channels indexed by target and driver pointers.
+	// Rebuilt whenever the number of animation channels has changed.
+	FUStringPool animationChannelPointers;
+	FCDAnimationChannelPointerMap animationChannelTargets;
+	FCDAnimationChannelPointerMap animationChannelDrivers;
+	size_t animationChannelIndexSize;
+
+	// Entity nodes not read in, since no requested entity needs them.
+	// Only valid during the import of the document.
+	FAXNodeSet skippedEntityNodes;
+
+	// The snapshot the document was restored from: the float arrays of
+	// the lazily loaded libraries are read from its mapping.
+	FAXSnapshot* snapshot;
+
+	// Number of imports or exports of the document currently in flight.
+	// The link data is released when the last of them completes.
+	uint32 referenceCount;
+
+	FCDocumentLinkData()
+	{
+		animationChannelIndexSize = 0;
+		snapshot = NULL;
+		referenceCount = 0;
+	}
+	~FCDocumentLinkData();
 };
 
-typedef fm::map<const FCDocument*, FCDocumentLinkData> DocumentLinkDataMap;
+typedef fm::map<const FCDocument*, FCDocumentLinkData*> DocumentLinkDataMap;
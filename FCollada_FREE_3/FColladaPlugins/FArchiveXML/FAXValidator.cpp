@@ -0,0 +1,662 @@
+/*
+	Copyright (C) 2005-2007 Feeling Software Inc.
+	Portions of the code are:
+	Copyright (C) 2005-2007 Sony Computer Entertainment America
+
+	MIT License: http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "StdAfx.h"
+#include "FAXValidator.h"
+#include "FUtils/FUDaeEnum.h"
+#include "FUtils/FUFile.h"
+#include "FUtils/FUStringConversion.h"
+#include <libxml/xmlreader.h>
+
+#define NO_INDEX_BOUND 0xFFFFFFFF
+
+// Input offsets may skip a few values, but never go far beyond the number of inputs.
+#define MAX_INPUT_OFFSET_MARGIN 16
+
+//
+// libxml text reader callbacks
+//
+
+static intptr_t XMLCALL ReadValidatedFile(void* context, char* buffer, size_t length)
+{
+	FUFile* file = (FUFile*) context;
+	size_t readCount = fread(buffer, 1, length, file->GetHandle());
+	return (readCount == 0 && ferror(file->GetHandle())) ? -1 : (intptr_t) readCount;
+}
+
+static int XMLCALL CloseValidatedFile(void* /*context*/)
+{
+	// The file is closed by its owner.
+	return 0;
+}
+
+static void XMLCALL OnValidatedFileError(void* arg, const char* /*message*/, xmlParserSeverities severity, xmlTextReaderLocatorPtr /*locator*/)
+{
+	// Keep libxml quiet: the import only reports that the XML is malformed.
+	if (severity == XML_PARSER_SEVERITY_ERROR || severity == XML_PARSER_SEVERITY_VALIDITY_ERROR)
+	{
+		*((bool*) arg) = true;
+	}
+}
+
+//
+// FAXValidator
+//
+
+FAXValidator::FAXValidator(FUError::RecordList& _errors)
+:	errors(_errors), reader(NULL), isMalformed(false)
+,	geometryLine(0), hasGeometryChild(false)
+,	meshLine(0), isMeshSkipped(false), hasVertices(false), verticesLine(0)
+,	hasPositions(false), positionCount(0), vertexSourceCount(0), vertexCount(0), polygonsCount(0)
+,	sourceLine(0), arrayValueCount(0), accessorCount(0), accessorStride(1)
+,	polygonsLine(0), isTriangles(false), isPolylist(false), isLines(false), expectedFaceCount(0)
+,	hasVertexInput(false), hasTessellation(false), hasVertexCounts(false), isPolygonsFailed(false), inputCount(0)
+,	faceCount(0), isIndexReported(false), holedLine(0), hasHoledFace(false), hasHole(false)
+,	valueCount(0), currentValue(0), isInValue(false), isInDigits(false), valuesLine(0)
+{
+}
+
+FAXValidator::~FAXValidator()
+{
+	FUAssert(reader == NULL, xmlFreeTextReader(reader));
+}
+
+bool FAXValidator::Validate(const fchar* filename)
+{
+	size_t firstError = errors.size();
+
+	// Stream the file through the text reader.
+	FUFile file(filename, FUFile::READ);
+	if (file.IsOpen())
+	{
+		reader = xmlReaderForIO(ReadValidatedFile, CloseValidatedFile, &file, NULL, NULL, 0);
+	}
+	if (reader == NULL)
+	{
+		AddError(FUError::ERROR_LEVEL, FUError::ERROR_MALFORMED_XML, 0);
+		return false;
+	}
+	xmlTextReaderSetErrorHandler(reader, OnValidatedFileError, &isMalformed);
+
+	int result;
+	while ((result = xmlTextReaderRead(reader)) == 1 && !isMalformed)
+	{
+		switch (xmlTextReaderNodeType(reader))
+		{
+		case XML_READER_TYPE_ELEMENT: {
+			xmlNode* node = xmlTextReaderCurrentNode(reader);
+			uint32 line = (node != NULL) ? (uint32) node->line : 0;
+			ReadStartElement((const char*) xmlTextReaderConstLocalName(reader), line, xmlTextReaderIsEmptyElement(reader) == 1);
+			break; }
+
+		case XML_READER_TYPE_END_ELEMENT:
+			if (!kinds.empty())
+			{
+				Kind kind = kinds.back();
+				kinds.pop_back();
+				ReadEndElement(kind);
+			}
+			break;
+
+		case XML_READER_TYPE_TEXT:
+		case XML_READER_TYPE_CDATA:
+			ReadText((const char*) xmlTextReaderConstValue(reader));
+			break;
+
+		default: break;
+		}
+	}
+	if (result != 0) isMalformed = true;
+	xmlFreeTextReader(reader);
+	reader = NULL;
+
+	if (isMalformed)
+	{
+		// Like the import, do not report anything past the parsing failure.
+		errors.resize(firstError);
+		AddError(FUError::ERROR_LEVEL, FUError::ERROR_MALFORMED_XML, 0);
+		return false;
+	}
+
+	ResolveUris();
+
+	for (size_t i = firstError; i < errors.size(); ++i)
+	{
+		if (errors[i].level == FUError::ERROR_LEVEL) return false;
+	}
+	AddError(FUError::DEBUG_LEVEL, FUError::DEBUG_LOAD_SUCCESSFUL, 0);
+	return true;
+}
+
+void FAXValidator::ReadStartElement(const char* name, uint32 line, bool isEmpty)
+{
+	Kind kind = OTHER;
+	Kind parent = kinds.empty() ? OTHER : kinds.back();
+	if (kinds.empty()) kind = ROOT;
+	else switch (parent)
+	{
+	case ROOT:
+		if (strncmp(name, "library_", 8) == 0) kind = LIBRARY;
+		else if (IsEquivalent(name, DAE_SCENE_ELEMENT)) kind = SCENE;
+		break;
+
+	case LIBRARY:
+		RegisterEntityId(line);
+		if (IsEquivalent(name, DAE_GEOMETRY_ELEMENT))
+		{
+			kind = GEOMETRY;
+			geometryLine = line;
+			hasGeometryChild = false;
+		}
+		break;
+
+	case SCENE:
+		ReadSceneInstance(name, line);
+		break;
+
+	case GEOMETRY:
+		// Only the first mesh or spline is read in.
+		if (hasGeometryChild) break;
+		if (IsEquivalent(name, DAE_MESH_ELEMENT) || IsEquivalent(name, DAE_CONVEX_MESH_ELEMENT))
+		{
+			hasGeometryChild = true;
+			if (IsEquivalent(name, DAE_CONVEX_MESH_ELEMENT) && !ReadAttribute(DAE_CONVEX_HULL_OF_ATTRIBUTE).empty()) break;
+			kind = MESH;
+			StartMesh(line);
+		}
+		else if (IsEquivalent(name, DAE_SPLINE_ELEMENT)) hasGeometryChild = true;
+		break;
+
+	case MESH:
+		if (isMeshSkipped) break;
+		if (IsEquivalent(name, DAE_SOURCE_ELEMENT))
+		{
+			kind = SOURCE;
+			sourceId = ReadAttribute(DAE_ID_ATTRIBUTE);
+			sourceLine = line;
+			arrayValueCount = accessorCount = 0;
+			accessorStride = 1;
+		}
+		else if (IsEquivalent(name, DAE_VERTICES_ELEMENT))
+		{
+			kind = VERTICES;
+			hasVertices = true;
+			verticesLine = line;
+		}
+		else if (IsEquivalent(name, DAE_POLYGONS_ELEMENT) || IsEquivalent(name, DAE_TRIANGLES_ELEMENT)
+			|| IsEquivalent(name, DAE_POLYLIST_ELEMENT) || IsEquivalent(name, DAE_LINES_ELEMENT)
+			|| IsEquivalent(name, DAE_LINESTRIPS_ELEMENT) || IsEquivalent(name, DAE_TRIFANS_ELEMENT)
+			|| IsEquivalent(name, DAE_TRISTRIPS_ELEMENT) || IsEquivalent(name, DAE_POINTS_ELEMENT))
+		{
+			kind = POLYGONS;
+			StartPolygons(name, line);
+		}
+		break;
+
+	case SOURCE:
+		if (IsEquivalent(name, DAE_FLOAT_ARRAY_ELEMENT))
+		{
+			kind = SOURCE_ARRAY;
+			StartValues(line);
+		}
+		else if (IsEquivalent(name, DAE_TECHNIQUE_COMMON_ELEMENT)) kind = SOURCE_TECHNIQUE;
+		break;
+
+	case SOURCE_TECHNIQUE:
+		if (IsEquivalent(name, DAE_ACCESSOR_ELEMENT))
+		{
+			accessorCount = FUStringConversion::ToUInt32(ReadAttribute(DAE_COUNT_ATTRIBUTE));
+			accessorStride = FUStringConversion::ToUInt32(ReadAttribute(DAE_STRIDE_ATTRIBUTE));
+			if (accessorStride == 0) accessorStride = 1;
+		}
+		break;
+
+	case VERTICES:
+		if (IsEquivalent(name, DAE_INPUT_ELEMENT)) ReadVertexInput(line);
+		break;
+
+	case POLYGONS:
+		if (isPolygonsFailed) break;
+		if (IsEquivalent(name, DAE_INPUT_ELEMENT) && !hasTessellation) ReadPolygonsInput(line);
+		else if (IsEquivalent(name, DAE_EXTRA_ELEMENT)) break;
+		else if (IsEquivalent(name, DAE_POLYGON_ELEMENT))
+		{
+			if (StartTessellation()) { kind = INDICES; StartValues(line); }
+		}
+		else if (IsEquivalent(name, DAE_POLYGONHOLED_ELEMENT))
+		{
+			if (StartTessellation())
+			{
+				kind = POLYGON_HOLED;
+				holedLine = line;
+				hasHoledFace = hasHole = false;
+			}
+		}
+		else if (IsEquivalent(name, DAE_VERTEXCOUNT_ELEMENT))
+		{
+			if (!StartTessellation() || expectedFaceCount == 0) break;
+			if (!isPolylist)
+			{
+				AddError(FUError::ERROR_LEVEL, FUError::ERROR_MISPLACED_VCOUNT, polygonsLine);
+				isPolygonsFailed = true;
+				break;
+			}
+			kind = VERTEX_COUNTS;
+			hasVertexCounts = true;
+			StartValues(line);
+		}
+		else AddError(FUError::WARNING_LEVEL, FUError::WARNING_UNKNOWN_POLYGON_CHILD, line);
+		break;
+
+	case POLYGON_HOLED:
+		if (IsEquivalent(name, DAE_POLYGON_ELEMENT) && !hasHole)
+		{
+			kind = INDICES;
+			hasHoledFace = true;
+			StartValues(line);
+		}
+		else if (IsEquivalent(name, DAE_HOLE_ELEMENT) || hasHole)
+		{
+			kind = HOLE_INDICES;
+			hasHole = true;
+			StartValues(line);
+		}
+		else AddError(FUError::ERROR_LEVEL, FUError::ERROR_UNKNOWN_PH_ELEMENT, holedLine);
+		break;
+
+	default: break;
+	}
+
+	// The scene nodes and the entity instances may appear at any depth.
+	if (parent != LIBRARY && IsEquivalent(name, DAE_NODE_ELEMENT)) RegisterEntityId(line);
+	else if (IsEquivalent(name, DAE_INSTANCE_GEOMETRY_ELEMENT) || IsEquivalent(name, DAE_INSTANCE_CONTROLLER_ELEMENT)
+		|| IsEquivalent(name, DAE_INSTANCE_CAMERA_ELEMENT) || IsEquivalent(name, DAE_INSTANCE_LIGHT_ELEMENT)
+		|| IsEquivalent(name, DAE_INSTANCE_NODE_ELEMENT))
+	{
+		ReadInstanceUri(line);
+	}
+
+	if (!isEmpty) kinds.push_back(kind);
+	else ReadEndElement(kind);
+}
+
+void FAXValidator::ReadEndElement(Kind kind)
+{
+	switch (kind)
+	{
+	case GEOMETRY:
+		if (!hasGeometryChild) AddError(FUError::WARNING_LEVEL, FUError::WARNING_EMPTY_GEOMETRY, geometryLine);
+		break;
+
+	case MESH: EndMesh(); break;
+	case SOURCE: EndSource(); break;
+
+	case VERTICES:
+		if (isMeshSkipped) break;
+		if (!hasPositions) AddError(FUError::WARNING_LEVEL, FUError::WARNING_VP_INPUT_NODE_MISSING, verticesLine);
+		if (vertexSourceCount == 0) AddError(FUError::WARNING_LEVEL, FUError::WARNING_GEOMETRY_VERTICES_MISSING, verticesLine);
+		break;
+
+	case POLYGONS: EndPolygons(); break;
+
+	case POLYGON_HOLED:
+		if (hasHoledFace) ++faceCount;
+		break;
+
+	case SOURCE_ARRAY:
+	case INDICES:
+	case HOLE_INDICES:
+	case VERTEX_COUNTS:
+		EndValues(kind);
+		break;
+
+	default: break;
+	}
+}
+
+//
+// Meshes
+//
+
+void FAXValidator::StartMesh(uint32 line)
+{
+	meshSources.clear();
+	meshLine = line;
+	isMeshSkipped = hasVertices = hasPositions = false;
+	positionCount = vertexSourceCount = vertexCount = 0;
+	polygonsCount = 0;
+}
+
+void FAXValidator::EndMesh()
+{
+	if (isMeshSkipped) return;
+	if (!hasVertices)
+	{
+		AddError(FUError::WARNING_LEVEL, FUError::WARNING_MESH_VERTICES_MISSING, meshLine);
+	}
+	if (polygonsCount == 0)
+	{
+		AddError(FUError::WARNING_LEVEL, FUError::WARNING_MESH_TESSELLATION_MISSING, meshLine);
+	}
+}
+
+void FAXValidator::EndSource()
+{
+	if (sourceId.empty())
+	{
+		AddError(FUError::WARNING_LEVEL, FUError::WARNING_INVALID_GEOMETRY_SOURCE_ID, sourceLine);
+	}
+	else if (objectIds.find(sourceId) != objectIds.end())
+	{
+		AddError(FUError::ERROR_LEVEL, FUError::ERROR_DUPLICATE_ID, sourceLine);
+	}
+	else objectIds.insert(sourceId, sourceLine);
+
+	// The import keeps the values found in the array, whatever the accessor count.
+	if ((uint64) accessorCount * accessorStride > arrayValueCount)
+	{
+		AddError(FUError::WARNING_LEVEL, FUError::WARNING_INVALID_ACCESSOR_COUNT, sourceLine);
+	}
+	if (meshSources.find(sourceId) == meshSources.end())
+	{
+		meshSources.insert(sourceId, arrayValueCount / accessorStride);
+	}
+}
+
+void FAXValidator::ReadVertexInput(uint32 line)
+{
+	if (isMeshSkipped) return;
+	FUDaeGeometryInput::Semantic semantic = FUDaeGeometryInput::FromString(ReadAttribute(DAE_SEMANTIC_ATTRIBUTE).c_str());
+	if (semantic == FUDaeGeometryInput::VERTEX) return;
+
+	IdMap::iterator it = meshSources.find(SkipPound(ReadAttribute(DAE_SOURCE_ATTRIBUTE)));
+	if (it == meshSources.end())
+	{
+		// The import gives up on the mesh.
+		AddError(FUError::ERROR_LEVEL, FUError::ERROR_UNKNOWN_MESH_ID, line);
+		isMeshSkipped = true;
+		return;
+	}
+
+	uint32 count = it->second;
+	vertexCount = (vertexSourceCount == 0) ? count : min(vertexCount, count);
+	++vertexSourceCount;
+	if (semantic == FUDaeGeometryInput::POSITION)
+	{
+		hasPositions = true;
+		positionCount = count;
+	}
+}
+
+//
+// Polygons sets
+//
+
+void FAXValidator::StartPolygons(const char* name, uint32 line)
+{
+	++polygonsCount;
+	polygonsLine = line;
+	isTriangles = IsEquivalent(name, DAE_TRIANGLES_ELEMENT);
+	isPolylist = IsEquivalent(name, DAE_POLYLIST_ELEMENT);
+	isLines = IsEquivalent(name, DAE_LINES_ELEMENT);
+	expectedFaceCount = FUStringConversion::ToUInt32(ReadAttribute(DAE_COUNT_ATTRIBUTE));
+	hasVertexInput = hasTessellation = hasVertexCounts = isPolygonsFailed = false;
+	inputCount = 0;
+	indexBounds.clear();
+	faceCount = 0;
+	isIndexReported = false;
+
+	if (ReadAttribute(DAE_MATERIAL_ATTRIBUTE).empty())
+	{
+		AddError(FUError::WARNING_LEVEL, FUError::WARNING_INVALID_POLYGON_MAT_SYMBOL, line);
+	}
+}
+
+void FAXValidator::ReadPolygonsInput(uint32 line)
+{
+	fm::string offsetString = ReadAttribute(DAE_OFFSET_ATTRIBUTE);
+	uint32 offset = (!offsetString.empty()) ? FUStringConversion::ToUInt32(offsetString) : (uint32) (indexBounds.size() + 1);
+	if (offset > ++inputCount + MAX_INPUT_OFFSET_MARGIN)
+	{
+		// Don't allocate bounds for a huge offset: the indices of these polygons cannot be checked.
+		if (!isPolygonsFailed) AddError(FUError::ERROR_LEVEL, FUError::ERROR_INVALID_INPUT_OFFSET, line);
+		isPolygonsFailed = true;
+		return;
+	}
+	if (offset >= indexBounds.size()) indexBounds.resize(offset + 1, NO_INDEX_BOUND);
+
+	FUDaeGeometryInput::Semantic semantic = FUDaeGeometryInput::FromString(ReadAttribute(DAE_SEMANTIC_ATTRIBUTE).c_str());
+	if (semantic == FUDaeGeometryInput::UNKNOWN) return;
+	else if (semantic == FUDaeGeometryInput::VERTEX)
+	{
+		if (hasVertexInput)
+		{
+			AddError(FUError::WARNING_LEVEL, FUError::WARNING_EXTRA_VERTEX_INPUT, line);
+			return;
+		}
+		hasVertexInput = true;
+		if (vertexSourceCount > 0) indexBounds[offset] = min(indexBounds[offset], vertexCount);
+	}
+	else
+	{
+		// The inputs that share an offset share their indices.
+		IdMap::iterator it = meshSources.find(SkipPound(ReadAttribute(DAE_SOURCE_ATTRIBUTE)));
+		if (it != meshSources.end()) indexBounds[offset] = min(indexBounds[offset], it->second);
+		else AddError(FUError::WARNING_LEVEL, FUError::WARNING_UNKNOWN_POLYGONS_INPUT, line);
+	}
+}
+
+bool FAXValidator::StartTessellation()
+{
+	if (!hasTessellation)
+	{
+		// Verify the inputs, as the import does before reading the indices.
+		hasTessellation = true;
+		if (expectedFaceCount == 0)
+		{
+			AddError(FUError::WARNING_LEVEL, FUError::WARNING_EMPTY_POLYGONS, polygonsLine);
+		}
+		if (!hasVertexInput && !isPolygonsFailed)
+		{
+			AddError(FUError::ERROR_LEVEL, FUError::ERROR_NO_VERTEX_INPUT, polygonsLine);
+			isPolygonsFailed = true;
+		}
+	}
+	return !isPolygonsFailed;
+}
+
+void FAXValidator::EndPolygons()
+{
+	if (!hasTessellation)
+	{
+		if (expectedFaceCount == 0)
+		{
+			AddError(FUError::WARNING_LEVEL, FUError::WARNING_EMPTY_POLYGONS, polygonsLine);
+		}
+		AddError(FUError::ERROR_LEVEL, FUError::WARNING_NO_POLYGON, polygonsLine);
+		return;
+	}
+	if (isPolygonsFailed) return;
+
+	if (isPolylist && expectedFaceCount != 0 && !hasVertexCounts)
+	{
+		AddError(FUError::ERROR_LEVEL, FUError::ERROR_NO_VCOUNT, polygonsLine);
+	}
+	else if (faceCount != expectedFaceCount)
+	{
+		AddError(FUError::ERROR_LEVEL, FUError::ERROR_INVALID_FACE_COUNT, polygonsLine);
+	}
+}
+
+//
+// Lists of values
+//
+
+void FAXValidator::StartValues(uint32 line)
+{
+	valueCount = 0;
+	isInValue = false;
+	valuesLine = line;
+}
+
+void FAXValidator::ReadText(const char* text)
+{
+	Kind kind = kinds.empty() ? OTHER : kinds.back();
+	if (kind != SOURCE_ARRAY && kind != INDICES && kind != HOLE_INDICES && kind != VERTEX_COUNTS) return;
+
+	// A value may be split across text nodes: parse it as FUStringConversion::ToUInt32 does.
+	for (const char* c = text; *c != 0; ++c)
+	{
+		char character = *c;
+		if (character == ' ' || character == '\t' || character == '\r' || character == '\n')
+		{
+			if (isInValue) ReadValue(kind);
+		}
+		else
+		{
+			if (!isInValue)
+			{
+				isInValue = isInDigits = true;
+				currentValue = 0;
+			}
+			if (isInDigits)
+			{
+				if (character >= '0' && character <= '9') currentValue = currentValue * 10 + (character - '0');
+				else isInDigits = false;
+			}
+		}
+	}
+}
+
+void FAXValidator::ReadValue(Kind kind)
+{
+	isInValue = false;
+	if (kind == INDICES || kind == HOLE_INDICES)
+	{
+		uint32 bound = indexBounds[valueCount % indexBounds.size()];
+		if (bound != NO_INDEX_BOUND && currentValue >= bound && !isIndexReported)
+		{
+			AddError(FUError::ERROR_LEVEL, FUError::ERROR_INVALID_POLYGON_INDEX, valuesLine);
+			isIndexReported = true;
+		}
+	}
+	else if (kind == VERTEX_COUNTS)
+	{
+		if (hasPositions && currentValue > positionCount && !isPolygonsFailed)
+		{
+			AddError(FUError::ERROR_LEVEL, FUError::ERROR_INVALID_FACE_COUNT, valuesLine);
+			isPolygonsFailed = true;
+		}
+	}
+	++valueCount;
+}
+
+void FAXValidator::EndValues(Kind kind)
+{
+	if (isInValue) ReadValue(kind);
+
+	switch (kind)
+	{
+	case SOURCE_ARRAY:
+		arrayValueCount = (uint32) valueCount;
+		break;
+
+	case INDICES:
+		// Count the faces as the import does, from the complete vertices.
+		if (kinds.back() == POLYGON_HOLED) break;
+		else if (isTriangles) faceCount += valueCount / indexBounds.size() / 3;
+		else if (isLines) faceCount += valueCount / indexBounds.size() / 2;
+		else if (!isPolylist) ++faceCount;
+		break;
+
+	case VERTEX_COUNTS:
+		faceCount += valueCount;
+		break;
+
+	default: break;
+	}
+}
+
+//
+// URIs
+//
+
+void FAXValidator::ReadInstanceUri(uint32 line)
+{
+	// Only the local URIs are resolved: the external references are loaded on demand.
+	fm::string url = ReadAttribute(DAE_URL_ATTRIBUTE);
+	if (!url.empty() && url[0] != '#') return;
+
+	PendingUri uri;
+	uri.id = SkipPound(url);
+	uri.level = FUError::WARNING_LEVEL;
+	uri.code = FUError::WARNING_INST_ENTITY_MISSING;
+	uri.line = line;
+	pendingUris.push_back(uri);
+}
+
+void FAXValidator::ReadSceneInstance(const char* name, uint32 line)
+{
+	if (!IsEquivalent(name, DAE_INSTANCE_VSCENE_ELEMENT) && !IsEquivalent(name, DAE_INSTANCE_PHYSICS_SCENE_ELEMENT))
+	{
+		AddError(FUError::WARNING_LEVEL, FUError::ERROR_INVALID_ELEMENT, line);
+		return;
+	}
+
+	fm::string url = ReadAttribute(DAE_URL_ATTRIBUTE);
+	size_t poundIndex = url.find('#');
+	if (poundIndex == fm::string::npos || poundIndex + 1 == url.length())
+	{
+		AddError(FUError::ERROR_LEVEL, FUError::ERROR_INVALID_URI, line);
+	}
+	else if (poundIndex == 0)
+	{
+		PendingUri uri;
+		uri.id = url.substr(1);
+		uri.level = FUError::WARNING_LEVEL;
+		uri.code = FUError::WARNING_MISSING_URI_TARGET;
+		uri.line = line;
+		pendingUris.push_back(uri);
+	}
+}
+
+void FAXValidator::ResolveUris()
+{
+	for (PendingUriList::iterator it = pendingUris.begin(); it != pendingUris.end(); ++it)
+	{
+		if (entityIds.find((*it).id) == entityIds.end()) AddError((*it).level, (*it).code, (*it).line);
+	}
+	pendingUris.clear();
+}
+
+//
+// Utilities
+//
+
+void FAXValidator::RegisterEntityId(uint32 line)
+{
+	fm::string id = ReadAttribute(DAE_ID_ATTRIBUTE);
+	if (id.empty()) return;
+	entityIds.insert(id, line);
+	if (objectIds.find(id) == objectIds.end()) objectIds.insert(id, line);
+}
+
+fm::string FAXValidator::ReadAttribute(const char* name)
+{
+	xmlChar* value = xmlTextReaderGetAttribute(reader, (const xmlChar*) name);
+	if (value == NULL) return fm::string();
+	fm::string attribute((const char*) value);
+	xmlFree(value);
+	return attribute;
+}
+
+void FAXValidator::AddError(FUError::Level level, uint32 code, uint32 line)
+{
+	FUError::Record record = { level, code, line };
+	errors.push_back(record);
+}
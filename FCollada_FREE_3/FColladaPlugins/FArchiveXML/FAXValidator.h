@@ -0,0 +1,158 @@
+/*
+	Copyright (C) 2005-2007 Feeling Software Inc.
+	Portions of the code are:
+	Copyright (C) 2005-2007 Sony Computer Entertainment America
+
+	MIT License: http://www.opensource.org/licenses/mit-license.php
+*/
+
+/**
+	@file FAXValidator.h
+	This file contains the FAXValidator class.
+*/
+
+#ifndef _FAX_VALIDATOR_H_
+#define _FAX_VALIDATOR_H_
+
+#ifdef HAS_LIBXML
+
+struct _xmlTextReader;
+
+/**
+	A validator for COLLADA files, that reads them without building
+	the FCDocument objects.
+
+	The file is streamed through the libxml text reader, so only the
+	element being read and its ancestors are held in memory.
+	The checks mirror the ones of the import and the errors found are
+	recorded with the codes that the import would log: the well-formedness,
+	the scene and instance URIs, the geometry source ids and the structure
+	of the mesh polygons sets. On top of these, the accessor counts are checked
+	against the array counts and the polygon indices against the source counts,
+	which the import silently tolerates.
+
+	The URIs are resolved once the whole file is read: they may refer forward.
+
+	@ingroup FColladaPlugins
+*/
+class FAXValidator
+{
+private:
+	// The kinds of the elements being read.
+	enum Kind
+	{
+		OTHER, ROOT, LIBRARY, SCENE, GEOMETRY, MESH, SOURCE, SOURCE_ARRAY, SOURCE_TECHNIQUE,
+		VERTICES, POLYGONS, POLYGON_HOLED, INDICES, HOLE_INDICES, VERTEX_COUNTS
+	};
+	typedef fm::vector<Kind> KindList;
+	typedef fm::map<fm::string, uint32> IdMap;
+
+	// A URI to resolve once the whole file is read.
+	struct PendingUri
+	{
+		fm::string id;
+		FUError::Level level;
+		uint32 code;
+		uint32 line;
+	};
+	typedef fm::vector<PendingUri, false> PendingUriList;
+
+	FUError::RecordList& errors;
+	struct _xmlTextReader* reader;
+	bool isMalformed;
+	KindList kinds;
+
+	IdMap entityIds;
+	IdMap objectIds;
+	PendingUriList pendingUris;
+
+	// The geometry being read.
+	uint32 geometryLine;
+	bool hasGeometryChild;
+
+	// The mesh being read: the value counts of its sources.
+	IdMap meshSources;
+	uint32 meshLine;
+	bool isMeshSkipped;
+	bool hasVertices;
+	uint32 verticesLine;
+	bool hasPositions;
+	uint32 positionCount;
+	uint32 vertexSourceCount;
+	uint32 vertexCount;
+	size_t polygonsCount;
+
+	// The geometry source being read.
+	fm::string sourceId;
+	uint32 sourceLine;
+	uint32 arrayValueCount;
+	uint32 accessorCount;
+	uint32 accessorStride;
+
+	// The polygons set being read: the index bounds of its offsets.
+	uint32 polygonsLine;
+	bool isTriangles;
+	bool isPolylist;
+	bool isLines;
+	uint32 expectedFaceCount;
+	bool hasVertexInput;
+	bool hasTessellation;
+	bool hasVertexCounts;
+	bool isPolygonsFailed;
+	uint32 inputCount;
+	UInt32List indexBounds;
+	size_t faceCount;
+	bool isIndexReported;
+	uint32 holedLine;
+	bool hasHoledFace;
+	bool hasHole;
+
+	// The list of values being read, across text nodes.
+	size_t valueCount;
+	uint32 currentValue;
+	bool isInValue;
+	bool isInDigits;
+	uint32 valuesLine;
+
+public:
+	/** Constructor.
+		@param errors The list to fill in with the errors found. */
+	FAXValidator(FUError::RecordList& errors);
+
+	/** Destructor. */
+	~FAXValidator();
+
+	/** Validates a COLLADA file.
+		@param filename The absolute filename of the COLLADA file.
+		@return Whether no error, as opposed to warnings, was found. */
+	bool Validate(const fchar* filename);
+
+private:
+	void ReadStartElement(const char* name, uint32 line, bool isEmpty);
+	void ReadEndElement(Kind kind);
+	void ReadText(const char* text);
+
+	void StartMesh(uint32 line);
+	void EndMesh();
+	void EndSource();
+	void ReadVertexInput(uint32 line);
+	void StartPolygons(const char* name, uint32 line);
+	void ReadPolygonsInput(uint32 line);
+	bool StartTessellation();
+	void EndPolygons();
+	void StartValues(uint32 line);
+	void ReadValue(Kind kind);
+	void EndValues(Kind kind);
+
+	void ReadInstanceUri(uint32 line);
+	void ReadSceneInstance(const char* name, uint32 line);
+	void ResolveUris();
+
+	void RegisterEntityId(uint32 line);
+	fm::string ReadAttribute(const char* name);
+	void AddError(FUError::Level level, uint32 code, uint32 line);
+};
+
+#endif // HAS_LIBXML
+
+#endif // _FAX_VALIDATOR_H_
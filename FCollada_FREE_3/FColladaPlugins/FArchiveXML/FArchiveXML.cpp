@@ -76,6 +76,9 @@
 #include "FCDocument/FCDLibrary.h"
 #include "FCDocument/FCDVersion.h"
 #include "FUtils/FUXmlDocument.h"
+#include "FUtils/FUThread.h"
+#include "FAXSnapshot.h"
+#include "FAXValidator.h"
 
 
 //
@@ -89,11 +92,29 @@ static const char* kArchivePluginExtensions[NUM_EXTENSIONS] = { "dae", "xml" };
 //
 
 ImplementObjectType(FArchiveXML)
-XMLLoadFuncMap FArchiveXML::xmlLoadFuncs;
-XMLWriteFuncMap FArchiveXML::xmlWriteFuncs;
+XMLLoadFuncTable FArchiveXML::xmlLoadFuncs;
+XMLWriteFuncTable FArchiveXML::xmlWriteFuncs;
 
 DocumentLinkDataMap FArchiveXML::documentLinkDataMap;
-int FArchiveXML::loadedDocumentCount = 0;
+uint32 FArchiveXML::loadedDocumentCount = 0;
+FUCriticalSection FArchiveXML::linkDataCriticalSection;
+FUCriticalSection FArchiveXML::registrationCriticalSection;
+
+// Retains the link data of a document for the duration of an import or export.
+class FAXLinkDataScope
+{
+private:
+	const FCDocument* document;
+
+public:
+	FAXLinkDataScope(const FCDocument* _document) : document(_document) { FArchiveXML::AcquireLinkData(document); }
+	~FAXLinkDataScope() { FArchiveXML::ReleaseLinkData(document); }
+};
+
+FCDocumentLinkData::~FCDocumentLinkData()
+{
+	SAFE_DELETE(snapshot);
+}
 
 FArchiveXML::FArchiveXML(void)
 {
@@ -102,8 +123,10 @@ FArchiveXML::FArchiveXML(void)
 
 FArchiveXML::~FArchiveXML(void)
 {
-	xmlLoadFuncs.clear();
-	xmlWriteFuncs.clear();
+	// The dispatch tables are left untouched: they are shared by all the
+	// instances of this plug-in and are read without locking while loading.
+	ClearIntermediateData();
+	xmlCleanupParser();
 }
 
 bool FArchiveXML::AddExtraExtension(const char* ext)
@@ -164,6 +187,9 @@ const char* FArchiveXML::GetSupportedExtensionAt(int index)
 
 void FArchiveXML::Initialize()
 {
+	// Parsing may then safely start on several threads.
+	xmlInitParser();
+
 	if (xmlLoadFuncs.empty())
 	{
 		xmlLoadFuncs.insert(&FCDObject::GetClassType(), FArchiveXML::LoadObject);
@@ -371,7 +397,69 @@ void FArchiveXML::Initialize()
 
 void FArchiveXML::ClearIntermediateData()
 {
-	FArchiveXML::documentLinkDataMap.clear();
+	linkDataCriticalSection.Enter();
+	for (DocumentLinkDataMap::iterator it = documentLinkDataMap.begin(); it != documentLinkDataMap.end(); ++it)
+	{
+		SAFE_DELETE(it->second);
+	}
+	documentLinkDataMap.clear();
+	loadedDocumentCount = 0;
+	linkDataCriticalSection.Leave();
+}
+
+FCDocumentLinkData& FArchiveXML::GetLinkData(const FCDocument* document)
+{
+	linkDataCriticalSection.Enter();
+	DocumentLinkDataMap::iterator it = documentLinkDataMap.find(document);
+	if (it == documentLinkDataMap.end())
+	{
+		it = documentLinkDataMap.insert(document, new FCDocumentLinkData());
+	}
+	FCDocumentLinkData* linkData = it->second;
+	linkDataCriticalSection.Leave();
+	return *linkData;
+}
+
+void FArchiveXML::AcquireLinkData(const FCDocument* document)
+{
+	linkDataCriticalSection.Enter();
+	if (loadedDocumentCount == 0)
+	{
+		// Nothing is in flight: drop the data left behind by partial imports/exports.
+		for (DocumentLinkDataMap::iterator it = documentLinkDataMap.begin(); it != documentLinkDataMap.end(); ++it)
+		{
+			SAFE_DELETE(it->second);
+		}
+		documentLinkDataMap.clear();
+	}
+
+	DocumentLinkDataMap::iterator it = documentLinkDataMap.find(document);
+	if (it == documentLinkDataMap.end())
+	{
+		it = documentLinkDataMap.insert(document, new FCDocumentLinkData());
+	}
+	else if (it->second->referenceCount == 0)
+	{
+		SAFE_DELETE(it->second);
+		it->second = new FCDocumentLinkData();
+	}
+	++(it->second->referenceCount);
+	++loadedDocumentCount;
+	linkDataCriticalSection.Leave();
+}
+
+void FArchiveXML::ReleaseLinkData(const FCDocument* document)
+{
+	linkDataCriticalSection.Enter();
+	DocumentLinkDataMap::iterator it = documentLinkDataMap.find(document);
+	FUAssert(it != documentLinkDataMap.end() && it->second->referenceCount > 0, linkDataCriticalSection.Leave(); return);
+	if (--(it->second->referenceCount) == 0)
+	{
+		SAFE_DELETE(it->second);
+		documentLinkDataMap.erase(it);
+	}
+	--loadedDocumentCount;
+	linkDataCriticalSection.Leave();
 }
 
 bool FArchiveXML::ImportFile(const fchar* filePath, FCDocument* fcdocument)
@@ -382,25 +470,43 @@ bool FArchiveXML::ImportFile(const fchar* filePath, FCDocument* fcdocument)
 
 	_FTRY
 	{
-		// Parse the document into a XML tree
-		FUXmlDocument daeDocument(fcdocument->GetFileManager(), fcdocument->GetFileUrl(), true);
-		xmlNode* rootNode = daeDocument.GetRootNode();
-		if (rootNode != NULL)
+		// The snapshot is owned by the link data of the document,
+		// which the lazily loaded libraries retain past the import.
+		FAXLinkDataScope linkDataScope(fcdocument);
+		FAXSnapshot* snapshot = NULL;
+		if (fcdocument->GetLoadOptions().IsSnapshotCacheEnabled())
 		{
-			//fcdocument->GetFileManager()->PushRootFile(filePath);
-			// Read in the whole document from the root node
-			status &= (Import(fcdocument, rootNode));
-			//fcdocument->GetFileManager()->PopRootFile();
+			snapshot = new FAXSnapshot(fcdocument->GetFileUrl());
+			GetLinkData(fcdocument).snapshot = snapshot;
 		}
-		else
+
+		if (snapshot != NULL && snapshot->Open())
 		{
-			status = false;
-    		FUError::Error(FUError::ERROR_LEVEL, FUError::ERROR_MALFORMED_XML);
+			// Read in the whole document from the XML tree restored from the snapshot
+			FUError::Error(FUError::DEBUG_LEVEL, FUError::DEBUG_LOAD_FROM_SNAPSHOT);
+			status &= (Import(fcdocument, snapshot->GetRootNode()));
+			snapshot->ReleaseXmlDocument();
 		}
+		else
+		{
+			// Parse the document into a XML tree
+			FUXmlDocument daeDocument(fcdocument->GetFileManager(), fcdocument->GetFileUrl(), true);
+			xmlNode* rootNode = daeDocument.GetRootNode();
+			if (rootNode != NULL)
+			{
+				if (snapshot != NULL) snapshot->Write(rootNode);
 
-		// Clean-up the XML reader
-		xmlCleanupParser();
-		FArchiveXML::ClearIntermediateData();
+				//fcdocument->GetFileManager()->PushRootFile(filePath);
+				// Read in the whole document from the root node
+				status &= (Import(fcdocument, rootNode));
+				//fcdocument->GetFileManager()->PopRootFile();
+			}
+			else
+			{
+				status = false;
+    			FUError::Error(FUError::ERROR_LEVEL, FUError::ERROR_MALFORMED_XML);
+			}
+		}
 	}
 	_FCATCH_ALL
 	{
@@ -440,10 +546,6 @@ bool FArchiveXML::ImportFileFromMemory(const fchar* filePath, FCDocument* fcdocu
 			status = false;
 			FUError::Error(FUError::ERROR_LEVEL, FUError::ERROR_MALFORMED_XML);
 		}
-
-		// Clean-up the XML reader
-		xmlCleanupParser();
-		FArchiveXML::ClearIntermediateData();
     }
     _FCATCH_ALL
     {
@@ -455,6 +557,24 @@ bool FArchiveXML::ImportFileFromMemory(const fchar* filePath, FCDocument* fcdocu
 	return status;	
 }
 
+bool FArchiveXML::ValidateFile(const fchar* filePath, FUError::RecordList& errors)
+{
+	bool status = false;
+
+	_FTRY
+	{
+		// Stream the file: neither the XML tree nor the document are built.
+		FAXValidator validator(errors);
+		status = validator.Validate(filePath);
+	}
+	_FCATCH_ALL
+	{
+		FUError::Record record = { FUError::ERROR_LEVEL, FUError::ERROR_PARSING_FAILED, 0 };
+		errors.push_back(record);
+	}
+	return status;
+}
+
 bool FArchiveXML::ExportFile(FCDocument* fcdocument, const fchar* filePath)
 {
 	bool status = true;
@@ -465,6 +585,7 @@ bool FArchiveXML::ExportFile(FCDocument* fcdocument, const fchar* filePath)
 	{
 		// Create a new XML document
 		FUXmlDocument daeDocument(NULL, filePath, false);
+		daeDocument.SetStreaming(FCollada::GetStreamingSaveFlag());
 		xmlNode* rootNode = daeDocument.CreateRootNode(DAE_COLLADA_ELEMENT);
 		status = ExportDocument(fcdocument, rootNode);
 		if (status)
@@ -539,11 +660,9 @@ bool FArchiveXML::EndExport(const fchar* UNUSED(filePath))
 
 bool FArchiveXML::ImportObject(FCDObject* object, const fm::vector<uint8>& data)
 {
+	FAXLinkDataScope linkDataScope(object->GetDocument());
 	FUXmlDocument loadDocument((const char*) data.begin(), data.size());
-	bool retVal = LoadSwitch(object, &object->GetObjectType(), loadDocument.GetRootNode());
-	if (FArchiveXML::loadedDocumentCount == 0)
-		FArchiveXML::ClearIntermediateData();
-	return retVal;
+	return LoadSwitch(object, &object->GetObjectType(), loadDocument.GetRootNode());
 }
 
 // Structure and enumeration used to order the libraries
@@ -551,13 +670,523 @@ enum nodeOrder { ANIMATION=0, ANIMATION_CLIP, IMAGE, EFFECT, MATERIAL, GEOMETRY,
 struct xmlOrderedNode { xmlNode* node; nodeOrder order; };
 typedef fm::vector<xmlOrderedNode> xmlOrderedNodeList;
 
+// The load options library of each ordered library node
+static const FCDLoadOptions::Library orderLibraries[UNKNOWN] = { FCDLoadOptions::ANIMATION, FCDLoadOptions::ANIMATION_CLIP, FCDLoadOptions::IMAGE,
+	FCDLoadOptions::EFFECT, FCDLoadOptions::MATERIAL, FCDLoadOptions::GEOMETRY, FCDLoadOptions::CONTROLLER, FCDLoadOptions::CAMERA,
+	FCDLoadOptions::LIGHT, FCDLoadOptions::FORCE_FIELD, FCDLoadOptions::EMITTER, FCDLoadOptions::VISUAL_SCENE,
+	FCDLoadOptions::PHYSICS_MATERIAL, FCDLoadOptions::PHYSICS_MODEL, FCDLoadOptions::PHYSICS_SCENE };
+
+static FCDLoadOptions::Mode GetLoadMode(const FCDocument* document, nodeOrder order)
+{
+	// The other libraries link to the animation channels while they are read.
+	if (order == ANIMATION || order == UNKNOWN) return FCDLoadOptions::EAGER;
+	return document->GetLoadOptions().GetMode(orderLibraries[order]);
+}
+
+static bool LoadLibraryNode(FCDocument* theDocument, nodeOrder order, xmlNode* node)
+{
+	bool status = true;
+	switch (order)
+	{
+	case ANIMATION: status &= (FArchiveXML::LoadAnimationLibrary(theDocument->GetAnimationLibrary(), node)); break;
+	case ANIMATION_CLIP: status &= (FArchiveXML::LoadAnimationClipLibrary(theDocument->GetAnimationClipLibrary(), node)); break;
+	case CAMERA: status &= (FArchiveXML::LoadCameraLibrary(theDocument->GetCameraLibrary(), node)); break;
+	case CONTROLLER: status &= (FArchiveXML::LoadControllerLibrary(theDocument->GetControllerLibrary(), node)); break;
+	case EFFECT: status &= (FArchiveXML::LoadEffectLibrary(theDocument->GetEffectLibrary(), node)); break;
+	case EMITTER: status &= (FArchiveXML::LoadEmitterLibrary(theDocument->GetEmitterLibrary(), node)); break;
+	case FORCE_FIELD: status &= (FArchiveXML::LoadForceFieldLibrary(theDocument->GetForceFieldLibrary(), node)); break;
+	case GEOMETRY: status &= (FArchiveXML::LoadGeometryLibrary(theDocument->GetGeometryLibrary(), node)); break;
+	case IMAGE: status &= (FArchiveXML::LoadImageLibrary(theDocument->GetImageLibrary(), node)); break;
+	case LIGHT: status &= (FArchiveXML::LoadLightLibrary(theDocument->GetLightLibrary(), node)); break;
+	case MATERIAL: status &= (FArchiveXML::LoadMaterialLibrary(theDocument->GetMaterialLibrary(), node)); break;
+	case PHYSICS_MODEL: 
+		{
+			status &= (FArchiveXML::LoadPhysicsModelLibrary(theDocument->GetPhysicsModelLibrary(), node)); 
+			size_t physicsModelCount = theDocument->GetPhysicsModelLibrary()->GetEntityCount();
+			for (size_t physicsModelCounter = 0; physicsModelCounter < physicsModelCount; physicsModelCounter++)
+			{
+				FCDPhysicsModel* model = theDocument->GetPhysicsModelLibrary()->GetEntity(physicsModelCounter);
+				status &= FArchiveXML::AttachModelInstancesFCDPhysicsModel(model);
+			}
+			break;
+		}
+	case PHYSICS_MATERIAL: status &= (FArchiveXML::LoadPhysicsMaterialLibrary(theDocument->GetPhysicsMaterialLibrary(), node)); break;
+	case PHYSICS_SCENE: status &= (FArchiveXML::LoadPhysicsSceneLibrary(theDocument->GetPhysicsSceneLibrary(), node)); break;
+	case VISUAL_SCENE: status &= (FArchiveXML::LoadVisualSceneNodeLibrary(theDocument->GetVisualSceneLibrary(), node)); break;
+	case UNKNOWN: default: break;
+	}
+	return status;
+}
+
+// Collects the ids of the geometries and controllers that an entity node depends on.
+static void ReadEntityNodeDependencies(xmlNode* entityNode, StringList& ids)
+{
+	// Skin and morph controllers deform a geometry, or another controller.
+	xmlNode* deformerNode = FindChildByType(entityNode, DAE_CONTROLLER_SKIN_ELEMENT);
+	if (deformerNode == NULL) deformerNode = FindChildByType(entityNode, DAE_CONTROLLER_MORPH_ELEMENT);
+	if (deformerNode != NULL)
+	{
+		ids.push_back(TO_STRING(ReadNodeUrl(deformerNode, DAE_SOURCE_ATTRIBUTE).GetFragment()));
+
+		// The morph targets are geometries as well.
+		xmlNode* targetsNode = FindChildByType(deformerNode, DAE_TARGETS_ELEMENT);
+		xmlNodeList inputNodes;
+		if (targetsNode != NULL) FindChildrenByType(targetsNode, DAE_INPUT_ELEMENT, inputNodes);
+		for (xmlNodeList::iterator it = inputNodes.begin(); it != inputNodes.end(); ++it)
+		{
+			fm::string semantic = ReadNodeSemantic(*it);
+			if (semantic != DAE_TARGET_MORPH_INPUT && semantic != DAE_TARGET_MORPH_INPUT_DEPRECATED) continue;
+
+			StringList targetIds;
+			ReadSource(FindChildById(deformerNode, ReadNodeSource(*it)), targetIds);
+			for (StringList::iterator itT = targetIds.begin(); itT != targetIds.end(); ++itT) ids.push_back(*itT);
+		}
+	}
+
+	// Convex meshes may be built from the vertices of another geometry.
+	xmlNode* convexNode = FindChildByType(entityNode, DAE_CONVEX_MESH_ELEMENT);
+	if (convexNode != NULL)
+	{
+		ids.push_back(TO_STRING(ReadNodeUrl(convexNode, DAE_CONVEX_HULL_OF_ATTRIBUTE).GetFragment()));
+	}
+}
+
+// Marks the geometry and controller nodes that none of the requested entities need.
+static void SkipUnrequestedEntities(const FCDLoadOptions& options, const xmlOrderedNodeList& libraryNodes, FAXNodeSet& skippedNodes)
+{
+	// The requested entities are matched on their cleaned-up name, which defaults to their id.
+	fm::map<fm::string, xmlNode*> entityNodes;
+	xmlNodeList pendingNodes;
+	for (size_t i = 0; i < libraryNodes.size(); ++i)
+	{
+		const xmlOrderedNode& n = libraryNodes[i];
+		if (n.order != GEOMETRY && n.order != CONTROLLER) continue;
+
+		for (xmlNode* child = n.node->children; child != NULL; child = child->next)
+		{
+			if (child->type != XML_ELEMENT_NODE || IsEquivalent(child->name, DAE_ASSET_ELEMENT) || IsEquivalent(child->name, DAE_EXTRA_ELEMENT)) continue;
+
+			fm::string id = ReadNodeId(child);
+			fm::string name = ReadNodeName(child);
+			if (name.empty()) name = id;
+			if (options.IsEntityRequested(TO_STRING(FCDEntity::CleanName(TO_FSTRING(name).c_str())))) pendingNodes.push_back(child);
+			else skippedNodes.insert(child, true);
+			if (!id.empty()) entityNodes.insert(id, child);
+		}
+	}
+
+	// Keep the entities that the requested entities depend on.
+	StringList dependencies;
+	while (!pendingNodes.empty())
+	{
+		xmlNode* node = pendingNodes.back();
+		pendingNodes.pop_back();
+
+		dependencies.clear();
+		ReadEntityNodeDependencies(node, dependencies);
+		for (StringList::iterator it = dependencies.begin(); it != dependencies.end(); ++it)
+		{
+			fm::map<fm::string, xmlNode*>::iterator itN = entityNodes.find(*it);
+			if (itN == entityNodes.end()) continue;
+			FAXNodeSet::iterator itS = skippedNodes.find(itN->second);
+			if (itS == skippedNodes.end()) continue;
+			skippedNodes.erase(itS);
+			pendingNodes.push_back(itN->second);
+		}
+	}
+}
+
+// Runs the second pass of the loading for the entities of one library.
+// The controller and visual scene links are not fatal: their results are or'ed.
+static bool LinkLibrary(FCDocument* theDocument, nodeOrder order)
+{
+	bool status = true;
+	switch (order)
+	{
+	case MATERIAL:
+		// Link the effect surface parameters with the images
+		for (size_t i = 0; i < theDocument->GetMaterialLibrary()->GetEntityCount(); ++i)
+		{
+			FArchiveXML::LinkMaterial(theDocument->GetMaterialLibrary()->GetEntity(i));
+		}
+		break;
+	case EFFECT:
+		for (size_t i = 0; i < theDocument->GetEffectLibrary()->GetEntityCount(); ++i)
+		{
+			FArchiveXML::LinkEffect(theDocument->GetEffectLibrary()->GetEntity(i));
+		}
+		break;
+	case CONTROLLER:
+		status = false;
+		for (size_t i = 0; i < theDocument->GetControllerLibrary()->GetEntityCount(); ++i)
+		{
+			status |= FArchiveXML::LinkController(theDocument->GetControllerLibrary()->GetEntity(i));
+		}
+		break;
+	case VISUAL_SCENE:
+		status = false;
+		for (size_t i = 0; i < theDocument->GetVisualSceneLibrary()->GetEntityCount(); i++)
+		{
+			FCDSceneNode* node = theDocument->GetVisualSceneLibrary()->GetEntity(i);
+			status |= FArchiveXML::LinkSceneNode(node);
+		}
+		break;
+	case GEOMETRY:
+		// Link the convex meshes with their point clouds (convex_hull_of)
+		for (size_t i = 0; i < theDocument->GetGeometryLibrary()->GetEntityCount(); ++i)
+		{
+			FCDGeometryMesh* mesh = theDocument->GetGeometryLibrary()->GetEntity(i)->GetMesh();
+			if (mesh) FArchiveXML::LinkGeometryMesh(mesh);
+		}
+		break;
+	case CAMERA:
+		{
+			// Link the targeted entities, for 3dsMax cameras and lights
+			size_t cameraCount = theDocument->GetCameraLibrary()->GetEntityCount();
+			for (size_t i = 0; i < cameraCount; ++i)
+			{
+				FCDCamera* camera = theDocument->GetCameraLibrary()->GetEntity(i);
+				FCDTargetedEntityDataMap::iterator it = FArchiveXML::GetLinkData(theDocument).targetedEntityDataMap.find(camera);
+				if (!it->second.targetId.empty())
+				{
+					status &= (FArchiveXML::LinkTargetedEntity(camera));
+				}
+			}
+			break;
+		}
+	case LIGHT:
+		{
+			size_t lightCount = theDocument->GetLightLibrary()->GetEntityCount();
+			for (size_t i = 0; i < lightCount; ++i)
+			{
+				FCDLight* light = theDocument->GetLightLibrary()->GetEntity(i);
+				FCDTargetedEntityDataMap::iterator it = FArchiveXML::GetLinkData(theDocument).targetedEntityDataMap.find(light);
+				if (!it->second.targetId.empty())
+				{
+					status &= (FArchiveXML::LinkTargetedEntity(light));
+				}
+			}
+			break;
+		}
+	case ANIMATION:
+		{
+			// Check that all the animation curves that need them, have found drivers
+			size_t animationCount = theDocument->GetAnimationLibrary()->GetEntityCount();
+			for (size_t i = 0; i < animationCount; ++i)
+			{
+				FCDAnimation* animation = theDocument->GetAnimationLibrary()->GetEntity(i);
+				status &= (FArchiveXML::LinkAnimation(animation));
+			}
+			break;
+		}
+	default: break;
+	}
+	return status;
+}
+
+// Retrieves, or sets, the deferred loading of the library for an ordered library node.
+static bool IsLibraryLoadDeferred(FCDocument* theDocument, nodeOrder order)
+{
+	switch (order)
+	{
+	case ANIMATION: return theDocument->GetAnimationLibrary()->IsLoadDeferred();
+	case ANIMATION_CLIP: return theDocument->GetAnimationClipLibrary()->IsLoadDeferred();
+	case CAMERA: return theDocument->GetCameraLibrary()->IsLoadDeferred();
+	case CONTROLLER: return theDocument->GetControllerLibrary()->IsLoadDeferred();
+	case EFFECT: return theDocument->GetEffectLibrary()->IsLoadDeferred();
+	case EMITTER: return theDocument->GetEmitterLibrary()->IsLoadDeferred();
+	case FORCE_FIELD: return theDocument->GetForceFieldLibrary()->IsLoadDeferred();
+	case GEOMETRY: return theDocument->GetGeometryLibrary()->IsLoadDeferred();
+	case IMAGE: return theDocument->GetImageLibrary()->IsLoadDeferred();
+	case LIGHT: return theDocument->GetLightLibrary()->IsLoadDeferred();
+	case MATERIAL: return theDocument->GetMaterialLibrary()->IsLoadDeferred();
+	case PHYSICS_MODEL: return theDocument->GetPhysicsModelLibrary()->IsLoadDeferred();
+	case PHYSICS_MATERIAL: return theDocument->GetPhysicsMaterialLibrary()->IsLoadDeferred();
+	case PHYSICS_SCENE: return theDocument->GetPhysicsSceneLibrary()->IsLoadDeferred();
+	case VISUAL_SCENE: return theDocument->GetVisualSceneLibrary()->IsLoadDeferred();
+	case UNKNOWN: default: return false;
+	}
+}
+
+static void SetLibraryDeferredLoad(FCDocument* theDocument, nodeOrder order, FCDLibraryDeferredLoad* load)
+{
+	switch (order)
+	{
+	case ANIMATION: theDocument->GetAnimationLibrary()->SetDeferredLoad(load); break;
+	case ANIMATION_CLIP: theDocument->GetAnimationClipLibrary()->SetDeferredLoad(load); break;
+	case CAMERA: theDocument->GetCameraLibrary()->SetDeferredLoad(load); break;
+	case CONTROLLER: theDocument->GetControllerLibrary()->SetDeferredLoad(load); break;
+	case EFFECT: theDocument->GetEffectLibrary()->SetDeferredLoad(load); break;
+	case EMITTER: theDocument->GetEmitterLibrary()->SetDeferredLoad(load); break;
+	case FORCE_FIELD: theDocument->GetForceFieldLibrary()->SetDeferredLoad(load); break;
+	case GEOMETRY: theDocument->GetGeometryLibrary()->SetDeferredLoad(load); break;
+	case IMAGE: theDocument->GetImageLibrary()->SetDeferredLoad(load); break;
+	case LIGHT: theDocument->GetLightLibrary()->SetDeferredLoad(load); break;
+	case MATERIAL: theDocument->GetMaterialLibrary()->SetDeferredLoad(load); break;
+	case PHYSICS_MODEL: theDocument->GetPhysicsModelLibrary()->SetDeferredLoad(load); break;
+	case PHYSICS_MATERIAL: theDocument->GetPhysicsMaterialLibrary()->SetDeferredLoad(load); break;
+	case PHYSICS_SCENE: theDocument->GetPhysicsSceneLibrary()->SetDeferredLoad(load); break;
+	case VISUAL_SCENE: theDocument->GetVisualSceneLibrary()->SetDeferredLoad(load); break;
+	case UNKNOWN: default: SAFE_DELETE(load); break;
+	}
+}
+
+// The library nodes of a lazy library, copied out of the parsed document.
+// The link data of the document is retained until the library is loaded,
+// so that its entities may still be linked with the animation channels.
+// xmlDocCopyNode leaves out the _private pointers,
+// which hold the binary float arrays of the nodes restored from a snapshot.
+static void CopyNodeBinaryFloats(const xmlNode* original, xmlNode* copy)
+{
+	copy->_private = original->_private;
+
+	const xmlNode* originalChild = original->children;
+	xmlNode* copyChild = copy->children;
+	for (; originalChild != NULL && copyChild != NULL; originalChild = originalChild->next, copyChild = copyChild->next)
+	{
+		if (originalChild->type == XML_ELEMENT_NODE) CopyNodeBinaryFloats(originalChild, copyChild);
+	}
+}
+
+class FAXDeferredLibrary : public FCDLibraryDeferredLoad
+{
+private:
+	FCDocument* document;
+	nodeOrder order;
+	xmlDoc* content;
+
+public:
+	FAXDeferredLibrary(FCDocument* _document, nodeOrder _order)
+	:	document(_document), order(_order)
+	{
+		content = xmlNewDoc(NULL);
+		xmlDocSetRootElement(content, xmlNewNode(NULL, (const xmlChar*) DAE_COLLADA_ELEMENT));
+		FArchiveXML::AcquireLinkData(document);
+	}
+
+	virtual ~FAXDeferredLibrary()
+	{
+		if (content != NULL)
+		{
+			xmlFreeDoc(content);
+			FArchiveXML::ReleaseLinkData(document);
+		}
+	}
+
+	void AddNode(xmlNode* libraryNode, const FAXNodeSet& skippedNodes)
+	{
+		FAXSnapshot* snapshot = FArchiveXML::GetLinkData(document).snapshot;
+		bool isFromSnapshot = snapshot != NULL && snapshot->IsOpen();
+		if (skippedNodes.empty())
+		{
+			xmlNode* copy = xmlAddChild(xmlDocGetRootElement(content), xmlDocCopyNode(libraryNode, content, 1));
+			if (isFromSnapshot) CopyNodeBinaryFloats(libraryNode, copy);
+			return;
+		}
+
+		// Leave out the entity nodes that are not to be read in.
+		xmlNode* copy = xmlAddChild(xmlDocGetRootElement(content), xmlDocCopyNode(libraryNode, content, 2));
+		for (xmlNode* child = libraryNode->children; child != NULL; child = child->next)
+		{
+			if (skippedNodes.find(child) != skippedNodes.end()) continue;
+			xmlNode* childCopy = xmlAddChild(copy, xmlDocCopyNode(child, content, 1));
+			if (isFromSnapshot && child->type == XML_ELEMENT_NODE) CopyNodeBinaryFloats(child, childCopy);
+		}
+	}
+
+	virtual void Load()
+	{
+		if (content == NULL) return;
+
+		xmlNode* rootNode = xmlDocGetRootElement(content);
+		for (xmlNode* child = rootNode->children; child != NULL; child = child->next)
+		{
+			if (child->type == XML_ELEMENT_NODE) LoadLibraryNode(document, order, child);
+		}
+		LinkLibrary(document, order);
+
+		xmlFreeDoc(content);
+		content = NULL;
+		FArchiveXML::ReleaseLinkData(document);
+	}
+};
+
+// Converts the text of the large numeric arrays of the geometry, controller and animation libraries
+// on worker threads, before their entities are read in. Each converted array is attached to its node,
+// in the same [count][values] form as the float arrays restored from a snapshot:
+// see FUDaeParser::ReadNodeBinaryFloats and FUDaeParser::ReadNodeBinaryUInt32s.
+// The entities themselves are still read in one by one, on the importing thread:
+// the document's id maps, the link data and the error handlers are not thread-safe,
+// and clashing ids must be renamed in document order.
+class FAXArrayConverter
+{
+private:
+	struct Job
+	{
+		xmlNode* node;
+		bool isFloatArray;
+		size_t textLength;
+		uint32* block;
+	};
+	typedef fm::vector<Job, true> JobList;
+
+	JobList jobs;
+	size_t textLength;
+	size_t nextJob;
+	FUCriticalSection jobSection;
+
+	// The amount of text below which the arrays are left to the entities, see FCDLoadOptions.
+	size_t threshold;
+
+public:
+	FAXArrayConverter(size_t _threshold) : textLength(0), nextJob(0), threshold(_threshold) {}
+
+	~FAXArrayConverter()
+	{
+		// The readers free each converted array once read: free the arrays that were not.
+		for (JobList::iterator it = jobs.begin(); it != jobs.end(); ++it)
+		{
+			ReleaseNodeBinaryValues((*it).node);
+		}
+	}
+
+	void AddLibraryNode(nodeOrder order, xmlNode* libraryNode, const FAXNodeSet& skippedNodes)
+	{
+		if (order != GEOMETRY && order != CONTROLLER && order != ANIMATION) return;
+		for (xmlNode* child = libraryNode->children; child != NULL; child = child->next)
+		{
+			if (child->type != XML_ELEMENT_NODE || skippedNodes.find(child) != skippedNodes.end()) continue;
+			AddNodes(child, order == GEOMETRY);
+		}
+	}
+
+	void Run()
+	{
+		size_t jobCount = jobs.size();
+		uint32 threadCount = FUThread::GetProcessorCount();
+		if (threshold == 0 && threadCount < 2) threadCount = 2; // Always exercise the worker threads
+		if (threadCount > jobCount) threadCount = (uint32) jobCount;
+		if (jobCount == 0 || textLength < threshold || (threadCount < 2 && threshold > 0))
+		{
+			// Leave the arrays to be converted by the entities, as they are read in.
+			jobs.clear();
+			return;
+		}
+
+		// Sort the longest arrays first, for the threads to finish together.
+		SortJobs();
+
+		fm::pvector<FUThread> threads;
+		threads.reserve(threadCount - 1);
+		for (uint32 i = 1; i < threadCount; ++i)
+		{
+			FUThread* thread = FUThread::CreateFUThread(ConvertJobsThread, this);
+			if (thread != NULL) threads.push_back(thread);
+		}
+		ConvertJobs();
+		for (fm::pvector<FUThread>::iterator it = threads.begin(); it != threads.end(); ++it)
+		{
+			FUThread::ExitFUThread(*it);
+		}
+
+		// Attach the converted arrays to their nodes.
+		for (JobList::iterator it = jobs.begin(); it != jobs.end(); ++it)
+		{
+			(*it).node->_private = (void*) (*it).block;
+		}
+	}
+
+private:
+	void AddNodes(xmlNode* parent, bool isGeometry)
+	{
+		for (xmlNode* child = parent->children; child != NULL; child = child->next)
+		{
+			if (child->type != XML_ELEMENT_NODE) continue;
+			if (IsEquivalent(child->name, DAE_EXTRA_ELEMENT)) continue;
+
+			bool isFloatArray = IsEquivalent(child->name, DAE_FLOAT_ARRAY_ELEMENT) && IsEquivalent(parent->name, DAE_SOURCE_ELEMENT);
+			bool isIndexList = isGeometry && (IsEquivalent(child->name, DAE_POLYGON_ELEMENT) || IsEquivalent(child->name, DAE_HOLE_ELEMENT)
+				|| IsEquivalent(child->name, DAE_VERTEXCOUNT_ELEMENT));
+			if (isFloatArray || isIndexList)
+			{
+				// The float arrays restored from a snapshot are already converted.
+				const char* content = ReadNodeContentDirect(child);
+				if (child->_private != NULL || content == NULL || *content == 0) continue;
+
+				Job job = { child, isFloatArray, strlen(content), NULL };
+				jobs.push_back(job);
+				textLength += job.textLength;
+			}
+			else AddNodes(child, isGeometry);
+		}
+	}
+
+	void SortJobs()
+	{
+		// Insertion sort is quick enough: there are few large arrays.
+		size_t jobCount = jobs.size();
+		for (size_t i = 1; i < jobCount; ++i)
+		{
+			Job job = jobs[i];
+			size_t j = i;
+			for (; j > 0 && jobs[j - 1].textLength < job.textLength; --j) jobs[j] = jobs[j - 1];
+			jobs[j] = job;
+		}
+	}
+
+#ifdef WIN32
+	static DWORD WINAPI ConvertJobsThread(void* parameter)
+#else
+	static void* ConvertJobsThread(void* parameter)
+#endif // WIN32
+	{
+		((FAXArrayConverter*) parameter)->ConvertJobs();
+		return 0;
+	}
+
+	void ConvertJobs()
+	{
+		FloatList floats;
+		UInt32List values;
+		while (true)
+		{
+			jobSection.Enter();
+			size_t index = nextJob++;
+			jobSection.Leave();
+			if (index >= jobs.size()) break;
+
+			// Use the same conversion functions as the entities, for identical values.
+			Job& job = jobs[index];
+			const char* content = ReadNodeContentDirect(job.node);
+			size_t count;
+			const void* data;
+			if (job.isFloatArray)
+			{
+				floats.clear();
+				FUStringConversion::ToFloatList(content, floats);
+				count = floats.size();
+				data = floats.begin();
+			}
+			else
+			{
+				values.clear();
+				FUStringConversion::ToUInt32List(content, values);
+				count = values.size();
+				data = values.begin();
+			}
+			job.block = new uint32[count + 1];
+			job.block[0] = (uint32) count;
+			if (count > 0) memcpy(job.block + 1, data, count * sizeof(uint32));
+		}
+	}
+};
+
 bool FArchiveXML::Import(FCDocument* theDocument, xmlNode* colladaNode)
 {
 	bool status = true;
 
-	if (FArchiveXML::loadedDocumentCount == 0)
-		FArchiveXML::ClearIntermediateData();
-	++FArchiveXML::loadedDocumentCount;
+	// The link data of this document lives until the import completes.
+	FAXLinkDataScope linkDataScope(theDocument);
 
 	// The only root node supported is "COLLADA"
 	if (!IsEquivalent(colladaNode->name, DAE_COLLADA_ELEMENT))
@@ -664,42 +1293,48 @@ bool FArchiveXML::Import(FCDocument* theDocument, xmlNode* colladaNode)
 		}
 	}
 
-	// Process the ordered libraries
+	// Read in only the geometries and controllers that the requested entities need.
+	FAXNodeSet& skippedEntityNodes = FArchiveXML::GetLinkData(theDocument).skippedEntityNodes;
+	skippedEntityNodes.clear();
+	if (theDocument->GetLoadOptions().HasRequestedEntities())
+	{
+		SkipUnrequestedEntities(theDocument->GetLoadOptions(), orderedLibraryNodes, skippedEntityNodes);
+	}
+
+	// Copy out the lazy libraries: they are loaded on first access.
+	FAXDeferredLibrary* deferredLibraries[UNKNOWN];
+	memset(deferredLibraries, 0, sizeof(deferredLibraries));
 	size_t libraryNodeCount = orderedLibraryNodes.size();
 	for (size_t i = 0; i < libraryNodeCount; ++i)
+	{
+		xmlOrderedNode& n = orderedLibraryNodes[i];
+		if (GetLoadMode(theDocument, n.order) != FCDLoadOptions::LAZY) continue;
+		if (deferredLibraries[n.order] == NULL) deferredLibraries[n.order] = new FAXDeferredLibrary(theDocument, n.order);
+		deferredLibraries[n.order]->AddNode(n.node, skippedEntityNodes);
+	}
+	for (size_t i = 0; i < UNKNOWN; ++i)
+	{
+		if (deferredLibraries[i] != NULL) SetLibraryDeferredLoad(theDocument, (nodeOrder) i, deferredLibraries[i]);
+	}
+
+	// Convert the large numeric arrays of the loaded libraries ahead of time, in parallel.
+	FAXArrayConverter arrayConverter(theDocument->GetLoadOptions().GetParallelConversionThreshold());
+	for (size_t i = 0; i < libraryNodeCount; ++i)
+	{
+		xmlOrderedNode& n = orderedLibraryNodes[i];
+		if (GetLoadMode(theDocument, n.order) != FCDLoadOptions::EAGER) continue;
+		arrayConverter.AddLibraryNode(n.order, n.node, skippedEntityNodes);
+	}
+	arrayConverter.Run();
+
+	// Process the ordered libraries
+	for (size_t i = 0; i < libraryNodeCount; ++i)
 	{
 		if (FCollada::CancelLoading()) return false;
 
 		xmlOrderedNode& n = orderedLibraryNodes[i];
-		switch (n.order)
-		{
-		case ANIMATION: status &= (FArchiveXML::LoadAnimationLibrary(theDocument->GetAnimationLibrary(), n.node)); break;
-		case ANIMATION_CLIP: status &= (FArchiveXML::LoadAnimationClipLibrary(theDocument->GetAnimationClipLibrary(), n.node)); break;
-		case CAMERA: status &= (FArchiveXML::LoadCameraLibrary(theDocument->GetCameraLibrary(), n.node)); break;
-		case CONTROLLER: status &= (FArchiveXML::LoadControllerLibrary(theDocument->GetControllerLibrary(), n.node)); break;
-		case EFFECT: status &= (FArchiveXML::LoadEffectLibrary(theDocument->GetEffectLibrary(), n.node)); break;
-		case EMITTER: status &= (FArchiveXML::LoadEmitterLibrary(theDocument->GetEmitterLibrary(), n.node)); break;
-		case FORCE_FIELD: status &= (FArchiveXML::LoadForceFieldLibrary(theDocument->GetForceFieldLibrary(), n.node)); break;
-		case GEOMETRY: status &= (FArchiveXML::LoadGeometryLibrary(theDocument->GetGeometryLibrary(), n.node)); break;
-		case IMAGE: status &= (FArchiveXML::LoadImageLibrary(theDocument->GetImageLibrary(), n.node)); break;
-		case LIGHT: status &= (FArchiveXML::LoadLightLibrary(theDocument->GetLightLibrary(), n.node)); break;
-		case MATERIAL: status &= (FArchiveXML::LoadMaterialLibrary(theDocument->GetMaterialLibrary(), n.node)); break;
-		case PHYSICS_MODEL: 
-			{
-				status &= (FArchiveXML::LoadPhysicsModelLibrary(theDocument->GetPhysicsModelLibrary(), n.node)); 
-				size_t physicsModelCount = theDocument->GetPhysicsModelLibrary()->GetEntityCount();
-				for (size_t physicsModelCounter = 0; physicsModelCounter < physicsModelCount; physicsModelCounter++)
-				{
-					FCDPhysicsModel* model = theDocument->GetPhysicsModelLibrary()->GetEntity(physicsModelCounter);
-					status &= FArchiveXML::AttachModelInstancesFCDPhysicsModel(model);
-				}
-				break;
-			}
-		case PHYSICS_MATERIAL: status &= (FArchiveXML::LoadPhysicsMaterialLibrary(theDocument->GetPhysicsMaterialLibrary(), n.node)); break;
-		case PHYSICS_SCENE: status &= (FArchiveXML::LoadPhysicsSceneLibrary(theDocument->GetPhysicsSceneLibrary(), n.node)); break;
-		case VISUAL_SCENE: status &= (FArchiveXML::LoadVisualSceneNodeLibrary(theDocument->GetVisualSceneLibrary(), n.node)); break;
-		case UNKNOWN: default: break;
-		}
+		if (GetLoadMode(theDocument, n.order) != FCDLoadOptions::EAGER) continue;
+		status &= LoadLibraryNode(theDocument, n.order, n.node);
 	}
 
 	// Read in the <scene> element
@@ -716,6 +1351,7 @@ bool FArchiveXML::Import(FCDocument* theDocument, xmlNode* colladaNode)
 				FUError::Error(FUError::WARNING_LEVEL, FUError::ERROR_INVALID_ELEMENT, child->line);
 				continue;
 			}
+			if (GetLoadMode(theDocument, isVisualSceneInstance ? VISUAL_SCENE : PHYSICS_SCENE) == FCDLoadOptions::SKIP) continue;
 
 			FUUri instanceUri = ReadNodeUrl(child);
 			if (instanceUri.GetFragment().empty())
@@ -734,62 +1370,16 @@ bool FArchiveXML::Import(FCDocument* theDocument, xmlNode* colladaNode)
 		}
 	}
 
-	// Link the effect surface parameters with the images
-	for (size_t i = 0; i < theDocument->GetMaterialLibrary()->GetEntityCount(); ++i)
-	{
-		FArchiveXML::LinkMaterial(theDocument->GetMaterialLibrary()->GetEntity(i));
-	}
-	for (size_t i = 0; i < theDocument->GetEffectLibrary()->GetEntityCount(); ++i)
-	{
-		FArchiveXML::LinkEffect(theDocument->GetEffectLibrary()->GetEntity(i));
-	}
-	for (size_t i = 0; i < theDocument->GetControllerLibrary()->GetEntityCount(); ++i)
-	{
-		status |= FArchiveXML::LinkController(theDocument->GetControllerLibrary()->GetEntity(i));
-	}
-
-	for (size_t i = 0; i < theDocument->GetVisualSceneLibrary()->GetEntityCount(); i++)
-	{
-		FCDSceneNode* node = theDocument->GetVisualSceneLibrary()->GetEntity(i);
-		status |= FArchiveXML::LinkSceneNode(node);
-	}
-
-	// Link the convex meshes with their point clouds (convex_hull_of)
-	for (size_t i = 0; i < theDocument->GetGeometryLibrary()->GetEntityCount(); ++i)
-	{
-		FCDGeometryMesh* mesh = theDocument->GetGeometryLibrary()->GetEntity(i)->GetMesh();
-		if (mesh) FArchiveXML::LinkGeometryMesh(mesh);
-	}
-
-	// Link the targeted entities, for 3dsMax cameras and lights
-	size_t cameraCount = theDocument->GetCameraLibrary()->GetEntityCount();
-	for (size_t i = 0; i < cameraCount; ++i)
-	{
-		FCDCamera* camera = theDocument->GetCameraLibrary()->GetEntity(i);
-		FCDTargetedEntityDataMap::iterator it = FArchiveXML::documentLinkDataMap[theDocument].targetedEntityDataMap.find(camera);
-		if (!it->second.targetId.empty())
-		{
-			status &= (FArchiveXML::LinkTargetedEntity(camera));
-		}
-	}
-	size_t lightCount = theDocument->GetLightLibrary()->GetEntityCount();
-	for (size_t i = 0; i < lightCount; ++i)
-	{
-		FCDLight* light = theDocument->GetLightLibrary()->GetEntity(i);
-		FCDTargetedEntityDataMap::iterator it = FArchiveXML::documentLinkDataMap[theDocument].targetedEntityDataMap.find(light);
-		if (!it->second.targetId.empty())
-		{
-			status &= (FArchiveXML::LinkTargetedEntity(light));
-		}
-	}
-
-	// Check that all the animation curves that need them, have found drivers
-	size_t animationCount = theDocument->GetAnimationLibrary()->GetEntityCount();
-	for (size_t i = 0; i < animationCount; ++i)
-	{
-		FCDAnimation* animation = theDocument->GetAnimationLibrary()->GetEntity(i);
-		status &= (FArchiveXML::LinkAnimation(animation));
-	}
+	// Link the loaded libraries: the lazy ones are linked once loaded.
+	if (!IsLibraryLoadDeferred(theDocument, MATERIAL)) LinkLibrary(theDocument, MATERIAL);
+	if (!IsLibraryLoadDeferred(theDocument, EFFECT)) LinkLibrary(theDocument, EFFECT);
+	if (!IsLibraryLoadDeferred(theDocument, CONTROLLER)) status |= LinkLibrary(theDocument, CONTROLLER);
+	if (!IsLibraryLoadDeferred(theDocument, VISUAL_SCENE)) status |= LinkLibrary(theDocument, VISUAL_SCENE);
+	if (!IsLibraryLoadDeferred(theDocument, GEOMETRY)) LinkLibrary(theDocument, GEOMETRY);
+	if (!IsLibraryLoadDeferred(theDocument, CAMERA)) status &= LinkLibrary(theDocument, CAMERA);
+	if (!IsLibraryLoadDeferred(theDocument, LIGHT)) status &= LinkLibrary(theDocument, LIGHT);
+	status &= LinkLibrary(theDocument, ANIMATION);
+	skippedEntityNodes.clear();
 
 	if (!theDocument->GetFileUrl().empty())
 	{
@@ -800,7 +1390,6 @@ bool FArchiveXML::Import(FCDocument* theDocument, xmlNode* colladaNode)
 		//FCDExternalReferenceManager::RegisterLoadedDocument(theDocument);
 	}
 
-	--FArchiveXML::loadedDocumentCount;
 	return status;
 }
 
@@ -809,9 +1398,7 @@ bool FArchiveXML::ExportDocument(FCDocument* theDocument, xmlNode* colladaNode)
 {
 	bool status = true;
 
-	if (FArchiveXML::loadedDocumentCount == 0)
-		FArchiveXML::ClearIntermediateData();
-	++FArchiveXML::loadedDocumentCount;
+	FAXLinkDataScope linkDataScope(theDocument);
 
 	if (colladaNode != NULL)
 	{
@@ -911,17 +1498,15 @@ bool FArchiveXML::ExportDocument(FCDocument* theDocument, xmlNode* colladaNode)
 		FArchiveXML::WriteExtra(theDocument->GetExtra(), colladaNode);
 	}
 
-	--FArchiveXML::loadedDocumentCount;
-
 	return status;
 }
 
 bool FArchiveXML::LoadSwitch(FCDObject* object, const FUObjectType* objectType, xmlNode* node)
 {
-	XMLLoadFuncMap::iterator it = FArchiveXML::xmlLoadFuncs.find(objectType);
-	if (it != FArchiveXML::xmlLoadFuncs.end())
+	XMLLoadFunc function = FArchiveXML::xmlLoadFuncs.find(objectType);
+	if (function != NULL)
 	{
-		return (*it->second)(object, node);
+		return (*function)(object, node);
 	}
 	else
 	{
@@ -933,6 +1518,7 @@ template <class T>
 bool FArchiveXML::LoadLibrary(FCDObject* object, xmlNode* node)
 {
 	FCDLibrary<T>* library = (FCDLibrary<T>*)object;
+	const FAXNodeSet& skippedNodes = GetLinkData(library->GetDocument()).skippedEntityNodes;
 
 	bool status = true;
 	for (xmlNode* child = node->children; child != NULL; child = child->next)
@@ -949,7 +1535,7 @@ bool FArchiveXML::LoadLibrary(FCDObject* object, xmlNode* node)
 				// Import the <extra> tag for this library.
 				LoadExtra(library->GetExtra(), child);
 			}
-			else
+			else if (skippedNodes.empty() || skippedNodes.find(child) == skippedNodes.end())
 			{
 				// Attempt to import this node as an entity of the library.
 				T* entity = library->AddEntity();
@@ -966,10 +1552,10 @@ bool FArchiveXML::LoadLibrary(FCDObject* object, xmlNode* node)
 
 xmlNode* FArchiveXML::WriteSwitch(FCDObject* object, const FUObjectType* objectType, xmlNode* node)
 {
-	XMLWriteFuncMap::iterator it = FArchiveXML::xmlWriteFuncs.find(objectType);
-	if (it != FArchiveXML::xmlWriteFuncs.end())
+	XMLWriteFunc function = FArchiveXML::xmlWriteFuncs.find(objectType);
+	if (function != NULL)
 	{
-		return (*it->second)(object, node);
+		return (*function)(object, node);
 	}
 	else
 	{
@@ -41,18 +41,22 @@ private:
 	//
 	// Importer variables
 	//
-	static XMLLoadFuncMap xmlLoadFuncs;
+	static XMLLoadFuncTable xmlLoadFuncs;
 
 	//
 	// Exporter variables
 	// 
-	static XMLWriteFuncMap xmlWriteFuncs;
+	static XMLWriteFuncTable xmlWriteFuncs;
 
 	//
 	// Link data used in 2nd passing of loading.
+	// Each document being imported or exported owns its own link data,
+	// so that several documents may be loaded concurrently.
 	//
 	static DocumentLinkDataMap documentLinkDataMap;
-	static int loadedDocumentCount;
+	static uint32 loadedDocumentCount;
+	static FUCriticalSection linkDataCriticalSection;
+	static FUCriticalSection registrationCriticalSection;
 
 	//
 	// Extra extension registration
@@ -71,6 +75,7 @@ public:
 	virtual bool IsImportSupported(){ return true; }
 	virtual bool IsExportSupported(){ return true; }
 	virtual bool IsPartialExportSupported(){ return true; }
+	virtual bool IsValidationSupported(){ return true; }
 
 	virtual bool IsExtensionSupported(const char* ext);
 	virtual int GetSupportedExtensionsCount(){ return NUM_EXTENSIONS + (int)extraExtensions.size(); }
@@ -81,6 +86,7 @@ public:
 
 	virtual bool ImportFile(const fchar* filePath, FCDocument* fcdocument);
 	virtual bool ImportFileFromMemory(const fchar* filePath, FCDocument* fcdocument, const void* contents, size_t length);
+	virtual bool ValidateFile(const fchar* filePath, FUError::RecordList& errors);
 
 	virtual bool ExportFile(FCDocument* fcdocument, const fchar* filePath);
 
@@ -99,15 +105,38 @@ public:
 public:
 
 	/**
-		Initializes the plug-in. Add function pointers into the map.
+		Initializes the plug-in. Add function pointers into the dispatch tables.
+		The dispatch tables are filled once and are read-only afterwards:
+		this must be called before any document is imported or exported.
 	*/
 	static void Initialize();
 
 	/**
-		Clears intermediate data used in 2nd pass of the loading/writing process
+		Clears intermediate data used in 2nd pass of the loading/writing process.
+		Must not be called while a document is being imported or exported.
 	*/
 	static void ClearIntermediateData();
 
+	/**
+		Retrieves the intermediate data used in the 2nd pass of the
+		loading/writing process of a document. The data is created if needed.
+		The returned reference stays valid until the data is released.
+		@param document The document being imported or exported.
+		@return The link data of this document. */
+	static FCDocumentLinkData& GetLinkData(const FCDocument* document);
+
+	/**
+		Retains the intermediate data of a document for the duration of its
+		import or export. Stale data left over from a previous pass is discarded.
+		@param document The document being imported or exported. */
+	static void AcquireLinkData(const FCDocument* document);
+
+	/**
+		Releases the intermediate data of a document once its last
+		import or export completes.
+		@param document The document being imported or exported. */
+	static void ReleaseLinkData(const FCDocument* document);
+
 	/** 
 		Imports the parsed xml data into the FCDocument.
 		@param theDocument the FCDocument to be filled with imported data.
@@ -354,6 +383,8 @@ public:
 
 	static void FindAnimationChannels(FCDocument* fcdocument, const fm::string& pointer, FCDAnimationChannelList& channels);
 	static void FindAnimationChannels(FCDAnimation* animation, const fm::string& pointer, FCDAnimationChannelList& targetChannels);
+	static FCDocumentLinkData& IndexAnimationChannels(FCDocument* fcdocument);
+	static void IndexAnimationChannels(FCDAnimation* animation, FCDocumentLinkData& linkData);
 
 	static FCDAnimatedCustom* CreateFCDAnimatedCustom(FCDObject* document, xmlNode* node);
 
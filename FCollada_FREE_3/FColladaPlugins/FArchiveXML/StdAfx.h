@@ -18,6 +18,7 @@
 #include "FUtils/FUXmlDocument.h"
 #include "FUtils/FUFileManager.h"
 #include "FUtils/FUUniqueStringMap.h"
+#include "FUtils/FUStringPool.h"
 
 using namespace FUDaeParser;
 using namespace FUDaeWriter;
@@ -13,6 +13,14 @@
 	FCProcessImages processes the image library of a COLLADA document,
 	removing the re-used images as well as transform them into DDS with mipmaps
 	and power of 2 width/height.
+
+	The images are identified by the contents of their files, so that copies of
+	the same file under different names are processed only once. The processing
+	is spread over a pool of worker threads and its results are kept in a cache
+	folder, keyed by the image contents, for the next runs.
+
+	DevIL is not thread-safe: each worker converts its images in a child process,
+	which runs this tool with the hidden '--convert-image' option.
 */
 
 #include "StdAfx.h"
@@ -28,22 +36,112 @@
 #include "FCDocument/FCDImage.h"
 #include "FCDocument/FCDLibrary.h"
 #include "FCDocument/FCDMaterial.h"
+#include "FUtils/FUCrc32.h"
+#include "FUtils/FUCriticalSection.h"
+#include "FUtils/FUFile.h"
 #include "FUtils/FUFileManager.h"
+#include "FUtils/FUThread.h"
 
 #include <IL/il.h>
 #include <IL/ilu.h>
 
-typedef fm::map<fstring, FCDImage*> FilenameMap;
+#ifdef WIN32
+#include <direct.h>
+#else
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif // WIN32
+
+typedef fm::map<fm::string, FCDImage*> ContentMap;
 typedef fm::map<FCDImage*, FCDImage*> ReplacementMap;
+typedef fm::map<FCDImage*, fm::string> ContentKeyMap;
+
+// The version of the image processing, part of the cache keys.
+// Increment it whenever the processing changes, to invalidate the cached images.
+#define PROCESSING_VERSION 1
 
-void ReplaceDuplicateImages(FCDImageLibrary* library);
-void ProcessImages(FCDImageLibrary* library);
-void ProcessImage(FCDImage* image);
+// The hidden command line option that converts one image in a child process.
+#define CONVERT_IMAGE_OPTION "--convert-image"
 
-void ProcessImageLibrary(FCDImageLibrary* library)
+// The outcome of an image conversion, also the exit code of the conversion process.
+enum ConversionResult
+{
+	CONVERSION_SUCCEEDED = 0,
+	CONVERSION_UNREADABLE,
+	CONVERSION_INVALID,
+	CONVERSION_UNWRITABLE,
+	CONVERSION_NOT_STARTED = 127
+};
+
+// Processes the images on a pool of worker threads.
+// DevIL keeps a single bound image for the whole process and it is not thread-safe:
+// each worker runs its DevIL conversions in a child process. Only when the child process
+// cannot be started is the image converted within this process, under a lock.
+// The messages of the workers are kept with their jobs and written out by the main thread.
+class ImageProcessor
+{
+private:
+	struct Job
+	{
+		FCDImage* image;
+		fstring filename;
+		fm::string contentKey;
+		fstring processedFilename; // Unique within the library.
+		bool isProcessed;
+		bool isCached;
+		fm::string message;
+	};
+	typedef fm::vector<Job, false> JobList;
+
+	enum Phase { HASH, PROCESS };
+
+	fstring cacheFolder;
+	JobList jobs;
+	Phase phase;
+	size_t nextJob;
+	FUCriticalSection jobSection;
+	FUCriticalSection devilSection;
+
+public:
+	ImageProcessor(const fstring& cacheFolder);
+
+	// Reads and hashes the files of all the images.
+	void HashImages(FCDImageLibrary* library, ContentKeyMap& contentKeys);
+
+	// Processes the images and points them to their DDS files.
+	void ProcessImages(FCDImageLibrary* library, const ContentKeyMap& contentKeys);
+
+private:
+	void RunJobs(Phase phase);
+#ifdef WIN32
+	static DWORD WINAPI RunJobsThread(void* parameter);
+#else
+	static void* RunJobsThread(void* parameter);
+#endif // WIN32
+	void RunJobs();
+	void HashImage(Job& job);
+	void ProcessImage(Job& job);
+	ConversionResult ConvertImage(const fstring& filename, const fstring& processedFilename);
+};
+
+static const char* executableName = NULL;
+
+void ReplaceDuplicateImages(FCDImageLibrary* library, const ContentKeyMap& contentKeys);
+ConversionResult ConvertImageFile(const fstring& filename, const fstring& processedFilename);
+ConversionResult RunConversionProcess(const fstring& filename, const fstring& processedFilename);
+bool ReadImageFile(const fstring& filename, uint8*& data, size_t& length);
+bool WriteImageFile(const fstring& filename, const uint8* data, size_t length);
+uint32 GetPowerOfTwoSize(uint32 size);
+
+void ProcessImageLibrary(FCDImageLibrary* library, const fstring& cacheFolder)
 {
-	ReplaceDuplicateImages(library);
-	ProcessImages(library);
+	ImageProcessor processor(cacheFolder);
+	ContentKeyMap contentKeys;
+	processor.HashImages(library, contentKeys);
+	ReplaceDuplicateImages(library, contentKeys);
+	processor.ProcessImages(library, contentKeys);
 }
 
 int main(int argc, const char* argv[], char* envp[])
@@ -53,15 +151,28 @@ int main(int argc, const char* argv[], char* envp[])
 #else //LINUX
 	environ = envp;
 #endif //WIN32 and LINUX
-	if (argc != 3)
+	executableName = argv[0];
+	if (argc == 4 && strcmp(argv[1], CONVERT_IMAGE_OPTION) == 0)
 	{
-		std::cout << "Expecting two arguments:" << std::endl;
-		std::cout << "FCProcessImages.exe <input_filename> <output_filename>" <<std::endl;
+		// Child process of an image processor: convert a single image.
+		ilInit();
+		iluInit();
+		ConversionResult result = ConvertImageFile(TO_FSTRING(argv[2]), TO_FSTRING(argv[3]));
+		ilShutDown();
+		return (int) result;
+	}
+
+	if (argc != 3 && argc != 4)
+	{
+		std::cout << "Expecting two or three arguments:" << std::endl;
+		std::cout << "FCProcessImages.exe <input_filename> <output_filename> [<cache_folder>]" <<std::endl;
+		std::cout << "The default cache folder is 'ImageCache', next to the output file." <<std::endl;
 		exit(-1);
 	}
 
 	fstring inputFilename = TO_FSTRING(argv[1]);
 	fstring outputFilename = TO_FSTRING(argv[2]);
+	fstring cacheFolder = (argc == 4) ? TO_FSTRING(argv[3]) : FUFileManager::StripFileFromPath(outputFilename) + FC("ImageCache");
 
 	// Create an empty COLLADA document and import the given file.
 	FCollada::Initialize();
@@ -78,7 +189,7 @@ int main(int argc, const char* argv[], char* envp[])
 		iluInit();
 
 		// Process the image library
-		ProcessImageLibrary(document->GetImageLibrary());
+		ProcessImageLibrary(document->GetImageLibrary(), cacheFolder);
 
 		// Shutdown DevIL
 		ilShutDown();
@@ -118,26 +229,29 @@ int main(int argc, const char* argv[], char* envp[])
 	return 0;
 }
 
-void ReplaceDuplicateImages(FCDImageLibrary* library)
+void ReplaceDuplicateImages(FCDImageLibrary* library, const ContentKeyMap& contentKeys)
 {
-	FilenameMap filenameMap;
+	ContentMap contentMap;
 	ReplacementMap replacementMap;
 
 	// First step: make two maps. One for the original files and
 	// one for the repeated images that will be replaced.
+	// The images are the same when their files have the same contents,
+	// or, for the files that cannot be read, the same name.
 	size_t originalImageCount = library->GetEntityCount();
 	for (size_t i = 0; i < originalImageCount; ++i)
 	{
 		FCDImage* image = library->GetEntity(i);
-		const fstring& filename = image->GetFilename();
-		FilenameMap::iterator itF = filenameMap.find(filename);
-		if (itF != filenameMap.end())
+		ContentKeyMap::const_iterator itK = contentKeys.find(image);
+		fm::string key = (itK != contentKeys.end() && !(*itK).second.empty()) ? (*itK).second : fm::string("file:") + TO_STRING(image->GetFilename());
+		ContentMap::iterator itC = contentMap.find(key);
+		if (itC != contentMap.end())
 		{
-			replacementMap.insert(image, (*itF).second);
+			replacementMap.insert(image, (*itC).second);
 		}
 		else
 		{
-			filenameMap.insert(filename, image);
+			contentMap.insert(key, image);
 		}
 	}
 
@@ -220,103 +334,368 @@ void ReplaceDuplicateImages(FCDImageLibrary* library)
 	}
 }
 
-void ProcessImages(FCDImageLibrary* library)
+
+//
+// ImageProcessor
+//
+
+ImageProcessor::ImageProcessor(const fstring& _cacheFolder)
+:	cacheFolder(_cacheFolder), phase(HASH), nextJob(0)
 {
-	for (size_t i = 0; i < library->GetEntityCount(); ++i)
+	if (!cacheFolder.empty())
 	{
-		FCDImage* image = library->GetEntity(i);
-		ProcessImage(image);
+		// Create the cache folder, if it doesn't exist yet.
+#ifdef WIN32
+		_mkdir(TO_STRING(cacheFolder).c_str());
+#else
+		mkdir(TO_STRING(cacheFolder).c_str(), 0777);
+#endif // WIN32
+		if (cacheFolder[cacheFolder.size() - 1] != '/' && cacheFolder[cacheFolder.size() - 1] != '\\') cacheFolder += FC("/");
 	}
 }
 
-void ProcessImage(FCDImage* image)
+void ImageProcessor::HashImages(FCDImageLibrary* library, ContentKeyMap& contentKeys)
 {
-	// Create an image container in DevIL.
-	ILuint imageId;
-	ilGenImages(1, &imageId);
-	ilBindImage(imageId);
+	jobs.clear();
+	size_t imageCount = library->GetEntityCount();
+	for (size_t i = 0; i < imageCount; ++i)
+	{
+		Job job;
+		job.image = library->GetEntity(i);
+		job.filename = job.image->GetFilename();
+		job.isCached = false;
+		jobs.push_back(job);
+	}
 
-	// Read in the image file into DevIL.
-    fstring filename = image->GetFilename();
-	if (!ilLoadImage(filename.c_str()))
+	RunJobs(HASH);
+
+	for (JobList::iterator it = jobs.begin(); it != jobs.end(); ++it)
 	{
-		std::cout << "Unable to read image file: '" << TO_STRING(filename).c_str() << "'." << std::endl;
-		ilDeleteImages(1, &imageId);
-		return;
+		contentKeys.insert((*it).image, (*it).contentKey);
+	}
+}
+
+void ImageProcessor::ProcessImages(FCDImageLibrary* library, const ContentKeyMap& contentKeys)
+{
+	jobs.clear();
+	size_t imageCount = library->GetEntityCount();
+	for (size_t i = 0; i < imageCount; ++i)
+	{
+		Job job;
+		job.image = library->GetEntity(i);
+		job.filename = job.image->GetFilename();
+		ContentKeyMap::const_iterator itK = contentKeys.find(job.image);
+		if (itK != contentKeys.end()) job.contentKey = (*itK).second;
+		job.isProcessed = false;
+		job.isCached = false;
+		jobs.push_back(job);
 	}
 
-	// Retrieve the width/height of the image file.
-	uint32 width = ilGetInteger(IL_IMAGE_WIDTH);
-	uint32 height = ilGetInteger(IL_IMAGE_HEIGHT);
-	uint32 depth = ilGetInteger(IL_IMAGE_DEPTH);
-	if (width == 0 || height == 0 || depth == 0)
+	// The processed images are written out as DDS files, next to the original images.
+	// Images with different contents may share a name without its extension: 'tex.png' and 'tex.jpg'.
+	// Give each image its own DDS file, which overwrites neither another one nor the original images.
+	typedef fm::map<fstring, FCDImage*> FilenameMap;
+	FilenameMap takenFilenames;
+	for (JobList::iterator it = jobs.begin(); it != jobs.end(); ++it)
 	{
-		std::cout << "Invalid image file: '" << TO_STRING(filename).c_str() << "'." << std::endl;
-		ilDeleteImages(1, &imageId);
+		takenFilenames.insert((*it).filename, (*it).image);
+	}
+	for (JobList::iterator it = jobs.begin(); it != jobs.end(); ++it)
+	{
+		fstring baseFilename = (*it).filename;
+		fstring extension = FUFileManager::GetFileExtension(baseFilename);
+		if (!extension.empty())
+		{
+			baseFilename = baseFilename.substr(0, baseFilename.size() - extension.size() - 1);
+		}
+		fstring processedFilename = baseFilename + FC(".dds");
+		for (uint32 index = 1; true; ++index)
+		{
+			FilenameMap::iterator itF = takenFilenames.find(processedFilename);
+			if (itF == takenFilenames.end() || (*itF).second == (*it).image) break;
+			processedFilename = baseFilename + FC("_") + TO_FSTRING(index) + FC(".dds");
+		}
+		takenFilenames.insert(processedFilename, (*it).image);
+		(*it).processedFilename = processedFilename;
+	}
+
+	RunJobs(PROCESS);
+
+	// Point the images to their processed files.
+	size_t processedCount = 0, cachedCount = 0;
+	for (JobList::iterator it = jobs.begin(); it != jobs.end(); ++it)
+	{
+		if (!(*it).message.empty()) std::cout << (*it).message.c_str() << std::endl;
+		if (!(*it).isProcessed) continue;
+		(*it).image->SetFilename((*it).processedFilename);
+		++processedCount;
+		if ((*it).isCached) ++cachedCount;
+	}
+	std::cout << "Images: " << (uint32) processedCount << " processed, " << (uint32) cachedCount << " of them from the cache." << std::endl;
+}
+
+void ImageProcessor::RunJobs(Phase _phase)
+{
+	phase = _phase;
+	nextJob = 0;
+
+	uint32 threadCount = FUThread::GetProcessorCount();
+	if (threadCount > jobs.size()) threadCount = (uint32) jobs.size();
+
+	fm::pvector<FUThread> threads;
+	for (uint32 i = 1; i < threadCount; ++i)
+	{
+		FUThread* thread = FUThread::CreateFUThread(RunJobsThread, this);
+		if (thread != NULL) threads.push_back(thread);
+	}
+	RunJobs();
+	for (fm::pvector<FUThread>::iterator it = threads.begin(); it != threads.end(); ++it)
+	{
+		FUThread::ExitFUThread(*it);
+	}
+}
+
+#ifdef WIN32
+DWORD WINAPI ImageProcessor::RunJobsThread(void* parameter)
+#else
+void* ImageProcessor::RunJobsThread(void* parameter)
+#endif // WIN32
+{
+	((ImageProcessor*) parameter)->RunJobs();
+	return 0;
+}
+
+void ImageProcessor::RunJobs()
+{
+	while (true)
+	{
+		jobSection.Enter();
+		size_t index = nextJob++;
+		jobSection.Leave();
+		if (index >= jobs.size()) break;
+
+		if (phase == HASH) HashImage(jobs[index]);
+		else ProcessImage(jobs[index]);
+	}
+}
+
+void ImageProcessor::HashImage(Job& job)
+{
+	uint8* data = NULL;
+	size_t length = 0;
+	if (!ReadImageFile(job.filename, data, length)) return;
+
+	// Two independent hashes and the length: collisions are not a practical concern.
+	uint32 fnv = 2166136261u;
+	for (size_t i = 0; i < length; ++i) fnv = (fnv ^ data[i]) * 16777619u;
+	char key[32];
+	snprintf(key, 32, "%08x%08x%08x", (uint32) length, (uint32) FUCrc32::CRC32(data, length), fnv);
+	key[31] = 0;
+	job.contentKey = key;
+	SAFE_DELETE_ARRAY(data);
+}
+
+void ImageProcessor::ProcessImage(Job& job)
+{
+	if (job.contentKey.empty())
+	{
+		job.message = fm::string("Unable to read image file: '") + TO_STRING(job.filename) + "'.";
 		return;
 	}
 
-	// Check if the dimensions are power of 2
-	uint16 countW=0, msbW=0, countH=0, msbH=0, countD=0, msbD=0;
-	uint32 mask = 0x00000001;
-	for (uint16 i=0; i<32; i++)
+	// The target size only depends on the image contents, so the content key
+	// and the processing version fully identify the processed image.
+	fstring cacheFilename;
+	if (!cacheFolder.empty())
 	{
-		if ((width&mask) == mask) { countW++; msbW = i; }
-		if ((height&mask) == mask) { countH++; msbH = i; }
-		if ((depth&mask) == mask) { countD++; msbD = i; }
-		mask = mask << 1;
+		char cacheName[64];
+		snprintf(cacheName, 64, "%s-v%d.dds", job.contentKey.c_str(), PROCESSING_VERSION);
+		cacheName[63] = 0;
+		cacheFilename = cacheFolder + TO_FSTRING((const char*) cacheName);
+
+		uint8* data = NULL;
+		size_t length = 0;
+		if (ReadImageFile(cacheFilename, data, length))
+		{
+			bool isWritten = WriteImageFile(job.processedFilename, data, length);
+			SAFE_DELETE_ARRAY(data);
+			if (isWritten)
+			{
+				job.isProcessed = true;
+				job.isCached = true;
+				return;
+			}
+		}
 	}
 
-	// Round to the closest power of 2
-	if (countW > 1) 
+	ConversionResult result = ConvertImage(job.filename, job.processedFilename);
+	switch (result)
 	{
-		mask = 1 << (msbW-1);
-		if ((width&mask) == mask)
-			width = mask<<2;
-		else
-			width = mask<<1;
+	case CONVERSION_SUCCEEDED: break;
+	case CONVERSION_INVALID: job.message = fm::string("Invalid image file: '") + TO_STRING(job.filename) + "'."; return;
+	case CONVERSION_UNWRITABLE: job.message = fm::string("Unable to write processed image file: '") + TO_STRING(job.processedFilename) + "'."; return;
+	default: job.message = fm::string("Unable to read image file: '") + TO_STRING(job.filename) + "'."; return;
 	}
-	if (countH > 1)
+	job.isProcessed = true;
+
+	if (!cacheFilename.empty())
 	{
-		mask = 1 << (msbH-1);
-		if ((height&mask) == mask)
-			height = mask<<2;
-		else
-			height = mask<<1;
+		// Write the cached image under a temporary name first:
+		// another process may be reading the cache.
+		uint8* data = NULL;
+		size_t length = 0;
+		if (ReadImageFile(job.processedFilename, data, length))
+		{
+			fstring temporaryFilename = cacheFilename + FC(".tmp");
+			if (WriteImageFile(temporaryFilename, data, length))
+			{
+				remove(TO_STRING(cacheFilename).c_str());
+				rename(TO_STRING(temporaryFilename).c_str(), TO_STRING(cacheFilename).c_str());
+			}
+			SAFE_DELETE_ARRAY(data);
+		}
+	}
+}
+
+ConversionResult ImageProcessor::ConvertImage(const fstring& filename, const fstring& processedFilename)
+{
+	ConversionResult result = RunConversionProcess(filename, processedFilename);
+	if (result == CONVERSION_NOT_STARTED)
+	{
+		// Convert the image within this process, one image at a time.
+		devilSection.Enter();
+		result = ConvertImageFile(filename, processedFilename);
+		devilSection.Leave();
+	}
+	return result;
+}
+
+//
+// Image conversion
+//
+
+ConversionResult ConvertImageFile(const fstring& filename, const fstring& processedFilename)
+{
+	// Read in the image file into DevIL.
+	ILuint imageId = 0;
+	ilGenImages(1, &imageId);
+	ilBindImage(imageId);
+	ConversionResult result = CONVERSION_SUCCEEDED;
+	if (!ilLoadImage(filename.c_str()))
+	{
+		result = CONVERSION_UNREADABLE;
 	}
-	if (countD > 1)
+	else
 	{
-		mask = 1 << (msbH-1);
-		if ((depth&mask) == mask)
-			depth = mask<<2;
+		// Retrieve the width/height of the image file.
+		uint32 width = ilGetInteger(IL_IMAGE_WIDTH);
+		uint32 height = ilGetInteger(IL_IMAGE_HEIGHT);
+		uint32 depth = ilGetInteger(IL_IMAGE_DEPTH);
+		if (width == 0 || height == 0 || depth == 0)
+		{
+			result = CONVERSION_INVALID;
+		}
 		else
-			depth = mask<<1;
+		{
+			// Resize the image to the closest power of 2 dimensions.
+			uint32 targetWidth = GetPowerOfTwoSize(width);
+			uint32 targetHeight = GetPowerOfTwoSize(height);
+			uint32 targetDepth = GetPowerOfTwoSize(depth);
+			if (targetWidth != width || targetHeight != height || targetDepth != depth)
+			{
+				iluImageParameter(ILU_FILTER, ILU_BILINEAR);
+				iluScale(targetWidth, targetHeight, targetDepth);
+			}
+
+			// Generate the mipmaps, once per unique image.
+			iluBuildMipmaps();
+
+			// Write out the image, as a DDS file
+			remove(TO_STRING(processedFilename).c_str()); // DevIL is strange: it won't replace a file.
+			if (!ilSaveImage(processedFilename.c_str())) result = CONVERSION_UNWRITABLE;
+		}
+	}
+	ilDeleteImages(1, &imageId);
+	return result;
+}
+
+ConversionResult RunConversionProcess(const fstring& filename, const fstring& processedFilename)
+{
+#ifdef WIN32
+	fchar modulePath[MAX_PATH];
+	if (GetModuleFileName(NULL, modulePath, MAX_PATH) == 0) return CONVERSION_NOT_STARTED;
+	fstring commandLine = FC("\"") + fstring(modulePath) + FC("\" ") + TO_FSTRING(CONVERT_IMAGE_OPTION) + FC(" \"") + filename + FC("\" \"") + processedFilename + FC("\"");
+
+	STARTUPINFO startupInfo;
+	ZeroMemory(&startupInfo, sizeof(startupInfo));
+	startupInfo.cb = sizeof(startupInfo);
+	PROCESS_INFORMATION processInformation;
+	if (!CreateProcess(NULL, commandLine.begin(), NULL, NULL, FALSE, 0, NULL, NULL, &startupInfo, &processInformation)) return CONVERSION_NOT_STARTED;
+	WaitForSingleObject(processInformation.hProcess, INFINITE);
+	DWORD exitCode = CONVERSION_NOT_STARTED;
+	GetExitCodeProcess(processInformation.hProcess, &exitCode);
+	CloseHandle(processInformation.hThread);
+	CloseHandle(processInformation.hProcess);
+	return (ConversionResult) exitCode;
+#else
+	if (executableName == NULL) return CONVERSION_NOT_STARTED;
+
+	// Prepare the arguments before forking: only exec may follow the fork of a threaded process.
+	fm::string source = TO_STRING(filename), target = TO_STRING(processedFilename);
+	const char* arguments[] = { executableName, CONVERT_IMAGE_OPTION, source.c_str(), target.c_str(), NULL };
+	pid_t processId = fork();
+	if (processId == 0)
+	{
+		execvp(executableName, (char* const*) arguments);
+		_exit(CONVERSION_NOT_STARTED);
 	}
-	
-	// Resize image
-	if ((countW | countH | countD) > 1)
+	if (processId < 0) return CONVERSION_NOT_STARTED;
+
+	int status = 0;
+	while (waitpid(processId, &status, 0) < 0)
 	{
-		iluImageParameter(ILU_FILTER, ILU_BILINEAR);
-		iluScale(width, height, depth);
+		if (errno != EINTR) return CONVERSION_NOT_STARTED;
 	}
+	// A conversion process that crashed was given an image that DevIL cannot handle.
+	return WIFEXITED(status) ? (ConversionResult) WEXITSTATUS(status) : CONVERSION_INVALID;
+#endif // WIN32
+}
 
-	// Generate the mipmaps
-	iluBuildMipmaps();
+//
+// Helpers
+//
 
-	// Write out the image, as a DDS file
-	fstring extension = FUFileManager::GetFileExtension(filename);
-	if (!extension.empty())
+bool ReadImageFile(const fstring& filename, uint8*& data, size_t& length)
+{
+	FUFile file(filename, FUFile::READ);
+	if (!file.IsOpen()) return false;
+	length = file.GetLength();
+	data = new uint8[length > 0 ? length : 1];
+	if (!file.Read(data, length))
 	{
-		filename = filename.substr(0, filename.size() - extension.size() - 1);
+		SAFE_DELETE_ARRAY(data);
+		return false;
 	}
-	filename += FC(".dds");
-	remove(TO_STRING(filename).c_str()); // DevIL is strange: it won't replace a file.
-	if (!ilSaveImage(filename.c_str()))
+	return true;
+}
+
+bool WriteImageFile(const fstring& filename, const uint8* data, size_t length)
+{
+	FUFile file(filename, FUFile::WRITE);
+	return file.IsOpen() && file.Write(data, length);
+}
+
+uint32 GetPowerOfTwoSize(uint32 size)
+{
+	// Count the bits set and find the most significant one.
+	uint16 count = 0, msb = 0;
+	for (uint16 i = 0; i < 32; ++i)
 	{
-		std::cout << "Unable to write processed image file: '" << TO_STRING(filename).c_str() << "'." << std::endl;
+		if ((size & (1u << i)) != 0) { ++count; msb = i; }
 	}
-	image->SetFilename(filename);
+	if (count <= 1) return size;
 
-	// Clear the memory used for the image in DevIL.
-	ilDeleteImages(1, &imageId);
+	// Round to the closest power of 2, using the bit below the most significant one.
+	uint32 mask = 1 << (msb - 1);
+	return ((size & mask) == mask) ? (mask << 2) : (mask << 1);
 }
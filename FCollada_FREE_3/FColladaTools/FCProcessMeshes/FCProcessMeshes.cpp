@@ -10,8 +10,13 @@
 */
 
 /*
-	FCProcessMeshes runs selected polygons tools of the meshes of a
-	COLLADA document.
+	FCProcessMeshes runs selected polygons tools of the meshes of
+	COLLADA documents.
+
+	The documents go through a three-stage pipeline: one document is loaded
+	and another one saved while the meshes of a third one are processed.
+	The meshes of a document are processed in parallel, on a pool of
+	worker threads.
 */
 
 #include "StdAfx.h"
@@ -24,7 +29,16 @@
 #include "FCDocument/FCDGeometryPolygonsTools.h"
 #include "FCDocument/FCDGeometrySource.h"
 #include "FCDocument/FCDExtra.h"
+#include "FUtils/FUCriticalSection.h"
 #include "FUtils/FUFileManager.h"
+#include "FUtils/FUSemaphore.h"
+#include "FUtils/FUThread.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif // WIN32
 
 struct ProcessMeshesOptions
 {
@@ -33,13 +47,337 @@ struct ProcessMeshesOptions
 	bool triangulate;
 };
 
-void ProcessGeometryLibrary(FCDGeometryLibrary* library, const ProcessMeshesOptions& options);
 void ProcessMesh(FCDGeometryMesh* mesh, const ProcessMeshesOptions& options);
 
+// Retrieves a wall-clock time, in seconds.
+static double GetTime()
+{
+#ifdef WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double) counter.QuadPart / (double) frequency.QuadPart;
+#else
+	timeval now;
+	gettimeofday(&now, NULL);
+	return (double) now.tv_sec + (double) now.tv_usec * 1e-6;
+#endif // WIN32
+}
+
+// A COLLADA document going through the pipeline.
+struct PipelineDocument
+{
+	fstring inputFilename;
+	fstring outputFilename;
+	FCDocument* document;
+	bool isLoaded;
+	bool isSaved;
+	size_t meshCount;
+
+	PipelineDocument() : document(NULL), isLoaded(false), isSaved(false), meshCount(0) {}
+};
+typedef fm::pvector<PipelineDocument> PipelineDocumentList;
+
+// Loads, processes and saves a list of COLLADA documents.
+//
+// The loader and the saver each run on their own thread, while the main thread
+// processes the meshes of one document at a time with a pool of worker threads.
+// The documents are all created up front, on the main thread. Afterwards, only the
+// loader thread releases documents: the loading of external references looks up
+// the list of top documents, which is not protected against concurrent changes.
+class MeshPipeline
+{
+private:
+	ProcessMeshesOptions options;
+	PipelineDocumentList documents;
+
+	// The documents in flight: loaded or being loaded, but not yet saved.
+	static const uint32 pipelineDepth = 3;
+	FUSemaphore loadSlots;
+	FUSemaphore loaded;
+	FUSemaphore toSave;
+
+	// The loader and saver threads wait for each other to be started.
+	// If either cannot be started, the other one quits before doing any work.
+	FUSemaphore started;
+	bool isStartCancelled;
+
+	// The saved documents, which the loader thread releases.
+	PipelineDocumentList savedDocuments;
+	FUCriticalSection savedSection;
+
+	// The meshes of the document being processed.
+	fm::pvector<FCDGeometryMesh> meshes;
+	size_t nextMesh;
+	double meshTime;
+	FUCriticalSection meshSection;
+
+	FUCriticalSection outputSection;
+
+	// The busy time of each stage, in seconds.
+	double loadTime;
+	double processTime;
+	double saveTime;
+	size_t totalMeshCount;
+
+public:
+	MeshPipeline(const ProcessMeshesOptions& _options)
+		:	options(_options)
+		,	loadSlots(pipelineDepth, pipelineDepth)
+		,	loaded(0, 0x7FFFFFFF)
+		,	toSave(0, 0x7FFFFFFF)
+		,	started(0, 2), isStartCancelled(false)
+		,	nextMesh(0), meshTime(0.0)
+		,	loadTime(0.0), processTime(0.0), saveTime(0.0), totalMeshCount(0)
+	{
+	}
+
+	~MeshPipeline()
+	{
+		for (PipelineDocumentList::iterator it = documents.begin(); it != documents.end(); ++it)
+		{
+			SAFE_DELETE((*it)->document);
+		}
+		CLEAR_POINTER_VECTOR(documents);
+	}
+
+	void AddDocument(const fstring& inputFilename, const fstring& outputFilename)
+	{
+		PipelineDocument* entry = new PipelineDocument();
+		entry->inputFilename = inputFilename;
+		entry->outputFilename = outputFilename;
+		documents.push_back(entry);
+	}
+
+	// Returns the number of documents that went through the whole pipeline.
+	size_t Run()
+	{
+		double startTime = GetTime();
+		for (PipelineDocumentList::iterator it = documents.begin(); it != documents.end(); ++it)
+		{
+			(*it)->document = FCollada::NewTopDocument();
+		}
+
+		FUThread* loader = FUThread::CreateFUThread(LoaderThread, this);
+		FUThread* saver = FUThread::CreateFUThread(SaverThread, this);
+		isStartCancelled = (loader == NULL || saver == NULL);
+		started.Up();
+		started.Up();
+		if (isStartCancelled)
+		{
+			// Run the stages one after the other.
+			if (loader != NULL) FUThread::ExitFUThread(loader);
+			if (saver != NULL) FUThread::ExitFUThread(saver);
+			loader = saver = NULL;
+			for (size_t i = 0; i < documents.size(); ++i)
+			{
+				LoadDocument(documents[i]);
+				ProcessDocument(documents[i]);
+				SaveDocument(documents[i]);
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < documents.size(); ++i)
+			{
+				loaded.Down();
+				ProcessDocument(documents[i]);
+				toSave.Up();
+			}
+			FUThread::ExitFUThread(saver);
+			FUThread::ExitFUThread(loader);
+		}
+
+		size_t savedCount = 0;
+		for (PipelineDocumentList::iterator it = documents.begin(); it != documents.end(); ++it)
+		{
+			if ((*it)->isSaved) ++savedCount;
+		}
+		PrintReport(GetTime() - startTime);
+		return savedCount;
+	}
+
+private:
+#ifdef WIN32
+	static DWORD WINAPI LoaderThread(void* parameter)
+#else
+	static void* LoaderThread(void* parameter)
+#endif // WIN32
+	{
+		MeshPipeline* pipeline = (MeshPipeline*) parameter;
+		pipeline->started.Down();
+		if (pipeline->isStartCancelled) return 0;
+		for (size_t i = 0; i < pipeline->documents.size(); ++i)
+		{
+			pipeline->loadSlots.Down();
+			pipeline->ReleaseSavedDocuments();
+			pipeline->LoadDocument(pipeline->documents[i]);
+			pipeline->loaded.Up();
+		}
+		return 0;
+	}
+
+#ifdef WIN32
+	static DWORD WINAPI SaverThread(void* parameter)
+#else
+	static void* SaverThread(void* parameter)
+#endif // WIN32
+	{
+		MeshPipeline* pipeline = (MeshPipeline*) parameter;
+		pipeline->started.Down();
+		if (pipeline->isStartCancelled) return 0;
+		for (size_t i = 0; i < pipeline->documents.size(); ++i)
+		{
+			pipeline->toSave.Down();
+			pipeline->SaveDocument(pipeline->documents[i]);
+
+			pipeline->savedSection.Enter();
+			pipeline->savedDocuments.push_back(pipeline->documents[i]);
+			pipeline->savedSection.Leave();
+			pipeline->loadSlots.Up();
+		}
+		return 0;
+	}
+
+	void ReleaseSavedDocuments()
+	{
+		savedSection.Enter();
+		for (PipelineDocumentList::iterator it = savedDocuments.begin(); it != savedDocuments.end(); ++it)
+		{
+			SAFE_DELETE((*it)->document);
+		}
+		savedDocuments.clear();
+		savedSection.Leave();
+	}
+
+	void LoadDocument(PipelineDocument* entry)
+	{
+		double startTime = GetTime();
+		entry->isLoaded = FCollada::LoadDocumentFromFile(entry->document, entry->inputFilename.c_str());
+		loadTime += GetTime() - startTime;
+
+		if (!entry->isLoaded) PrintStatus(entry, "Import failed.");
+	}
+
+	void ProcessDocument(PipelineDocument* entry)
+	{
+		if (!entry->isLoaded) return;
+		double startTime = GetTime();
+		FCDocument* document = entry->document;
+
+		// Collect the meshes and process them on the worker threads.
+		FCDGeometryLibrary* library = document->GetGeometryLibrary();
+		size_t geometryCount = library->GetEntityCount();
+		for (size_t i = 0; i < geometryCount; ++i)
+		{
+			FCDGeometry* geometry = library->GetEntity(i);
+			if (geometry->IsMesh()) meshes.push_back(geometry->GetMesh());
+		}
+		entry->meshCount = meshes.size();
+		totalMeshCount += meshes.size();
+		ProcessMeshes();
+
+		// It is common practice for tools to add a new contributor to identify that they were run
+		// on a COLLADA document.
+		FCDAssetContributor* contributor = document->GetAsset()->AddContributor();
+		const char* userName = getenv("USER");
+		if (userName == NULL) userName = getenv("USERNAME");
+		if (userName != NULL) contributor->SetAuthor(TO_FSTRING(userName));
+		contributor->SetSourceData(entry->inputFilename);
+		char authoringTool[1024];
+		snprintf(authoringTool, 1024, "FCProcessMeshes sample for FCollada v%d.%02d", FCOLLADA_VERSION >> 16, FCOLLADA_VERSION & 0xFFFF);
+		authoringTool[1023] = 0;
+		contributor->SetAuthoringTool(TO_FSTRING((const char*)authoringTool));
+
+		processTime += GetTime() - startTime;
+	}
+
+	void SaveDocument(PipelineDocument* entry)
+	{
+		if (!entry->isLoaded) return;
+		double startTime = GetTime();
+		entry->isSaved = FCollada::SaveDocument(entry->document, entry->outputFilename.c_str());
+		saveTime += GetTime() - startTime;
+
+		PrintStatus(entry, entry->isSaved ? "Done." : "Export failed.");
+	}
+
+	void ProcessMeshes()
+	{
+		// The main thread takes its share of the meshes.
+		uint32 threadCount = FUThread::GetProcessorCount();
+		if (threadCount > meshes.size()) threadCount = (uint32) meshes.size();
+
+		fm::pvector<FUThread> threads;
+		for (uint32 i = 1; i < threadCount; ++i)
+		{
+			FUThread* thread = FUThread::CreateFUThread(ProcessMeshesThread, this);
+			if (thread != NULL) threads.push_back(thread);
+		}
+		ProcessMeshJobs();
+		for (fm::pvector<FUThread>::iterator it = threads.begin(); it != threads.end(); ++it)
+		{
+			FUThread::ExitFUThread(*it);
+		}
+
+		meshes.clear();
+		nextMesh = 0;
+	}
+
+#ifdef WIN32
+	static DWORD WINAPI ProcessMeshesThread(void* parameter)
+#else
+	static void* ProcessMeshesThread(void* parameter)
+#endif // WIN32
+	{
+		((MeshPipeline*) parameter)->ProcessMeshJobs();
+		return 0;
+	}
+
+	void ProcessMeshJobs()
+	{
+		double startTime = GetTime();
+		while (true)
+		{
+			meshSection.Enter();
+			size_t index = nextMesh++;
+			meshSection.Leave();
+			if (index >= meshes.size()) break;
+
+			ProcessMesh(meshes[index], options);
+		}
+
+		meshSection.Enter();
+		meshTime += GetTime() - startTime;
+		meshSection.Leave();
+	}
+
+	void PrintStatus(PipelineDocument* entry, const char* status)
+	{
+		outputSection.Enter();
+		std::cout << TO_STRING(entry->inputFilename).c_str() << ": " << status << std::endl;
+		outputSection.Leave();
+	}
+
+	void PrintReport(double wallTime)
+	{
+		char line[256];
+		std::cout << std::endl << "Timing:" << std::endl;
+		snprintf(line, 256, "  Load:    %8.3f s", loadTime); line[255] = 0;
+		std::cout << line << std::endl;
+		snprintf(line, 256, "  Process: %8.3f s (%u meshes, %.3f thread-seconds)", processTime, (unsigned int) totalMeshCount, meshTime); line[255] = 0;
+		std::cout << line << std::endl;
+		snprintf(line, 256, "  Save:    %8.3f s", saveTime); line[255] = 0;
+		std::cout << line << std::endl;
+		snprintf(line, 256, "  Total:   %8.3f s for %u documents", wallTime, (unsigned int) documents.size()); line[255] = 0;
+		std::cout << line << std::endl;
+	}
+};
+
 void PrintUsage()
 {
-	std::cout << "Expecting two arguments:" << std::endl;
-	std::cout << "FCProcessMeshes.exe [-fm][-t][-tt] <input_filename> <output_filename>" <<std::endl;
+	std::cout << "Expecting pairs of input and output filenames:" << std::endl;
+	std::cout << "FCProcessMeshes.exe [-fm][-t][-tt] <input_filename> <output_filename> [<input_filename> <output_filename> ...]" <<std::endl;
 	std::cout << "-fm Fix model for the viewer so there is less need for runtime processing." <<std::endl;
 	std::cout << "-t Triangulate the meshes." <<std::endl;
 	std::cout << "-tt Generate texture tangents for the meshes. This implies triangulating." <<std::endl;
@@ -58,8 +396,8 @@ int main(int argc, const char* argv[], char* envp[])
 	options.fixModel = false;
 	options.textureTangents = false;
 	options.triangulate = false;
-	fstring inputFilename;
-	fstring outputFilename;
+	FStringList inputFilenames;
+	FStringList outputFilenames;
 
 	// parse the arguments
 	int argCounter = 1;
@@ -88,87 +426,45 @@ int main(int argc, const char* argv[], char* envp[])
 		}
 		else
 		{
-			// should be last two arguments, the file name
-			if (argc - argCounter != 2)
+			// the remaining arguments are pairs of file names
+			if ((argc - argCounter) % 2 != 0)
 			{
 				PrintUsage();
 				exit(-1);
 			}
-			inputFilename = TO_FSTRING(argv[argCounter]);
-			outputFilename = TO_FSTRING(argv[argCounter + 1]);
-			argCounter += 2;
+			for (; argCounter < argc; argCounter += 2)
+			{
+				inputFilenames.push_back(TO_FSTRING(argv[argCounter]));
+				outputFilenames.push_back(TO_FSTRING(argv[argCounter + 1]));
+			}
 		}
 	}
-	if (inputFilename.empty() || outputFilename.empty())
+	if (inputFilenames.empty())
 	{
 		PrintUsage();
 		exit(-1);
 	}
 
-	std::cout << argv[1] << std::endl;
-	std::cout << "Import: ";
-	std::cout.flush();
-
-	// Create an empty COLLADA document and import the given file.
 	FCollada::Initialize();
-	FCDocument* document = FCollada::NewTopDocument();
 	FUErrorSimpleHandler errorHandler;
-	FCollada::LoadDocumentFromFile(document, inputFilename.c_str());
-	if (errorHandler.IsSuccessful())
+	size_t savedCount;
 	{
-		std::cout << "Done." << std::endl;
-		std::cout << "Processing: "; std::cout.flush();
-
-		ProcessGeometryLibrary(document->GetGeometryLibrary(), options);
-
-		// It is common practice for tools to add a new contributor to identify that they were run
-		// on a COLLADA document.
-		FCDAssetContributor* contributor = document->GetAsset()->AddContributor();
-		const char* userName = getenv("USER");
-		if (userName == NULL) userName = getenv("USERNAME");
-		if (userName != NULL) contributor->SetAuthor(TO_FSTRING(userName));
-		contributor->SetSourceData(inputFilename);
-		char authoringTool[1024];
-		snprintf(authoringTool, 1024, "FCProcessMeshes sample for FCollada v%d.%02d", FCOLLADA_VERSION >> 16, FCOLLADA_VERSION & 0xFFFF);
-		authoringTool[1023] = 0;
-		contributor->SetAuthoringTool(TO_FSTRING((const char*)authoringTool));
-
-		// Write out the processed COLLADA document.
-		std::cout << "Done." << std::endl;
-		std::cout << "Export: "; std::cout.flush();
-		FCollada::SaveDocument(document, outputFilename.c_str());
-		if (errorHandler.IsSuccessful())
-		{
-			std::cout << "Done." << std::endl;
-		}
-		else
+		MeshPipeline pipeline(options);
+		for (size_t i = 0; i < inputFilenames.size(); ++i)
 		{
-			std::cout << errorHandler.GetErrorString();
-			std::cout << std::endl << std::endl;
+			pipeline.AddDocument(inputFilenames[i], outputFilenames[i]);
 		}
+		savedCount = pipeline.Run();
 	}
-	else
+
+	if (!errorHandler.IsSuccessful())
 	{
-		std::cout << errorHandler.GetErrorString();
+		std::cout << std::endl << errorHandler.GetErrorString();
 		std::cout << std::endl << std::endl;
 	}
 
-	SAFE_DELETE(document);
 	FCollada::Release();
-	return 0;
-}
-
-void ProcessGeometryLibrary(FCDGeometryLibrary* library, const ProcessMeshesOptions& options)
-{
-	size_t geometryCount = library->GetEntityCount();
-	for (size_t i = 0; i < geometryCount; ++i)
-	{
-		FCDGeometry* geometry = library->GetEntity(i);
-		if (geometry->IsMesh())
-		{
-			ProcessMesh(geometry->GetMesh(), options);
-		}
-	}
+	return (savedCount == inputFilenames.size()) ? 0 : -1;
 }
 
 void ProcessMesh(FCDGeometryMesh* mesh, const ProcessMeshesOptions& options)
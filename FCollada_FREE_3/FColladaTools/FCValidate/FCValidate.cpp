@@ -11,23 +11,107 @@
 /*
 	FCValidate is a small tool to validate a given COLLADA file against FCollada.
 	TODO: Add schema validation.
+
+	With the -fast option, the files are streamed through the validation of
+	the COLLADA archive instead of being loaded: the memory used does not grow
+	with the size of the files and the files are validated in parallel.
+	The errors are reported with the same codes as the ones of the full load.
 */
 
 #include "StdAfx.h"
 #include "FCDocument/FCDocument.h"
+#include "FUtils/FUCriticalSection.h"
+#include "FUtils/FUThread.h"
+
+// The files validated in parallel, by the -fast option.
+struct FastValidation
+{
+	const char** filenames;
+	FUError::RecordList* results;
+	size_t fileCount;
+
+	size_t nextFile;
+	FUCriticalSection criticalSection;
+};
+
+#ifdef WIN32
+static DWORD WINAPI FastValidationThread(void* parameter)
+#else
+static void* FastValidationThread(void* parameter)
+#endif // WIN32
+{
+	FastValidation* validation = (FastValidation*) parameter;
+	while (true)
+	{
+		validation->criticalSection.Enter();
+		size_t index = validation->nextFile++;
+		validation->criticalSection.Leave();
+		if (index >= validation->fileCount) break;
+
+		fstring filename = TO_FSTRING(validation->filenames[index]);
+		FCollada::ValidateDocumentFromFile(filename.c_str(), validation->results[index]);
+	}
+	return 0;
+}
+
+static void ValidateFast(const char** filenames, size_t fileCount)
+{
+	FastValidation validation;
+	validation.filenames = filenames;
+	validation.results = new FUError::RecordList[fileCount];
+	validation.fileCount = fileCount;
+	validation.nextFile = 0;
+
+	size_t threadCount = min((size_t) FUThread::GetProcessorCount(), fileCount);
+	fm::pvector<FUThread> threads;
+	for (size_t i = 1; i < threadCount; ++i)
+	{
+		FUThread* thread = FUThread::CreateFUThread(FastValidationThread, &validation);
+		if (thread != NULL) threads.push_back(thread);
+	}
+	FastValidationThread(&validation);
+	for (size_t i = 0; i < threads.size(); ++i)
+	{
+		FUThread::ExitFUThread(threads[i]);
+	}
+
+	// Report the errors in the order of the files, as the full load does.
+	for (size_t i = 0; i < fileCount; ++i)
+	{
+		FUErrorSimpleHandler errorHandler;
+		const FUError::RecordList& errors = validation.results[i];
+		for (FUError::RecordList::const_iterator it = errors.begin(); it != errors.end(); ++it)
+		{
+			FUError::Error((*it).level, (*it).code, (*it).line);
+		}
+
+		std::cout << filenames[i] << std::endl;
+		std::cout << errorHandler.GetErrorString();
+		std::cout << std::endl << std::endl;
+	}
+	SAFE_DELETE_ARRAY(validation.results);
+}
 
 int main(int argc, const char* argv[])
 {
-	if (argc < 2)
+	--argc; ++argv;
+	bool isFast = argc > 0 && strcmp(argv[0], "-fast") == 0;
+	if (isFast) { --argc; ++argv; }
+
+	if (argc < 1)
 	{
 		std::cout << "Expecting at least one argument: the filename(s) to validate." << std::endl;
+		std::cout << "Usage: FCValidate [-fast] <filename> [<filename>...]" << std::endl;
 		exit(-1);
 	}
 
 	FCollada::Initialize();
 
-	--argc; ++argv;
-	for (; argc > 0; --argc, ++argv)
+	if (isFast)
+	{
+		ValidateFast(argv, (size_t) argc);
+	}
+	else for (; argc > 0; --argc, ++argv)
 	{
 		FUErrorSimpleHandler errorHandler;
 		FCDocument* document = FCollada::NewTopDocument();
@@ -44,4 +128,3 @@ int main(int argc, const char* argv[])
 
 	return 0;
 }
-
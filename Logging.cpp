@@ -6,53 +6,227 @@
 //
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
 #include <CoreFoundation/CoreFoundation.h>
 
 #include "Logging.h"
 #include "main.h"
 
-void NeonLog(int inLevel, const char* inFormat, ...)
+#define LOG_BUFFER_SIZE     (64 * 1024)
+
+typedef struct
 {
-    va_list argList;
-    
-    va_start(argList, inFormat);
-    NeonLog(inLevel, inFormat, argList);
-    va_end(argList);
+    char    mData[LOG_BUFFER_SIZE];
+    int     mSize;
+} LogBuffer;
+
+// NeonLog fills the current buffer.  Once it is full it becomes the pending buffer, which is written out either
+// right away or by the writer thread, while NeonLog goes on with the other buffer.
+static LogBuffer        sLogBuffers[2];
+static LogBuffer*       sCurrentBuffer = &sLogBuffers[0];
+static LogBuffer*       sPendingBuffer = NULL;
+
+static bool             sAsynchronous = false;
+static bool             sStopWriter = false;
+static bool             sExitHandlerRegistered = false;
+static pthread_t        sWriterThread;
+static pthread_mutex_t  sLogMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   sLogCondition = PTHREAD_COND_INITIALIZER;
+
+static void WriteBuffer(LogBuffer* inBuffer)
+{
+    fwrite(inBuffer->mData, 1, inBuffer->mSize, stdout);
+    fflush(stdout);
+
+    inBuffer->mSize = 0;
 }
 
-void NeonLog(int inLevel, const char* inFormat, va_list inArgList)
+static void* LogWriterThread(void* inParameter)
 {
-    if (inLevel >= gMinMessageLevel)
+    pthread_mutex_lock(&sLogMutex);
+
+    while (true)
     {
-        vprintf(inFormat, inArgList);
+        while ((sPendingBuffer == NULL) && (!sStopWriter))
+        {
+            pthread_cond_wait(&sLogCondition, &sLogMutex);
+        }
+
+        if (sPendingBuffer == NULL)
+        {
+            break;
+        }
+
+        LogBuffer* buffer = sPendingBuffer;
+
+        pthread_mutex_unlock(&sLogMutex);
+        WriteBuffer(buffer);
+        pthread_mutex_lock(&sLogMutex);
+
+        sPendingBuffer = NULL;
+        pthread_cond_broadcast(&sLogCondition);
     }
+
+    pthread_mutex_unlock(&sLogMutex);
+
+    return NULL;
 }
 
-void NeonMessage(const char* inFormat, ...)
+static void SubmitCurrentBuffer()
 {
-    va_list argList;
-    
-    va_start(argList, inFormat);
-    NeonLog(0, inFormat, argList);
-    va_end(argList);
+    if (sCurrentBuffer->mSize == 0)
+    {
+        return;
+    }
+
+    if (!sAsynchronous)
+    {
+        WriteBuffer(sCurrentBuffer);
+        return;
+    }
+
+    pthread_mutex_lock(&sLogMutex);
+
+    while (sPendingBuffer != NULL)
+    {
+        pthread_cond_wait(&sLogCondition, &sLogMutex);
+    }
+
+    sPendingBuffer = sCurrentBuffer;
+    sCurrentBuffer = (sCurrentBuffer == &sLogBuffers[0]) ? &sLogBuffers[1] : &sLogBuffers[0];
+
+    pthread_cond_broadcast(&sLogCondition);
+    pthread_mutex_unlock(&sLogMutex);
 }
 
-void NeonWarning(const char* inFormat, ...)
+static void StopWriterThread()
+{
+    NeonLogFlush();
+
+    if (sAsynchronous)
+    {
+        pthread_mutex_lock(&sLogMutex);
+        sStopWriter = true;
+        pthread_cond_broadcast(&sLogCondition);
+        pthread_mutex_unlock(&sLogMutex);
+
+        pthread_join(sWriterThread, NULL);
+
+        sAsynchronous = false;
+        sStopWriter = false;
+    }
+}
+
+static void RegisterExitHandler()
+{
+    // The exporter exits from deep inside on fatal errors, what was logged up to there must still come out.
+    if (!sExitHandlerRegistered)
+    {
+        atexit(StopWriterThread);
+        sExitHandlerRegistered = true;
+    }
+}
+
+void NeonLogSetAsynchronous(bool inAsynchronous)
+{
+    if (inAsynchronous == sAsynchronous)
+    {
+        return;
+    }
+
+    if (!inAsynchronous)
+    {
+        StopWriterThread();
+        return;
+    }
+
+    NeonLogFlush();
+    RegisterExitHandler();
+
+    sAsynchronous = (pthread_create(&sWriterThread, NULL, LogWriterThread, NULL) == 0);
+}
+
+void NeonLogFlush()
+{
+    SubmitCurrentBuffer();
+
+    if (sAsynchronous)
+    {
+        pthread_mutex_lock(&sLogMutex);
+
+        while (sPendingBuffer != NULL)
+        {
+            pthread_cond_wait(&sLogCondition, &sLogMutex);
+        }
+
+        pthread_mutex_unlock(&sLogMutex);
+    }
+}
+
+void NeonLog(int inLevel, const char* inFormat, ...)
 {
     va_list argList;
-    
+
     va_start(argList, inFormat);
-    NeonLog(1, inFormat, argList);
+    NeonLogV(inLevel, inFormat, argList);
     va_end(argList);
- 
 }
 
-void NeonError(const char* inFormat, ...)
+void NeonLogV(int inLevel, const char* inFormat, va_list inArgList)
 {
+    if (inLevel < gMinMessageLevel)
+    {
+        return;
+    }
+
+    RegisterExitHandler();
+
+    // Format straight into the buffer, and only move to a fresh buffer if the message didn't fit.
     va_list argList;
-    
-    va_start(argList, inFormat);
-    NeonLog(2, inFormat, argList);
+
+    va_copy(argList, inArgList);
+    int available = LOG_BUFFER_SIZE - sCurrentBuffer->mSize;
+    int length = vsnprintf(&sCurrentBuffer->mData[sCurrentBuffer->mSize], available, inFormat, argList);
     va_end(argList);
 
-}
\ No newline at end of file
+    if (length < 0)
+    {
+        return;
+    }
+
+    if (length < available)
+    {
+        sCurrentBuffer->mSize += length;
+    }
+    else
+    {
+        SubmitCurrentBuffer();
+
+        if (length < LOG_BUFFER_SIZE)
+        {
+            va_copy(argList, inArgList);
+            vsnprintf(sCurrentBuffer->mData, LOG_BUFFER_SIZE, inFormat, argList);
+            va_end(argList);
+
+            sCurrentBuffer->mSize = length;
+        }
+        else
+        {
+            // Larger than a whole buffer, this can only be written on its own.
+            NeonLogFlush();
+
+            va_copy(argList, inArgList);
+            vprintf(inFormat, argList);
+            va_end(argList);
+
+            fflush(stdout);
+        }
+    }
+
+    // Errors come out right away, in case the export doesn't make it to the end.
+    if (inLevel == NEON_LOG_LEVEL_ERROR)
+    {
+        NeonLogFlush();
+    }
+}
@@ -10,11 +10,33 @@
 
 #include <stdarg.h>
 
+typedef enum
+{
+    NEON_LOG_LEVEL_MESSAGE,
+    NEON_LOG_LEVEL_WARNING,
+    NEON_LOG_LEVEL_ERROR,
+    NEON_LOG_LEVEL_OUTPUT,      // Always shown: the usage and the reports that were asked for
+    NEON_LOG_LEVEL_MAX
+} NeonLogLevel;
+
+// Messages below this level are dropped.  NEON_LOG_LEVEL_WARNING by default, -verbose lowers it to messages.
+extern int gMinMessageLevel;
+
 void NeonLog(int inLevel, const char* inFormat, ...);
-void NeonLog(int inLevel, const char* inFormat, va_list inArgList);
+void NeonLogV(int inLevel, const char* inFormat, va_list inArgList);
+
+// The level is checked before the arguments are evaluated, so a message that is filtered out costs a comparison.
+#define NEON_LOG(level, ...)        do { if ((level) >= gMinMessageLevel) NeonLog((level), __VA_ARGS__); } while (0)
+
+#define NeonMessage(...)            NEON_LOG(NEON_LOG_LEVEL_MESSAGE, __VA_ARGS__)
+#define NeonWarning(...)            NEON_LOG(NEON_LOG_LEVEL_WARNING, __VA_ARGS__)
+#define NeonError(...)              NEON_LOG(NEON_LOG_LEVEL_ERROR, __VA_ARGS__)
+#define NeonOutput(...)             NEON_LOG(NEON_LOG_LEVEL_OUTPUT, __VA_ARGS__)
 
-void NeonMessage(const char* inFormat, ...);
-void NeonWarning(const char* inFormat, ...);
-void NeonError(const char* inFormat, ...);
+// The log is buffered and written to the standard output when the buffer fills up, on errors, on NeonLogFlush and
+// at exit.  If asynchronous, the buffers are written by a thread of their own.  NeonLog must only be called from
+// one thread at a time.
+void NeonLogSetAsynchronous(bool inAsynchronous);
+void NeonLogFlush();
 
-#endif
\ No newline at end of file
+#endif
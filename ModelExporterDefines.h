@@ -10,7 +10,7 @@
 #include "NeonMath.h"
 
 #define NEON21_MODELEXPORTER_MAJOR_VERSION          (1)
-#define NEON21_MODELEXPORTER_MINOR_VERSION          (0)
+#define NEON21_MODELEXPORTER_MINOR_VERSION          (2)
 
 enum Neon21ModelType
 {
@@ -65,8 +65,22 @@ typedef struct
     float   mBindShapeMatrix[16];
     
     char    mTextureFilename[NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH];
+    
+    int     mNumSubmeshes;
+    
+    int     mTangentStride;     // Tangent xyz and handedness (+1 or -1), after the texcoords in the vertex stream.  0 if there are no tangents.
+    // Vertex stream follows
+    // SubmeshRecords follow
 } ModelHeader;
 
+typedef struct
+{
+    int     mFirstVertex;
+    int     mNumVertices;
+    
+    char    mTextureFilename[NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH];
+} SubmeshRecord;
+
 typedef struct
 {
     int     mMajorVersion;
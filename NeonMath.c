@@ -13,6 +13,32 @@
 #include <stdbool.h>
 #include <assert.h>
 
+// The SIMD kernels only match the scalar code when every multiply and add is rounded on its own.  Keep the compiler
+// from fusing them, here and with -ffp-contract=off in the project, for the compilers that ignore this pragma.
+#pragma STDC FP_CONTRACT OFF
+
+#if defined(NEON_MATH_SIMD_SSE)
+#include <xmmintrin.h>
+
+typedef __m128 SimdVector;
+
+#define SimdLoad(inFloats)              _mm_loadu_ps(inFloats)
+#define SimdStore(outFloats, inVector)  _mm_storeu_ps(outFloats, inVector)
+#define SimdSplat(inFloat)              _mm_set1_ps(inFloat)
+#define SimdAdd(inLeft, inRight)        _mm_add_ps(inLeft, inRight)
+#define SimdMul(inLeft, inRight)        _mm_mul_ps(inLeft, inRight)
+#elif defined(NEON_MATH_SIMD_NEON)
+#include <arm_neon.h>
+
+typedef float32x4_t SimdVector;
+
+#define SimdLoad(inFloats)              vld1q_f32(inFloats)
+#define SimdStore(outFloats, inVector)  vst1q_f32(outFloats, inVector)
+#define SimdSplat(inFloat)              vdupq_n_f32(inFloat)
+#define SimdAdd(inLeft, inRight)        vaddq_f32(inLeft, inRight)
+#define SimdMul(inLeft, inRight)        vmulq_f32(inLeft, inRight)
+#endif
+
 const float EPSILON = 0.001;
 
 void Set(Vector3* inVector, float inX, float inY, float inZ)
@@ -233,7 +259,7 @@ void SubtractRow(Matrix44* inMatrix, int inLeftRow, int inRightRow, float inRigh
     }
 }
 
-void Inverse(Matrix44* inMatrix, Matrix44* outInverse)
+void InverseGaussJordan(Matrix44* inMatrix, Matrix44* outInverse)
 {
     Matrix44 sourceMatrix;
     
@@ -260,7 +286,106 @@ void Inverse(Matrix44* inMatrix, Matrix44* outInverse)
     }
 }
 
-void MatrixMultiply(Matrix44* inLeft, Matrix44* inRight, Matrix44* outResult)
+void Inverse(Matrix44* inMatrix, Matrix44* outInverse)
+{
+    // Cofactors built from the 2x2 determinants of the top and bottom halves.  The inverse of the transpose is the
+    // transpose of the inverse, so this holds whether a[i * 4 + j] is read as row i or as column i.
+    const float* a = inMatrix->mMatrix;
+    
+    float s0 = (a[0] * a[5]) - (a[4] * a[1]);
+    float s1 = (a[0] * a[6]) - (a[4] * a[2]);
+    float s2 = (a[0] * a[7]) - (a[4] * a[3]);
+    float s3 = (a[1] * a[6]) - (a[5] * a[2]);
+    float s4 = (a[1] * a[7]) - (a[5] * a[3]);
+    float s5 = (a[2] * a[7]) - (a[6] * a[3]);
+    
+    float c5 = (a[10] * a[15]) - (a[14] * a[11]);
+    float c4 = (a[9] * a[15]) - (a[13] * a[11]);
+    float c3 = (a[9] * a[14]) - (a[13] * a[10]);
+    float c2 = (a[8] * a[15]) - (a[12] * a[11]);
+    float c1 = (a[8] * a[14]) - (a[12] * a[10]);
+    float c0 = (a[8] * a[13]) - (a[12] * a[9]);
+    
+    float determinant = (s0 * c5) - (s1 * c4) + (s2 * c3) + (s3 * c2) - (s4 * c1) + (s5 * c0);
+    
+    // Singular matrix, there is no inverse.
+    assert(determinant != 0.0f);
+    
+    float invDet = 1.0f / determinant;
+    
+    Matrix44 inverse;
+    float* b = inverse.mMatrix;
+    
+    b[0] = ((a[5] * c5) - (a[6] * c4) + (a[7] * c3)) * invDet;
+    b[1] = ((-a[1] * c5) + (a[2] * c4) - (a[3] * c3)) * invDet;
+    b[2] = ((a[13] * s5) - (a[14] * s4) + (a[15] * s3)) * invDet;
+    b[3] = ((-a[9] * s5) + (a[10] * s4) - (a[11] * s3)) * invDet;
+    
+    b[4] = ((-a[4] * c5) + (a[6] * c2) - (a[7] * c1)) * invDet;
+    b[5] = ((a[0] * c5) - (a[2] * c2) + (a[3] * c1)) * invDet;
+    b[6] = ((-a[12] * s5) + (a[14] * s2) - (a[15] * s1)) * invDet;
+    b[7] = ((a[8] * s5) - (a[10] * s2) + (a[11] * s1)) * invDet;
+    
+    b[8] = ((a[4] * c4) - (a[5] * c2) + (a[7] * c0)) * invDet;
+    b[9] = ((-a[0] * c4) + (a[1] * c2) - (a[3] * c0)) * invDet;
+    b[10] = ((a[12] * s4) - (a[13] * s2) + (a[15] * s0)) * invDet;
+    b[11] = ((-a[8] * s4) + (a[9] * s2) - (a[11] * s0)) * invDet;
+    
+    b[12] = ((-a[4] * c3) + (a[5] * c1) - (a[6] * c0)) * invDet;
+    b[13] = ((a[0] * c3) - (a[1] * c1) + (a[2] * c0)) * invDet;
+    b[14] = ((-a[12] * s3) + (a[13] * s1) - (a[14] * s0)) * invDet;
+    b[15] = ((a[8] * s3) - (a[9] * s1) + (a[10] * s0)) * invDet;
+    
+    CloneMatrix44(&inverse, outInverse);
+}
+
+void InverseAffine(Matrix44* inMatrix, Matrix44* outInverse)
+{
+    const float* m = inMatrix->mMatrix;
+    
+    assert((m[3] == 0.0f) && (m[7] == 0.0f) && (m[11] == 0.0f) && (m[15] == 1.0f));
+    
+    Vector3 column0, column1, column2, translation;
+    
+    Set(&column0, m[0], m[1], m[2]);
+    Set(&column1, m[4], m[5], m[6]);
+    Set(&column2, m[8], m[9], m[10]);
+    Set(&translation, m[12], m[13], m[14]);
+    
+    // The rows of the inverse of the upper 3x3 are the cross products of its columns, over the determinant.
+    Vector3 rows[3];
+    
+    Cross3(&column1, &column2, &rows[0]);
+    Cross3(&column2, &column0, &rows[1]);
+    Cross3(&column0, &column1, &rows[2]);
+    
+    float determinant = Dot3(&column0, &rows[0]);
+    
+    assert(determinant != 0.0f);
+    
+    float invDet = 1.0f / determinant;
+    
+    Matrix44 inverse;
+    
+    for (int row = 0; row < 3; row++)
+    {
+        Mul3(invDet, &rows[row]);
+        
+        inverse.mMatrix[row] = rows[row].mVector[x];
+        inverse.mMatrix[row + 4] = rows[row].mVector[y];
+        inverse.mMatrix[row + 8] = rows[row].mVector[z];
+        inverse.mMatrix[row + 12] = -Dot3(&rows[row], &translation);
+    }
+    
+    inverse.mMatrix[3] = 0.0f;
+    inverse.mMatrix[7] = 0.0f;
+    inverse.mMatrix[11] = 0.0f;
+    inverse.mMatrix[15] = 1.0f;
+    
+    CloneMatrix44(&inverse, outInverse);
+}
+
+void MatrixMultiplyScalar(Matrix44* inLeft, Matrix44* inRight, Matrix44* outResult)
 {
     Matrix44 tempLeft, tempRight;
     
@@ -287,6 +412,105 @@ void MatrixMultiply(Matrix44* inLeft, Matrix44* inRight, Matrix44* outResult)
     }
 }
 
+#if defined(NEON_MATH_SIMD_SSE) || defined(NEON_MATH_SIMD_NEON)
+
+// Each column of the result is the columns of the left matrix weighted by a column of the right one.  The sums are
+// done in the same order as the scalar version, so both give the same results as long as neither is contracted.
+static inline void MatrixMultiplySimd(const float* inLeft, const float* inRight, float* outResult)
+{
+    SimdVector left0 = SimdLoad(&inLeft[0]);
+    SimdVector left1 = SimdLoad(&inLeft[4]);
+    SimdVector left2 = SimdLoad(&inLeft[8]);
+    SimdVector left3 = SimdLoad(&inLeft[12]);
+    
+    for (int col = 0; col < 4; col++)
+    {
+        // Read before writing, outResult may be inRight.
+        SimdVector right0 = SimdSplat(inRight[(col * 4)]);
+        SimdVector right1 = SimdSplat(inRight[(col * 4) + 1]);
+        SimdVector right2 = SimdSplat(inRight[(col * 4) + 2]);
+        SimdVector right3 = SimdSplat(inRight[(col * 4) + 3]);
+        
+        SimdVector result = SimdAdd(SimdAdd(SimdAdd(SimdMul(left0, right0), SimdMul(left1, right1)), SimdMul(left2, right2)), SimdMul(left3, right3));
+        
+        SimdStore(&outResult[col * 4], result);
+    }
+}
+
+void MatrixMultiply(Matrix44* inLeft, Matrix44* inRight, Matrix44* outResult)
+{
+    MatrixMultiplySimd(inLeft->mMatrix, inRight->mMatrix, outResult->mMatrix);
+}
+
+void MatrixMultiplyN(Matrix44* inLeft, Matrix44* inRight, Matrix44* outResults, int inNumMatrices)
+{
+    for (int curMatrix = 0; curMatrix < inNumMatrices; curMatrix++)
+    {
+        MatrixMultiplySimd(inLeft[curMatrix].mMatrix, inRight[curMatrix].mMatrix, outResults[curMatrix].mMatrix);
+    }
+}
+
+void TransformVector4x3(Matrix44* inTransformationMatrix, Vector3* inSourceVector, Vector4* outDestVector)
+{
+    const float* m = inTransformationMatrix->mMatrix;
+    const float* v = inSourceVector->mVector;
+    
+    SimdVector result = SimdAdd(SimdAdd(SimdAdd(SimdMul(SimdLoad(&m[0]), SimdSplat(v[x])), SimdMul(SimdLoad(&m[4]), SimdSplat(v[y]))),
+                                        SimdMul(SimdLoad(&m[8]), SimdSplat(v[z]))), SimdLoad(&m[12]));
+    
+    SimdStore(outDestVector->mVector, result);
+}
+
+void TransformPoints(const Matrix44* inTransformationMatrix, const float* inPoints, float* outPoints, size_t inNumPoints, size_t inStride)
+{
+    const float* m = inTransformationMatrix->mMatrix;
+    
+    SimdVector column0 = SimdLoad(&m[0]);
+    SimdVector column1 = SimdLoad(&m[4]);
+    SimdVector column2 = SimdLoad(&m[8]);
+    SimdVector column3 = SimdLoad(&m[12]);
+    
+    float result[4];
+    
+    for (size_t curPoint = 0; curPoint < inNumPoints; curPoint++)
+    {
+        const float* point = &inPoints[curPoint * inStride];
+        
+        // Only 3 floats are read and written per point, the fourth can belong to the next attribute of the stream.
+        SimdStore(result, SimdAdd(SimdAdd(SimdAdd(SimdMul(column0, SimdSplat(point[x])), SimdMul(column1, SimdSplat(point[y]))),
+                                          SimdMul(column2, SimdSplat(point[z]))), column3));
+        
+        memcpy(&outPoints[curPoint * inStride], result, sizeof(float) * 3);
+    }
+}
+
+#else
+
+void MatrixMultiply(Matrix44* inLeft, Matrix44* inRight, Matrix44* outResult)
+{
+    MatrixMultiplyScalar(inLeft, inRight, outResult);
+}
+
+void MatrixMultiplyN(Matrix44* inLeft, Matrix44* inRight, Matrix44* outResults, int inNumMatrices)
+{
+    for (int curMatrix = 0; curMatrix < inNumMatrices; curMatrix++)
+    {
+        MatrixMultiplyScalar(&inLeft[curMatrix], &inRight[curMatrix], &outResults[curMatrix]);
+    }
+}
+
+void TransformVector4x3(Matrix44* inTransformationMatrix, Vector3* inSourceVector, Vector4* outDestVector)
+{
+    TransformVector4x3Scalar(inTransformationMatrix, inSourceVector, outDestVector);
+}
+
+void TransformPoints(const Matrix44* inTransformationMatrix, const float* inPoints, float* outPoints, size_t inNumPoints, size_t inStride)
+{
+    TransformPointsScalar(inTransformationMatrix, inPoints, outPoints, inNumPoints, inStride);
+}
+
+#endif
+
 void GenerateRotationMatrix(float inAngleDegrees, float inX, float inY, float inZ, Matrix44* outMatrix)
 {
     // Formula taken from http://www.opengl.org/documentation/specs/man_pages/hardcopy/GL/html/gl/rotate.html
@@ -611,7 +835,7 @@ void LoadFromColMajorArrayOfArrays(Matrix44* inMatrix, float inData[][4])
     }
 }
 
-void TransformVector4x3(Matrix44* inTransformationMatrix, Vector3* inSourceVector, Vector4* outDestVector)
+void TransformVector4x3Scalar(Matrix44* inTransformationMatrix, Vector3* inSourceVector, Vector4* outDestVector)
 {
     Vector4 tempSource;
     
@@ -633,6 +857,26 @@ void TransformVector4x3(Matrix44* inTransformationMatrix, Vector3* inSourceVecto
     }
 }
 
+void TransformPointsScalar(const Matrix44* inTransformationMatrix, const float* inPoints, float* outPoints, size_t inNumPoints, size_t inStride)
+{
+    const float* m = inTransformationMatrix->mMatrix;
+    
+    for (size_t curPoint = 0; curPoint < inNumPoints; curPoint++)
+    {
+        const float* point = &inPoints[curPoint * inStride];
+        float* outPoint = &outPoints[curPoint * inStride];
+        
+        float pointX = point[x];
+        float pointY = point[y];
+        float pointZ = point[z];
+        
+        for (int row = 0; row < 3; row++)
+        {
+            outPoint[row] = (m[row] * pointX) + (m[row + 4] * pointY) + (m[row + 8] * pointZ) + m[row + 12];
+        }
+    }
+}
+
 float ClampFloat(float inValue, float inLower, float inUpper)
 {
     float retVal = inValue;
@@ -8,6 +8,15 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+
+// The matrix kernels use SSE or NEON when the compiler targets them.  Define NEON_MATH_NO_SIMD to build the portable
+// versions only.
+#if !defined(NEON_MATH_NO_SIMD) && defined(__SSE__)
+#define NEON_MATH_SIMD_SSE
+#elif !defined(NEON_MATH_NO_SIMD) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define NEON_MATH_SIMD_NEON
+#endif
 
 extern const float EPSILON;
 
@@ -153,6 +162,11 @@ void LoadFromColMajorArrayOfArrays(Matrix44* inMatrix, float inData[][4]);
 
 void TransformVector4x3(Matrix44* inTransformationMatrix, Vector3* inSourceVector, Vector4* outDestVector);
 
+// Transforms inNumPoints points of 3 floats, treated as having a w of 1.  inStride is the number of floats from one point
+// to the next, in both inPoints and outPoints, so that positions can be transformed in place in an interleaved stream.
+// The bottom row of the matrix is ignored, as it is for affine transforms.
+void TransformPoints(const Matrix44* inTransformationMatrix, const float* inPoints, float* outPoints, size_t inNumPoints, size_t inStride);
+
 void CloneMatrix44(Matrix44* inSrc, Matrix44* inDest);
 
 void SetIdentity(Matrix44* inMatrix);
@@ -162,8 +176,20 @@ void DivideRow(Matrix44* inMatrix, int inRow, float inDivisor);
 void SubtractRow(Matrix44* inMatrix, int inLeftRow, int inRightRow, float inRightRowScale, int inDestRow);
 void Inverse(Matrix44* inMatrix, Matrix44* outInverse);
 
+// Only for matrices whose bottom row is 0 0 0 1 (rotation, scale and translation), cheaper than Inverse.
+void InverseAffine(Matrix44* inMatrix, Matrix44* outInverse);
+
 void MatrixMultiply(Matrix44* inLeft, Matrix44* inRight, Matrix44* outResult);
 
+// outResults[i] = inLeft[i] * inRight[i].  The outputs may be the inputs.
+void MatrixMultiplyN(Matrix44* inLeft, Matrix44* inRight, Matrix44* outResults, int inNumMatrices);
+
+// Portable versions of the kernels above, the SSE and NEON ones are checked against them.
+void MatrixMultiplyScalar(Matrix44* inLeft, Matrix44* inRight, Matrix44* outResult);
+void TransformVector4x3Scalar(Matrix44* inTransformationMatrix, Vector3* inSourceVector, Vector4* outDestVector);
+void TransformPointsScalar(const Matrix44* inTransformationMatrix, const float* inPoints, float* outPoints, size_t inNumPoints, size_t inStride);
+void InverseGaussJordan(Matrix44* inMatrix, Matrix44* outInverse);
+
 void GenerateRotationMatrix(float inAngle, float inX, float inY, float inZ, Matrix44* outMatrix);
 void GenerateTranslationMatrix(float inTranslateX, float inTranslateY, float inTranslateZ, Matrix44* outMatrix);
 void GenerateScaleMatrix(float inScaleX, float inScaleY, float inScaleZ, Matrix44* outMatrix);
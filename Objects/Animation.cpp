@@ -1,8 +1,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <assert.h>
 
 #include "Animation.h"
+#include "Logging.h"
 
 #pragma mark Animation
 
@@ -40,8 +42,8 @@ void Animation::SetAnimationName(const char* inName)
 {
     if (strlen(inName) >= ANIMATION_NAME_LENGTH)
     {
-        printf( "Animation name %s is longer than %d characters.  There may be unexpected consequences in the export.\n",
-                inName, ANIMATION_NAME_LENGTH );
+        NeonWarning("Animation name %s is longer than %d characters.  There may be unexpected consequences in the export.\n",
+                    inName, ANIMATION_NAME_LENGTH );
     }
     
     strncpy(mAnimationName, inName, ANIMATION_NAME_LENGTH);
@@ -66,109 +68,71 @@ AnimationCurve* Animation::GetCurve(int inIndex)
 
 AnimationCurve::AnimationCurve()
 {
+    mKeyframeType = NEON21_ANIMATION_KEYFRAME_BEZIER;
 }
 
 AnimationCurve::~AnimationCurve()
 {
-    AnimationKeyframe* curKeyframe;
-    
-    int count = mAnimationKeyframes.size();
+}
+
+void AnimationCurve::ReserveKeyframes(int inNumKeyframes)
+{
+    mTimes.reserve(inNumKeyframes);
+    mValues.reserve(inNumKeyframes);
     
-    while(count != 0)
+    if (mKeyframeType == NEON21_ANIMATION_KEYFRAME_BEZIER)
     {
-        curKeyframe = mAnimationKeyframes.front();
-        
-        mAnimationKeyframes.erase(mAnimationKeyframes.begin());
-        
-        delete curKeyframe;
-        
-        count--;
+        mInTangents.reserve(inNumKeyframes);
+        mOutTangents.reserve(inNumKeyframes);
     }
 }
 
-void AnimationCurve::AddKeyframe(AnimationKeyframe* inKeyframe)
+void AnimationCurve::AddBezierKeyframe(float inTime, float inValue, float inInTangentX, float inInTangentY, float inOutTangentX, float inOutTangentY)
 {
-    mAnimationKeyframes.push_back(inKeyframe);
+    assert(mKeyframeType == NEON21_ANIMATION_KEYFRAME_BEZIER);
+    
+    mTimes.push_back(inTime);
+    mValues.push_back(inValue);
+    
+    Vector2 inTangent = { { inInTangentX, inInTangentY } };
+    Vector2 outTangent = { { inOutTangentX, inOutTangentY } };
+    
+    mInTangents.push_back(inTangent);
+    mOutTangents.push_back(outTangent);
 }
 
 int AnimationCurve::GetNumKeyframes()
 {
-    return mAnimationKeyframes.size();
-}
-
-AnimationKeyframe* AnimationCurve::GetKeyframe(int inIndex)
-{
-    return mAnimationKeyframes.at(inIndex);
-}
-
-#pragma mark AnimationKeyframe
-
-AnimationKeyframe::AnimationKeyframe()
-{
-    mTime = 0.0;
-    mValue = 0.0;
-}
-
-AnimationKeyframe::~AnimationKeyframe()
-{
-}
-
-void AnimationKeyframe::SetTime(float inTime)
-{
-    mTime = inTime;
-}
-
-void AnimationKeyframe::SetValue(float inValue)
-{
-    mValue = inValue;
-}
-
-float AnimationKeyframe::GetTime()
-{
-    return mTime;
-}
-
-float AnimationKeyframe::GetValue()
-{
-    return mValue;
+    return mTimes.size();
 }
 
-KeyframeType AnimationKeyframe::GetKeyframeType()
+KeyframeType AnimationCurve::GetKeyframeType()
 {
     return mKeyframeType;
 }
 
-#pragma mark BezierAnimationKeyframe
-
-BezierAnimationKeyframe::BezierAnimationKeyframe()
-{
-    mKeyframeType = NEON21_ANIMATION_KEYFRAME_BEZIER;
-}
-
-BezierAnimationKeyframe::~BezierAnimationKeyframe()
+float AnimationCurve::GetKeyframeTime(int inIndex)
 {
+    return mTimes.at(inIndex);
 }
 
-void BezierAnimationKeyframe::SetInTangent(float inX, float inY)
+float AnimationCurve::GetKeyframeValue(int inIndex)
 {
-    mInTangent.mVector[x] = inX;
-    mInTangent.mVector[y] = inY;
+    return mValues.at(inIndex);
 }
 
-void BezierAnimationKeyframe::SetOutTangent(float inX, float inY)
+void AnimationCurve::GetKeyframeInTangent(int inIndex, float* outX, float* outY)
 {
-    mOutTangent.mVector[x] = inX;
-    mOutTangent.mVector[y] = inY;
-}
-
-void BezierAnimationKeyframe::GetInTangent(float* outX, float* outY)
-{
-    *outX = mInTangent.mVector[x];
-    *outY = mInTangent.mVector[y];
+    const Vector2& inTangent = mInTangents.at(inIndex);
+    
+    *outX = inTangent.mVector[x];
+    *outY = inTangent.mVector[y];
 }
 
-void BezierAnimationKeyframe::GetOutTangent(float* outX, float* outY)
+void AnimationCurve::GetKeyframeOutTangent(int inIndex, float* outX, float* outY)
 {
-    *outX = mOutTangent.mVector[x];
-    *outY = mOutTangent.mVector[y];
+    const Vector2& outTangent = mOutTangents.at(inIndex);
+    
+    *outX = outTangent.mVector[x];
+    *outY = outTangent.mVector[y];
 }
@@ -5,7 +5,6 @@
 #include <vector>
 
 class Joint;
-class AnimationKeyframe;
 class AnimationCurve;
 
 class Animation
@@ -34,53 +33,32 @@ class Animation
         std::vector<AnimationCurve*> mAnimationCurves;
 };
 
+// Keyframes are stored by value, in contiguous arrays per curve, rather than as
+// one heap object per keyframe.  The keyframe type is shared by the whole curve.
 class AnimationCurve
 {
     public:
         AnimationCurve();
         ~AnimationCurve();
         
-        void AddKeyframe(AnimationKeyframe* inKeyframe);
+        void ReserveKeyframes(int inNumKeyframes);
+        void AddBezierKeyframe(float inTime, float inValue, float inInTangentX, float inInTangentY, float inOutTangentX, float inOutTangentY);
         int  GetNumKeyframes();
-        AnimationKeyframe* GetKeyframe(int inIndex);
-
-    private:
-        std::vector<AnimationKeyframe*> mAnimationKeyframes;
-};
-
-class AnimationKeyframe
-{
-    public:
-        AnimationKeyframe();
-        virtual ~AnimationKeyframe();
-        
-        void SetTime(float inTime);
-        void SetValue(float inValue);
-        
-        float GetTime();
-        float GetValue();
         
         KeyframeType GetKeyframeType();
+        float GetKeyframeTime(int inIndex);
+        float GetKeyframeValue(int inIndex);
         
-    protected:
-        float                   mTime;
-        float                   mValue;
-        KeyframeType            mKeyframeType;
-};
+        void GetKeyframeInTangent(int inIndex, float* outX, float* outY);
+        void GetKeyframeOutTangent(int inIndex, float* outX, float* outY);
 
-class BezierAnimationKeyframe : public AnimationKeyframe
-{
-    public:
-        BezierAnimationKeyframe();
-        virtual ~BezierAnimationKeyframe();
-        
-        void SetInTangent(float inX, float inY);
-        void SetOutTangent(float inX, float inY);
+    private:
+        KeyframeType            mKeyframeType;
         
-        void GetInTangent(float* outX, float* outY);
-        void GetOutTangent(float* outX, float* outY);
+        std::vector<float>      mTimes;
+        std::vector<float>      mValues;
         
-    private:
-        Vector2 mInTangent;
-        Vector2 mOutTangent;
+        // Bezier curves only
+        std::vector<Vector2>    mInTangents;
+        std::vector<Vector2>    mOutTangents;
 };
\ No newline at end of file
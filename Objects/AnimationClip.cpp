@@ -60,16 +60,16 @@ Animation* AnimationClip::GetAnimation(int inAnimationNum)
 
 void AnimationClip::DumpInfo()
 {
-    NeonMessage("Animation Clip name is %s\n", mAnimationClipName);
+    NeonOutput("Animation Clip name is %s\n", mAnimationClipName);
     
     int numAnimations = (int)mAnimationList.size();
-    NeonMessage("Number of animations is %d\n", numAnimations);
+    NeonOutput("Number of animations is %d\n", numAnimations);
     
     for (int curAnimationIndex = 0; curAnimationIndex < numAnimations; curAnimationIndex++)
     {
         Animation* curAnimation = mAnimationList.at(curAnimationIndex);
         
-        NeonMessage("\tAnimation %d name is %s\n", curAnimationIndex, curAnimation->GetAnimationName());
+        NeonOutput("\tAnimation %d name is %s\n", curAnimationIndex, curAnimation->GetAnimationName());
         
         Joint* targetJoint;
         int targetComponent;
@@ -77,37 +77,37 @@ void AnimationClip::DumpInfo()
         
         curAnimation->GetTarget(&targetJoint, &targetComponent, targetName);
         
-        NeonMessage("\t\tTarget joint is %s\n", targetJoint->GetJointName());
-        NeonMessage("\t\tTarget component is ");
+        NeonOutput("\t\tTarget joint is %s\n", targetJoint->GetJointName());
+        NeonOutput("\t\tTarget component is ");
         
         switch(targetComponent)
         {
             case 0:
             {
-                NeonMessage("x");
+                NeonOutput("x");
                 break;
             }
             
             case 1:
             {
-                NeonMessage("y");
+                NeonOutput("y");
                 break;
             }
             
             case 2:
             {
-                NeonMessage("z");
+                NeonOutput("z");
                 break;
             }
             
             case 3:
             {
-                NeonMessage("translation");
+                NeonOutput("translation");
                 break;
             }
         }
         
-        NeonMessage("\n");
+        NeonOutput("\n");
         
         // TODO - Iterate through animation curves
         
@@ -115,25 +115,23 @@ void AnimationClip::DumpInfo()
         
         for (int curCurveIndex = 0; curCurveIndex < numCurves; curCurveIndex++)
         {
-            NeonMessage("\t\tCurve %d\n", curCurveIndex);
+            NeonOutput("\t\tCurve %d\n", curCurveIndex);
             
             AnimationCurve* curCurve = curAnimation->GetCurve(curCurveIndex);
             
             int numKeyframes = curCurve->GetNumKeyframes();
             
-            NeonMessage("\t\tNum keyframes is %d\n", numKeyframes);
+            NeonOutput("\t\tNum keyframes is %d\n", numKeyframes);
             
             for (int keyframeIndex = 0; keyframeIndex < numKeyframes; keyframeIndex++)
             {
-                AnimationKeyframe* curKeyframe = curCurve->GetKeyframe(keyframeIndex);
+                NeonOutput("\t\t\tKeyframe %d type is", keyframeIndex);
                 
-                NeonMessage("\t\t\tKeyframe %d type is", keyframeIndex);
-                
-                switch(curKeyframe->GetKeyframeType())
+                switch(curCurve->GetKeyframeType())
                 {                
                     case NEON21_ANIMATION_KEYFRAME_BEZIER:
                     {
-                        NeonMessage("Bezier");
+                        NeonOutput("Bezier");
                         break;
                     }
                     
@@ -145,24 +143,22 @@ void AnimationClip::DumpInfo()
                     }
                 }
                 
-                NeonMessage("\n");
+                NeonOutput("\n");
                 
-                NeonMessage("\t\t\t\tTime: %f\n", curKeyframe->GetTime());
-                NeonMessage("\t\t\t\tValue: %f\n", curKeyframe->GetValue());
+                NeonOutput("\t\t\t\tTime: %f\n", curCurve->GetKeyframeTime(keyframeIndex));
+                NeonOutput("\t\t\t\tValue: %f\n", curCurve->GetKeyframeValue(keyframeIndex));
                 
-                switch(curKeyframe->GetKeyframeType())
+                switch(curCurve->GetKeyframeType())
                 {
                     case NEON21_ANIMATION_KEYFRAME_BEZIER:
                     {
-                        BezierAnimationKeyframe* bezierKeyframe = (BezierAnimationKeyframe*)curKeyframe;
-                        
                         float inX, inY, outX, outY;
                         
-                        bezierKeyframe->GetInTangent(&inX, &inY);
-                        bezierKeyframe->GetOutTangent(&outX, &outY);
+                        curCurve->GetKeyframeInTangent(keyframeIndex, &inX, &inY);
+                        curCurve->GetKeyframeOutTangent(keyframeIndex, &outX, &outY);
                         
-                        NeonMessage("\t\t\t\tIn Tangent: %f, %f\n", inX, inY);
-                        NeonMessage("\t\t\t\tOut Tangent: %f, %f\n", outX, outY);
+                        NeonOutput("\t\t\t\tIn Tangent: %f, %f\n", inX, inY);
+                        NeonOutput("\t\t\t\tOut Tangent: %f, %f\n", outX, outY);
 
                         break;
                     }
@@ -11,8 +11,23 @@
 #include <assert.h>
 #include <CoreFoundation/CoreFoundation.h>
 
+#include <algorithm>
+
 #include "Mesh.h"
 #include "main.h"
+#include "Profiling.h"
+
+// Frees a buffer unless it is borrowed from the FCDocument, and leaves the pointer ready for new data.
+template <class T> static void ReleaseBuffer(T*& ioBuffer, bool& ioBorrowed)
+{
+    if (!ioBorrowed)
+    {
+        delete [] ioBuffer;
+    }
+    
+    ioBuffer = NULL;
+    ioBorrowed = false;
+}
 
 Mesh::MeshInfo::MeshInfo()
 {
@@ -25,16 +40,28 @@ Mesh::MeshInfo::MeshInfo()
     mNumTexcoordIndices = 0;
     mTexcoordIndices = NULL;
     
+    mNumTangentIndices = 0;
+    mTangentIndices = NULL;
+    
     mNumFaces = 0;
     mFaceVertexCounts = NULL;
+    
+    mBorrowedPositionIndices = false;
+    mBorrowedNormalIndices = false;
+    mBorrowedTexcoordIndices = false;
+    mBorrowedTangentIndices = false;
+    mBorrowedFaceVertexCounts = false;
+    
+    memset(mTextureFilename, 0, NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH);
 }
 
 Mesh::MeshInfo::~MeshInfo()
 {
-    delete mPositionIndices;
-    delete mNormalIndices;
-    delete mTexcoordIndices;
-    delete mFaceVertexCounts;
+    ReleaseBuffer(mPositionIndices, mBorrowedPositionIndices);
+    ReleaseBuffer(mNormalIndices, mBorrowedNormalIndices);
+    ReleaseBuffer(mTexcoordIndices, mBorrowedTexcoordIndices);
+    ReleaseBuffer(mTangentIndices, mBorrowedTangentIndices);
+    ReleaseBuffer(mFaceVertexCounts, mBorrowedFaceVertexCounts);
 }
 
 Mesh::Mesh()
@@ -50,9 +77,19 @@ Mesh::Mesh()
     mNumTexcoordElems = 0;
     mTexcoordElems = NULL;
     mTexcoordStride = 0;
+    
+    mNumTangentElems = 0;
+    mTangentElems = NULL;
+    mTangentStride = 0;
+    
+    mBorrowedPositionElems = false;
+    mBorrowedNormalElems = false;
+    mBorrowedTexcoordElems = false;
+    mBorrowedTangentElems = false;
         
     mNumMatrixCounts = 0;
     mMatrixCounts = NULL;
+    mMatrixOffsets = NULL;
     
     mNumMatrixIndices = 0;
     mMatrixIndices = NULL;
@@ -72,13 +109,15 @@ Mesh::Mesh()
 
 Mesh::~Mesh()
 {
-    delete mPositionElems;
-    delete mNormalElems;
-    delete mTexcoordElems;
+    ReleaseBuffer(mPositionElems, mBorrowedPositionElems);
+    ReleaseBuffer(mNormalElems, mBorrowedNormalElems);
+    ReleaseBuffer(mTexcoordElems, mBorrowedTexcoordElems);
+    ReleaseBuffer(mTangentElems, mBorrowedTangentElems);
         
-    delete mMatrixCounts;
-    delete mMatrixIndices;
-    delete mMatrixWeights;
+    delete [] mMatrixCounts;
+    delete [] mMatrixOffsets;
+    delete [] mMatrixIndices;
+    delete [] mMatrixWeights;
     
     assert(mCurMeshInfo == NULL);
 }
@@ -101,10 +140,7 @@ void Mesh::EndMesh()
 
 void Mesh::AddPositions(uint32_t inNumPositionElems, uint32_t inPositionStride, float* inPositionElems)
 {
-    if (mPositionElems != NULL)
-    {
-        delete mPositionElems;
-    }
+    ReleaseBuffer(mPositionElems, mBorrowedPositionElems);
     
     mNumPositionElems = inNumPositionElems;
     mPositionStride = inPositionStride;
@@ -116,10 +152,7 @@ void Mesh::AddPositions(uint32_t inNumPositionElems, uint32_t inPositionStride,
 
 void Mesh::AddNormals(uint32_t inNumNormalElems, uint32_t inNormalStride, float* inNormalElems)
 {
-    if (mNormalElems != NULL)
-    {
-        delete mNormalElems;
-    }
+    ReleaseBuffer(mNormalElems, mBorrowedNormalElems);
     
     mNumNormalElems = inNumNormalElems;
     mNormalStride = inNormalStride;
@@ -131,10 +164,7 @@ void Mesh::AddNormals(uint32_t inNumNormalElems, uint32_t inNormalStride, float*
 
 void Mesh::AddTexcoords(uint32_t inNumTexcoordElems, uint32_t inTexcoordStride, float* inTexcoordElems)
 {
-    if (mTexcoordElems != NULL)
-    {
-        delete mTexcoordElems;
-    }
+    ReleaseBuffer(mTexcoordElems, mBorrowedTexcoordElems);
     
     mNumTexcoordElems = inNumTexcoordElems;
     mTexcoordStride = inTexcoordStride;
@@ -153,10 +183,7 @@ void Mesh::AddPositionIndices(uint32_t inNumIndices, uint32_t* inIndices)
 {
     assert(mCurMeshInfo != NULL);
     
-    if (mCurMeshInfo->mPositionIndices != NULL)
-    {
-        delete mCurMeshInfo->mPositionIndices;
-    }
+    ReleaseBuffer(mCurMeshInfo->mPositionIndices, mCurMeshInfo->mBorrowedPositionIndices);
     
     mCurMeshInfo->mNumPositionIndices = inNumIndices;
     mCurMeshInfo->mPositionIndices = new uint32_t[inNumIndices];
@@ -168,10 +195,7 @@ void Mesh::AddNormalIndices(uint32_t inNumIndices, uint32_t* inIndices)
 {
     assert(mCurMeshInfo != NULL);
     
-    if (mCurMeshInfo->mNormalIndices != NULL)
-    {
-        delete mCurMeshInfo->mNormalIndices;
-    }
+    ReleaseBuffer(mCurMeshInfo->mNormalIndices, mCurMeshInfo->mBorrowedNormalIndices);
     
     mCurMeshInfo->mNumNormalIndices = inNumIndices;
     mCurMeshInfo->mNormalIndices = new uint32_t[inNumIndices];
@@ -183,10 +207,7 @@ void Mesh::AddTexcoordIndices(uint32_t inNumIndices, uint32_t* inIndices)
 {
     assert(mCurMeshInfo != NULL);
     
-    if (mCurMeshInfo->mTexcoordIndices != NULL)
-    {
-        delete mCurMeshInfo->mTexcoordIndices;
-    }
+    ReleaseBuffer(mCurMeshInfo->mTexcoordIndices, mCurMeshInfo->mBorrowedTexcoordIndices);
     
     mCurMeshInfo->mNumTexcoordIndices = inNumIndices;
     mCurMeshInfo->mTexcoordIndices = new uint32_t[inNumIndices];
@@ -194,25 +215,125 @@ void Mesh::AddTexcoordIndices(uint32_t inNumIndices, uint32_t* inIndices)
     memcpy(mCurMeshInfo->mTexcoordIndices, inIndices, sizeof(uint32_t) * inNumIndices);
 }
 
+void Mesh::BorrowPositions(uint32_t inNumPositionElems, uint32_t inPositionStride, float* inPositionElems)
+{
+    ReleaseBuffer(mPositionElems, mBorrowedPositionElems);
+    
+    mNumPositionElems = inNumPositionElems;
+    mPositionStride = inPositionStride;
+    mPositionElems = inPositionElems;
+    mBorrowedPositionElems = true;
+}
+
+void Mesh::BorrowNormals(uint32_t inNumNormalElems, uint32_t inNormalStride, float* inNormalElems)
+{
+    ReleaseBuffer(mNormalElems, mBorrowedNormalElems);
+    
+    mNumNormalElems = inNumNormalElems;
+    mNormalStride = inNormalStride;
+    mNormalElems = inNormalElems;
+    mBorrowedNormalElems = true;
+}
+
+void Mesh::BorrowTexcoords(uint32_t inNumTexcoordElems, uint32_t inTexcoordStride, float* inTexcoordElems)
+{
+    ReleaseBuffer(mTexcoordElems, mBorrowedTexcoordElems);
+    
+    // AddTexcoords flips V in its copy.  We can't write to the document's data, so the flip
+    // is deferred to CreateInterleavedStream instead.
+    mNumTexcoordElems = inNumTexcoordElems;
+    mTexcoordStride = inTexcoordStride;
+    mTexcoordElems = inTexcoordElems;
+    mBorrowedTexcoordElems = true;
+}
+
+void Mesh::BorrowTangents(uint32_t inNumTangentElems, uint32_t inTangentStride, float* inTangentElems)
+{
+    ReleaseBuffer(mTangentElems, mBorrowedTangentElems);
+    
+    mNumTangentElems = inNumTangentElems;
+    mTangentStride = inTangentStride;
+    mTangentElems = inTangentElems;
+    mBorrowedTangentElems = true;
+}
+
+void Mesh::BorrowPositionIndices(uint32_t inNumIndices, uint32_t* inIndices)
+{
+    assert(mCurMeshInfo != NULL);
+    
+    ReleaseBuffer(mCurMeshInfo->mPositionIndices, mCurMeshInfo->mBorrowedPositionIndices);
+    
+    mCurMeshInfo->mNumPositionIndices = inNumIndices;
+    mCurMeshInfo->mPositionIndices = inIndices;
+    mCurMeshInfo->mBorrowedPositionIndices = true;
+}
+
+void Mesh::BorrowNormalIndices(uint32_t inNumIndices, uint32_t* inIndices)
+{
+    assert(mCurMeshInfo != NULL);
+    
+    ReleaseBuffer(mCurMeshInfo->mNormalIndices, mCurMeshInfo->mBorrowedNormalIndices);
+    
+    mCurMeshInfo->mNumNormalIndices = inNumIndices;
+    mCurMeshInfo->mNormalIndices = inIndices;
+    mCurMeshInfo->mBorrowedNormalIndices = true;
+}
+
+void Mesh::BorrowTexcoordIndices(uint32_t inNumIndices, uint32_t* inIndices)
+{
+    assert(mCurMeshInfo != NULL);
+    
+    ReleaseBuffer(mCurMeshInfo->mTexcoordIndices, mCurMeshInfo->mBorrowedTexcoordIndices);
+    
+    mCurMeshInfo->mNumTexcoordIndices = inNumIndices;
+    mCurMeshInfo->mTexcoordIndices = inIndices;
+    mCurMeshInfo->mBorrowedTexcoordIndices = true;
+}
+
+void Mesh::BorrowTangentIndices(uint32_t inNumIndices, uint32_t* inIndices)
+{
+    assert(mCurMeshInfo != NULL);
+    
+    ReleaseBuffer(mCurMeshInfo->mTangentIndices, mCurMeshInfo->mBorrowedTangentIndices);
+    
+    mCurMeshInfo->mNumTangentIndices = inNumIndices;
+    mCurMeshInfo->mTangentIndices = inIndices;
+    mCurMeshInfo->mBorrowedTangentIndices = true;
+}
+
+void Mesh::BorrowFaceVertexInfo(uint32_t inNumFaces, const uint32_t* inFaceVertexCounts)
+{
+    assert(mMeshState != MESH_STATE_PENDING);
+    
+    ReleaseBuffer(mCurMeshInfo->mFaceVertexCounts, mCurMeshInfo->mBorrowedFaceVertexCounts);
+    
+    mCurMeshInfo->mNumFaces = inNumFaces;
+    mCurMeshInfo->mFaceVertexCounts = const_cast<uint32_t*>(inFaceVertexCounts);
+    mCurMeshInfo->mBorrowedFaceVertexCounts = true;
+}
+
 void Mesh::AddMatrixCounts(uint32_t inNumCounts, uint32_t* inCounts)
 {
-    if (mMatrixCounts != NULL)
-    {
-        delete mMatrixCounts;
-    }
+    delete [] mMatrixCounts;
+    delete [] mMatrixOffsets;
     
     mNumMatrixCounts = inNumCounts;
     mMatrixCounts = new uint32_t[inNumCounts];
+    mMatrixOffsets = new uint32_t[inNumCounts + 1];
     
     memcpy(mMatrixCounts, inCounts, sizeof(uint32_t) * inNumCounts);
+    
+    mMatrixOffsets[0] = 0;
+    
+    for (int i = 0; i < inNumCounts; i++)
+    {
+        mMatrixOffsets[i + 1] = mMatrixOffsets[i] + inCounts[i];
+    }
 }
 
 void Mesh::AddMatrixIndices(uint32_t inNumIndices, uint32_t* inIndices)
 {
-    if (mMatrixIndices != NULL)
-    {
-        delete mMatrixIndices;
-    }
+    delete [] mMatrixIndices;
     
     mNumMatrixIndices = inNumIndices;
     mMatrixIndices = new uint32_t[inNumIndices];
@@ -222,10 +343,7 @@ void Mesh::AddMatrixIndices(uint32_t inNumIndices, uint32_t* inIndices)
 
 void Mesh::AddMatrixWeights(uint32_t inNumWeights, float* inWeights)
 {
-    if (mMatrixWeights != NULL)
-    {
-        delete mMatrixWeights;
-    }
+    delete [] mMatrixWeights;
     
     mNumMatrixWeights = inNumWeights;
     mMatrixWeights = new float[inNumWeights];
@@ -233,6 +351,30 @@ void Mesh::AddMatrixWeights(uint32_t inNumWeights, float* inWeights)
     memcpy(mMatrixWeights, inWeights, sizeof(float) * inNumWeights);
 }
 
+void Mesh::AdoptMatrixInfluences(uint32_t inNumVertices, uint32_t* inOffsets, uint32_t* inIndices, float* inWeights)
+{
+    delete [] mMatrixCounts;
+    delete [] mMatrixOffsets;
+    delete [] mMatrixIndices;
+    delete [] mMatrixWeights;
+    
+    mNumMatrixCounts = inNumVertices;
+    mMatrixOffsets = inOffsets;
+    mMatrixIndices = inIndices;
+    mMatrixWeights = inWeights;
+    
+    mNumMatrixIndices = inOffsets[inNumVertices];
+    mNumMatrixWeights = inOffsets[inNumVertices];
+    
+    // The counts are modified when the interleaved stream is created, so keep them separately from the offsets
+    mMatrixCounts = new uint32_t[inNumVertices];
+    
+    for (int i = 0; i < inNumVertices; i++)
+    {
+        mMatrixCounts[i] = inOffsets[i + 1] - inOffsets[i];
+    }
+}
+
 uint32_t Mesh::GetMaxMatrixCount()
 {
     int maxCount = 0;
@@ -248,8 +390,15 @@ uint32_t Mesh::GetMaxMatrixCount()
     return maxCount;
 }
 
+uint32_t Mesh::GetTangentStreamStride()
+{
+    return (mTangentStride == 0) ? 0 : TANGENT_STREAM_STRIDE;
+}
+
 bool Mesh::Validate(char* outErrorString, int inErrorStringSize)
 {
+    PROFILE_SCOPE(PROFILE_TIMER_MESH_VALIDATE);
+    
     // Validate strides
     
     if (mNumPositionElems != 0)
@@ -279,6 +428,21 @@ bool Mesh::Validate(char* outErrorString, int inErrorStringSize)
         }
     }
     
+    if (mNumTangentElems != 0)
+    {
+        if (mTangentStride < 3)
+        {
+            snprintf(outErrorString, inErrorStringSize, "Non-zero number of tangent elements, but the tangent stride is less than 3.  This is not allowed.\n");
+            return false;
+        }
+        
+        if ((mNormalStride < 3) || (mTexcoordStride < 2))
+        {
+            snprintf(outErrorString, inErrorStringSize, "Tangents require 3 component normals and 2 component texcoords.\n");
+            return false;
+        }
+    }
+    
     if (mNumMatrixCounts != 0)
     {
         if (mNumMatrixCounts != (mNumPositionElems / mPositionStride))
@@ -312,6 +476,7 @@ bool Mesh::Validate(char* outErrorString, int inErrorStringSize)
     int positionElemRemainder = (mPositionStride == 0) ? 0 : mNumPositionElems % mPositionStride;
     int normalElemRemainder = (mNormalStride == 0) ? 0 : mNumNormalElems % mNormalStride;
     int texcoordElemRemainder = (mTexcoordStride == 0) ? 0 : mNumTexcoordElems % mTexcoordStride;
+    int tangentElemRemainder = (mTangentStride == 0) ? 0 : mNumTangentElems % mTangentStride;
     
     if (positionElemRemainder != 0)
     {
@@ -331,12 +496,19 @@ bool Mesh::Validate(char* outErrorString, int inErrorStringSize)
         snprintf(outErrorString, inErrorStringSize, "Non-integral number of texcoord vectors in the texcoord stream.\n");
         return false;
     }
+    
+    if (tangentElemRemainder != 0)
+    {
+        snprintf(outErrorString, inErrorStringSize, "Non-integral number of tangent vectors in the tangent stream.\n");
+        return false;
+    }
 
     // Ensure the indices never go out of range
     
     int numPositionVectors = (mPositionStride == 0) ? 0 : mNumPositionElems / mPositionStride;
     int numNormalVectors = (mNormalStride == 0) ? 0 : mNumNormalElems / mNormalStride;
     int numTexcoordVectors = (mTexcoordStride == 0) ? 0 : mNumTexcoordElems / mTexcoordStride;
+    int numTangentVectors = (mTangentStride == 0) ? 0 : mNumTangentElems / mTangentStride;
     
     int numMeshInfo = mMeshInfo.size();
     
@@ -370,20 +542,30 @@ bool Mesh::Validate(char* outErrorString, int inErrorStringSize)
                 return false;
             }
         }
+        
+        for (int i = 0; i < curMeshInfo->mNumTangentIndices; i++)
+        {
+            if (curMeshInfo->mTangentIndices[i] >= numTangentVectors)
+            {
+                snprintf(outErrorString, inErrorStringSize, "Tangent index out of range.\n");
+                return false;
+            }
+        }
 
         // Ensure that the number of indices for each attribute type are the same
         
-        int compare[3];
+        int compare[4];
         
         compare[0] = curMeshInfo->mNumPositionIndices;
         compare[1] = curMeshInfo->mNumNormalIndices;
         compare[2] = curMeshInfo->mNumTexcoordIndices;
+        compare[3] = curMeshInfo->mNumTangentIndices;
         
         bool compareSuccess = true;
         
-        for (int left = 0; left < 3; left++)
+        for (int left = 0; left < 4; left++)
         {
-            for (int right = 0; right < 3; right++)
+            for (int right = 0; right < 4; right++)
             {
                 int leftVal = compare[left];
                 int rightVal = compare[right];
@@ -402,7 +584,7 @@ bool Mesh::Validate(char* outErrorString, int inErrorStringSize)
 loopExit:
         if (!compareSuccess)
         {
-            snprintf(outErrorString, inErrorStringSize, "Unequal numbers of position, normal, and texcoord indices.\n");
+            snprintf(outErrorString, inErrorStringSize, "Unequal numbers of position, normal, texcoord, and tangent indices.\n");
             return false;
         }
         
@@ -470,6 +652,8 @@ void Mesh::AddFaceVertexInfo(uint32_t inNumFaces, const uint32_t* inFaceVertexCo
 {
     assert(mMeshState != MESH_STATE_PENDING);
     
+    ReleaseBuffer(mCurMeshInfo->mFaceVertexCounts, mCurMeshInfo->mBorrowedFaceVertexCounts);
+    
     mCurMeshInfo->mNumFaces = inNumFaces;
     mCurMeshInfo->mFaceVertexCounts = new uint32_t[mCurMeshInfo->mNumFaces];
     
@@ -488,10 +672,16 @@ void Mesh::GetBindShapeMatrix(Matrix44* outBindShapeMatrix)
 
 void Mesh::CreateInterleavedStream(unsigned char** outStream, uint32_t* outNumVertices, uint32_t* outStride)
 {
+    PROFILE_SCOPE(PROFILE_TIMER_CREATE_INTERLEAVED_STREAM);
+    
     assert(mMeshState == MESH_STATE_PENDING);
     
     *outNumVertices = 0;
     
+    // Group polygon groups that share a texture, so that each texture is a single submesh range.  The sort is stable
+    // so that single material meshes keep their original vertex order.
+    std::stable_sort(mMeshInfo.begin(), mMeshInfo.end(), MeshInfoTextureComparator);
+    
     for (std::vector<MeshInfo*>::iterator curMeshInfoIterator = mMeshInfo.begin(); curMeshInfoIterator != mMeshInfo.end(); curMeshInfoIterator++)
     {
         if ((*curMeshInfoIterator)->mNumFaces != 0)
@@ -511,7 +701,7 @@ void Mesh::CreateInterleavedStream(unsigned char** outStream, uint32_t* outNumVe
     
     // Position elems, normal elems, texcoord elems, and number of weights are all floats
     // Then we have matrix indices that are unsigned bytes
-    int totalStride = (mPositionStride + mNormalStride + mTexcoordStride + matrixCount) * sizeof(float) + matrixCount;
+    int totalStride = (mPositionStride + mNormalStride + mTexcoordStride + GetTangentStreamStride() + matrixCount) * sizeof(float) + matrixCount;
     
     // 4 byte align the stride
     totalStride = (totalStride + 3) & 0xFFFFFFFC;
@@ -521,21 +711,6 @@ void Mesh::CreateInterleavedStream(unsigned char** outStream, uint32_t* outNumVe
     *outStream = new unsigned char[totalStride * (*outNumVertices)];
     memset(*outStream, 0, totalStride * (*outNumVertices));
     
-    uint32_t* matrixOffsetList = NULL;
-    
-    if (mNumMatrixCounts != 0)
-    {
-        matrixOffsetList = new uint32_t[mNumMatrixCounts];
-        int curOffset = 0;
-
-        for (int i = 0; i < mNumMatrixCounts; i++)
-        {
-            matrixOffsetList[i] = curOffset;
-            
-            curOffset += mMatrixCounts[i];
-        }
-    }
-    
     int numMeshes = mMeshInfo.size();
     int vertexWriteIndex = 0;
     
@@ -561,10 +736,47 @@ void Mesh::CreateInterleavedStream(unsigned char** outStream, uint32_t* outNumVe
             
             if (mTexcoordStride != 0)
             {
-                memcpy(vertexWritePtr, &mTexcoordElems[curMeshInfo->mTexcoordIndices[curVertex] * mTexcoordStride], sizeof(float) * mTexcoordStride);
+                uint32_t texcoordBase = curMeshInfo->mTexcoordIndices[curVertex] * mTexcoordStride;
+                
+                if (mBorrowedTexcoordElems)
+                {
+                    float* texcoordWritePtr = (float*)vertexWritePtr;
+                    
+                    for (int i = 0; i < mTexcoordStride; i++)
+                    {
+                        texcoordWritePtr[i] = GetExportedTexcoord(texcoordBase + i);
+                    }
+                }
+                else
+                {
+                    memcpy(vertexWritePtr, &mTexcoordElems[texcoordBase], sizeof(float) * mTexcoordStride);
+                }
+                
                 vertexWritePtr += (mTexcoordStride * sizeof(float));
             }
             
+            if (mTangentStride != 0)
+            {
+                float* tangentWritePtr = (float*)vertexWritePtr;
+                
+                if (curMeshInfo->mTangentIndices != NULL)
+                {
+                    float* tangent = &mTangentElems[curMeshInfo->mTangentIndices[curVertex] * mTangentStride];
+                    float* normal = &mNormalElems[curMeshInfo->mNormalIndices[curVertex] * mNormalStride];
+                    
+                    memcpy(tangentWritePtr, tangent, sizeof(float) * 3);
+                    tangentWritePtr[3] = CalculateTangentHandedness(curMeshInfo, curVertex, normal, tangent);
+                }
+                else
+                {
+                    // This polygon group doesn't use the texcoords that the tangents were generated from
+                    memset(tangentWritePtr, 0, sizeof(float) * TANGENT_STREAM_STRIDE);
+                    tangentWritePtr[3] = 1.0f;
+                }
+                
+                vertexWritePtr += (TANGENT_STREAM_STRIDE * sizeof(float));
+            }
+            
             if (mNumMatrixCounts != 0)
             {
                 int index = curMeshInfo->mPositionIndices[curVertex];
@@ -578,7 +790,7 @@ void Mesh::CreateInterleavedStream(unsigned char** outStream, uint32_t* outNumVe
 				
 				for (int i = 0; i < mMatrixCounts[index]; i++)
 				{
-					weightSum += mMatrixWeights[matrixOffsetList[index] + i];
+					weightSum += mMatrixWeights[mMatrixOffsets[index] + i];
 				}
 								                
                 if ((gMaxNumWeights == 0) || (mMatrixCounts[index] <= matrixCount))
@@ -594,7 +806,7 @@ void Mesh::CreateInterleavedStream(unsigned char** outStream, uint32_t* outNumVe
 					}
 					else
 					{
-						memcpy(vertexWritePtr, &mMatrixWeights[matrixOffsetList[index]], mMatrixCounts[index] * sizeof(float));
+						memcpy(vertexWritePtr, &mMatrixWeights[mMatrixOffsets[index]], mMatrixCounts[index] * sizeof(float));
 						vertexWritePtr += (mMatrixCounts[index] * sizeof(float));
 					}
                 }
@@ -612,8 +824,8 @@ void Mesh::CreateInterleavedStream(unsigned char** outStream, uint32_t* outNumVe
 						// Find the matrixCount smallest influences
 											
 						indexWeightPairs = new IndexWeightPair[mMatrixCounts[index]];
-						float* weightsBase = &mMatrixWeights[matrixOffsetList[index]];
-						unsigned int* jointIndicesBase = &mMatrixIndices[matrixOffsetList[index]];
+						float* weightsBase = &mMatrixWeights[mMatrixOffsets[index]];
+						unsigned int* jointIndicesBase = &mMatrixIndices[mMatrixOffsets[index]];
 
 						// First copy all indices and weights
 						
@@ -663,7 +875,7 @@ void Mesh::CreateInterleavedStream(unsigned char** outStream, uint32_t* outNumVe
                     {
                         if (indexWeightPairs == NULL)
                         {
-                            *vertexWritePtr = mMatrixIndices[matrixOffsetList[index] + curIndex];
+                            *vertexWritePtr = mMatrixIndices[mMatrixOffsets[index] + curIndex];
                         }
                         else
                         {
@@ -684,8 +896,6 @@ void Mesh::CreateInterleavedStream(unsigned char** outStream, uint32_t* outNumVe
             vertexWriteIndex++;
         }
     }
-    
-    delete [] matrixOffsetList;
 }
 
 int Mesh::IndexWeightComparator(const void* inLeft, const void* inRight)
@@ -705,6 +915,115 @@ int Mesh::IndexWeightComparator(const void* inLeft, const void* inRight)
     return 0;
 }
 
+// Texcoords are exported with V flipped (every odd element of the texcoord stream).  Borrowed texcoords are flipped as they're read.
+float Mesh::GetExportedTexcoord(uint32_t inElementIndex)
+{
+    float texcoord = mTexcoordElems[inElementIndex];
+    
+    if (mBorrowedTexcoordElems && (inElementIndex & 1))
+    {
+        texcoord = 1.0 - texcoord;
+    }
+    
+    return texcoord;
+}
+
+// Returns +1 if the texture space is right handed, -1 if it is mirrored.  The bitangent is then cross(normal, tangent) * handedness.
+// Like MikkTSpace, handedness is per triangle and uses the texcoords as exported.  Index buffers are triangle lists by now.
+float Mesh::CalculateTangentHandedness(MeshInfo* inMeshInfo, int inTriangleVertex, float* inNormal, float* inTangent)
+{
+    int firstVertex = inTriangleVertex - (inTriangleVertex % 3);
+    
+    if ((firstVertex + 2) >= inMeshInfo->mNumPositionIndices)
+    {
+        return 1.0f;
+    }
+    
+    float* positions[3];
+    float  texcoords[3][2];
+    
+    for (int i = 0; i < 3; i++)
+    {
+        positions[i] = &mPositionElems[inMeshInfo->mPositionIndices[firstVertex + i] * mPositionStride];
+        
+        uint32_t texcoordBase = inMeshInfo->mTexcoordIndices[firstVertex + i] * mTexcoordStride;
+        texcoords[i][0] = GetExportedTexcoord(texcoordBase);
+        texcoords[i][1] = GetExportedTexcoord(texcoordBase + 1);
+    }
+    
+    float du1 = texcoords[1][0] - texcoords[0][0];
+    float dv1 = texcoords[1][1] - texcoords[0][1];
+    float du2 = texcoords[2][0] - texcoords[0][0];
+    float dv2 = texcoords[2][1] - texcoords[0][1];
+    
+    float determinant = du1 * dv2 - du2 * dv1;
+    
+    if (determinant == 0.0f)
+    {
+        return 1.0f;
+    }
+    
+    // Bitangent derived from the texture mapping (dP/dv), up to the positive scale 1 / |determinant|
+    float bitangent[3];
+    
+    for (int i = 0; i < 3; i++)
+    {
+        float edge1 = positions[1][i] - positions[0][i];
+        float edge2 = positions[2][i] - positions[0][i];
+        
+        bitangent[i] = (edge2 * du1 - edge1 * du2) * ((determinant < 0.0f) ? -1.0f : 1.0f);
+    }
+    
+    // Compare against the bitangent implied by the normal and tangent
+    float crossX = inNormal[1] * inTangent[2] - inNormal[2] * inTangent[1];
+    float crossY = inNormal[2] * inTangent[0] - inNormal[0] * inTangent[2];
+    float crossZ = inNormal[0] * inTangent[1] - inNormal[1] * inTangent[0];
+    
+    float dot = crossX * bitangent[0] + crossY * bitangent[1] + crossZ * bitangent[2];
+    
+    return (dot < 0.0f) ? -1.0f : 1.0f;
+}
+
+bool Mesh::MeshInfoTextureComparator(const MeshInfo* inLeft, const MeshInfo* inRight)
+{
+    return strncmp(inLeft->mTextureFilename, inRight->mTextureFilename, NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH) < 0;
+}
+
+void Mesh::CreateSubmeshRecords(SubmeshRecord** outRecords, uint32_t* outNumRecords)
+{
+    assert(mMeshState == MESH_STATE_PENDING);
+    
+    int numMeshes = mMeshInfo.size();
+    
+    *outRecords = new SubmeshRecord[numMeshes];
+    *outNumRecords = 0;
+    
+    int firstVertex = 0;
+    
+    for (int curMesh = 0; curMesh < numMeshes; curMesh++)
+    {
+        MeshInfo* curMeshInfo = mMeshInfo.at(curMesh);
+        SubmeshRecord* lastRecord = (*outNumRecords == 0) ? NULL : &(*outRecords)[*outNumRecords - 1];
+        
+        if ((lastRecord != NULL) && (strncmp(lastRecord->mTextureFilename, curMeshInfo->mTextureFilename, NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH) == 0))
+        {
+            lastRecord->mNumVertices += curMeshInfo->mNumPositionIndices;
+        }
+        else
+        {
+            SubmeshRecord* newRecord = &(*outRecords)[*outNumRecords];
+            
+            newRecord->mFirstVertex = firstVertex;
+            newRecord->mNumVertices = curMeshInfo->mNumPositionIndices;
+            memcpy(newRecord->mTextureFilename, curMeshInfo->mTextureFilename, NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH);
+            
+            (*outNumRecords)++;
+        }
+        
+        firstVertex += curMeshInfo->mNumPositionIndices;
+    }
+}
+
 void Mesh::CreateSplittedIndexBuffers(MeshInfo* inMeshInfo)
 {
     uint32_t* splittedPositionBuffer;
@@ -714,7 +1033,7 @@ void Mesh::CreateSplittedIndexBuffers(MeshInfo* inMeshInfo)
     
     inMeshInfo->mNumPositionIndices = numSplittedPositionElements;
     
-    delete inMeshInfo->mPositionIndices;
+    ReleaseBuffer(inMeshInfo->mPositionIndices, inMeshInfo->mBorrowedPositionIndices);
     inMeshInfo->mPositionIndices = splittedPositionBuffer;
     
     
@@ -725,7 +1044,7 @@ void Mesh::CreateSplittedIndexBuffers(MeshInfo* inMeshInfo)
     
     inMeshInfo->mNumNormalIndices = numSplittedNormalElements;
     
-    delete inMeshInfo->mNormalIndices;
+    ReleaseBuffer(inMeshInfo->mNormalIndices, inMeshInfo->mBorrowedNormalIndices);
     inMeshInfo->mNormalIndices = splittedNormalBuffer;
     
     
@@ -736,8 +1055,22 @@ void Mesh::CreateSplittedIndexBuffers(MeshInfo* inMeshInfo)
     
     inMeshInfo->mNumTexcoordIndices = numSplittedTexcoordElements;
     
-    delete inMeshInfo->mTexcoordIndices;
+    ReleaseBuffer(inMeshInfo->mTexcoordIndices, inMeshInfo->mBorrowedTexcoordIndices);
     inMeshInfo->mTexcoordIndices = splittedTexcoordBuffer;
+    
+    
+    if (inMeshInfo->mTangentIndices != NULL)
+    {
+        uint32_t* splittedTangentBuffer;
+        uint32_t  numSplittedTangentElements;
+        
+        SplitBuffer(inMeshInfo->mTangentIndices, inMeshInfo->mNumTangentIndices, &splittedTangentBuffer, &numSplittedTangentElements, inMeshInfo);
+        
+        inMeshInfo->mNumTangentIndices = numSplittedTangentElements;
+        
+        ReleaseBuffer(inMeshInfo->mTangentIndices, inMeshInfo->mBorrowedTangentIndices);
+        inMeshInfo->mTangentIndices = splittedTangentBuffer;
+    }
 }
 
 void Mesh::SplitBuffer( uint32_t* inInputIndexBuffer, uint32_t inInputNumElems,
@@ -802,3 +1135,10 @@ void Mesh::AddTextureName(char* inTextureName)
 {
     strncpy(mTextureFilename, inTextureName, NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH);
 }
+
+void Mesh::AddSubmeshTextureName(char* inTextureName)
+{
+    assert(mCurMeshInfo != NULL);
+    
+    strncpy(mCurMeshInfo->mTextureFilename, inTextureName, NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH);
+}
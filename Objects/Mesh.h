@@ -36,10 +36,22 @@ class Mesh
                 
                 uint32_t    mNumTexcoordIndices;
                 uint32_t*   mTexcoordIndices;
+                
+                uint32_t    mNumTangentIndices;
+                uint32_t*   mTangentIndices;
 
                 uint32_t    mNumFaces;          // Never touched if we just get a triangle list.  Only non-zero if we have to split non-triangular primitives.
                 uint32_t*   mFaceVertexCounts;  // A number for each face, for each face this specifies the number of vertices.  So 3 would be a triangle,
                                                 // 4 a quad, 5 a pentagon, and so forth.
+                
+                // Borrowed buffers belong to the FCDocument and are never modified or deleted by the mesh.
+                bool        mBorrowedPositionIndices;
+                bool        mBorrowedNormalIndices;
+                bool        mBorrowedTexcoordIndices;
+                bool        mBorrowedTangentIndices;
+                bool        mBorrowedFaceVertexCounts;
+                
+                char        mTextureFilename[NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH];     // Texture of this polygon group's material
         };
         
         Mesh();
@@ -56,16 +68,38 @@ class Mesh
         void AddNormalIndices(uint32_t inNumIndices, uint32_t* inIndices);
         void AddTexcoordIndices(uint32_t inNumIndices, uint32_t* inIndices);
         
+        // The Borrow functions reference the caller's buffers instead of copying them.  The buffers must outlive
+        // the mesh (eg: data owned by the FCDocument), and are never written to.  Buffers that need modification are
+        // copied on write, and the texcoord V flip is applied when the interleaved stream is created.
+        void BorrowPositions(uint32_t inNumPositionElems, uint32_t inPositionStride, float* inPositionElems);
+        void BorrowNormals(uint32_t inNumNormalElems, uint32_t inNormalStride, float* inNormalElems);
+        void BorrowTexcoords(uint32_t inNumTexcoordElems, uint32_t inTexcoordStride, float* inTexcoordElems);
+        void BorrowTangents(uint32_t inNumTangentElems, uint32_t inTangentStride, float* inTangentElems);
+        
+        void BorrowPositionIndices(uint32_t inNumIndices, uint32_t* inIndices);
+        void BorrowNormalIndices(uint32_t inNumIndices, uint32_t* inIndices);
+        void BorrowTexcoordIndices(uint32_t inNumIndices, uint32_t* inIndices);
+        void BorrowTangentIndices(uint32_t inNumIndices, uint32_t* inIndices);
+        void BorrowFaceVertexInfo(uint32_t inNumFaces, const uint32_t* inFaceVertexCounts);
+        
         void AddMatrixCounts(uint32_t inNumCounts, uint32_t* inCounts);
         void AddMatrixIndices(uint32_t inNumIndices, uint32_t* inIndices);
         void AddMatrixWeights(uint32_t inNumWeights, float* inWeights);
         
+        // Takes ownership of skin influences packed in compressed rows (see FCDSkinController::GetPackedInfluences).
+        // The influences for vertex i are at [inOffsets[i], inOffsets[i + 1]).  All buffers must be allocated with new [].
+        void AdoptMatrixInfluences(uint32_t inNumVertices, uint32_t* inOffsets, uint32_t* inIndices, float* inWeights);
+        
         void AddFaceVertexInfo(uint32_t inNumFaces, const uint32_t* inFaceVertexCounts);
         
         void SetBindShapeMatrix(Matrix44* inBindShapeMatrix);
         void GetBindShapeMatrix(Matrix44* outBindShapeMatrix);
         
         uint32_t GetMaxMatrixCount();
+        
+        // Tangents are written as xyz followed by the handedness of the texture space
+        static const int TANGENT_STREAM_STRIDE = 4;
+        uint32_t GetTangentStreamStride();
                                         
         static const int VALIDATION_STRING_LENGTH = 512;
         bool Validate(char* outErrorString, int inErrorStringSize);
@@ -79,6 +113,11 @@ class Mesh
         void SetModelName(const char* inName);
         
         void AddTextureName(char* inTextureName);
+        void AddSubmeshTextureName(char* inTextureName);
+        
+        // Must be called after CreateInterleavedStream, which groups the MeshInfos by texture.  Adjacent MeshInfos
+        // that share a texture are merged into a single record.  Memory is allocated with new [].
+        void CreateSubmeshRecords(SubmeshRecord** outRecords, uint32_t* outNumRecords);
         
         float*      mPositionElems;
         uint32_t    mNumPositionElems;
@@ -91,10 +130,21 @@ class Mesh
         float*      mTexcoordElems;
         uint32_t    mNumTexcoordElems;
         uint32_t    mTexcoordStride;
+        
+        float*      mTangentElems;
+        uint32_t    mNumTangentElems;
+        uint32_t    mTangentStride;
+        
+        bool        mBorrowedPositionElems;
+        bool        mBorrowedNormalElems;
+        bool        mBorrowedTexcoordElems;     // Borrowed texcoords haven't been V flipped yet
+        bool        mBorrowedTangentElems;
                 
         uint32_t*   mMatrixCounts;      // Matrix / weight counts per vertex
         uint32_t    mNumMatrixCounts;   // Should be the same as the number of vertices
         
+        uint32_t*   mMatrixOffsets;     // Offset of the first matrix index / weight per vertex, mNumMatrixCounts + 1 entries
+        
         uint32_t*   mMatrixIndices;     // Joint indices per vertex
         uint32_t    mNumMatrixIndices;  // Number of matrix indices in total (summed over all vertices)
         
@@ -121,5 +171,9 @@ class Mesh
             float weight;
         };
 
+        float GetExportedTexcoord(uint32_t inElementIndex);
+        float CalculateTangentHandedness(MeshInfo* inMeshInfo, int inTriangleVertex, float* inNormal, float* inTangent);
+        
         static int IndexWeightComparator(const void* inLeft, const void* inRight);
+        static bool MeshInfoTextureComparator(const MeshInfo* inLeft, const MeshInfo* inRight);
 };
\ No newline at end of file
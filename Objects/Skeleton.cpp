@@ -1,6 +1,7 @@
 #include <assert.h>
 
 #include "Skeleton.h"
+#include "Logging.h"
 
 int Joint::mNextIdentifier = 0;
 
@@ -21,7 +22,7 @@ TransformRecord sExpectedJoints[] = { { TRANSFORM_TYPE_MATRIX,      { 1.0, 0.0,
                                       { TRANSFORM_TYPE_ROTATION,    { 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 }, "rotateAxisY" },
                                       { TRANSFORM_TYPE_ROTATION,    { 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 }, "rotateAxisX" } };
 
-#define INSERT_TABS     for (int i = 0; i < numTabs; i++) printf("\t");
+#define INSERT_TABS     for (int i = 0; i < numTabs; i++) NeonOutput("\t");
 
 Joint::Joint()
 {
@@ -57,67 +58,67 @@ static int numTabs = 0;
 void Joint::PrintHierarchy()
 {
     INSERT_TABS
-    printf("--------------------------------\n");
+    NeonOutput("--------------------------------\n");
 
     INSERT_TABS
-    printf("%s, %d\n", mJointName, mID);
+    NeonOutput("%s, %d\n", mJointName, mID);
     
     for (int curTransformIndex = 0; curTransformIndex < mTransforms.size(); curTransformIndex++)
     {
         TransformRecord* curTransform = mTransforms.at(curTransformIndex);
                 
         INSERT_TABS
-        printf("Transform %d:\n", curTransformIndex);
+        NeonOutput("Transform %d:\n", curTransformIndex);
         
         INSERT_TABS
-        printf("Type is %s\n", sTransformTypeStrings[curTransform->mTransformType]);
+        NeonOutput("Type is %s\n", sTransformTypeStrings[curTransform->mTransformType]);
         
         switch(curTransform->mTransformType)
         {
             case TRANSFORM_TYPE_ROTATION:
             {
                 INSERT_TABS
-                printf("Axis %.2f, Angle %.2f, %.2f, %.2f\n",   curTransform->mTransformData.mMatrix[3], 
-                                                                curTransform->mTransformData.mMatrix[0],
-                                                                curTransform->mTransformData.mMatrix[1],
-                                                                curTransform->mTransformData.mMatrix[2]);
+                NeonOutput("Axis %.2f, Angle %.2f, %.2f, %.2f\n",   curTransform->mTransformData.mMatrix[3], 
+                                                                    curTransform->mTransformData.mMatrix[0],
+                                                                    curTransform->mTransformData.mMatrix[1],
+                                                                    curTransform->mTransformData.mMatrix[2]);
                 break;
             }
             
             case TRANSFORM_TYPE_TRANSLATION:
             {
                 INSERT_TABS
-                printf("Translation %.2f, %.2f, %.2f\n",    curTransform->mTransformData.mMatrix[0], 
-                                                            curTransform->mTransformData.mMatrix[1],
-                                                            curTransform->mTransformData.mMatrix[2]);
+                NeonOutput("Translation %.2f, %.2f, %.2f\n",    curTransform->mTransformData.mMatrix[0], 
+                                                                curTransform->mTransformData.mMatrix[1],
+                                                                curTransform->mTransformData.mMatrix[2]);
                 break;
             }
             
             case TRANSFORM_TYPE_MATRIX:
             {
                 INSERT_TABS
-                printf("Matrix:\t%f, %f, %f, %f\n", curTransform->mTransformData.mMatrix[0],
-                                                    curTransform->mTransformData.mMatrix[4],
-                                                    curTransform->mTransformData.mMatrix[8],
-                                                    curTransform->mTransformData.mMatrix[12]);
+                NeonOutput("Matrix:\t%f, %f, %f, %f\n", curTransform->mTransformData.mMatrix[0],
+                                                        curTransform->mTransformData.mMatrix[4],
+                                                        curTransform->mTransformData.mMatrix[8],
+                                                        curTransform->mTransformData.mMatrix[12]);
                                                     
                 INSERT_TABS
-                printf("\t\t\t%f, %f, %f, %f\n",    curTransform->mTransformData.mMatrix[1],
-                                                    curTransform->mTransformData.mMatrix[5],
-                                                    curTransform->mTransformData.mMatrix[9],
-                                                    curTransform->mTransformData.mMatrix[13]);
+                NeonOutput("\t\t\t%f, %f, %f, %f\n",    curTransform->mTransformData.mMatrix[1],
+                                                        curTransform->mTransformData.mMatrix[5],
+                                                        curTransform->mTransformData.mMatrix[9],
+                                                        curTransform->mTransformData.mMatrix[13]);
                 
                 INSERT_TABS
-                printf("\t\t\t%f, %f, %f, %f\n",    curTransform->mTransformData.mMatrix[2],
-                                                    curTransform->mTransformData.mMatrix[6],
-                                                    curTransform->mTransformData.mMatrix[10],
-                                                    curTransform->mTransformData.mMatrix[14]);
+                NeonOutput("\t\t\t%f, %f, %f, %f\n",    curTransform->mTransformData.mMatrix[2],
+                                                        curTransform->mTransformData.mMatrix[6],
+                                                        curTransform->mTransformData.mMatrix[10],
+                                                        curTransform->mTransformData.mMatrix[14]);
                                                     
                 INSERT_TABS
-                printf("\t\t\t%f, %f, %f, %f\n",    curTransform->mTransformData.mMatrix[3],
-                                                    curTransform->mTransformData.mMatrix[7],
-                                                    curTransform->mTransformData.mMatrix[11],
-                                                    curTransform->mTransformData.mMatrix[15]);
+                NeonOutput("\t\t\t%f, %f, %f, %f\n",    curTransform->mTransformData.mMatrix[3],
+                                                        curTransform->mTransformData.mMatrix[7],
+                                                        curTransform->mTransformData.mMatrix[11],
+                                                        curTransform->mTransformData.mMatrix[15]);
                 break;
             }
             
@@ -129,7 +130,7 @@ void Joint::PrintHierarchy()
     }
     
     INSERT_TABS
-    printf("--------------------------------\n");
+    NeonOutput("--------------------------------\n");
         
     numTabs++;
     
@@ -254,7 +255,7 @@ void Joint::Validate()
         
         if (transformIndex <= lastTransformIndex)
         {
-            printf("Transforms were not in the expected order.  This requires debugging and inspecting the skeleton in the .dae file");
+            NeonError("Transforms were not in the expected order.  This requires debugging and inspecting the skeleton in the .dae file");
             assert(false);
         }
         else
@@ -13,6 +13,7 @@
 #include "AnimationClip.h"
 #include "Animation.h"
 #include "Logging.h"
+#include "Profiling.h"
 
 #include "Skeleton.h"
 
@@ -20,6 +21,8 @@ extern FUObjectRef<FCDocument> gDocument;
 
 AnimationClip* ReadAnimationClip(FCDAnimationClip* inAnimationClip, Skeleton* inSkeleton)
 {
+    PROFILE_SCOPE(PROFILE_TIMER_READ_ANIMATION_CLIP);
+    
     AnimationClip* retClip = new AnimationClip;
     
     retClip->SetAnimationClipName(inAnimationClip->GetName().c_str());
@@ -28,7 +31,7 @@ AnimationClip* ReadAnimationClip(FCDAnimationClip* inAnimationClip, Skeleton* in
     
     if (numAnimations == 0)
     {
-        printf("No animations found in animation clip %s.  Skipping.\n", inAnimationClip->GetName().c_str());
+        NeonWarning("No animations found in animation clip %s.  Skipping.\n", inAnimationClip->GetName().c_str());
         goto fail;
     }
     
@@ -70,17 +73,15 @@ AnimationClip* ReadAnimationClip(FCDAnimationClip* inAnimationClip, Skeleton* in
                 FCDAnimationCurve* curCurve = curChannel->GetCurve(curCurveIndex);
                 int keyframeCount = curCurve->GetKeyCount();
                 
+                newCurve->ReserveKeyframes(keyframeCount);
+                
                 for (int curKeyframeIndex = 0; curKeyframeIndex < keyframeCount; curKeyframeIndex++)
                 {
-                    AnimationKeyframe* keyframe = ExtractKeyframe(curCurve->GetKey(curKeyframeIndex));
-                    
-                    if (keyframe == NULL)
+                    if (!ExtractKeyframe(curCurve->GetKey(curKeyframeIndex), newCurve))
                     {
-                        printf("Failure encountered extracting a keyframe.  Aborting this animation clip.\n");
+                        NeonWarning("Failure encountered extracting a keyframe.  Aborting this animation clip.\n");
                         goto fail;
                     }
-                    
-                    newCurve->AddKeyframe(keyframe);
                 }
             }
         }
@@ -101,7 +102,7 @@ AnimationClip* ReadAnimation(FCDAnimationLibrary* inAnimationLibrary, FCDAnimati
        
     if (inNumAnimations == 0)
     {
-        printf("No animations found.  Skipping.\n");
+        NeonWarning("No animations found.  Skipping.\n");
         goto fail;
     }
 
@@ -136,7 +137,7 @@ AnimationClip* ReadAnimation(FCDAnimationLibrary* inAnimationLibrary, FCDAnimati
             if (    ((componentIndex != w) && (curveCount != 1)) ||
                     ((componentIndex == w) && (curveCount != 3))    )
             {
-                printf("This animation does not have an appropriate number of curves.  Aborting.\n");
+                NeonWarning("This animation does not have an appropriate number of curves.  Aborting.\n");
                 goto fail;
             }
             
@@ -148,17 +149,15 @@ AnimationClip* ReadAnimation(FCDAnimationLibrary* inAnimationLibrary, FCDAnimati
                 FCDAnimationCurve* curCurve = curChannel->GetCurve(curCurveIndex);
                 int keyframeCount = curCurve->GetKeyCount();
                 
+                newCurve->ReserveKeyframes(keyframeCount);
+                
                 for (int curKeyframeIndex = 0; curKeyframeIndex < keyframeCount; curKeyframeIndex++)
                 {
-                    AnimationKeyframe* keyframe = ExtractKeyframe(curCurve->GetKey(curKeyframeIndex));
-                    
-                    if (keyframe == NULL)
+                    if (!ExtractKeyframe(curCurve->GetKey(curKeyframeIndex), newCurve))
                     {
-                        printf("Failure encountered extracting a keyframe.  Aborting this animation clip.\n");
+                        NeonWarning("Failure encountered extracting a keyframe.  Aborting this animation clip.\n");
                         goto fail;
                     }
-                    
-                    newCurve->AddKeyframe(keyframe);
                 }
             }
         }
@@ -181,9 +180,7 @@ AnimationClip* ReadAnimation(FCDAnimationLibrary* inAnimationLibrary, FCDAnimati
                     
                     for (int curKeyframe = 0; curKeyframe < numKeyframes; curKeyframe++)
                     {
-                        AnimationKeyframe* keyframe = testCurve->GetKeyframe(curKeyframe);
-                        
-                        if (fabsf(keyframe->GetValue()) > EPSILON)
+                        if (fabsf(testCurve->GetKeyframeValue(curKeyframe)) > EPSILON)
                         {
                             allZero = false;
                             goto NON_ZERO;
@@ -196,7 +193,7 @@ AnimationClip* ReadAnimation(FCDAnimationLibrary* inAnimationLibrary, FCDAnimati
 NON_ZERO:
         if (testZero && allZero)
         {
-            printf("Zeroed out translation found for a joint other than the root.  Stripping this, as this is invalid\n");
+            NeonWarning("Zeroed out translation found for a joint other than the root.  Stripping this, as this is invalid\n");
         }
         else
         {
@@ -218,7 +215,7 @@ bool FindAnimationTarget(FCDAnimation* inAnimation, Skeleton* inSkeleton, Joint*
     
     if (extra == NULL)
     {
-        printf("No extra metadata attached to animation.  With no animation target, we can't export this animation.\n");
+        NeonWarning("No extra metadata attached to animation.  With no animation target, we can't export this animation.\n");
         return false;
     }
     
@@ -243,7 +240,7 @@ bool FindAnimationTarget(FCDAnimation* inAnimation, Skeleton* inSkeleton, Joint*
     
     if (animTargetType == NULL)
     {
-        printf("Didn't find an AnimTarget.  Can't export this animation.\n");
+        NeonWarning("Didn't find an AnimTarget.  Can't export this animation.\n");
         return false;
     }
     
@@ -251,7 +248,7 @@ bool FindAnimationTarget(FCDAnimation* inAnimation, Skeleton* inSkeleton, Joint*
     
     if (techniqueCount == 0)
     {
-        printf("No technique count.  With no animation target, we can't export this animation.\n");
+        NeonWarning("No technique count.  With no animation target, we can't export this animation.\n");
         return false;
     }
     
@@ -272,7 +269,7 @@ bool FindAnimationTarget(FCDAnimation* inAnimation, Skeleton* inSkeleton, Joint*
     
     if (targetTechnique == NULL)
     {
-        printf("Couldn't find a target technique.  With no animation target, we can't export this animation.\n");
+        NeonWarning("Couldn't find a target technique.  With no animation target, we can't export this animation.\n");
         return false;
     }
     
@@ -280,7 +277,7 @@ bool FindAnimationTarget(FCDAnimation* inAnimation, Skeleton* inSkeleton, Joint*
     
     if (childNodeCount == 0)
     {
-        printf("No child nodes found.  With no animation target, we can't export this animation.\n");
+        NeonWarning("No child nodes found.  With no animation target, we can't export this animation.\n");
         return false;
     }
     
@@ -315,7 +312,7 @@ bool FindAnimationTarget(FCDAnimation* inAnimation, Skeleton* inSkeleton, Joint*
                         
                         if (strcmp(content, ".ANGLE") != 0)
                         {
-                            printf("Animation target isn't an angle.  Don't know what to do here\n");
+                            NeonWarning("Animation target isn't an angle.  Don't know what to do here\n");
                             return false;
                         }
                     }
@@ -364,7 +361,7 @@ void GetJointAndComponent(Skeleton* inSkeleton, const char* inJointPath, Joint**
     
     if (joint == NULL)
     {
-        printf("Couldn't find joint named %s.  Cannot export this animation\n", inJointPath);
+        NeonWarning("Couldn't find joint named %s.  Cannot export this animation\n", inJointPath);
         goto fail;
     }
     
@@ -401,30 +398,23 @@ fail:
     return;
 }
 
-AnimationKeyframe* ExtractKeyframe(FCDAnimationKey* inKey)
+bool ExtractKeyframe(FCDAnimationKey* inKey, AnimationCurve* outCurve)
 {
     FUDaeInterpolation::Interpolation interpolationType = (FUDaeInterpolation::Interpolation)inKey->interpolation;
     
-    AnimationKeyframe* animationKeyframe = NULL;
-    
     if (interpolationType == FUDaeInterpolation::BEZIER)
     {
-        BezierAnimationKeyframe* bezierKeyframe = new BezierAnimationKeyframe;
         FCDAnimationKeyBezier* fcdBezierKeyframe = (FCDAnimationKeyBezier*)inKey;
         
-        bezierKeyframe->SetInTangent(fcdBezierKeyframe->inTangent.x, fcdBezierKeyframe->inTangent.y);
-        bezierKeyframe->SetOutTangent(fcdBezierKeyframe->outTangent.x, fcdBezierKeyframe->outTangent.y);
-        
-        animationKeyframe = bezierKeyframe;
+        outCurve->AddBezierKeyframe(inKey->input, inKey->output,
+                                    fcdBezierKeyframe->inTangent.x, fcdBezierKeyframe->inTangent.y,
+                                    fcdBezierKeyframe->outTangent.x, fcdBezierKeyframe->outTangent.y);
     }
     else
     {
-        printf("Unsupported keyframe type.\n");
-        return NULL;
+        NeonWarning("Unsupported keyframe type.\n");
+        return false;
     }
     
-    animationKeyframe->SetTime(inKey->input);
-    animationKeyframe->SetValue(inKey->output);
-    
-    return animationKeyframe;
+    return true;
 }
\ No newline at end of file
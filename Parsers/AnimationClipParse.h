@@ -6,7 +6,7 @@ class Skeleton;
 class Joint;
 class Animation;
 class AnimationClip;
-class AnimationKeyframe;
+class AnimationCurve;
 class FCDAnimationClip;
 class FCDAnimationKey;
 
@@ -15,4 +15,4 @@ AnimationClip* ReadAnimation(FCDAnimationLibrary* inAnimationLibrary, FCDAnimati
 bool FindAnimationTarget(FCDAnimation* inAnimation, Skeleton* inSkeleton, Joint** outJoint, int* outComponent, char* outTargetName);
 
 void GetJointAndComponent(Skeleton* inSkeleton, const char* inJointPath, Joint** outJoint, int* outComponent, char* outComponentName);
-AnimationKeyframe* ExtractKeyframe(FCDAnimationKey* inKey);
\ No newline at end of file
+bool ExtractKeyframe(FCDAnimationKey* inKey, AnimationCurve* outCurve);
\ No newline at end of file
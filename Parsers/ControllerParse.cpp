@@ -2,6 +2,7 @@
 #include <CoreFoundation/CoreFoundation.h>
 
 #include "main.h"
+#include "Profiling.h"
 
 #define NO_LIBXML
 #include "FCollada.h"
@@ -44,11 +45,13 @@ void CountSceneNodes(FCDSceneNode* inSceneNode, int* inOutNumSceneNodes)
 
 Skeleton* ReadController(FCDControllerInstance* inControllerInstance)
 {
+    PROFILE_SCOPE(PROFILE_TIMER_READ_CONTROLLER);
+    
     FCDController* controller = (FCDController*)inControllerInstance->GetEntity();
     
     if (!controller->IsSkin())
     {
-        printf("This controller is not a skin and cannot be exported.\n");
+        NeonWarning("This controller is not a skin and cannot be exported.\n");
         return NULL;
     }
         
@@ -63,7 +66,7 @@ Skeleton* ReadController(FCDControllerInstance* inControllerInstance)
         
         if (joint == NULL)
         {
-            printf("Null joint found, this shouldn't be possible.  Skipping export of this skeleton.\n");
+            NeonWarning("Null joint found, this shouldn't be possible.  Skipping export of this skeleton.\n");
             return NULL;
         }
         
@@ -90,9 +93,12 @@ Skeleton* ReadController(FCDControllerInstance* inControllerInstance)
     SetIdentity(&identity);
     
     Joint* rootJoint = CreateSkeletonFromRoot(rootIndex, NULL, jointNodes, jointCount, &identity, false, controller);
-#if 0
-    rootJoint->PrintHierarchy();
-#endif    
+
+    if (gDumpInfo)
+    {
+        rootJoint->PrintHierarchy();
+    }
+
     // Create Skeleton
     
     Skeleton* skeleton = new Skeleton;
@@ -113,51 +119,20 @@ Skeleton* ReadController(FCDControllerInstance* inControllerInstance)
         Mesh* retMesh = ReadGeometry(NULL, (FCDGeometry*)geometry);
         
         int numInfluences = skinController->GetInfluenceCount();
+        int numPairs = skinController->GetTotalPairCount();
         
-        uint32_t*               matrixCounts = new uint32_t[numInfluences];
-        
-        std::vector<int32_t>    matrixIndices;
-        std::vector<float>      matrixWeights;
-        
-        // Extract the following information:
-        // 1) Number of joints that each vertex is influenced by
+        // Extract the following information in one pass, directly into buffers owned by the mesh:
+        // 1) Offset to the joints that each vertex is influenced by (the difference between two offsets is the count)
         // 2) The indices for the joints that the vertex is influenced by
         // 3) The weights for each joint
         
-        for (int curInfluence = 0; curInfluence < numInfluences; curInfluence++)
-        {
-            FCDSkinControllerVertex* vertex = skinController->GetVertexInfluence(curInfluence);
-            
-            matrixCounts[curInfluence] = vertex->GetPairCount();
-            
-            for (int curPair = 0; curPair < matrixCounts[curInfluence]; curPair++)
-            {
-                FCDJointWeightPair* pair = vertex->GetPair(curPair);
-                
-                matrixIndices.push_back(pair->jointIndex);
-                matrixWeights.push_back(pair->weight);
-            }
-        }
-        
-        int numMatrixIndices = matrixIndices.size();
-        uint32_t* matrixIndexStream = new uint32[numMatrixIndices];
+        uint32_t*   matrixOffsets = new uint32_t[numInfluences + 1];
+        uint32_t*   matrixIndexStream = new uint32_t[numPairs];
+        float*      matrixWeightsStream = new float[numPairs];
         
-        for (int curIndex = 0; curIndex < numMatrixIndices; curIndex++)
-        {
-            matrixIndexStream[curIndex] = matrixIndices[curIndex];
-        }
+        skinController->GetPackedInfluences(matrixOffsets, (int32*)matrixIndexStream, matrixWeightsStream);
         
-        int numMatrixWeights = matrixWeights.size();
-        float* matrixWeightsStream = new float[numMatrixWeights];
-        
-        for (int curIndex = 0; curIndex < numMatrixWeights; curIndex++)
-        {
-            matrixWeightsStream[curIndex] = matrixWeights[curIndex];
-        }
-        
-        retMesh->AddMatrixCounts(numInfluences, matrixCounts);
-        retMesh->AddMatrixIndices(numMatrixIndices, matrixIndexStream);
-        retMesh->AddMatrixWeights(numMatrixWeights, matrixWeightsStream);
+        retMesh->AdoptMatrixInfluences(numInfluences, matrixOffsets, matrixIndexStream, matrixWeightsStream);
         
         FMMatrix44 bindShapeMatrix = skinController->GetBindShapeTransform();
         
@@ -169,8 +144,6 @@ Skeleton* ReadController(FCDControllerInstance* inControllerInstance)
         }
         
         retMesh->SetBindShapeMatrix(&bindShapeMatrixColMajor);
-        
-        delete [] matrixCounts;
                 
         CFArrayAppendValue(gMeshList, retMesh);
     }
@@ -199,7 +172,7 @@ int FindSkeletonRoot(FCDControllerInstance* inControllerInstance, FCDSceneNode**
                 }
                 else
                 {
-                    printf("This skeleton has multiple roots, this won't be exported correcty.\n");
+                    NeonWarning("This skeleton has multiple roots, this won't be exported correcty.\n");
                 }
             }
         }
@@ -386,7 +359,7 @@ Joint* CreateSkeletonFromRoot(  int inRootIndex, FCDSceneNode* inChild, FCDScene
     }
     else
     {
-        printf("Neither a valid index, nor a valid scene node pointer were provided.  Can't continue.\n");
+        NeonError("Neither a valid index, nor a valid scene node pointer were provided.  Can't continue.\n");
         return NULL;
     }
     
@@ -400,7 +373,7 @@ Joint* CreateSkeletonFromRoot(  int inRootIndex, FCDSceneNode* inChild, FCDScene
         
         if (child == NULL)
         {
-            printf("Null child node for parent %s.  You may have a badly exported skeleton.\n", node->GetName().c_str());
+            NeonWarning("Null child node for parent %s.  You may have a badly exported skeleton.\n", node->GetName().c_str());
             continue;
         }
         
@@ -12,6 +12,7 @@
 #include "FCDocument/FCDGeometrySource.h"
 #include "FCDocument/FCDGeometryPolygons.h"
 #include "FCDocument/FCDGeometryPolygonsInput.h"
+#include "FCDocument/FCDGeometryPolygonsTools.h"
 
 #include "FCDocument/FCDMaterialInstance.h"
 #include "FCDocument/FCDMaterial.h"
@@ -23,116 +24,125 @@
 #include "FCDocument/FCDImage.h"
 
 #include "main.h"
+#include "Logging.h"
+#include "Profiling.h"
 
-void ExtractMaterial(FCDGeometryInstance* inInstance, Mesh* inMesh)
+// Returns the texture referenced by a material instance.  outTextureName must hold NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH
+// characters, and is left untouched if no texture could be found.
+void ExtractMaterial(FCDMaterialInstance* inMaterialInstance, char* outTextureName)
 {
-    int materialInstanceCount = inInstance->GetMaterialInstanceCount();
+    if (inMaterialInstance == NULL)
+    {
+        NeonWarning("No material instance was returned.  No texture references will be exported.\n");
+        return;
+    }
     
-    if (materialInstanceCount > 1)
+    FCDMaterial* material = (FCDMaterial*)inMaterialInstance->GetEntity();
+    
+    if (material == NULL)
     {
-        printf("%d material instances were found, only the first one will be exported.\n", materialInstanceCount);
+        NeonWarning("Failed to get material entity.  No texture references will be exported.\n");
+        return;
     }
     
-    if (materialInstanceCount != 0)
+    FCDEffect* effect = material->GetEffect();
+    
+    if (effect == NULL)
     {
-        FCDMaterialInstance* materialInstance = inInstance->GetMaterialInstance(0);
-        
-        if (materialInstance == NULL)
-        {
-            printf("No material instance was returned.  No texture references will be exported.\n");
-            return;
-        }
-        
-        FCDMaterial* material = (FCDMaterial*)materialInstance->GetEntity();
-        
-        if (material == NULL)
-        {
-            printf("Failed to get material entity.  No texture references will be exported.\n");
-            return;
-        }
-        
-        FCDEffect* effect = material->GetEffect();
-        
-        if (effect == NULL)
-        {
-            printf("No effect found for the material.  No texture references will be exported.\n");
-            return;
-        }
-        
-        if (effect->GetEffectParameterCount() != 0)
-        {
-            printf("Non-zero global effect parameter count.  Non profile specific effect parameters are not supported and these will be ignored.\n");
-        }
-        
-        FCDEffectProfile* effectProfile = effect->FindProfile(FUDaeProfileType::COMMON);
-        
-        if (effectProfile == NULL)
-        {
-            printf("No common effect profile was found.  This is the only type supported.  No texture references will be exported.\n");
-        }
-        
-        int effectParameterCount = effectProfile->GetEffectParameterCount();
-        
-        FCDEffectParameterSurface* surfaceParam = NULL;
-        
-        for (int i = 0; i < effectParameterCount; i++)
-        {
-            FCDEffectParameter* effectParameter = effectProfile->GetEffectParameter(i);
-            
-            if (effectParameter->GetType() == FCDEffectParameter::SURFACE)
-            {
-                surfaceParam = (FCDEffectParameterSurface*)effectParameter;
-                break;
-            }
-        }
-        
-        if (surfaceParam == NULL)
-        {
-            printf("No surface parameter was found.  No texture references will be exported.\n");
-            return;
-        }
-        
-        int imageCount = surfaceParam->GetImageCount();
-        
-        if (imageCount == 0)
-        {
-            printf("No images found in the surface.  No texture references will be exported.\n");
-            return;
-        }
-        else if (imageCount > 1)
-        {
-            printf("More than one image was found in the surface.  Only the first will be exported.\n");
-        }
-        
-        FCDImage* image = surfaceParam->GetImage(0);
-        char* filePath = (char*)image->GetFilename().c_str();
-        
-        int fileNameLength = strlen(filePath);
-        char* fileName = (char*)filePath;
+        NeonWarning("No effect found for the material.  No texture references will be exported.\n");
+        return;
+    }
+    
+    if (effect->GetEffectParameterCount() != 0)
+    {
+        NeonWarning("Non-zero global effect parameter count.  Non profile specific effect parameters are not supported and these will be ignored.\n");
+    }
+    
+    FCDEffectProfile* effectProfile = effect->FindProfile(FUDaeProfileType::COMMON);
+    
+    if (effectProfile == NULL)
+    {
+        NeonWarning("No common effect profile was found.  This is the only type supported.  No texture references will be exported.\n");
+        return;
+    }
+    
+    int effectParameterCount = effectProfile->GetEffectParameterCount();
+    
+    FCDEffectParameterSurface* surfaceParam = NULL;
+    
+    for (int i = 0; i < effectParameterCount; i++)
+    {
+        FCDEffectParameter* effectParameter = effectProfile->GetEffectParameter(i);
         
-        for (int i = (fileNameLength - 1); i >= 0; i--)
+        if (effectParameter->GetType() == FCDEffectParameter::SURFACE)
         {
-            if (filePath[i] == '/')
-            {
-                fileName = &filePath[i + 1];
-                break;
-            }
+            surfaceParam = (FCDEffectParameterSurface*)effectParameter;
+            break;
         }
-        
-        if (strlen(fileName) >= NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH)
+    }
+    
+    if (surfaceParam == NULL)
+    {
+        NeonWarning("No surface parameter was found.  No texture references will be exported.\n");
+        return;
+    }
+    
+    int imageCount = surfaceParam->GetImageCount();
+    
+    if (imageCount == 0)
+    {
+        NeonWarning("No images found in the surface.  No texture references will be exported.\n");
+        return;
+    }
+    else if (imageCount > 1)
+    {
+        NeonWarning("More than one image was found in the surface.  Only the first will be exported.\n");
+    }
+    
+    FCDImage* image = surfaceParam->GetImage(0);
+    char* filePath = (char*)image->GetFilename().c_str();
+    
+    int fileNameLength = strlen(filePath);
+    char* fileName = (char*)filePath;
+    
+    for (int i = (fileNameLength - 1); i >= 0; i--)
+    {
+        if (filePath[i] == '/')
         {
-            printf("%s is too long of a filename, %d is the limit.  Please reduce to at most this level and try again.\n", fileName, NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH - 1);
-            return;
+            fileName = &filePath[i + 1];
+            break;
         }
-        
-        inMesh->AddTextureName(fileName);
     }
+    
+    if (strlen(fileName) >= NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH)
+    {
+        NeonError("%s is too long of a filename, %d is the limit.  Please reduce to at most this level and try again.\n", fileName, NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH - 1);
+        return;
+    }
+    
+    strncpy(outTextureName, fileName, NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH);
+}
+
+// Finds the material instance bound to a polygon group.  Falls back to the first material instance (the
+// only one that used to be exported) if the polygon group's material semantic isn't bound.
+FCDMaterialInstance* FindPolygonsMaterialInstance(FCDGeometryInstance* inInstance, FCDGeometryPolygons* inPolygons)
+{
+    FCDMaterialInstance* materialInstance = inInstance->FindMaterialInstance(inPolygons->GetMaterialSemantic());
+    
+    if ((materialInstance == NULL) && (inInstance->GetMaterialInstanceCount() != 0))
+    {
+        materialInstance = inInstance->GetMaterialInstance(0);
+    }
+    
+    return materialInstance;
 }
 
 // If inInstance is specified, then inGeometry will be ignored.
 // Otherwise inInstance should be NULL and inGeometry will be used.
 Mesh* ReadGeometry(FCDGeometryInstance* inInstance, FCDGeometry* inGeometry)
 {
+    PROFILE_SCOPE(PROFILE_TIMER_READ_GEOMETRY);
+    
     FCDGeometry* geometry = NULL;
     Mesh* curMesh;
     
@@ -147,7 +157,7 @@ Mesh* ReadGeometry(FCDGeometryInstance* inInstance, FCDGeometry* inGeometry)
         
     if (!geometry->IsMesh())
     {
-        printf("%s geometry is not a mesh, skipping.\n", geometry->GetName().c_str());
+        NeonWarning("%s geometry is not a mesh, skipping.\n", geometry->GetName().c_str());
         return NULL;
     }
     
@@ -156,10 +166,29 @@ Mesh* ReadGeometry(FCDGeometryInstance* inInstance, FCDGeometry* inGeometry)
     FCDGeometrySource* positionSource = mesh->FindSourceByType(FUDaeGeometryInput::POSITION);
     FCDGeometrySource* normalSource = mesh->FindSourceByType(FUDaeGeometryInput::NORMAL);
     FCDGeometrySource* texcoordSource = mesh->FindSourceByType(FUDaeGeometryInput::TEXCOORD);
+    FCDGeometrySource* tangentSource = NULL;
+    
+    if (gExportTangents && (normalSource != NULL) && (texcoordSource != NULL))
+    {
+        // Use the texture tangents from the file if there are any.  Otherwise generate them from the first set
+        // of texcoords.  FCollada welds the tangents per position / normal / texcoord, like the other attributes.
+        tangentSource = mesh->FindSourceByType(FUDaeGeometryInput::TEXTANGENT);
+        
+        if (tangentSource == NULL)
+        {
+            FCDGeometryPolygonsTools::GenerateTextureTangentBasis(mesh, texcoordSource, false);
+            tangentSource = mesh->FindSourceByType(FUDaeGeometryInput::TEXTANGENT);
+        }
+        
+        if (tangentSource == NULL)
+        {
+            NeonWarning("Unable to generate tangents for %s.  No tangents will be exported.\n", geometry->GetName().c_str());
+        }
+    }
     
     if (positionSource == NULL)
     {
-        printf("No position data in mesh, skipping.\n");
+        NeonWarning("No position data in mesh, skipping.\n");
         return NULL;
     }
     else
@@ -168,34 +197,49 @@ Mesh* ReadGeometry(FCDGeometryInstance* inInstance, FCDGeometry* inGeometry)
         
         if (positionSource != NULL)
         {
-            curMesh->AddPositions(positionSource->GetDataCount(), positionSource->GetStride(), positionSource->GetData());
+            curMesh->BorrowPositions(positionSource->GetDataCount(), positionSource->GetStride(), positionSource->GetData());
         }
         
         if (normalSource != NULL)
         {
-            curMesh->AddNormals(normalSource->GetDataCount(), normalSource->GetStride(), normalSource->GetData());
+            curMesh->BorrowNormals(normalSource->GetDataCount(), normalSource->GetStride(), normalSource->GetData());
         }
         
         if (texcoordSource != NULL)
         {
-            curMesh->AddTexcoords(texcoordSource->GetDataCount(), texcoordSource->GetStride(), texcoordSource->GetData());
+            curMesh->BorrowTexcoords(texcoordSource->GetDataCount(), texcoordSource->GetStride(), texcoordSource->GetData());
+        }
+        
+        if (tangentSource != NULL)
+        {
+            curMesh->BorrowTangents(tangentSource->GetDataCount(), tangentSource->GetStride(), tangentSource->GetData());
         }
         
         curMesh->SetModelName(geometry->GetName().c_str());
     }
+    
+    // The texture of the first material instance is also written in the model header
+    char defaultTextureName[NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH];
+    memset(defaultTextureName, 0, NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH);
+    
+    if ((inInstance != NULL) && (inInstance->GetMaterialInstanceCount() != 0))
+    {
+        ExtractMaterial(inInstance->GetMaterialInstance(0), defaultTextureName);
+    }
 
     int numPolySources = mesh->GetPolygonsCount();
     
     FCDGeometryPolygonsInput* positionInput = NULL;
     FCDGeometryPolygonsInput* normalInput = NULL;
     FCDGeometryPolygonsInput* texcoordInput = NULL;
+    FCDGeometryPolygonsInput* tangentInput = NULL;
     FCDGeometryPolygons* polygons = NULL;
     
     bool needsSplitting = false;
     
     if (numPolySources < 1)
     {
-        printf("There are no polygon sources in this mesh, skipping.\n");
+        NeonWarning("There are no polygon sources in this mesh, skipping.\n");
         goto cleanup;
     }
 
@@ -205,7 +249,7 @@ Mesh* ReadGeometry(FCDGeometryInstance* inInstance, FCDGeometry* inGeometry)
         
         if (polygons->GetPrimitiveType() != FCDGeometryPolygons::POLYGONS)
         {
-            printf("Primitive type is something other than Polygons.  Skipping\n");
+            NeonWarning("Primitive type is something other than Polygons.  Skipping\n");
             goto cleanup;
         }
             
@@ -218,10 +262,11 @@ Mesh* ReadGeometry(FCDGeometryInstance* inInstance, FCDGeometry* inGeometry)
         positionInput = polygons->FindInput(FUDaeGeometryInput::POSITION);
         normalInput = polygons->FindInput(FUDaeGeometryInput::NORMAL);
         texcoordInput = polygons->FindInput(FUDaeGeometryInput::TEXCOORD);
+        tangentInput = (tangentSource != NULL) ? polygons->FindInput(tangentSource) : NULL;
         
         if (positionInput == NULL)
         {
-            printf("No position indices found.  Skipping this mesh.\n");
+            NeonWarning("No position indices found.  Skipping this mesh.\n");
             goto cleanup;
         }
         else
@@ -235,7 +280,7 @@ Mesh* ReadGeometry(FCDGeometryInstance* inInstance, FCDGeometry* inGeometry)
                 // We only know how to split polygon lists.  Bail if we got something else (eg: triangle strips, fans, etc)
                 if (primitiveType != FCDGeometryPolygons::POLYGONS)
                 {
-                    printf("Splitting polygon lists is the only type of splitting that's supported.  Aborting this mesh.\n");
+                    NeonWarning("Splitting polygon lists is the only type of splitting that's supported.  Aborting this mesh.\n");
                     goto cleanup;
                 }
                 else
@@ -245,23 +290,47 @@ Mesh* ReadGeometry(FCDGeometryInstance* inInstance, FCDGeometry* inGeometry)
                     uint32_t numFaces = polygons->GetFaceVertexCountCount();
                     const uint32_t* faceVertexCounts = polygons->GetFaceVertexCounts();
                     
-                    curMesh->AddFaceVertexInfo(numFaces, faceVertexCounts);
+                    curMesh->BorrowFaceVertexInfo(numFaces, faceVertexCounts);
                 }
             }
             
             if (positionInput != NULL)
             {
-                curMesh->AddPositionIndices(positionInput->GetIndexCount(), positionInput->GetIndices());
+                curMesh->BorrowPositionIndices(positionInput->GetIndexCount(), positionInput->GetIndices());
             }
             
             if (normalInput != NULL)
             {
-                curMesh->AddNormalIndices(normalInput->GetIndexCount(), normalInput->GetIndices());
+                curMesh->BorrowNormalIndices(normalInput->GetIndexCount(), normalInput->GetIndices());
             }
             
             if (texcoordInput != NULL)
             {
-                curMesh->AddTexcoordIndices(texcoordInput->GetIndexCount(), texcoordInput->GetIndices());
+                curMesh->BorrowTexcoordIndices(texcoordInput->GetIndexCount(), texcoordInput->GetIndices());
+            }
+            
+            if (tangentInput != NULL)
+            {
+                curMesh->BorrowTangentIndices(tangentInput->GetIndexCount(), tangentInput->GetIndices());
+            }
+            
+            // Each polygon group becomes a submesh range using its own material's texture
+            if (inInstance != NULL)
+            {
+                FCDMaterialInstance* materialInstance = FindPolygonsMaterialInstance(inInstance, polygons);
+                
+                if ((materialInstance == NULL) || (materialInstance == inInstance->GetMaterialInstance(0)))
+                {
+                    curMesh->AddSubmeshTextureName(defaultTextureName);
+                }
+                else
+                {
+                    char textureName[NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH];
+                    memset(textureName, 0, NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH);
+                    
+                    ExtractMaterial(materialInstance, textureName);
+                    curMesh->AddSubmeshTextureName(textureName);
+                }
             }
             
             curMesh->EndMesh();
@@ -270,7 +339,7 @@ Mesh* ReadGeometry(FCDGeometryInstance* inInstance, FCDGeometry* inGeometry)
     
     if (inInstance != NULL)
     {
-        ExtractMaterial(inInstance, curMesh);
+        curMesh->AddTextureName(defaultTextureName);
     }
 
     return curMesh;
@@ -3,6 +3,9 @@
 class Mesh;
 class FCDGeometryInstance;
 class FCDGeometry;
+class FCDGeometryPolygons;
+class FCDMaterialInstance;
 
-void ExtractMaterial(FCDGeometryInstance* inInstance, Mesh* inMesh);
+void ExtractMaterial(FCDMaterialInstance* inMaterialInstance, char* outTextureName);
+FCDMaterialInstance* FindPolygonsMaterialInstance(FCDGeometryInstance* inInstance, FCDGeometryPolygons* inPolygons);
 Mesh* ReadGeometry(FCDGeometryInstance* inInstance, FCDGeometry* inGeometry = NULL);
\ No newline at end of file
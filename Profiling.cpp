@@ -0,0 +1,242 @@
+//
+//  Profiling.cpp
+//  Neon21ModelExporter
+//
+//  Copyright (c) 2012 Neon Games LLC. All rights reserved.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#ifdef __APPLE__
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
+#include "Profiling.h"
+#include "Logging.h"
+
+#define PROFILE_STACK_DEPTH     (32)
+
+static const char* TIMER_NAMES[PROFILE_TIMER_MAX] = {   "LoadDocumentFromFile",
+                                                        "ReadSceneLibrary",
+                                                        "ReadGeometry",
+                                                        "ReadController",
+                                                        "ReadAnimationClip",
+                                                        "ReadAnimationLibrary",
+                                                        "Mesh::Validate",
+                                                        "Mesh::CreateInterleavedStream",
+                                                        "WriteMeshes",
+                                                        "WriteSkeletons",
+                                                        "WriteAnimationClips"  };
+
+static const char* COUNTER_NAMES[PROFILE_COUNTER_MAX] = {   "Meshes",
+                                                            "Vertices",
+                                                            "Joints",
+                                                            "Animations",
+                                                            "Bytes written" };
+
+typedef struct
+{
+    int     mNumCalls;
+    double  mTotalTime;         // In microseconds, as is every time in this file
+    double  mSelfTime;          // Total time less the time spent in the nested timers
+    double  mMaxTime;
+} TimerRecord;
+
+typedef struct
+{
+    ProfileTimer    mTimer;
+    double          mStartTime;
+    double          mNestedTime;
+} ActiveTimer;
+
+typedef struct
+{
+    ProfileTimer    mTimer;
+    double          mStartTime;
+    double          mDuration;
+} TraceEvent;
+
+bool                gProfilingEnabled = false;
+
+static TimerRecord  sTimers[PROFILE_TIMER_MAX];
+static long long    sCounters[PROFILE_COUNTER_MAX];
+
+static ActiveTimer  sTimerStack[PROFILE_STACK_DEPTH];
+static int          sTimerStackDepth = 0;
+
+static FILE*        sTraceFile = NULL;
+static TraceEvent*  sTraceEvents = NULL;
+static int          sNumTraceEvents = 0;
+static int          sTraceEventCapacity = 0;
+
+static double       sStartTime = 0.0;
+
+static double GetTime()
+{
+#ifdef __APPLE__
+    static mach_timebase_info_data_t timebase;
+
+    if (timebase.denom == 0)
+    {
+        mach_timebase_info(&timebase);
+    }
+
+    return ((double)mach_absolute_time() * (double)timebase.numer) / ((double)timebase.denom * 1000.0);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((double)now.tv_sec * 1000000.0) + ((double)now.tv_nsec / 1000.0);
+#endif
+}
+
+void ProfileEnable(const char* inTraceFilename)
+{
+    memset(sTimers, 0, sizeof(sTimers));
+    memset(sCounters, 0, sizeof(sCounters));
+
+    sTimerStackDepth = 0;
+    sStartTime = GetTime();
+
+    // Opened now since the serializers change the working directory.
+    if (inTraceFilename != NULL)
+    {
+        sTraceFile = fopen(inTraceFilename, "w");
+
+        if (sTraceFile == NULL)
+        {
+            NeonWarning("Couldn't open the trace file %s for writing.\n", inTraceFilename);
+        }
+    }
+
+    gProfilingEnabled = true;
+}
+
+void ProfileBeginTimer(ProfileTimer inTimer)
+{
+    assert(sTimerStackDepth < PROFILE_STACK_DEPTH);
+
+    ActiveTimer* activeTimer = &sTimerStack[sTimerStackDepth++];
+
+    activeTimer->mTimer = inTimer;
+    activeTimer->mNestedTime = 0.0;
+    activeTimer->mStartTime = GetTime();
+}
+
+void ProfileEndTimer(ProfileTimer inTimer)
+{
+    double endTime = GetTime();
+
+    assert((sTimerStackDepth > 0) && (sTimerStack[sTimerStackDepth - 1].mTimer == inTimer));
+
+    ActiveTimer* activeTimer = &sTimerStack[--sTimerStackDepth];
+    double duration = endTime - activeTimer->mStartTime;
+
+    TimerRecord* record = &sTimers[inTimer];
+
+    record->mNumCalls++;
+    record->mTotalTime += duration;
+    record->mSelfTime += duration - activeTimer->mNestedTime;
+
+    if (duration > record->mMaxTime)
+    {
+        record->mMaxTime = duration;
+    }
+
+    if (sTimerStackDepth > 0)
+    {
+        sTimerStack[sTimerStackDepth - 1].mNestedTime += duration;
+    }
+
+    if (sTraceFile != NULL)
+    {
+        if (sNumTraceEvents == sTraceEventCapacity)
+        {
+            sTraceEventCapacity = (sTraceEventCapacity == 0) ? 1024 : (sTraceEventCapacity * 2);
+            sTraceEvents = (TraceEvent*)realloc(sTraceEvents, sTraceEventCapacity * sizeof(TraceEvent));
+        }
+
+        TraceEvent* event = &sTraceEvents[sNumTraceEvents++];
+
+        event->mTimer = inTimer;
+        event->mStartTime = activeTimer->mStartTime - sStartTime;
+        event->mDuration = duration;
+    }
+}
+
+void ProfileAddCount(ProfileCounter inCounter, long long inCount)
+{
+    sCounters[inCounter] += inCount;
+}
+
+static void WriteTrace()
+{
+    // Complete events, ordered by when they ended.  The trace viewer sorts them out.
+    fprintf(sTraceFile, "{\"traceEvents\":[\n");
+
+    for (int curEvent = 0; curEvent < sNumTraceEvents; curEvent++)
+    {
+        TraceEvent* event = &sTraceEvents[curEvent];
+
+        fprintf(sTraceFile, "{\"name\":\"%s\",\"cat\":\"exporter\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1},\n",
+                TIMER_NAMES[event->mTimer], event->mStartTime, event->mDuration);
+    }
+
+    double endTime = GetTime() - sStartTime;
+
+    for (int curCounter = 0; curCounter < PROFILE_COUNTER_MAX; curCounter++)
+    {
+        fprintf(sTraceFile, "{\"name\":\"%s\",\"cat\":\"exporter\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":1,\"args\":{\"value\":%lld}}%s\n",
+                COUNTER_NAMES[curCounter], endTime, sCounters[curCounter], (curCounter == PROFILE_COUNTER_MAX - 1) ? "" : ",");
+    }
+
+    fprintf(sTraceFile, "],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(sTraceFile);
+    sTraceFile = NULL;
+
+    free(sTraceEvents);
+
+    sTraceEvents = NULL;
+    sNumTraceEvents = 0;
+    sTraceEventCapacity = 0;
+}
+
+void ProfileReport()
+{
+    if (!gProfilingEnabled)
+    {
+        return;
+    }
+
+    NeonOutput("\n%-32s %8s %12s %12s %12s\n", "Timer", "Calls", "Total (ms)", "Self (ms)", "Max (ms)");
+
+    for (int curTimer = 0; curTimer < PROFILE_TIMER_MAX; curTimer++)
+    {
+        TimerRecord* record = &sTimers[curTimer];
+
+        if (record->mNumCalls != 0)
+        {
+            NeonOutput("%-32s %8d %12.3f %12.3f %12.3f\n", TIMER_NAMES[curTimer], record->mNumCalls,
+                    record->mTotalTime / 1000.0, record->mSelfTime / 1000.0, record->mMaxTime / 1000.0);
+        }
+    }
+
+    NeonOutput("\n%-32s %12s\n", "Counter", "Value");
+
+    for (int curCounter = 0; curCounter < PROFILE_COUNTER_MAX; curCounter++)
+    {
+        NeonOutput("%-32s %12lld\n", COUNTER_NAMES[curCounter], sCounters[curCounter]);
+    }
+
+    NeonOutput("\nTotal time: %.3f ms\n", (GetTime() - sStartTime) / 1000.0);
+
+    if (sTraceFile != NULL)
+    {
+        WriteTrace();
+    }
+}
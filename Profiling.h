@@ -0,0 +1,79 @@
+//
+//  Profiling.h
+//  Neon21ModelExporter
+//
+//  Copyright (c) 2012 Neon Games LLC. All rights reserved.
+//
+
+#ifndef Neon21ModelExporter_Profiling_h
+#define Neon21ModelExporter_Profiling_h
+
+typedef enum
+{
+    PROFILE_TIMER_LOAD_DOCUMENT,
+    PROFILE_TIMER_READ_SCENE_LIBRARY,
+    PROFILE_TIMER_READ_GEOMETRY,
+    PROFILE_TIMER_READ_CONTROLLER,
+    PROFILE_TIMER_READ_ANIMATION_CLIP,
+    PROFILE_TIMER_READ_ANIMATION_LIBRARY,
+    PROFILE_TIMER_MESH_VALIDATE,
+    PROFILE_TIMER_CREATE_INTERLEAVED_STREAM,
+    PROFILE_TIMER_WRITE_MESHES,
+    PROFILE_TIMER_WRITE_SKELETONS,
+    PROFILE_TIMER_WRITE_ANIMATION_CLIPS,
+    PROFILE_TIMER_MAX
+} ProfileTimer;
+
+typedef enum
+{
+    PROFILE_COUNTER_MESHES,
+    PROFILE_COUNTER_VERTICES,
+    PROFILE_COUNTER_JOINTS,
+    PROFILE_COUNTER_ANIMATIONS,
+    PROFILE_COUNTER_BYTES_WRITTEN,
+    PROFILE_COUNTER_MAX
+} ProfileCounter;
+
+extern bool gProfilingEnabled;
+
+// Starts recording the timers and counters.  If inTraceFilename isn't NULL, every timed call is also kept and
+// written out by ProfileReport to that file as a Chrome trace (chrome://tracing).
+void ProfileEnable(const char* inTraceFilename);
+
+// Prints the summary table and writes the trace.  Does nothing if profiling isn't enabled.
+void ProfileReport();
+
+void ProfileBeginTimer(ProfileTimer inTimer);
+void ProfileEndTimer(ProfileTimer inTimer);
+void ProfileAddCount(ProfileCounter inCounter, long long inCount);
+
+// Times the enclosing scope.  When profiling is disabled this costs a test of gProfilingEnabled.
+class ScopedProfileTimer
+{
+    public:
+        ScopedProfileTimer(ProfileTimer inTimer)
+        {
+            mTimer = inTimer;
+
+            if (gProfilingEnabled)
+            {
+                ProfileBeginTimer(inTimer);
+            }
+        }
+
+        ~ScopedProfileTimer()
+        {
+            if (gProfilingEnabled)
+            {
+                ProfileEndTimer(mTimer);
+            }
+        }
+
+    private:
+        ProfileTimer    mTimer;
+};
+
+#define PROFILE_SCOPE(timer)                ScopedProfileTimer scopedProfileTimer(timer)
+#define PROFILE_COUNT(counter, count)       do { if (gProfilingEnabled) ProfileAddCount(counter, count); } while (0)
+
+#endif
@@ -4,9 +4,14 @@
 #include "Skeleton.h"
 
 #include "ModelExporterDefines.h"
+#include "Logging.h"
+#include "main.h"
+#include "Profiling.h"
 
 void WriteAnimationClips(CFMutableArrayRef inClipList)
 {
+    PROFILE_SCOPE(PROFILE_TIMER_WRITE_ANIMATION_CLIPS);
+    
     int numClips = CFArrayGetCount(inClipList);
     
     for (int curClipIndex = 0; curClipIndex < numClips; curClipIndex++)
@@ -15,7 +20,10 @@ void WriteAnimationClips(CFMutableArrayRef inClipList)
         
         if (curClip != NULL)
         {
-            curClip->DumpInfo();
+            if (gDumpInfo)
+            {
+                curClip->DumpInfo();
+            }
 
             char* animClipName = curClip->GetAnimationClipName();
             
@@ -32,6 +40,9 @@ void WriteAnimationClips(CFMutableArrayRef inClipList)
             
             WriteAnimationClip(curClip, curFile);
             
+            PROFILE_COUNT(PROFILE_COUNTER_ANIMATIONS, curClip->GetNumAnimations());
+            PROFILE_COUNT(PROFILE_COUNTER_BYTES_WRITTEN, ftell(curFile));
+            
             fclose(curFile);
         }
     }
@@ -72,7 +83,7 @@ void WriteAnimation(Animation* inAnimation, FILE* inFile)
     
     if (strlen(targetJoint->GetJointName()) >= NEON21_MODELEXPORTER_JOINT_NAME_LENGTH)
     {
-        printf("Joint name %s is too long, this animation cannot be exported.\n", targetJoint->GetJointName());
+        NeonWarning("Joint name %s is too long, this animation cannot be exported.\n", targetJoint->GetJointName());
         return;
     }
     else
@@ -95,13 +106,11 @@ void WriteAnimation(Animation* inAnimation, FILE* inFile)
         
         for (int curKeyframeIndex = 0; curKeyframeIndex < curveHeader.mNumKeyframes; curKeyframeIndex++)
         {
-            AnimationKeyframe* curKeyframe = curCurve->GetKeyframe(curKeyframeIndex);
-            
             AnimationKeyframeCommon commonKeyframeData;
             
-            commonKeyframeData.mKeyframeType = curKeyframe->GetKeyframeType();
-            commonKeyframeData.mKeyframeTime = curKeyframe->GetTime();
-            commonKeyframeData.mKeyframeValue = curKeyframe->GetValue();
+            commonKeyframeData.mKeyframeType = curCurve->GetKeyframeType();
+            commonKeyframeData.mKeyframeTime = curCurve->GetKeyframeTime(curKeyframeIndex);
+            commonKeyframeData.mKeyframeValue = curCurve->GetKeyframeValue(curKeyframeIndex);
             
             fwrite(&commonKeyframeData, sizeof(AnimationKeyframeCommon), 1, inFile);
             
@@ -110,10 +119,9 @@ void WriteAnimation(Animation* inAnimation, FILE* inFile)
                 case NEON21_ANIMATION_KEYFRAME_BEZIER:
                 {
                     BezierKeyframeData bezierKeyframeData;
-                    BezierAnimationKeyframe* bezierKeyframe = (BezierAnimationKeyframe*)curKeyframe;
                     
-                    bezierKeyframe->GetInTangent(&bezierKeyframeData.mInTangentX, &bezierKeyframeData.mInTangentY);
-                    bezierKeyframe->GetOutTangent(&bezierKeyframeData.mOutTangentX, &bezierKeyframeData.mOutTangentY);
+                    curCurve->GetKeyframeInTangent(curKeyframeIndex, &bezierKeyframeData.mInTangentX, &bezierKeyframeData.mInTangentY);
+                    curCurve->GetKeyframeOutTangent(curKeyframeIndex, &bezierKeyframeData.mOutTangentX, &bezierKeyframeData.mOutTangentY);
                     
                     fwrite(&bezierKeyframeData, sizeof(bezierKeyframeData), 1, inFile);
                     
@@ -2,16 +2,20 @@
 #include "Mesh.h"
 
 #include "main.h"
+#include "Logging.h"
+#include "Profiling.h"
 
 #include <unistd.h>
 
 void WriteMeshes(CFMutableArrayRef inMeshList)
 {
+    PROFILE_SCOPE(PROFILE_TIMER_WRITE_MESHES);
+    
     int numMeshes = CFArrayGetCount(inMeshList);
     
     if (numMeshes == 0)
     {
-        printf("There were no meshes capable of being exported.  Skipping...\n");
+        NeonWarning("There were no meshes capable of being exported.  Skipping...\n");
         return;
     }
     
@@ -30,7 +34,7 @@ void WriteMeshes(CFMutableArrayRef inMeshList)
         
         if (!isValid)
         {
-            printf("%s. Aborting\n", meshErrorString);
+            NeonError("%s. Aborting\n", meshErrorString);
             return;
         }
         
@@ -42,6 +46,13 @@ void WriteMeshes(CFMutableArrayRef inMeshList)
         
         curMesh->CreateInterleavedStream(&streamData, &numVertices, &stride);
         
+        // One range per texture, all sharing the interleaved stream
+        
+        SubmeshRecord*  submeshRecords = NULL;
+        uint32_t        numSubmeshRecords = 0;
+        
+        curMesh->CreateSubmeshRecords(&submeshRecords, &numSubmeshRecords);
+        
         // Create header
         
         ModelHeader header;
@@ -52,6 +63,7 @@ void WriteMeshes(CFMutableArrayRef inMeshList)
         header.mPositionStride = curMesh->mPositionStride;
         header.mNormalStride = curMesh->mNormalStride;
         header.mTexcoordStride = curMesh->mTexcoordStride;
+        header.mTangentStride = curMesh->GetTangentStreamStride();
         
         header.mNumMatricesPerVertex = curMesh->GetMaxMatrixCount();
         
@@ -70,6 +82,8 @@ void WriteMeshes(CFMutableArrayRef inMeshList)
         
         memcpy(header.mTextureFilename, curMesh->mTextureFilename, NEON21_MODELEXPORTER_TEXTURE_NAME_LENGTH);
         
+        header.mNumSubmeshes = numSubmeshRecords;
+        
         // Now write out everything
         chdir(gOutputDirectory);
         
@@ -92,7 +106,15 @@ void WriteMeshes(CFMutableArrayRef inMeshList)
         // Write out stream
         fwrite( streamData, stride, numVertices, outputFile  );
         
+        // Write out submesh ranges
+        fwrite( submeshRecords, sizeof(SubmeshRecord), numSubmeshRecords, outputFile );
+        
+        PROFILE_COUNT(PROFILE_COUNTER_MESHES, 1);
+        PROFILE_COUNT(PROFILE_COUNTER_VERTICES, numVertices);
+        PROFILE_COUNT(PROFILE_COUNTER_BYTES_WRITTEN, ftell(outputFile));
+        
         free(streamData);
+        delete [] submeshRecords;
         fclose(outputFile);
     }
 }
\ No newline at end of file
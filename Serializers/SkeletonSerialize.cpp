@@ -4,19 +4,23 @@
 #include "Skeleton.h"
 
 #include "main.h"
+#include "Logging.h"
+#include "Profiling.h"
 
 void WriteSkeletons(CFMutableArrayRef inSkeletonList)
 {
+    PROFILE_SCOPE(PROFILE_TIMER_WRITE_SKELETONS);
+    
     int numSkeletons = CFArrayGetCount(inSkeletonList);
     
     if (numSkeletons == 0)
     {
-        printf("There are no skeletons in this file that are capable of being exported, skipping.\n");
+        NeonWarning("There are no skeletons in this file that are capable of being exported, skipping.\n");
         return;
     }
     else if (numSkeletons > 1)
     {
-        printf("More than one skeleton found.  Only the first one will be exported.\n");
+        NeonWarning("More than one skeleton found.  Only the first one will be exported.\n");
     }
     
     Skeleton* curSkeleton = static_cast<Skeleton*>(const_cast<void*>(CFArrayGetValueAtIndex(inSkeletonList, 0)));
@@ -100,5 +104,8 @@ void WriteSkeletons(CFMutableArrayRef inSkeletonList)
         delete [] childrenIndices;
     }
 
+    PROFILE_COUNT(PROFILE_COUNTER_JOINTS, header.mNumJoints);
+    PROFILE_COUNT(PROFILE_COUNTER_BYTES_WRITTEN, ftell(outputFile));
+    
     fclose(outputFile);
 }
\ No newline at end of file
@@ -48,6 +48,7 @@
 #include "AnimationClipSerialize.h"
 
 #include "Logging.h"
+#include "Profiling.h"
 
 #include <sys/stat.h>
 
@@ -60,10 +61,12 @@ FUObjectRef<FCDocument>     gDocument = NULL;
 CFMutableArrayRef           gMeshList = NULL;
 CFMutableArrayRef           gSkeletonList = NULL;
 CFMutableArrayRef           gAnimationClipList = NULL;
-CFMutableArrayRef			gExportRestrictionList = NULL;
+FCDLoadOptions              gLoadOptions;
 int                         gMaxNumWeights = 0;
-bool                        gMinMessageLevel = 1;
+int                         gMinMessageLevel = NEON_LOG_LEVEL_WARNING;
 bool                        gExportIndexed = 0;
+bool                        gExportTangents = 0;
+bool                        gDumpInfo = 0;
 
 static bool                 gAnimationsFound = false;
 
@@ -96,7 +99,7 @@ bool RequireSetting(const char* inComments, const char* inSetting, const char* i
     
     if (!settingPtr)
     {
-        printf("Export setting %s not found, proceeding with the assumption that it is set to %s\n", inSetting, inRequiredValue);
+        NeonWarning("Export setting %s not found, proceeding with the assumption that it is set to %s\n", inSetting, inRequiredValue);
         return true;
     }
     else
@@ -105,7 +108,7 @@ bool RequireSetting(const char* inComments, const char* inSetting, const char* i
         
         if (memcmp(settingPtr, inRequiredValue, strlen(inRequiredValue)) != 0)
         {
-            printf("Export setting %s should be %s, instead it is %c.  Aborting.\n", inSetting, inRequiredValue, *settingPtr);
+            NeonError("Export setting %s should be %s, instead it is %c.  Aborting.\n", inSetting, inRequiredValue, *settingPtr);
             exit(0);
         }
     }
@@ -139,18 +142,36 @@ bool Init()
 
     if (success == -1)
     {
-        printf("There was an error reading the file %s.  Most likely it was not found.\n", gInputFile);
+        NeonError("There was an error reading the file %s.  Most likely it was not found.\n", gInputFile);
         exit(0);
     }
     
     FCollada::Initialize();
     
     gDocument = FCollada::NewTopDocument();
-    bool retVal = FCollada::LoadDocumentFromFile(gDocument, gInputFile);
+    
+    // Only the libraries reachable from the exported meshes and clips are read up front.
+    // Cameras and lights are only reported when the scene is walked, so they are read on demand.
+    // The objects requested with -restrictObjects were added to the load options by ParseArgs,
+    // so the geometries and controllers that aren't needed are never read in.
+    gLoadOptions.SetMode(FCDLoadOptions::PHYSICS_MATERIAL, FCDLoadOptions::SKIP);
+    gLoadOptions.SetMode(FCDLoadOptions::PHYSICS_MODEL, FCDLoadOptions::SKIP);
+    gLoadOptions.SetMode(FCDLoadOptions::PHYSICS_SCENE, FCDLoadOptions::SKIP);
+    gLoadOptions.SetMode(FCDLoadOptions::FORCE_FIELD, FCDLoadOptions::SKIP);
+    gLoadOptions.SetMode(FCDLoadOptions::EMITTER, FCDLoadOptions::SKIP);
+    gLoadOptions.SetMode(FCDLoadOptions::CAMERA, FCDLoadOptions::LAZY);
+    gLoadOptions.SetMode(FCDLoadOptions::LIGHT, FCDLoadOptions::LAZY);
+    
+    bool retVal = false;
+    
+    {
+        PROFILE_SCOPE(PROFILE_TIMER_LOAD_DOCUMENT);
+        retVal = FCollada::LoadDocumentFromFile(gDocument, gInputFile, gLoadOptions);
+    }
     
     if (!retVal)
     {
-        printf("The Collada file could not be parsed, nothing will be done.\n");
+        NeonError("The Collada file could not be parsed, nothing will be done.\n");
         exit(0);
     }
     
@@ -170,6 +191,8 @@ bool Init()
 
 bool ReadSceneLibrary()
 {
+    PROFILE_SCOPE(PROFILE_TIMER_READ_SCENE_LIBRARY);
+    
     bool retVal = true;
 
 	FCDVisualSceneNodeLibrary*  vsl = gDocument->GetVisualSceneLibrary();
@@ -178,11 +201,11 @@ bool ReadSceneLibrary()
     
     if (entityCount == 0)
     {
-        printf("No scenes found in the document.  No models or skeletons will be exported.\n");
+        NeonWarning("No scenes found in the document.  No models or skeletons will be exported.\n");
     }
     else if (entityCount > 1)
     {
-        printf("More than one scene was found in the document.  Only the first one will be exported.\n");
+        NeonWarning("More than one scene was found in the document.  Only the first one will be exported.\n");
     }
     
     FCDSceneNode* rootScene = vsl->GetEntity(0);
@@ -200,7 +223,7 @@ bool ReadSceneLibrary()
         
         if (curEntity == NULL)
         {
-            printf("Warning, entity %x is NULL.\n", instanceIndex);
+            NeonWarning("Warning, entity %x is NULL.\n", instanceIndex);
             continue;
         }
         
@@ -211,43 +234,15 @@ bool ReadSceneLibrary()
 		
 		// Compare against restriction list.  If not on restriction list, then don't export this item.
 		// If we have an empty restriction list, then don't worry about this.
+		// The importer already dropped the geometries and controllers that weren't requested,
+		// this catches the remaining entities (and the meshes only loaded for a requested controller).
 		
-		int restrictionListSize = 0;
+		const FCDLoadOptions& loadOptions = gDocument->GetLoadOptions();
 		
-		if (gExportRestrictionList != NULL)
+		if (loadOptions.HasRequestedEntities() && !loadOptions.IsEntityRequested(curEntityName))
 		{
-			restrictionListSize = CFArrayGetCount(gExportRestrictionList);
-		}
-
-		if (restrictionListSize != 0)
-		{
-			bool shouldExport = false;
-
-			for (int i = 0; i < restrictionListSize; i++)
-			{
-				CFStringRef entityNameStringRef = (CFStringRef)CFArrayGetValueAtIndex(gExportRestrictionList, i);
-				int stringLength = CFStringGetLength(entityNameStringRef);
-				
-				char* entityNameCStr = (char*)malloc(stringLength + 1);
-				
-				CFStringGetCString(entityNameStringRef, entityNameCStr, stringLength + 1, kCFStringEncodingASCII);
-				
-				int result = strcmp(entityNameCStr, curEntityName);
-				
-				free(entityNameCStr);
-				
-				if (result == 0)
-				{
-					shouldExport = TRUE;
-					break;
-				}
-			}
-			
-			if (!shouldExport)
-			{
-				NeonMessage("%s is not on the export list.  Skipping...\n", curEntityName);
-				continue;
-			}
+			NeonMessage("%s is not on the export list.  Skipping...\n", curEntityName);
+			continue;
 		}
         
         switch(type)
@@ -276,7 +271,7 @@ bool ReadSceneLibrary()
                     {
                         // When parsing the animation clips, we reference one skeleton and look for nodes in there
                         // that correspond to the animations.  We don't search through all skeletons.
-                        printf("More than one skeleton was found in this file.  Animations won't work.");
+                        NeonWarning("More than one skeleton was found in this file.  Animations won't work.");
                     }
                     
                     CFArrayAppendValue(gSkeletonList, skeleton);
@@ -287,7 +282,7 @@ bool ReadSceneLibrary()
             
             default:
             {
-                printf("%s encountered.  Skipping.\n", ENTITY_NAMES[type]);
+                NeonWarning("%s encountered.  Skipping.\n", ENTITY_NAMES[type]);
                 break;
             }
         }
@@ -333,13 +328,15 @@ bool ReadAnimationLibrary()
         return true;
     }
     
+    PROFILE_SCOPE(PROFILE_TIMER_READ_ANIMATION_LIBRARY);
+    
     FCDAnimationLibrary* animationLibrary = gDocument->GetAnimationLibrary();
     
     int numEntities = animationLibrary->GetEntityCount();
     
     if (numEntities == 0)
     {
-        printf("No animation clips found.  Skipping...\n");
+        NeonMessage("No animation clips found.  Skipping...\n");
     }
     else
     {
@@ -398,13 +395,21 @@ void ExtractInstances(FCDSceneNode* inRoot, fm::pvector<FCDEntityInstance>* inIn
 
 void DisplayUsage()
 {
-    printf("Usage is Neon21ModelExporter <input filename> <output directory>\n");
-	printf("Optional arguments are:\n");
-	printf("-maxNumWeights <val>:\tThis will restrict the maximum number of vertex influences\n");
-	printf("\t\t\t\t\t\t\t(and rescale the largest influences to add to 1).\n");
-	printf("-restrictObjects \"<objects separated by spaces>\":\tThis will only export objects with the\n");
-	printf("\t\t\t\t\t\t\t\t\t\tindicated names. Object names must be separated by spaces,\n");
-	printf("\t\t\t\t\t\t\t\t\t\tand the entire list remust be enclosed in quotes.\n");
+    NeonOutput("Usage is Neon21ModelExporter <input filename> <output directory>\n");
+	NeonOutput("Optional arguments are:\n");
+	NeonOutput("-maxNumWeights <val>:\tThis will restrict the maximum number of vertex influences\n");
+	NeonOutput("\t\t\t\t\t\t\t(and rescale the largest influences to add to 1).\n");
+	NeonOutput("-restrictObjects \"<objects separated by spaces>\":\tThis will only export objects with the\n");
+	NeonOutput("\t\t\t\t\t\t\t\t\t\tindicated names. Object names must be separated by spaces,\n");
+	NeonOutput("\t\t\t\t\t\t\t\t\t\tand the entire list remust be enclosed in quotes.\n");
+	NeonOutput("-tangents <val>:\tIf val is non-zero, texture tangents and their handedness are generated\n");
+	NeonOutput("\t\t\t\t\t\t\tand added to the vertex stream (for normal mapping).\n");
+	NeonOutput("-snapshotCache <val>:\tIf val is non-zero, the parsed input file is cached in a binary snapshot\n");
+	NeonOutput("\t\t\t\t\t\t\t(<input filename>.fcsnap) that is reused until the input file changes.\n");
+	NeonOutput("-profile <val>:\tIf val is non-zero, a table of the time spent in each phase of the export is printed at the end.\n");
+	NeonOutput("-dumpInfo <val>:\tIf val is non-zero, the skeletons and every key of the animation clips are printed.\n");
+	NeonOutput("-asyncLog <val>:\tIf val is non-zero, the log is written out by a thread of its own.\n");
+	NeonOutput("-profileTrace <file>:\tProfiles the export and also writes every timed call to a Chrome trace file.\n");
 }
 
 bool ParseArgs(int inArgc, char* inArgv[])
@@ -427,16 +432,13 @@ bool ParseArgs(int inArgc, char* inArgv[])
 			int objectListStringLength = strlen(inArgv[argIndex + 1]);
 			char* objectList = (char*)malloc(objectListStringLength + 1);
 			
-			gExportRestrictionList = CFArrayCreateMutable(NULL, 0, NULL);
-			
 			strcpy(objectList, inArgv[argIndex + 1]);
 
 			char* curFile = strtok(objectList, " ");
 			
 			while(curFile != NULL)
 			{
-				CFStringRef newString = CFStringCreateWithCString(NULL, curFile, kCFStringEncodingASCII);
-				CFArrayAppendValue(gExportRestrictionList, newString);
+				gLoadOptions.AddRequestedEntity(curFile);
 				
 				curFile = strtok(NULL, " ");
 			}
@@ -445,17 +447,61 @@ bool ParseArgs(int inArgc, char* inArgv[])
 		}
         else if (strstr(inArgv[argIndex], "-verbose"))
         {
-            gMinMessageLevel = 0;
+            gMinMessageLevel = NEON_LOG_LEVEL_MESSAGE;
         }
         else if (strstr(inArgv[argIndex], "-indexed"))
         {
             gExportIndexed = true;
         }
+        else if (strstr(inArgv[argIndex], "-tangents"))
+        {
+            int exportTangents = 0;
+            sscanf(inArgv[argIndex + 1], "%d", &exportTangents);
+            
+            gExportTangents = (exportTangents != 0);
+        }
+        else if (strstr(inArgv[argIndex], "-dumpInfo"))
+        {
+            int dumpInfo = 0;
+            sscanf(inArgv[argIndex + 1], "%d", &dumpInfo);
+            
+            gDumpInfo = (dumpInfo != 0);
+        }
+        else if (strstr(inArgv[argIndex], "-asyncLog"))
+        {
+            int asyncLog = 0;
+            sscanf(inArgv[argIndex + 1], "%d", &asyncLog);
+            
+            NeonLogSetAsynchronous(asyncLog != 0);
+        }
+        else if (strstr(inArgv[argIndex], "-profileTrace"))
+        {
+            ProfileEnable(inArgv[argIndex + 1]);
+        }
+        else if (strstr(inArgv[argIndex], "-profile"))
+        {
+            int profile = 0;
+            sscanf(inArgv[argIndex + 1], "%d", &profile);
+            
+            if ((profile != 0) && (!gProfilingEnabled))
+            {
+                ProfileEnable(NULL);
+            }
+        }
+        else if (strstr(inArgv[argIndex], "-snapshotCache"))
+        {
+            int snapshotCache = 0;
+            sscanf(inArgv[argIndex + 1], "%d", &snapshotCache);
+            
+            gLoadOptions.SetSnapshotCacheEnabled(snapshotCache != 0);
+        }
     }
     
     return true;
 }
 
+// The benchmark drives Init, ReadScene and WriteScene itself, on the scenes that it generates.
+#ifndef NEON21_MODELEXPORTER_BENCHMARK
 int main (int argc, char* argv[])
 {
     bool status = ParseArgs(argc, argv);
@@ -470,7 +516,10 @@ int main (int argc, char* argv[])
         
         // Write out the information in a more sane binary format
         WriteScene();
+        
+        ProfileReport();
     }
 
     return 0;
 }
+#endif
@@ -1,7 +1,13 @@
 #pragma once
 
+extern char* gInputFile;
 extern char* gOutputDirectory;
 extern CFMutableArrayRef gMeshList;
 extern int   gMaxNumWeights;
-extern bool  gMinMessageLevel;
-extern bool  gExportIndexed;
\ No newline at end of file
+extern bool  gExportIndexed;
+extern bool  gExportTangents;
+extern bool  gDumpInfo;
+
+bool Init();
+bool ReadScene();
+void WriteScene();